@@ -0,0 +1,154 @@
+/*
+ * Copyright (c) 2017 Andrew Kelley
+ *
+ * This file is part of zig, which is MIT licensed.
+ * See http://opensource.org/licenses/MIT
+ */
+
+// Replays the BigInt calls constant folding makes: ir_eval_math_op computes
+// a result and checks it with bigint_fits_in_bits against the type, the wrap
+// operators truncate, casts and switch ranges compare. Operands are shaped
+// like the ones in real source: mostly small literals, u8 to u32 values and
+// some negative numbers, all of which fit in one digit.
+//
+//     cmake --build . --target bench_bigint && ./bench_bigint [count]
+
+#include "bigint.hpp"
+#include "os.hpp"
+#include "util.hpp"
+
+#include <chrono>
+#include <stdio.h>
+
+static double now_seconds(void) {
+    auto t = std::chrono::steady_clock::now().time_since_epoch();
+    return std::chrono::duration_cast<std::chrono::duration<double>>(t).count();
+}
+
+static uint64_t next_random(uint64_t *state) {
+    // xorshift64*, so the operands are the same on every run
+    *state ^= *state >> 12;
+    *state ^= *state << 25;
+    *state ^= *state >> 27;
+    return *state * 2685821657736338717ULL;
+}
+
+static void init_operand(BigInt *dest, uint64_t *state) {
+    uint64_t x = next_random(state);
+    switch (x % 8) {
+        case 0:
+        case 1:
+        case 2:
+            bigint_init_unsigned(dest, (x >> 8) % 1000);
+            break;
+        case 3:
+            bigint_init_unsigned(dest, (x >> 8) & 0xff);
+            break;
+        case 4:
+            bigint_init_unsigned(dest, (x >> 8) & 0xffff);
+            break;
+        case 5:
+            bigint_init_unsigned(dest, (x >> 8) & 0xffffffff);
+            break;
+        case 6:
+            bigint_init_signed(dest, -(int64_t)((x >> 8) % 1000));
+            break;
+        default:
+            bigint_init_signed(dest, (int32_t)(x >> 8));
+            break;
+    }
+}
+
+struct Operation {
+    const char *name;
+    size_t (*fn)(const BigInt *op1, const BigInt *op2);
+};
+
+static size_t op_add(const BigInt *op1, const BigInt *op2) {
+    BigInt result;
+    bigint_add(&result, op1, op2);
+    return bigint_fits_in_bits(&result, 64, true);
+}
+
+static size_t op_sub(const BigInt *op1, const BigInt *op2) {
+    BigInt result;
+    bigint_sub(&result, op1, op2);
+    return bigint_fits_in_bits(&result, 32, true);
+}
+
+static size_t op_mul(const BigInt *op1, const BigInt *op2) {
+    BigInt result;
+    bigint_mul(&result, op1, op2);
+    return bigint_fits_in_bits(&result, 64, false);
+}
+
+static size_t op_add_wrap(const BigInt *op1, const BigInt *op2) {
+    BigInt result;
+    bigint_add_wrap(&result, op1, op2, 32, false);
+    return bigint_cmp_zero(&result);
+}
+
+static size_t op_mul_wrap(const BigInt *op1, const BigInt *op2) {
+    BigInt result;
+    bigint_mul_wrap(&result, op1, op2, 16, true);
+    return bigint_cmp_zero(&result);
+}
+
+static size_t op_cmp(const BigInt *op1, const BigInt *op2) {
+    return bigint_cmp(op1, op2);
+}
+
+static size_t op_truncate(const BigInt *op1, const BigInt *op2) {
+    BigInt result;
+    bigint_truncate(&result, op1, 8, false);
+    return bigint_fits_in_bits(&result, 8, false);
+}
+
+static size_t op_fits_in_bits(const BigInt *op1, const BigInt *op2) {
+    if (bigint_cmp_zero(op1) == CmpEQ)
+        return 0;
+    return bigint_fits_in_bits(op1, 8, true) + bigint_fits_in_bits(op1, 16, false);
+}
+
+static size_t op_clz(const BigInt *op1, const BigInt *op2) {
+    if (op1->is_negative)
+        return 0;
+    return bigint_clz(op1, 32);
+}
+
+static const Operation operations[] = {
+    {"add + fits", op_add},
+    {"sub + fits", op_sub},
+    {"mul + fits", op_mul},
+    {"add wrap", op_add_wrap},
+    {"mul wrap", op_mul_wrap},
+    {"cmp", op_cmp},
+    {"truncate", op_truncate},
+    {"fits_in_bits", op_fits_in_bits},
+    {"clz", op_clz},
+};
+
+int main(int argc, char **argv) {
+    size_t count = (argc >= 2) ? (size_t)atoi(argv[1]) : 1000000;
+
+    BigInt *operands = allocate<BigInt>(count + 1);
+    uint64_t state = 0x9e3779b97f4a7c15ULL;
+    for (size_t i = 0; i < count + 1; i += 1) {
+        init_operand(&operands[i], &state);
+    }
+
+    fprintf(stdout, "%" ZIG_PRI_usize " operations each\n", count);
+    fprintf(stdout, "%-16s%12s%12s\n", "", "ms", "ns/op");
+    size_t checksum = 0;
+    for (size_t op_i = 0; op_i < array_length(operations); op_i += 1) {
+        const Operation *operation = &operations[op_i];
+        double start = now_seconds();
+        for (size_t i = 0; i < count; i += 1) {
+            checksum += operation->fn(&operands[i], &operands[i + 1]);
+        }
+        double elapsed = now_seconds() - start;
+        fprintf(stdout, "%-16s%12.2f%12.2f\n", operation->name, elapsed * 1000.0, elapsed * 1e9 / count);
+    }
+    fprintf(stdout, "checksum %" ZIG_PRI_usize "\n", checksum);
+    return 0;
+}
@@ -0,0 +1,356 @@
+/*
+ * Copyright (c) 2017 Andrew Kelley
+ *
+ * This file is part of zig, which is MIT licensed.
+ * See http://opensource.org/licenses/MIT
+ */
+
+// Compares HashMap against the robin hood table it replaced, using the key
+// types and hash functions the compiler actually uses: Buf * identifiers
+// (decl_table, import_table, package_table, ...) and pointers (fn tables,
+// the IR maps).
+//
+//     cmake --build . --target bench_hash_map && ./bench_hash_map [count]
+
+#include "buffer.hpp"
+#include "hash_map.hpp"
+#include "os.hpp"
+#include "util.hpp"
+
+#include <chrono>
+#include <stdio.h>
+
+// The previous implementation, kept verbatim for comparison.
+template<typename K, typename V, uint32_t (*HashFunction)(K key), bool (*EqualFn)(K a, K b)>
+class LinearHashMap {
+public:
+    void init(int capacity) {
+        init_capacity(capacity);
+    }
+    void deinit(void) {
+        free(_entries);
+    }
+
+    struct Entry {
+        bool used;
+        int distance_from_start_index;
+        K key;
+        V value;
+    };
+
+    void clear() {
+        for (int i = 0; i < _capacity; i += 1) {
+            _entries[i].used = false;
+        }
+        _size = 0;
+        _max_distance_from_start_index = 0;
+        _modification_count += 1;
+    }
+
+    int size() const {
+        return _size;
+    }
+
+    void put(const K &key, const V &value) {
+        _modification_count += 1;
+        internal_put(key, value);
+
+        // if we get too full (60%), double the capacity
+        if (_size * 5 >= _capacity * 3) {
+            Entry *old_entries = _entries;
+            int old_capacity = _capacity;
+            init_capacity(_capacity * 2);
+            // dump all of the old elements into the new table
+            for (int i = 0; i < old_capacity; i += 1) {
+                Entry *old_entry = &old_entries[i];
+                if (old_entry->used)
+                    internal_put(old_entry->key, old_entry->value);
+            }
+            free(old_entries);
+        }
+    }
+
+    Entry *put_unique(const K &key, const V &value) {
+        // TODO make this more efficient
+        Entry *entry = internal_get(key);
+        if (entry)
+            return entry;
+        put(key, value);
+        return nullptr;
+    }
+
+    const V &get(const K &key) const {
+        Entry *entry = internal_get(key);
+        if (!entry)
+            zig_panic("key not found");
+        return entry->value;
+    }
+
+    Entry *maybe_get(const K &key) const {
+        return internal_get(key);
+    }
+
+    void maybe_remove(const K &key) {
+        if (maybe_get(key)) {
+            remove(key);
+        }
+    }
+
+    void remove(const K &key) {
+        _modification_count += 1;
+        int start_index = key_to_index(key);
+        for (int roll_over = 0; roll_over <= _max_distance_from_start_index; roll_over += 1) {
+            int index = (start_index + roll_over) % _capacity;
+            Entry *entry = &_entries[index];
+
+            if (!entry->used)
+                zig_panic("key not found");
+
+            if (!EqualFn(entry->key, key))
+                continue;
+
+            for (; roll_over < _capacity; roll_over += 1) {
+                int next_index = (start_index + roll_over + 1) % _capacity;
+                Entry *next_entry = &_entries[next_index];
+                if (!next_entry->used || next_entry->distance_from_start_index == 0) {
+                    entry->used = false;
+                    _size -= 1;
+                    return;
+                }
+                *entry = *next_entry;
+                entry->distance_from_start_index -= 1;
+                entry = next_entry;
+            }
+            zig_panic("shifting everything in the table");
+        }
+        zig_panic("key not found");
+    }
+
+    class Iterator {
+    public:
+        Entry *next() {
+            if (_inital_modification_count != _table->_modification_count)
+                zig_panic("concurrent modification");
+            if (_count >= _table->size())
+                return NULL;
+            for (; _index < _table->_capacity; _index += 1) {
+                Entry *entry = &_table->_entries[_index];
+                if (entry->used) {
+                    _index += 1;
+                    _count += 1;
+                    return entry;
+                }
+            }
+            zig_panic("no next item");
+        }
+    private:
+        const LinearHashMap * _table;
+        // how many items have we returned
+        int _count = 0;
+        // iterator through the entry array
+        int _index = 0;
+        // used to detect concurrent modification
+        uint32_t _inital_modification_count;
+        Iterator(const LinearHashMap * table) :
+                _table(table), _inital_modification_count(table->_modification_count) {
+        }
+        friend LinearHashMap;
+    };
+
+    // you must not modify the underlying HashMap while this iterator is still in use
+    Iterator entry_iterator() const {
+        return Iterator(this);
+    }
+
+private:
+
+    Entry *_entries;
+    int _capacity;
+    int _size;
+    int _max_distance_from_start_index;
+    // this is used to detect bugs where a hashtable is edited while an iterator is running.
+    uint32_t _modification_count;
+
+    void init_capacity(int capacity) {
+        _capacity = capacity;
+        _entries = allocate<Entry>(_capacity);
+        _size = 0;
+        _max_distance_from_start_index = 0;
+        for (int i = 0; i < _capacity; i += 1) {
+            _entries[i].used = false;
+        }
+    }
+
+    void internal_put(K key, V value) {
+        int start_index = key_to_index(key);
+        for (int roll_over = 0, distance_from_start_index = 0;
+                roll_over < _capacity; roll_over += 1, distance_from_start_index += 1)
+        {
+            int index = (start_index + roll_over) % _capacity;
+            Entry *entry = &_entries[index];
+
+            if (entry->used && !EqualFn(entry->key, key)) {
+                if (entry->distance_from_start_index < distance_from_start_index) {
+                    // robin hood to the rescue
+                    Entry tmp = *entry;
+                    if (distance_from_start_index > _max_distance_from_start_index)
+                        _max_distance_from_start_index = distance_from_start_index;
+                    *entry = {
+                        true,
+                        distance_from_start_index,
+                        key,
+                        value,
+                    };
+                    key = tmp.key;
+                    value = tmp.value;
+                    distance_from_start_index = tmp.distance_from_start_index;
+                }
+                continue;
+            }
+
+            if (!entry->used) {
+                // adding an entry. otherwise overwriting old value with
+                // same key
+                _size += 1;
+            }
+
+            if (distance_from_start_index > _max_distance_from_start_index)
+                _max_distance_from_start_index = distance_from_start_index;
+            *entry = {
+                true,
+                distance_from_start_index,
+                key,
+                value,
+            };
+            return;
+        }
+        zig_panic("put into a full HashMap");
+    }
+
+
+    Entry *internal_get(const K &key) const {
+        int start_index = key_to_index(key);
+        for (int roll_over = 0; roll_over <= _max_distance_from_start_index; roll_over += 1) {
+            int index = (start_index + roll_over) % _capacity;
+            Entry *entry = &_entries[index];
+
+            if (!entry->used)
+                return NULL;
+
+            if (EqualFn(entry->key, key))
+                return entry;
+        }
+        return NULL;
+    }
+
+    int key_to_index(const K &key) const {
+        return (int)(HashFunction(key) % ((uint32_t)_capacity));
+    }
+};
+
+static double now_seconds(void) {
+    auto t = std::chrono::steady_clock::now().time_since_epoch();
+    return std::chrono::duration_cast<std::chrono::duration<double>>(t).count();
+}
+
+struct BenchResult {
+    double insert;
+    double hit;
+    double miss;
+    double remove;
+    size_t checksum;
+};
+
+template<typename Map, typename K>
+static BenchResult run_bench(K *keys, K *missing_keys, size_t count) {
+    BenchResult result = {};
+    Map map;
+    map.init(16);
+
+    double start = now_seconds();
+    for (size_t i = 0; i < count; i += 1) {
+        // put_unique is how decl_table, generic_table and friends are filled
+        if (map.put_unique(keys[i], i) != nullptr)
+            zig_panic("duplicate key");
+    }
+    result.insert = now_seconds() - start;
+
+    start = now_seconds();
+    for (int round = 0; round < 4; round += 1) {
+        for (size_t i = 0; i < count; i += 1) {
+            auto entry = map.maybe_get(keys[i]);
+            result.checksum += entry->value;
+        }
+    }
+    result.hit = now_seconds() - start;
+
+    start = now_seconds();
+    for (int round = 0; round < 4; round += 1) {
+        for (size_t i = 0; i < count; i += 1) {
+            if (map.maybe_get(missing_keys[i]) != nullptr)
+                zig_panic("unexpected key");
+        }
+    }
+    result.miss = now_seconds() - start;
+
+    start = now_seconds();
+    for (size_t i = 0; i < count; i += 2) {
+        map.remove(keys[i]);
+    }
+    for (size_t i = 1; i < count; i += 2) {
+        if (map.maybe_get(keys[i])->value != i)
+            zig_panic("lost key after remove");
+    }
+    result.remove = now_seconds() - start;
+    if ((size_t)map.size() != count / 2)
+        zig_panic("wrong size after remove");
+
+    map.deinit();
+    return result;
+}
+
+static void print_row(const char *name, const BenchResult &r) {
+    fprintf(stdout, "%-24s%12.2f%12.2f%12.2f%12.2f\n", name,
+            r.insert * 1000.0, r.hit * 1000.0, r.miss * 1000.0, r.remove * 1000.0);
+}
+
+template<typename K, uint32_t (*HashFunction)(K key), bool (*EqualFn)(K a, K b)>
+static void compare(const char *name, K *keys, K *missing_keys, size_t count) {
+    BenchResult old_result = run_bench<LinearHashMap<K, size_t, HashFunction, EqualFn>>(keys, missing_keys, count);
+    BenchResult new_result = run_bench<HashMap<K, size_t, HashFunction, EqualFn>>(keys, missing_keys, count);
+    if (old_result.checksum != new_result.checksum)
+        zig_panic("maps disagree");
+
+    fprintf(stdout, "\n%s, %" ZIG_PRI_usize " keys (ms)\n", name, count);
+    fprintf(stdout, "%-24s%12s%12s%12s%12s\n", "", "insert", "hit x4", "miss x4", "remove");
+    print_row("robin hood (old)", old_result);
+    print_row("swiss table (new)", new_result);
+}
+
+static bool buf_key_eql(Buf *a, Buf *b) {
+    return buf_eql_buf(a, b);
+}
+
+int main(int argc, char **argv) {
+    size_t count = (argc >= 2) ? (size_t)atoi(argv[1]) : 200000;
+
+    // identifiers shaped like the ones in real source: short, sharing prefixes
+    Buf **names = allocate<Buf *>(count);
+    Buf **missing_names = allocate<Buf *>(count);
+    for (size_t i = 0; i < count; i += 1) {
+        names[i] = buf_sprintf("field_%" ZIG_PRI_usize, i);
+        missing_names[i] = buf_sprintf("other_%" ZIG_PRI_usize, i);
+    }
+    compare<Buf *, buf_hash, buf_key_eql>("Buf * identifiers", names, missing_names, count);
+
+    // heap pointers, like FnTableEntry * and IrInstruction * keys
+    const void **ptrs = allocate<const void *>(count);
+    const void **missing_ptrs = allocate<const void *>(count);
+    for (size_t i = 0; i < count; i += 1) {
+        ptrs[i] = allocate<uint64_t>(2);
+        missing_ptrs[i] = allocate<uint64_t>(2);
+    }
+    compare<const void *, ptr_hash, ptr_eq>("pointers", ptrs, missing_ptrs, count);
+
+    return 0;
+}
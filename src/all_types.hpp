@@ -8,6 +8,7 @@
 #ifndef ZIG_ALL_TYPES_HPP
 #define ZIG_ALL_TYPES_HPP
 
+#include "arena.hpp"
 #include "list.hpp"
 #include "buffer.hpp"
 #include "zig_llvm.hpp"
@@ -30,6 +31,7 @@ struct LabelTableEntry;
 struct BuiltinFnEntry;
 struct TypeStructField;
 struct CodeGen;
+struct ParseScheduler;
 struct ConstExprValue;
 struct IrInstruction;
 struct IrInstructionCast;
@@ -59,6 +61,30 @@ struct IrExecutable {
     AstNode *source_node;
     IrExecutable *parent_exec;
     Scope *begin_scope;
+    // Set by pass 1 when the code declares a struct, enum or union. Their
+    // decls see the scope the IR was generated in, so the IR is not reusable.
+    bool declares_container;
+    // what ir_remove_dead_code took out of the pass 1 IR
+    size_t gen_instruction_count;
+    size_t dead_instruction_count;
+    size_t dead_block_count;
+};
+
+// The pass 1 IR of a function body, generated for a compile time call and
+// kept so that later calls analyze it again instead of regenerating it.
+struct IrCachedExecutable {
+    IrExecutable exec;
+    // The scope the body was generated in. Before the IR is reused, the
+    // parameter variables along it are pointed at the new call's arguments.
+    Scope *scope;
+    // the values pass 1 gave each instruction, in block order, with their
+    // own copy of any array elements or struct fields; analysis overwrites
+    // the types and may write through the aggregates of what it copies
+    ZigList<ConstExprValue *> gen_values;
+    // the variables the body declares; analysis sets their values
+    ZigList<VariableTableEntry *> local_vars;
+    // a recursive call must not analyze the same IR as its caller
+    bool in_use;
 };
 
 enum OutType {
@@ -102,6 +128,10 @@ struct ConstStructValue {
 enum ConstArraySpecial {
     ConstArraySpecialNone,
     ConstArraySpecialUndef,
+    // The array is a []u8 whose bytes live packed in s_buf rather than as one
+    // ConstExprValue per element. It is expanded into s_none.elements only
+    // when an element needs to be addressed or mutated; see expand_undef_array.
+    ConstArraySpecialBuf,
 };
 
 struct ConstArrayValue {
@@ -110,6 +140,9 @@ struct ConstArrayValue {
         ConstExprValue *elements;
         ConstParent parent;
     } s_none;
+    // Only valid for ConstArraySpecialBuf. Never mutated once set, so the same
+    // Buf can be shared between copies of the value.
+    Buf *s_buf;
 };
 
 enum ConstPtrSpecial {
@@ -548,6 +581,8 @@ enum CastOp {
     CastOpResizeSlice,
     CastOpBytesToSlice,
     CastOpNumLitToConcrete,
+    CastOpArrayToVector,
+    CastOpVectorToArray,
 };
 
 struct AstNodeFnCallExpr {
@@ -928,6 +963,12 @@ struct TypeTableEntryArray {
     uint64_t len;
 };
 
+struct TypeTableEntryVector {
+    // an int, float or bool type
+    TypeTableEntry *elem_type;
+    uint32_t len;
+};
+
 struct TypeStructField {
     Buf *name;
     TypeTableEntry *type_entry;
@@ -1068,6 +1109,7 @@ enum TypeTableEntryId {
     TypeTableEntryIdBoundFn,
     TypeTableEntryIdArgTuple,
     TypeTableEntryIdOpaque,
+    TypeTableEntryIdVector,
 };
 
 struct TypeTableEntry {
@@ -1085,6 +1127,7 @@ struct TypeTableEntry {
         TypeTableEntryInt integral;
         TypeTableEntryFloat floating;
         TypeTableEntryArray array;
+        TypeTableEntryVector vector;
         TypeTableEntryStruct structure;
         TypeTableEntryMaybe maybe;
         TypeTableEntryError error;
@@ -1166,6 +1209,12 @@ struct FnTableEntry {
 
     ZigList<IrInstruction *> alloca_list;
     ZigList<VariableTableEntry *> variable_list;
+    ZigList<IrCachedExecutable *> comptime_ir_cache;
+    // set when ir_interpret_fn_body found the body uses something it never
+    // handles; giving up on the values of one call does not set it
+    bool comptime_not_interpretable;
+    // the body has not been queued for analysis yet; see queue_fn_analysis
+    bool analysis_deferred;
 
     AstNode *set_global_align_node;
     uint32_t alignment;
@@ -1178,6 +1227,11 @@ struct FnTableEntry {
 uint32_t fn_table_entry_hash(FnTableEntry*);
 bool fn_table_entry_eql(FnTableEntry *a, FnTableEntry *b);
 
+uint32_t const_val_ptr_hash(ConstExprValue *value);
+bool const_val_ptr_eql(ConstExprValue *a, ConstExprValue *b);
+uint32_t const_val_content_hash(ConstExprValue *value);
+bool const_val_content_eql(ConstExprValue *a, ConstExprValue *b);
+
 enum BuiltinFnId {
     BuiltinFnIdInvalid,
     BuiltinFnIdMemcpy,
@@ -1208,6 +1262,9 @@ enum BuiltinFnId {
     BuiltinFnIdEmbedFile,
     BuiltinFnIdCmpExchange,
     BuiltinFnIdFence,
+    BuiltinFnIdAtomicRmw,
+    BuiltinFnIdAtomicLoad,
+    BuiltinFnIdAtomicStore,
     BuiltinFnIdDivExact,
     BuiltinFnIdDivTrunc,
     BuiltinFnIdDivFloor,
@@ -1231,6 +1288,12 @@ enum BuiltinFnId {
     BuiltinFnIdOffsetOf,
     BuiltinFnIdInlineCall,
     BuiltinFnIdTypeId,
+    BuiltinFnIdVectorType,
+    BuiltinFnIdSplat,
+    BuiltinFnIdShuffle,
+    BuiltinFnIdExtractElement,
+    BuiltinFnIdInsertElement,
+    BuiltinFnIdReduce,
 };
 
 struct BuiltinFnEntry {
@@ -1254,6 +1317,7 @@ enum PanicMsgId {
     PanicMsgIdSliceWidenRemainder,
     PanicMsgIdUnwrapMaybeFail,
     PanicMsgIdInvalidErrorCode,
+    PanicMsgIdShiftAmountTooBig,
 
     PanicMsgIdCount,
 };
@@ -1272,6 +1336,7 @@ struct TypeId {
             uint32_t bit_offset;
             uint32_t unaligned_bit_count;
         } pointer;
+        // also used by vector types
         struct {
             TypeTableEntry *child_type;
             uint64_t size;
@@ -1312,6 +1377,7 @@ struct ZigLLVMFnKey {
         } clz;
         struct {
             uint32_t bit_count;
+            uint32_t vector_len; // 0 for a scalar
         } floor_ceil;
         struct {
             AddSubMul add_sub_mul;
@@ -1329,10 +1395,36 @@ struct TimeEvent {
     const char *name;
 };
 
+enum ProfileCategory {
+    ProfileCategoryParse,
+    ProfileCategoryIrGen,
+    ProfileCategoryAnalyze,
+    ProfileCategoryComptimeCall,
+    ProfileCategoryLLVMGen,
+    ProfileCategoryLLVMPasses,
+
+    ProfileCategoryCount,
+};
+
+// One timed piece of work, recorded with --enable-timing-info. Spans on the
+// same thread nest, and child_time is what was spent in nested spans.
+struct ProfileSpan {
+    ProfileCategory category;
+    Buf *name;
+    // where the work came from, e.g. the call site of a comptime call; may be null
+    AstNode *source_node;
+    double start;
+    double end;
+    double child_time;
+    // 0 is the main thread
+    uint32_t thread_index;
+};
+
 enum BuildMode {
     BuildModeDebug,
     BuildModeFastRelease,
     BuildModeSafeRelease,
+    BuildModeSmallRelease,
 };
 
 struct LinkLib {
@@ -1342,6 +1434,11 @@ struct LinkLib {
     bool provided_explicitly;
 };
 
+struct CacheDependency {
+    Buf *path;
+    uint64_t hash;
+};
+
 struct CodeGen {
     LLVMModuleRef module;
     ZigList<ErrorMsg*> errors;
@@ -1416,7 +1513,6 @@ struct CodeGen {
         TypeTableEntry *entry_arch_enum;
         TypeTableEntry *entry_environ_enum;
         TypeTableEntry *entry_oformat_enum;
-        TypeTableEntry *entry_atomic_order_enum;
         TypeTableEntry *entry_global_linkage_enum;
         TypeTableEntry *entry_arg_tuple;
     } builtin_types;
@@ -1474,6 +1570,23 @@ struct CodeGen {
     ZigList<FnTableEntry *> fn_protos;
     ZigList<TldVar *> global_vars;
 
+    // --lazy-analysis: the body of a function that is not exported, an entry
+    // point or a test is only analyzed once analyzed code or a global variable
+    // that will be emitted refers to the function.
+    bool lazy_analysis;
+    size_t lazy_fn_defs_index;
+    size_t lazy_global_vars_index;
+    HashMap<ConstExprValue *, bool, const_val_ptr_hash, const_val_ptr_eql> lazy_visited_values;
+    size_t fn_bodies_skipped_count;
+
+    // Anonymous constant globals keyed by type and contents, so that equal
+    // string literals and tables rendered from different places share one
+    // global. The values of global variables own their storage and are kept
+    // out of it.
+    HashMap<ConstExprValue *, ConstGlobalRefs *, const_val_content_hash, const_val_content_eql> const_global_pool;
+    HashMap<ConstExprValue *, bool, const_val_ptr_hash, const_val_ptr_eql> global_var_values;
+    size_t const_globals_pooled_count;
+
     OutType out_type;
     FnTableEntry *cur_fn;
     FnTableEntry *main_fn;
@@ -1531,12 +1644,52 @@ struct CodeGen {
     Buf *test_name_prefix;
 
     ZigList<TimeEvent> timing_events;
+    bool timing_info;
+    ZigList<ProfileSpan> profile_spans;
+    ZigList<size_t> profile_stack;
+    size_t ir_instruction_count;
+    size_t ir_dead_instruction_count;
+    size_t ir_dead_block_count;
+    size_t const_val_count;
+    size_t comptime_call_count;
+    size_t comptime_call_memoized_count;
+    size_t comptime_ir_reused_count;
+    size_t comptime_interpreted_count;
 
     Buf *cache_dir;
     Buf *out_h_path;
+    // when greater than 1, the module is split into this many objects which
+    // are optimized and emitted in parallel
+    size_t codegen_threads;
+    // --lto: the root object, builtin.o and compiler_rt.o are bitcode and the
+    // linker optimizes and generates code for them as one program
+    ZigLLVMLtoMode lto;
+    // --profile-generate: the root module counts how often each edge runs and
+    // writes the counts when main returns, see std/special/profile_rt.zig.
+    // --profile-use: the counts, merged by llvm-profdata, guide optimization.
+    bool profile_generate;
+    Buf *profile_use_path;
+    // imports are parsed ahead of analysis on this many threads; 0 means one per core
+    size_t parse_threads;
+    ParseScheduler *parse_scheduler;
+
+    // --skip-unchanged: the files whose contents went into the root object, so
+    // that the next build can reuse the object when none of them changed
+    bool skip_unchanged;
+    bool skip_unchanged_uncacheable;
+    ZigList<CacheDependency> cache_dependencies;
+
+    // --switch-lowering: print which strategy each runtime switch was lowered to
+    bool report_switch_lowering;
 
     ZigList<FnTableEntry *> inline_fns;
     ZigList<AstNode *> tld_ref_source_node_stack;
+
+    // AST nodes, IR and compile time values live as long as the CodeGen, so
+    // instead of a heap allocation each they are bump allocated per phase.
+    Arena ast_arena;
+    Arena ir_arena;
+    Arena const_arena;
 };
 
 enum VarLinkage {
@@ -1546,7 +1699,8 @@ enum VarLinkage {
 };
 
 struct VariableTableEntry {
-    Buf name;
+    // interned, so variable lookups compare names by pointer
+    Buf *name;
     ConstExprValue *value;
     LLVMValueRef value_ref;
     bool src_is_const;
@@ -1703,6 +1857,18 @@ enum AtomicOrder {
     AtomicOrderSeqCst,
 };
 
+// synchronized with code in define_builtin_compile_vars
+enum AtomicRmwOp {
+    AtomicRmwOpXchg,
+    AtomicRmwOpAdd,
+    AtomicRmwOpSub,
+    AtomicRmwOpAnd,
+    AtomicRmwOpOr,
+    AtomicRmwOpXor,
+    AtomicRmwOpMax,
+    AtomicRmwOpMin,
+};
+
 // A basic block contains no branching. Branches send control flow
 // to another basic block.
 // Phi instructions must be first in a basic block.
@@ -1788,6 +1954,9 @@ enum IrInstructionId {
     IrInstructionIdEmbedFile,
     IrInstructionIdCmpxchg,
     IrInstructionIdFence,
+    IrInstructionIdAtomicRmw,
+    IrInstructionIdAtomicLoad,
+    IrInstructionIdAtomicStore,
     IrInstructionIdTruncate,
     IrInstructionIdIntType,
     IrInstructionIdBoolNot,
@@ -1829,6 +1998,12 @@ enum IrInstructionId {
     IrInstructionIdFieldParentPtr,
     IrInstructionIdOffsetOf,
     IrInstructionIdTypeId,
+    IrInstructionIdVectorType,
+    IrInstructionIdSplat,
+    IrInstructionIdShuffle,
+    IrInstructionIdExtractElement,
+    IrInstructionIdInsertElement,
+    IrInstructionIdReduce,
 };
 
 struct IrInstruction {
@@ -1845,6 +2020,8 @@ struct IrInstruction {
     IrBasicBlock *owner_bb;
     // true if this instruction was generated by zig and not from user code
     bool is_gen;
+    // removed from its basic block by ir_remove_dead_code
+    bool is_dead;
 };
 
 struct IrInstructionCondBr {
@@ -2297,6 +2474,43 @@ struct IrInstructionFence {
     AtomicOrder order;
 };
 
+struct IrInstructionAtomicRmw {
+    IrInstruction base;
+
+    IrInstruction *operand_type;
+    IrInstruction *ptr;
+    IrInstruction *op_value;
+    IrInstruction *operand;
+    IrInstruction *order_value;
+
+    // if this instruction gets to runtime then we know these values:
+    AtomicRmwOp op;
+    AtomicOrder order;
+};
+
+struct IrInstructionAtomicLoad {
+    IrInstruction base;
+
+    IrInstruction *operand_type;
+    IrInstruction *ptr;
+    IrInstruction *order_value;
+
+    // if this instruction gets to runtime then we know these values:
+    AtomicOrder order;
+};
+
+struct IrInstructionAtomicStore {
+    IrInstruction base;
+
+    IrInstruction *operand_type;
+    IrInstruction *ptr;
+    IrInstruction *value;
+    IrInstruction *order_value;
+
+    // if this instruction gets to runtime then we know these values:
+    AtomicOrder order;
+};
+
 struct IrInstructionTruncate {
     IrInstruction base;
 
@@ -2597,6 +2811,69 @@ struct IrInstructionTypeId {
     IrInstruction *type_value;
 };
 
+struct IrInstructionVectorType {
+    IrInstruction base;
+
+    IrInstruction *len;
+    IrInstruction *elem_type;
+};
+
+struct IrInstructionSplat {
+    IrInstruction base;
+
+    IrInstruction *len;
+    IrInstruction *scalar;
+};
+
+struct IrInstructionShuffle {
+    IrInstruction base;
+
+    IrInstruction *elem_type;
+    IrInstruction *a;
+    IrInstruction *b;
+    IrInstruction *mask;
+
+    // if this instruction gets to runtime then we know the mask: each entry
+    // indexes a when it is positive or zero and b at ~entry when negative
+    int32_t *mask_indexes;
+    uint32_t mask_len;
+};
+
+struct IrInstructionExtractElement {
+    IrInstruction base;
+
+    IrInstruction *vector;
+    IrInstruction *index;
+};
+
+struct IrInstructionInsertElement {
+    IrInstruction base;
+
+    IrInstruction *vector;
+    IrInstruction *index;
+    IrInstruction *value;
+};
+
+enum ReduceOp {
+    ReduceOpAdd,
+    ReduceOpMul,
+    ReduceOpAnd,
+    ReduceOpOr,
+    ReduceOpXor,
+    ReduceOpMin,
+    ReduceOpMax,
+};
+
+struct IrInstructionReduce {
+    IrInstruction base;
+
+    IrInstruction *op_value;
+    IrInstruction *vector;
+
+    // if this instruction gets to runtime then we know this value:
+    ReduceOp op;
+};
+
 static const size_t slice_ptr_index = 0;
 static const size_t slice_len_index = 1;
 
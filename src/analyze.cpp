@@ -12,7 +12,10 @@
 #include "ir.hpp"
 #include "ir_print.hpp"
 #include "os.hpp"
+#include "parse_scheduler.hpp"
 #include "parser.hpp"
+#include "profile.hpp"
+#include "unchanged_build.hpp"
 #include "zig_llvm.hpp"
 
 static const size_t default_backward_branch_quota = 1000;
@@ -48,12 +51,19 @@ ErrorMsg *add_error_note(CodeGen *g, ErrorMsg *parent_msg, AstNode *node, Buf *m
     return err;
 }
 
+static size_t type_table_entry_count = 0;
+
 TypeTableEntry *new_type_table_entry(TypeTableEntryId id) {
+    type_table_entry_count += 1;
     TypeTableEntry *entry = allocate<TypeTableEntry>(1);
     entry->id = id;
     return entry;
 }
 
+size_t get_type_table_entry_count(void) {
+    return type_table_entry_count;
+}
+
 static ScopeDecls **get_container_scope_ptr(TypeTableEntry *type_entry) {
     if (type_entry->id == TypeTableEntryIdStruct) {
         return &type_entry->data.structure.decls_scope;
@@ -196,6 +206,7 @@ bool type_is_complete(TypeTableEntry *type_entry) {
         case TypeTableEntryIdFloat:
         case TypeTableEntryIdPointer:
         case TypeTableEntryIdArray:
+        case TypeTableEntryIdVector:
         case TypeTableEntryIdNumLitFloat:
         case TypeTableEntryIdNumLitInt:
         case TypeTableEntryIdUndefLit:
@@ -233,6 +244,7 @@ bool type_has_zero_bits_known(TypeTableEntry *type_entry) {
         case TypeTableEntryIdFloat:
         case TypeTableEntryIdPointer:
         case TypeTableEntryIdArray:
+        case TypeTableEntryIdVector:
         case TypeTableEntryIdNumLitFloat:
         case TypeTableEntryIdNumLitInt:
         case TypeTableEntryIdUndefLit:
@@ -592,6 +604,53 @@ TypeTableEntry *get_array_type(CodeGen *g, TypeTableEntry *child_type, uint64_t
     return entry;
 }
 
+bool is_valid_vector_elem_type(TypeTableEntry *elem_type) {
+    switch (elem_type->id) {
+        case TypeTableEntryIdInt:
+            return elem_type->data.integral.bit_count != 0;
+        case TypeTableEntryIdFloat:
+        case TypeTableEntryIdBool:
+            return true;
+        default:
+            return false;
+    }
+}
+
+TypeTableEntry *get_vector_type(CodeGen *g, TypeTableEntry *elem_type, uint32_t len) {
+    assert(is_valid_vector_elem_type(elem_type));
+    assert(len != 0);
+
+    TypeId type_id = {};
+    type_id.id = TypeTableEntryIdVector;
+    type_id.data.array.child_type = elem_type;
+    type_id.data.array.size = len;
+    auto existing_entry = g->type_table.maybe_get(type_id);
+    if (existing_entry) {
+        TypeTableEntry *entry = existing_entry->value;
+        return entry;
+    }
+
+    TypeTableEntry *entry = new_type_table_entry(TypeTableEntryIdVector);
+    entry->is_copyable = true;
+
+    buf_resize(&entry->name, 0);
+    buf_appendf(&entry->name, "@Vector(%" PRIu32 ", %s)", len, buf_ptr(&elem_type->name));
+
+    entry->type_ref = LLVMVectorType(elem_type->type_ref, len);
+
+    uint64_t debug_size_in_bits = 8*LLVMStoreSizeOfType(g->target_data_ref, entry->type_ref);
+    uint64_t debug_align_in_bits = 8*LLVMABIAlignmentOfType(g->target_data_ref, entry->type_ref);
+
+    entry->di_type = ZigLLVMCreateDebugVectorType(g->dbuilder, debug_size_in_bits,
+            debug_align_in_bits, elem_type->di_type, (int)len);
+
+    entry->data.vector.elem_type = elem_type;
+    entry->data.vector.len = len;
+
+    g->type_table.put(type_id, entry);
+    return entry;
+}
+
 static void slice_type_common_init(CodeGen *g, TypeTableEntry *child_type,
         bool is_const, TypeTableEntry *entry)
 {
@@ -1114,6 +1173,7 @@ static TypeTableEntry *analyze_fn_type(CodeGen *g, AstNode *proto_node, Scope *c
             case TypeTableEntryIdFloat:
             case TypeTableEntryIdPointer:
             case TypeTableEntryIdArray:
+            case TypeTableEntryIdVector:
             case TypeTableEntryIdStruct:
             case TypeTableEntryIdMaybe:
             case TypeTableEntryIdErrorUnion:
@@ -1171,6 +1231,7 @@ static TypeTableEntry *analyze_fn_type(CodeGen *g, AstNode *proto_node, Scope *c
         case TypeTableEntryIdFloat:
         case TypeTableEntryIdPointer:
         case TypeTableEntryIdArray:
+        case TypeTableEntryIdVector:
         case TypeTableEntryIdStruct:
         case TypeTableEntryIdMaybe:
         case TypeTableEntryIdErrorUnion:
@@ -1419,6 +1480,7 @@ static bool type_allowed_in_packed_struct(TypeTableEntry *type_entry) {
         case TypeTableEntryIdBoundFn:
         case TypeTableEntryIdArgTuple:
         case TypeTableEntryIdOpaque:
+        case TypeTableEntryIdVector:
             return false;
         case TypeTableEntryIdVoid:
         case TypeTableEntryIdBool:
@@ -1962,10 +2024,14 @@ static void resolve_decl_fn(CodeGen *g, TldFn *tld_fn) {
         }
 
         if (!fn_table_entry->type_entry->data.fn.is_generic) {
-            g->fn_protos.append(fn_table_entry);
-
-            if (fn_def_node)
-                g->fn_defs.append(fn_table_entry);
+            if (fn_def_node) {
+                fn_table_entry->analysis_deferred = true;
+                g->fn_bodies_skipped_count += 1;
+                if (!g->lazy_analysis || fn_table_entry->linkage != GlobalLinkageIdInternal)
+                    queue_fn_analysis(g, fn_table_entry);
+            } else {
+                g->fn_protos.append(fn_table_entry);
+            }
 
             if (g->have_pub_main && scope_is_root_decls(tld_fn->base.parent_scope) &&
                 ((!g->is_test_build && import == g->root_import) ||
@@ -1973,6 +2039,7 @@ static void resolve_decl_fn(CodeGen *g, TldFn *tld_fn) {
             {
                 if (buf_eql_str(&fn_table_entry->symbol_name, "main")) {
                     g->main_fn = fn_table_entry;
+                    queue_fn_analysis(g, fn_table_entry);
 
                     if (g->libc_link_lib == nullptr && tld_fn->base.visib_mod != VisibModExport) {
                         TypeTableEntry *err_void = get_error_type(g, g->builtin_types.entry_void);
@@ -1985,10 +2052,12 @@ static void resolve_decl_fn(CodeGen *g, TldFn *tld_fn) {
                     }
                 } else if (buf_eql_str(&fn_table_entry->symbol_name, "panic")) {
                     typecheck_panic_fn(g, fn_table_entry);
+                    queue_fn_analysis(g, fn_table_entry);
                 }
             } else if (import->package == g->zigrt_package && scope_is_root_decls(tld_fn->base.parent_scope)) {
                 if (buf_eql_str(&fn_table_entry->symbol_name, "__zig_panic")) {
                     g->extern_panic_fn = fn_table_entry;
+                    queue_fn_analysis(g, fn_table_entry);
                 }
             }
         }
@@ -2104,7 +2173,7 @@ void init_tld(Tld *tld, TldId id, Buf *name, VisibMod visib_mod, AstNode *source
     Scope *parent_scope)
 {
     tld->id = id;
-    tld->name = name;
+    tld->name = buf_intern(name);
     tld->visib_mod = visib_mod;
     tld->source_node = source_node;
     tld->import = source_node ? source_node->owner : nullptr;
@@ -2272,6 +2341,7 @@ TypeTableEntry *validate_var_type(CodeGen *g, AstNode *source_node, TypeTableEnt
         case TypeTableEntryIdFloat:
         case TypeTableEntryIdPointer:
         case TypeTableEntryIdArray:
+        case TypeTableEntryIdVector:
         case TypeTableEntryIdStruct:
         case TypeTableEntryIdMaybe:
         case TypeTableEntryIdErrorUnion:
@@ -2302,7 +2372,7 @@ VariableTableEntry *add_variable(CodeGen *g, AstNode *source_node, Scope *parent
 
     assert(name);
 
-    buf_init_from_buf(&variable_entry->name, name);
+    variable_entry->name = buf_intern(name);
 
     if (value->type->id != TypeTableEntryIdInvalid) {
         VariableTableEntry *existing_var = find_variable(g, parent_scope, name);
@@ -2420,7 +2490,7 @@ static void resolve_decl_var(CodeGen *g, TldVar *tld_var) {
     TypeTableEntry *type = explicit_type ? explicit_type : implicit_type;
     assert(type != nullptr); // should have been caught by the parser
 
-    ConstExprValue *init_val = init_value ? &init_value->value : create_const_runtime(type);
+    ConstExprValue *init_val = init_value ? &init_value->value : create_const_runtime(g, type);
 
     tld_var->var = add_variable(g, source_node, tld_var->base.parent_scope, var_decl->symbol,
             is_const, init_val, &tld_var->base);
@@ -2599,7 +2669,7 @@ VariableTableEntry *find_variable(CodeGen *g, Scope *scope, Buf *name) {
     while (scope) {
         if (scope->id == ScopeIdVarDecl) {
             ScopeVarDecl *var_scope = (ScopeVarDecl *)scope;
-            if (buf_eql_buf(name, &var_scope->var->name))
+            if (buf_eql_buf(name, var_scope->var->name))
                 return var_scope->var;
         } else if (scope->id == ScopeIdDecls) {
             ScopeDecls *decls_scope = (ScopeDecls *)scope;
@@ -2695,6 +2765,7 @@ static bool is_container(TypeTableEntry *type_entry) {
         case TypeTableEntryIdInt:
         case TypeTableEntryIdFloat:
         case TypeTableEntryIdArray:
+        case TypeTableEntryIdVector:
         case TypeTableEntryIdNumLitFloat:
         case TypeTableEntryIdNumLitInt:
         case TypeTableEntryIdUndefLit:
@@ -2743,6 +2814,7 @@ void resolve_container_type(CodeGen *g, TypeTableEntry *type_entry) {
         case TypeTableEntryIdInt:
         case TypeTableEntryIdFloat:
         case TypeTableEntryIdArray:
+        case TypeTableEntryIdVector:
         case TypeTableEntryIdNumLitFloat:
         case TypeTableEntryIdNumLitInt:
         case TypeTableEntryIdUndefLit:
@@ -2805,7 +2877,7 @@ void define_local_param_variables(CodeGen *g, FnTableEntry *fn_table_entry, Vari
         }
 
         VariableTableEntry *var = add_variable(g, param_decl_node, fn_table_entry->child_scope,
-                param_name, true, create_const_runtime(param_type), nullptr);
+                param_name, true, create_const_runtime(g, param_type), nullptr);
         var->src_arg_index = i;
         fn_table_entry->child_scope = var->child_scope;
         var->shadowable = var->shadowable || is_var_args;
@@ -2869,7 +2941,10 @@ static void analyze_fn_body(CodeGen *g, FnTableEntry *fn_table_entry) {
     TypeTableEntry *fn_type = fn_table_entry->type_entry;
     assert(!fn_type->data.fn.is_generic);
 
+    size_t ir_gen_span = profile_begin(g, ProfileCategoryIrGen, &fn_table_entry->symbol_name,
+            fn_table_entry->body_node);
     ir_gen_fn(g, fn_table_entry);
+    profile_end(g, ir_gen_span);
     if (fn_table_entry->ir_executable.invalid) {
         fn_table_entry->anal_state = FnAnalStateInvalid;
         return;
@@ -2882,7 +2957,10 @@ static void analyze_fn_body(CodeGen *g, FnTableEntry *fn_table_entry) {
         fprintf(stderr, "}\n");
     }
 
+    size_t analyze_span = profile_begin(g, ProfileCategoryAnalyze, &fn_table_entry->symbol_name,
+            fn_table_entry->body_node);
     analyze_fn_ir(g, fn_table_entry, return_type_node);
+    profile_end(g, analyze_span);
 }
 
 static void add_symbols_from_import(CodeGen *g, AstNode *src_use_node, AstNode *dst_use_node) {
@@ -2961,6 +3039,50 @@ void preview_use_decl(CodeGen *g, AstNode *node) {
     node->data.use.value = result;
 }
 
+static ImportTableEntry *add_parsed_source_file(CodeGen *g, ImportTableEntry *import_entry) {
+    Buf *abs_full_path = import_entry->path;
+    unchanged_build_add_dependency(g, abs_full_path, import_entry->source_code);
+
+    Buf *src_dirname = buf_alloc();
+    Buf *src_basename = buf_alloc();
+    os_path_split(abs_full_path, src_dirname, src_basename);
+
+    import_entry->di_file = ZigLLVMCreateFile(g->dbuilder, buf_ptr(src_basename), buf_ptr(src_dirname));
+    g->import_table.put(abs_full_path, import_entry);
+    g->import_queue.append(import_entry);
+
+    import_entry->decls_scope = create_decls_scope(import_entry->root, nullptr, nullptr, import_entry);
+
+
+    assert(import_entry->root->type == NodeTypeRoot);
+    for (size_t decl_i = 0; decl_i < import_entry->root->data.root.top_level_decls.length; decl_i += 1) {
+        AstNode *top_level_decl = import_entry->root->data.root.top_level_decls.at(decl_i);
+
+        if (top_level_decl->type == NodeTypeFnDef) {
+            AstNode *proto_node = top_level_decl->data.fn_def.fn_proto;
+            assert(proto_node->type == NodeTypeFnProto);
+            Buf *proto_name = proto_node->data.fn_proto.name;
+
+            bool is_pub = (proto_node->data.fn_proto.visib_mod == VisibModPub);
+
+            if (is_pub) {
+                if (buf_eql_str(proto_name, "main")) {
+                    g->have_pub_main = true;
+                } else if (buf_eql_str(proto_name, "panic")) {
+                    g->have_pub_panic = true;
+                }
+            } else if (proto_node->data.fn_proto.visib_mod == VisibModExport && buf_eql_str(proto_name, "main") &&
+                    g->libc_link_lib != nullptr)
+            {
+                g->have_c_main = true;
+            }
+
+        }
+    }
+
+    return import_entry;
+}
+
 ImportTableEntry *add_source_file(CodeGen *g, PackageTableEntry *package, Buf *abs_full_path, Buf *source_code) {
     if (g->verbose) {
         fprintf(stderr, "\nOriginal Source (%s):\n", buf_ptr(abs_full_path));
@@ -2971,6 +3093,7 @@ ImportTableEntry *add_source_file(CodeGen *g, PackageTableEntry *package, Buf *a
         fprintf(stderr, "---------\n");
     }
 
+    size_t parse_span = profile_begin(g, ProfileCategoryParse, abs_full_path, nullptr);
     Tokenization tokenization = {0};
     tokenize(source_code, &tokenization);
 
@@ -2989,6 +3112,8 @@ ImportTableEntry *add_source_file(CodeGen *g, PackageTableEntry *package, Buf *a
         fprintf(stderr, "------\n");
     }
 
+    parse_scheduler_scan_imports(g, package, abs_full_path, source_code, tokenization.tokens);
+
     ImportTableEntry *import_entry = allocate<ImportTableEntry>(1);
     import_entry->package = package;
     import_entry->source_code = source_code;
@@ -2996,56 +3121,176 @@ ImportTableEntry *add_source_file(CodeGen *g, PackageTableEntry *package, Buf *a
     import_entry->path = abs_full_path;
 
     import_entry->root = ast_parse(source_code, tokenization.tokens, import_entry, g->err_color,
-            &g->next_node_index);
+            &g->next_node_index, &g->ast_arena);
     assert(import_entry->root);
+    profile_end(g, parse_span);
     if (g->verbose) {
         ast_print(stderr, import_entry->root, 0);
     }
 
-    Buf *src_dirname = buf_alloc();
-    Buf *src_basename = buf_alloc();
-    os_path_split(abs_full_path, src_dirname, src_basename);
+    return add_parsed_source_file(g, import_entry);
+}
 
-    import_entry->di_file = ZigLLVMCreateFile(g->dbuilder, buf_ptr(src_basename), buf_ptr(src_dirname));
-    g->import_table.put(abs_full_path, import_entry);
-    g->import_queue.append(import_entry);
+ImportTableEntry *add_prefetched_source_file(CodeGen *g, PackageTableEntry *package, Buf *abs_full_path) {
+    ImportTableEntry *import_entry = parse_scheduler_claim(g, package, abs_full_path);
+    if (import_entry == nullptr)
+        return nullptr;
+    return add_parsed_source_file(g, import_entry);
+}
 
-    import_entry->decls_scope = create_decls_scope(import_entry->root, nullptr, nullptr, import_entry);
 
+void scan_import(CodeGen *g, ImportTableEntry *import) {
+    if (!import->scanned) {
+        import->scanned = true;
+        scan_decls(g, import->decls_scope, import->root);
+    }
+}
 
-    assert(import_entry->root->type == NodeTypeRoot);
-    for (size_t decl_i = 0; decl_i < import_entry->root->data.root.top_level_decls.length; decl_i += 1) {
-        AstNode *top_level_decl = import_entry->root->data.root.top_level_decls.at(decl_i);
+void queue_fn_analysis(CodeGen *g, FnTableEntry *fn_entry) {
+    if (!fn_entry->analysis_deferred)
+        return;
+    fn_entry->analysis_deferred = false;
+    g->fn_bodies_skipped_count -= 1;
+    g->fn_protos.append(fn_entry);
+    g->fn_defs.append(fn_entry);
+}
 
-        if (top_level_decl->type == NodeTypeFnDef) {
-            AstNode *proto_node = top_level_decl->data.fn_def.fn_proto;
-            assert(proto_node->type == NodeTypeFnProto);
-            Buf *proto_name = proto_node->data.fn_proto.name;
+static bool type_may_reference_fn(TypeTableEntry *type_entry) {
+    switch (type_entry->id) {
+        case TypeTableEntryIdInvalid:
+        case TypeTableEntryIdVar:
+        case TypeTableEntryIdMetaType:
+        case TypeTableEntryIdVoid:
+        case TypeTableEntryIdBool:
+        case TypeTableEntryIdUnreachable:
+        case TypeTableEntryIdInt:
+        case TypeTableEntryIdFloat:
+        case TypeTableEntryIdNumLitFloat:
+        case TypeTableEntryIdNumLitInt:
+        case TypeTableEntryIdUndefLit:
+        case TypeTableEntryIdNullLit:
+        case TypeTableEntryIdPureError:
+        case TypeTableEntryIdEnumTag:
+        case TypeTableEntryIdNamespace:
+        case TypeTableEntryIdBlock:
+        case TypeTableEntryIdArgTuple:
+        case TypeTableEntryIdOpaque:
+        case TypeTableEntryIdVector:
+            return false;
+        case TypeTableEntryIdFn:
+        case TypeTableEntryIdBoundFn:
+        case TypeTableEntryIdPointer:
+        case TypeTableEntryIdStruct:
+        case TypeTableEntryIdEnum:
+        case TypeTableEntryIdUnion:
+            return true;
+        case TypeTableEntryIdArray:
+            return type_may_reference_fn(type_entry->data.array.child_type);
+        case TypeTableEntryIdMaybe:
+            return type_may_reference_fn(type_entry->data.maybe.child_type);
+        case TypeTableEntryIdErrorUnion:
+            return type_may_reference_fn(type_entry->data.error.child_type);
+    }
+    zig_unreachable();
+}
 
-            bool is_pub = (proto_node->data.fn_proto.visib_mod == VisibModPub);
+void queue_fns_referenced_by_value(CodeGen *g, ConstExprValue *const_val) {
+    if (const_val == nullptr || const_val->special != ConstValSpecialStatic)
+        return;
+    TypeTableEntry *type_entry = const_val->type;
+    if (type_entry == nullptr || !type_may_reference_fn(type_entry))
+        return;
 
-            if (is_pub) {
-                if (buf_eql_str(proto_name, "main")) {
-                    g->have_pub_main = true;
-                } else if (buf_eql_str(proto_name, "panic")) {
-                    g->have_pub_panic = true;
-                }
-            } else if (proto_node->data.fn_proto.visib_mod == VisibModExport && buf_eql_str(proto_name, "main") &&
-                    g->libc_link_lib != nullptr)
-            {
-                g->have_c_main = true;
-            }
+    // values are shared between instructions and can point at each other
+    bool is_new;
+    g->lazy_visited_values.get_or_insert(const_val, &is_new);
+    if (!is_new)
+        return;
 
-        }
+    switch (type_entry->id) {
+        case TypeTableEntryIdFn:
+            queue_fn_analysis(g, const_val->data.x_fn.fn_entry);
+            return;
+        case TypeTableEntryIdBoundFn:
+            queue_fn_analysis(g, const_val->data.x_bound_fn.fn);
+            return;
+        case TypeTableEntryIdPointer:
+            switch (const_val->data.x_ptr.special) {
+                case ConstPtrSpecialRef:
+                    queue_fns_referenced_by_value(g, const_val->data.x_ptr.data.ref.pointee);
+                    return;
+                case ConstPtrSpecialBaseArray:
+                    queue_fns_referenced_by_value(g, const_val->data.x_ptr.data.base_array.array_val);
+                    return;
+                case ConstPtrSpecialBaseStruct:
+                    queue_fns_referenced_by_value(g, const_val->data.x_ptr.data.base_struct.struct_val);
+                    return;
+                case ConstPtrSpecialInvalid:
+                case ConstPtrSpecialHardCodedAddr:
+                case ConstPtrSpecialDiscard:
+                    return;
+            }
+            zig_unreachable();
+        case TypeTableEntryIdArray:
+            if (const_val->data.x_array.special != ConstArraySpecialNone)
+                return;
+            for (uint64_t i = 0; i < type_entry->data.array.len; i += 1) {
+                queue_fns_referenced_by_value(g, &const_val->data.x_array.s_none.elements[i]);
+            }
+            return;
+        case TypeTableEntryIdStruct:
+            for (size_t i = 0; i < type_entry->data.structure.src_field_count; i += 1) {
+                queue_fns_referenced_by_value(g, &const_val->data.x_struct.fields[i]);
+            }
+            return;
+        case TypeTableEntryIdMaybe:
+            queue_fns_referenced_by_value(g, const_val->data.x_maybe);
+            return;
+        case TypeTableEntryIdErrorUnion:
+            queue_fns_referenced_by_value(g, const_val->data.x_err_union.payload);
+            return;
+        case TypeTableEntryIdEnum:
+            queue_fns_referenced_by_value(g, const_val->data.x_enum.payload);
+            return;
+        case TypeTableEntryIdUnion:
+            // container initialization rejects unions, so there is no
+            // compile time union value to walk yet
+            zig_panic("TODO");
+        case TypeTableEntryIdInvalid:
+        case TypeTableEntryIdVar:
+        case TypeTableEntryIdMetaType:
+        case TypeTableEntryIdVoid:
+        case TypeTableEntryIdBool:
+        case TypeTableEntryIdUnreachable:
+        case TypeTableEntryIdInt:
+        case TypeTableEntryIdFloat:
+        case TypeTableEntryIdNumLitFloat:
+        case TypeTableEntryIdNumLitInt:
+        case TypeTableEntryIdUndefLit:
+        case TypeTableEntryIdNullLit:
+        case TypeTableEntryIdPureError:
+        case TypeTableEntryIdEnumTag:
+        case TypeTableEntryIdNamespace:
+        case TypeTableEntryIdBlock:
+        case TypeTableEntryIdArgTuple:
+        case TypeTableEntryIdOpaque:
+        case TypeTableEntryIdVector:
+            zig_unreachable();
     }
-
-    return import_entry;
+    zig_unreachable();
 }
 
-void scan_import(CodeGen *g, ImportTableEntry *import) {
-    if (!import->scanned) {
-        import->scanned = true;
-        scan_decls(g, import->decls_scope, import->root);
+// Queues the bodies of functions referred to by the function bodies and global
+// variables that were analyzed since the last call.
+static void queue_referenced_fns(CodeGen *g) {
+    for (; g->lazy_fn_defs_index < g->fn_defs_index; g->lazy_fn_defs_index += 1) {
+        FnTableEntry *fn_entry = g->fn_defs.at(g->lazy_fn_defs_index);
+        if (fn_entry->anal_state == FnAnalStateComplete)
+            ir_queue_referenced_fns(g, &fn_entry->analyzed_executable);
+    }
+    for (; g->lazy_global_vars_index < g->global_vars.length; g->lazy_global_vars_index += 1) {
+        TldVar *tld_var = g->global_vars.at(g->lazy_global_vars_index);
+        queue_fns_referenced_by_value(g, tld_var->var->value);
     }
 }
 
@@ -3078,6 +3323,9 @@ void semantic_analyze(CodeGen *g) {
             FnTableEntry *fn_entry = g->fn_defs.at(g->fn_defs_index);
             analyze_fn_body(g, fn_entry);
         }
+
+        if (g->lazy_analysis)
+            queue_referenced_fns(g);
     }
 }
 
@@ -3147,6 +3395,7 @@ bool handle_is_ptr(TypeTableEntry *type_entry) {
         case TypeTableEntryIdInt:
         case TypeTableEntryIdFloat:
         case TypeTableEntryIdPointer:
+        case TypeTableEntryIdVector:
         case TypeTableEntryIdPureError:
         case TypeTableEntryIdFn:
         case TypeTableEntryIdEnumTag:
@@ -3200,6 +3449,14 @@ bool fn_table_entry_eql(FnTableEntry *a, FnTableEntry *b) {
     return ptr_eq(a, b);
 }
 
+uint32_t const_val_ptr_hash(ConstExprValue *value) {
+    return ptr_hash(value);
+}
+
+bool const_val_ptr_eql(ConstExprValue *a, ConstExprValue *b) {
+    return ptr_eq(a, b);
+}
+
 uint32_t fn_type_id_hash(FnTypeId *id) {
     uint32_t result = 0;
     result += ((uint32_t)(id->cc)) * (uint32_t)3349388391;
@@ -3234,6 +3491,24 @@ bool fn_type_id_eql(FnTypeId *a, FnTypeId *b) {
     return true;
 }
 
+static uint32_t hash_const_val(ConstExprValue *const_val);
+
+static uint32_t hash_digits(const uint64_t *digits, size_t digit_count, bool is_negative) {
+    uint32_t result = is_negative ? (uint32_t)2405416353 : (uint32_t)1331471175;
+    for (size_t i = 0; i < digit_count; i += 1) {
+        result = result * (uint32_t)2654435761 + (uint32_t)digits[i];
+        result = result * (uint32_t)2654435761 + (uint32_t)(digits[i] >> 32);
+    }
+    return result;
+}
+
+// fields and elements of a comptime known aggregate may be undefined
+static uint32_t hash_const_val_elem(ConstExprValue *const_val) {
+    if (const_val->special == ConstValSpecialUndef)
+        return (uint32_t)3078237171;
+    return hash_const_val(const_val);
+}
+
 static uint32_t hash_const_val(ConstExprValue *const_val) {
     assert(const_val->special == ConstValSpecialStatic);
     switch (const_val->type->id) {
@@ -3248,14 +3523,8 @@ static uint32_t hash_const_val(ConstExprValue *const_val) {
         case TypeTableEntryIdInt:
         case TypeTableEntryIdNumLitInt:
         case TypeTableEntryIdEnumTag:
-            {
-                uint32_t result = 1331471175;
-                for (size_t i = 0; i < const_val->data.x_bigint.digit_count; i += 1) {
-                    uint64_t digit = bigint_ptr(&const_val->data.x_bigint)[i];
-                    result ^= ((uint32_t)(digit >> 32)) ^ (uint32_t)(result);
-                }
-                return result;
-            }
+            return hash_digits(bigint_ptr(&const_val->data.x_bigint), const_val->data.x_bigint.digit_count,
+                    const_val->data.x_bigint.is_negative);
         case TypeTableEntryIdFloat:
         case TypeTableEntryIdNumLitFloat:
             return (uint32_t)(const_val->data.x_bigfloat.value * (uint32_t)UINT32_MAX);
@@ -3309,11 +3578,51 @@ static uint32_t hash_const_val(ConstExprValue *const_val) {
         case TypeTableEntryIdNullLit:
             return 844854567;
         case TypeTableEntryIdArray:
-            // TODO better hashing algorithm
-            return 1166190605;
+            {
+                uint32_t result = 1166190605;
+                switch (const_val->data.x_array.special) {
+                    case ConstArraySpecialUndef:
+                        return result;
+                    case ConstArraySpecialBuf:
+                        {
+                            // must agree with hashing the expanded u8 elements
+                            Buf *buf = const_val->data.x_array.s_buf;
+                            for (size_t i = 0; i < buf_len(buf); i += 1) {
+                                uint64_t byte = (uint8_t)buf_ptr(buf)[i];
+                                result = result * (uint32_t)2246822519 + hash_digits(&byte, (byte == 0) ? 0 : 1, false);
+                            }
+                            return result;
+                        }
+                    case ConstArraySpecialNone:
+                        {
+                            uint64_t len = const_val->type->data.array.len;
+                            for (uint64_t i = 0; i < len; i += 1) {
+                                ConstExprValue *elem_val = &const_val->data.x_array.s_none.elements[i];
+                                result = result * (uint32_t)2246822519 + hash_const_val_elem(elem_val);
+                            }
+                            return result;
+                        }
+                }
+                zig_unreachable();
+            }
+        case TypeTableEntryIdVector:
+            {
+                uint32_t result = 2354190398;
+                for (uint32_t i = 0; i < const_val->type->data.vector.len; i += 1) {
+                    ConstExprValue *elem_val = &const_val->data.x_array.s_none.elements[i];
+                    result = result * (uint32_t)2246822519 + hash_const_val_elem(elem_val);
+                }
+                return result;
+            }
         case TypeTableEntryIdStruct:
-            // TODO better hashing algorithm
-            return 1532530855;
+            {
+                uint32_t result = 1532530855;
+                for (size_t i = 0; i < const_val->type->data.structure.src_field_count; i += 1) {
+                    ConstExprValue *field_val = &const_val->data.x_struct.fields[i];
+                    result = result * (uint32_t)3266489917 + hash_const_val_elem(field_val);
+                }
+                return result;
+            }
         case TypeTableEntryIdUnion:
             // TODO better hashing algorithm
             return 2709806591;
@@ -3324,14 +3633,22 @@ static uint32_t hash_const_val(ConstExprValue *const_val) {
                 return 4016830364;
             }
         case TypeTableEntryIdErrorUnion:
-            // TODO better hashing algorithm
-            return 3415065496;
+            if (const_val->data.x_err_union.err) {
+                return (uint32_t)3415065496 ^ hash_ptr(const_val->data.x_err_union.err);
+            } else if (const_val->data.x_err_union.payload) {
+                return hash_const_val_elem(const_val->data.x_err_union.payload) * (uint32_t)668265263;
+            } else {
+                return 3415065496;
+            }
         case TypeTableEntryIdPureError:
-            // TODO better hashing algorithm
-            return 2630160122;
+            return (uint32_t)2630160122 ^ hash_ptr(const_val->data.x_pure_err);
         case TypeTableEntryIdEnum:
-            // TODO better hashing algorithm
-            return 31643936;
+            {
+                uint32_t result = (uint32_t)31643936 + hash_size(const_val->data.x_enum.tag);
+                if (const_val->data.x_enum.payload)
+                    result = result * (uint32_t)374761393 + hash_const_val_elem(const_val->data.x_enum.payload);
+                return result;
+            }
         case TypeTableEntryIdFn:
             return 4133894920 ^ hash_ptr(const_val->data.x_fn.fn_entry);
         case TypeTableEntryIdNamespace:
@@ -3347,6 +3664,14 @@ static uint32_t hash_const_val(ConstExprValue *const_val) {
     zig_unreachable();
 }
 
+uint32_t const_val_content_hash(ConstExprValue *value) {
+    return hash_ptr(value->type) + hash_const_val(value);
+}
+
+bool const_val_content_eql(ConstExprValue *a, ConstExprValue *b) {
+    return a->type == b->type && const_values_equal(a, b);
+}
+
 uint32_t generic_fn_type_id_hash(GenericFnTypeId *id) {
     uint32_t result = 0;
     result += hash_ptr(id->fn_entry);
@@ -3453,6 +3778,7 @@ bool type_requires_comptime(TypeTableEntry *type_entry) {
         case TypeTableEntryIdArgTuple:
             return true;
         case TypeTableEntryIdArray:
+        case TypeTableEntryIdVector:
         case TypeTableEntryIdStruct:
         case TypeTableEntryIdUnion:
         case TypeTableEntryIdMaybe:
@@ -3472,21 +3798,19 @@ bool type_requires_comptime(TypeTableEntry *type_entry) {
     zig_unreachable();
 }
 
-void init_const_str_lit(CodeGen *g, ConstExprValue *const_val, Buf *str) {
+void init_const_str_lit_shared(CodeGen *g, ConstExprValue *const_val, Buf *str) {
     const_val->special = ConstValSpecialStatic;
     const_val->type = get_array_type(g, g->builtin_types.entry_u8, buf_len(str));
-    const_val->data.x_array.s_none.elements = create_const_vals(buf_len(str));
+    const_val->data.x_array.special = ConstArraySpecialBuf;
+    const_val->data.x_array.s_buf = str;
+}
 
-    for (size_t i = 0; i < buf_len(str); i += 1) {
-        ConstExprValue *this_char = &const_val->data.x_array.s_none.elements[i];
-        this_char->special = ConstValSpecialStatic;
-        this_char->type = g->builtin_types.entry_u8;
-        bigint_init_unsigned(&this_char->data.x_bigint, (uint8_t)buf_ptr(str)[i]);
-    }
+void init_const_str_lit(CodeGen *g, ConstExprValue *const_val, Buf *str) {
+    init_const_str_lit_shared(g, const_val, buf_create_from_buf(str));
 }
 
 ConstExprValue *create_const_str_lit(CodeGen *g, Buf *str) {
-    ConstExprValue *const_val = create_const_vals(1);
+    ConstExprValue *const_val = create_const_vals(g, 1);
     init_const_str_lit(g, const_val, str);
     return const_val;
 }
@@ -3494,20 +3818,13 @@ ConstExprValue *create_const_str_lit(CodeGen *g, Buf *str) {
 void init_const_c_str_lit(CodeGen *g, ConstExprValue *const_val, Buf *str) {
     // first we build the underlying array
     size_t len_with_null = buf_len(str) + 1;
-    ConstExprValue *array_val = create_const_vals(1);
+    Buf *buf_with_null = buf_create_from_buf(str);
+    buf_append_char(buf_with_null, 0);
+    ConstExprValue *array_val = create_const_vals(g, 1);
     array_val->special = ConstValSpecialStatic;
     array_val->type = get_array_type(g, g->builtin_types.entry_u8, len_with_null);
-    array_val->data.x_array.s_none.elements = create_const_vals(len_with_null);
-    for (size_t i = 0; i < buf_len(str); i += 1) {
-        ConstExprValue *this_char = &array_val->data.x_array.s_none.elements[i];
-        this_char->special = ConstValSpecialStatic;
-        this_char->type = g->builtin_types.entry_u8;
-        bigint_init_unsigned(&this_char->data.x_bigint, (uint8_t)buf_ptr(str)[i]);
-    }
-    ConstExprValue *null_char = &array_val->data.x_array.s_none.elements[len_with_null - 1];
-    null_char->special = ConstValSpecialStatic;
-    null_char->type = g->builtin_types.entry_u8;
-    bigint_init_unsigned(&null_char->data.x_bigint, 0);
+    array_val->data.x_array.special = ConstArraySpecialBuf;
+    array_val->data.x_array.s_buf = buf_with_null;
 
     // then make the pointer point to it
     const_val->special = ConstValSpecialStatic;
@@ -3518,7 +3835,7 @@ void init_const_c_str_lit(CodeGen *g, ConstExprValue *const_val, Buf *str) {
     const_val->data.x_ptr.data.base_array.is_cstr = true;
 }
 ConstExprValue *create_const_c_str_lit(CodeGen *g, Buf *str) {
-    ConstExprValue *const_val = create_const_vals(1);
+    ConstExprValue *const_val = create_const_vals(g, 1);
     init_const_c_str_lit(g, const_val, str);
     return const_val;
 }
@@ -3530,8 +3847,8 @@ void init_const_unsigned_negative(ConstExprValue *const_val, TypeTableEntry *typ
     const_val->data.x_bigint.is_negative = negative;
 }
 
-ConstExprValue *create_const_unsigned_negative(TypeTableEntry *type, uint64_t x, bool negative) {
-    ConstExprValue *const_val = create_const_vals(1);
+ConstExprValue *create_const_unsigned_negative(CodeGen *g, TypeTableEntry *type, uint64_t x, bool negative) {
+    ConstExprValue *const_val = create_const_vals(g, 1);
     init_const_unsigned_negative(const_val, type, x, negative);
     return const_val;
 }
@@ -3541,7 +3858,7 @@ void init_const_usize(CodeGen *g, ConstExprValue *const_val, uint64_t x) {
 }
 
 ConstExprValue *create_const_usize(CodeGen *g, uint64_t x) {
-    return create_const_unsigned_negative(g->builtin_types.entry_usize, x, false);
+    return create_const_unsigned_negative(g, g->builtin_types.entry_usize, x, false);
 }
 
 void init_const_signed(ConstExprValue *const_val, TypeTableEntry *type, int64_t x) {
@@ -3550,8 +3867,8 @@ void init_const_signed(ConstExprValue *const_val, TypeTableEntry *type, int64_t
     bigint_init_signed(&const_val->data.x_bigint, x);
 }
 
-ConstExprValue *create_const_signed(TypeTableEntry *type, int64_t x) {
-    ConstExprValue *const_val = create_const_vals(1);
+ConstExprValue *create_const_signed(CodeGen *g, TypeTableEntry *type, int64_t x) {
+    ConstExprValue *const_val = create_const_vals(g, 1);
     init_const_signed(const_val, type, x);
     return const_val;
 }
@@ -3562,8 +3879,8 @@ void init_const_float(ConstExprValue *const_val, TypeTableEntry *type, double va
     bigfloat_init_float(&const_val->data.x_bigfloat, value);
 }
 
-ConstExprValue *create_const_float(TypeTableEntry *type, double value) {
-    ConstExprValue *const_val = create_const_vals(1);
+ConstExprValue *create_const_float(CodeGen *g, TypeTableEntry *type, double value) {
+    ConstExprValue *const_val = create_const_vals(g, 1);
     init_const_float(const_val, type, value);
     return const_val;
 }
@@ -3574,8 +3891,8 @@ void init_const_enum_tag(ConstExprValue *const_val, TypeTableEntry *type, uint64
     const_val->data.x_enum.tag = tag;
 }
 
-ConstExprValue *create_const_enum_tag(TypeTableEntry *type, uint64_t tag) {
-    ConstExprValue *const_val = create_const_vals(1);
+ConstExprValue *create_const_enum_tag(CodeGen *g, TypeTableEntry *type, uint64_t tag) {
+    ConstExprValue *const_val = create_const_vals(g, 1);
     init_const_enum_tag(const_val, type, tag);
     return const_val;
 }
@@ -3587,7 +3904,7 @@ void init_const_bool(CodeGen *g, ConstExprValue *const_val, bool value) {
 }
 
 ConstExprValue *create_const_bool(CodeGen *g, bool value) {
-    ConstExprValue *const_val = create_const_vals(1);
+    ConstExprValue *const_val = create_const_vals(g, 1);
     init_const_bool(g, const_val, value);
     return const_val;
 }
@@ -3597,8 +3914,8 @@ void init_const_runtime(ConstExprValue *const_val, TypeTableEntry *type) {
     const_val->type = type;
 }
 
-ConstExprValue *create_const_runtime(TypeTableEntry *type) {
-    ConstExprValue *const_val = create_const_vals(1);
+ConstExprValue *create_const_runtime(CodeGen *g, TypeTableEntry *type) {
+    ConstExprValue *const_val = create_const_vals(g, 1);
     init_const_runtime(const_val, type);
     return const_val;
 }
@@ -3610,7 +3927,7 @@ void init_const_type(CodeGen *g, ConstExprValue *const_val, TypeTableEntry *type
 }
 
 ConstExprValue *create_const_type(CodeGen *g, TypeTableEntry *type_value) {
-    ConstExprValue *const_val = create_const_vals(1);
+    ConstExprValue *const_val = create_const_vals(g, 1);
     init_const_type(g, const_val, type_value);
     return const_val;
 }
@@ -3622,14 +3939,14 @@ void init_const_slice(CodeGen *g, ConstExprValue *const_val, ConstExprValue *arr
 
     const_val->special = ConstValSpecialStatic;
     const_val->type = get_slice_type(g, array_val->type->data.array.child_type, is_const);
-    const_val->data.x_struct.fields = create_const_vals(2);
+    const_val->data.x_struct.fields = create_const_vals(g, 2);
 
     init_const_ptr_array(g, &const_val->data.x_struct.fields[slice_ptr_index], array_val, start, is_const);
     init_const_usize(g, &const_val->data.x_struct.fields[slice_len_index], len);
 }
 
 ConstExprValue *create_const_slice(CodeGen *g, ConstExprValue *array_val, size_t start, size_t len, bool is_const) {
-    ConstExprValue *const_val = create_const_vals(1);
+    ConstExprValue *const_val = create_const_vals(g, 1);
     init_const_slice(g, const_val, array_val, start, len, is_const);
     return const_val;
 }
@@ -3648,7 +3965,7 @@ void init_const_ptr_array(CodeGen *g, ConstExprValue *const_val, ConstExprValue
 }
 
 ConstExprValue *create_const_ptr_array(CodeGen *g, ConstExprValue *array_val, size_t elem_index, bool is_const) {
-    ConstExprValue *const_val = create_const_vals(1);
+    ConstExprValue *const_val = create_const_vals(g, 1);
     init_const_ptr_array(g, const_val, array_val, elem_index, is_const);
     return const_val;
 }
@@ -3661,7 +3978,7 @@ void init_const_ptr_ref(CodeGen *g, ConstExprValue *const_val, ConstExprValue *p
 }
 
 ConstExprValue *create_const_ptr_ref(CodeGen *g, ConstExprValue *pointee_val, bool is_const) {
-    ConstExprValue *const_val = create_const_vals(1);
+    ConstExprValue *const_val = create_const_vals(g, 1);
     init_const_ptr_ref(g, const_val, pointee_val, is_const);
     return const_val;
 }
@@ -3678,7 +3995,7 @@ void init_const_ptr_hard_coded_addr(CodeGen *g, ConstExprValue *const_val, TypeT
 ConstExprValue *create_const_ptr_hard_coded_addr(CodeGen *g, TypeTableEntry *pointee_type,
         size_t addr, bool is_const)
 {
-    ConstExprValue *const_val = create_const_vals(1);
+    ConstExprValue *const_val = create_const_vals(g, 1);
     init_const_ptr_hard_coded_addr(g, const_val, pointee_type, addr, is_const);
     return const_val;
 }
@@ -3691,7 +4008,7 @@ void init_const_arg_tuple(CodeGen *g, ConstExprValue *const_val, size_t arg_inde
 }
 
 ConstExprValue *create_const_arg_tuple(CodeGen *g, size_t arg_index_start, size_t arg_index_end) {
-    ConstExprValue *const_val = create_const_vals(1);
+    ConstExprValue *const_val = create_const_vals(g, 1);
     init_const_arg_tuple(g, const_val, arg_index_start, arg_index_end);
     return const_val;
 }
@@ -3707,7 +4024,7 @@ void init_const_undefined(CodeGen *g, ConstExprValue *const_val) {
 
         const_val->special = ConstValSpecialStatic;
         size_t field_count = wanted_type->data.structure.src_field_count;
-        const_val->data.x_struct.fields = create_const_vals(field_count);
+        const_val->data.x_struct.fields = create_const_vals(g, field_count);
         for (size_t i = 0; i < field_count; i += 1) {
             ConstExprValue *field_val = &const_val->data.x_struct.fields[i];
             field_val->type = wanted_type->data.structure.fields[i].type_entry;
@@ -3725,9 +4042,10 @@ void init_const_undefined(CodeGen *g, ConstExprValue *const_val) {
     }
 }
 
-ConstExprValue *create_const_vals(size_t count) {
-    ConstGlobalRefs *global_refs = allocate<ConstGlobalRefs>(count);
-    ConstExprValue *vals = allocate<ConstExprValue>(count);
+ConstExprValue *create_const_vals(CodeGen *g, size_t count) {
+    g->const_val_count += count;
+    ConstGlobalRefs *global_refs = arena_allocate<ConstGlobalRefs>(&g->const_arena, count);
+    ConstExprValue *vals = arena_allocate<ConstExprValue>(&g->const_arena, count);
     for (size_t i = 0; i < count; i += 1) {
         vals[i].global_refs = &global_refs[i];
     }
@@ -3765,6 +4083,27 @@ bool ir_get_var_is_comptime(VariableTableEntry *var) {
     return var->is_comptime->value.data.x_bool;
 }
 
+static bool const_values_equal_elem(ConstExprValue *a, ConstExprValue *b) {
+    if (a->special != b->special)
+        return false;
+    if (a->special == ConstValSpecialUndef)
+        return true;
+    return const_values_equal(a, b);
+}
+
+static bool const_array_equal_buf(ConstExprValue *array_val, Buf *buf) {
+    for (size_t i = 0; i < buf_len(buf); i += 1) {
+        ConstExprValue *elem_val = &array_val->data.x_array.s_none.elements[i];
+        if (elem_val->special != ConstValSpecialStatic)
+            return false;
+        BigInt byte;
+        bigint_init_unsigned(&byte, (uint8_t)buf_ptr(buf)[i]);
+        if (bigint_cmp(&elem_val->data.x_bigint, &byte) != CmpEQ)
+            return false;
+    }
+    return true;
+}
+
 bool const_values_equal(ConstExprValue *a, ConstExprValue *b) {
     assert(a->type->id == b->type->id);
     assert(a->special == ConstValSpecialStatic);
@@ -3779,7 +4118,7 @@ bool const_values_equal(ConstExprValue *a, ConstExprValue *b) {
                 if (enum1->tag == enum2->tag) {
                     TypeEnumField *enum_field = &a->type->data.enumeration.fields[enum1->tag];
                     if (type_has_bits(enum_field->type_entry)) {
-                        zig_panic("TODO const expr analyze enum special value for equality");
+                        return const_values_equal_elem(enum1->payload, enum2->payload);
                     } else {
                         return true;
                     }
@@ -3846,21 +4185,44 @@ bool const_values_equal(ConstExprValue *a, ConstExprValue *b) {
             }
             zig_unreachable();
         case TypeTableEntryIdArray:
-            zig_panic("TODO");
+            {
+                ConstArrayValue *array_a = &a->data.x_array;
+                ConstArrayValue *array_b = &b->data.x_array;
+                if (array_a->special == ConstArraySpecialUndef || array_b->special == ConstArraySpecialUndef)
+                    return array_a->special == array_b->special;
+                if (array_a->special == ConstArraySpecialBuf && array_b->special == ConstArraySpecialBuf)
+                    return buf_eql_buf(array_a->s_buf, array_b->s_buf);
+                if (array_a->special == ConstArraySpecialBuf)
+                    return const_array_equal_buf(b, array_a->s_buf);
+                if (array_b->special == ConstArraySpecialBuf)
+                    return const_array_equal_buf(a, array_b->s_buf);
+                uint64_t len = a->type->data.array.len;
+                assert(len == b->type->data.array.len);
+                for (uint64_t i = 0; i < len; i += 1) {
+                    if (!const_values_equal_elem(&array_a->s_none.elements[i], &array_b->s_none.elements[i]))
+                        return false;
+                }
+                return true;
+            }
+        case TypeTableEntryIdVector:
+            for (uint32_t i = 0; i < a->type->data.vector.len; i += 1) {
+                if (!const_values_equal_elem(&a->data.x_array.s_none.elements[i], &b->data.x_array.s_none.elements[i]))
+                    return false;
+            }
+            return true;
         case TypeTableEntryIdStruct:
             for (size_t i = 0; i < a->type->data.structure.src_field_count; i += 1) {
                 ConstExprValue *field_a = &a->data.x_struct.fields[i];
                 ConstExprValue *field_b = &b->data.x_struct.fields[i];
-                if (!const_values_equal(field_a, field_b))
+                if (!const_values_equal_elem(field_a, field_b))
                     return false;
             }
             return true;
         case TypeTableEntryIdUnion:
             zig_panic("TODO");
         case TypeTableEntryIdUndefLit:
-            zig_panic("TODO");
         case TypeTableEntryIdNullLit:
-            zig_panic("TODO");
+            return true;
         case TypeTableEntryIdMaybe:
             if (a->data.x_maybe == nullptr || b->data.x_maybe == nullptr) {
                 return (a->data.x_maybe == nullptr && b->data.x_maybe == nullptr);
@@ -3868,7 +4230,11 @@ bool const_values_equal(ConstExprValue *a, ConstExprValue *b) {
                 return const_values_equal(a->data.x_maybe, b->data.x_maybe);
             }
         case TypeTableEntryIdErrorUnion:
-            zig_panic("TODO");
+            if (a->data.x_err_union.err || b->data.x_err_union.err)
+                return a->data.x_err_union.err == b->data.x_err_union.err;
+            if (a->data.x_err_union.payload == nullptr || b->data.x_err_union.payload == nullptr)
+                return a->data.x_err_union.payload == b->data.x_err_union.payload;
+            return const_values_equal_elem(a->data.x_err_union.payload, b->data.x_err_union.payload);
         case TypeTableEntryIdNamespace:
             return a->data.x_import == b->data.x_import;
         case TypeTableEntryIdBlock:
@@ -4033,6 +4399,21 @@ void render_const_value(CodeGen *g, Buf *buf, ConstExprValue *const_val) {
                     return;
                 }
 
+                if (const_val->data.x_array.special == ConstArraySpecialBuf) {
+                    Buf *array_buf = const_val->data.x_array.s_buf;
+                    buf_append_char(buf, '"');
+                    for (size_t i = 0; i < buf_len(array_buf); i += 1) {
+                        uint8_t c = (uint8_t)buf_ptr(array_buf)[i];
+                        if (c == '"') {
+                            buf_append_str(buf, "\\\"");
+                        } else {
+                            buf_append_char(buf, c);
+                        }
+                    }
+                    buf_append_char(buf, '"');
+                    return;
+                }
+
                 // if it's []u8, assume UTF-8 and output a string
                 if (child_type->id == TypeTableEntryIdInt &&
                     child_type->data.integral.bit_count == 8 &&
@@ -4064,6 +4445,18 @@ void render_const_value(CodeGen *g, Buf *buf, ConstExprValue *const_val) {
                 buf_appendf(buf, "}");
                 return;
             }
+        case TypeTableEntryIdVector:
+            {
+                buf_appendf(buf, "%s{", buf_ptr(&type_entry->name));
+                for (uint32_t i = 0; i < type_entry->data.vector.len; i += 1) {
+                    if (i != 0)
+                        buf_appendf(buf, ",");
+                    ConstExprValue *child_value = &const_val->data.x_array.s_none.elements[i];
+                    render_const_value(g, buf, child_value);
+                }
+                buf_appendf(buf, "}");
+                return;
+            }
         case TypeTableEntryIdNullLit:
             {
                 buf_appendf(buf, "null");
@@ -4206,6 +4599,7 @@ uint32_t type_id_hash(TypeId x) {
                 (((uint32_t)x.data.pointer.bit_offset) * (uint32_t)2639019452) +
                 (((uint32_t)x.data.pointer.unaligned_bit_count) * (uint32_t)529908881);
         case TypeTableEntryIdArray:
+        case TypeTableEntryIdVector:
             return hash_ptr(x.data.array.child_type) +
                 ((uint32_t)x.data.array.size * (uint32_t)2122979968);
         case TypeTableEntryIdInt:
@@ -4251,6 +4645,7 @@ bool type_id_eql(TypeId a, TypeId b) {
                 a.data.pointer.bit_offset == b.data.pointer.bit_offset &&
                 a.data.pointer.unaligned_bit_count == b.data.pointer.unaligned_bit_count;
         case TypeTableEntryIdArray:
+        case TypeTableEntryIdVector:
             return a.data.array.child_type == b.data.array.child_type &&
                 a.data.array.size == b.data.array.size;
         case TypeTableEntryIdInt:
@@ -4267,9 +4662,11 @@ uint32_t zig_llvm_fn_key_hash(ZigLLVMFnKey x) {
         case ZigLLVMFnIdClz:
             return (uint32_t)(x.data.clz.bit_count) * (uint32_t)2428952817;
         case ZigLLVMFnIdFloor:
-            return (uint32_t)(x.data.floor_ceil.bit_count) * (uint32_t)1899859168;
+            return (uint32_t)(x.data.floor_ceil.bit_count) * (uint32_t)1899859168 +
+                (uint32_t)(x.data.floor_ceil.vector_len) * (uint32_t)2614437379;
         case ZigLLVMFnIdCeil:
-            return (uint32_t)(x.data.floor_ceil.bit_count) * (uint32_t)1953839089;
+            return (uint32_t)(x.data.floor_ceil.bit_count) * (uint32_t)1953839089 +
+                (uint32_t)(x.data.floor_ceil.vector_len) * (uint32_t)3357813011;
         case ZigLLVMFnIdOverflowArithmetic:
             return ((uint32_t)(x.data.overflow_arithmetic.bit_count) * 87135777) +
                 ((uint32_t)(x.data.overflow_arithmetic.add_sub_mul) * 31640542) +
@@ -4288,7 +4685,8 @@ bool zig_llvm_fn_key_eql(ZigLLVMFnKey a, ZigLLVMFnKey b) {
             return a.data.clz.bit_count == b.data.clz.bit_count;
         case ZigLLVMFnIdFloor:
         case ZigLLVMFnIdCeil:
-            return a.data.floor_ceil.bit_count == b.data.floor_ceil.bit_count;
+            return a.data.floor_ceil.bit_count == b.data.floor_ceil.bit_count &&
+                a.data.floor_ceil.vector_len == b.data.floor_ceil.vector_len;
         case ZigLLVMFnIdOverflowArithmetic:
             return (a.data.overflow_arithmetic.bit_count == b.data.overflow_arithmetic.bit_count) &&
                 (a.data.overflow_arithmetic.add_sub_mul == b.data.overflow_arithmetic.add_sub_mul) &&
@@ -4299,29 +4697,53 @@ bool zig_llvm_fn_key_eql(ZigLLVMFnKey a, ZigLLVMFnKey b) {
 
 void expand_undef_array(CodeGen *g, ConstExprValue *const_val) {
     assert(const_val->type->id == TypeTableEntryIdArray);
-    if (const_val->data.x_array.special == ConstArraySpecialUndef) {
-        const_val->data.x_array.special = ConstArraySpecialNone;
-        size_t elem_count = const_val->type->data.array.len;
-        const_val->data.x_array.s_none.elements = create_const_vals(elem_count);
-        for (size_t i = 0; i < elem_count; i += 1) {
-            ConstExprValue *element_val = &const_val->data.x_array.s_none.elements[i];
-            element_val->type = const_val->type->data.array.child_type;
-            init_const_undefined(g, element_val);
-            ConstParent *parent = get_const_val_parent(g, element_val);
-            if (parent != nullptr) {
-                parent->id = ConstParentIdArray;
-                parent->data.p_array.array_val = const_val;
-                parent->data.p_array.elem_index = i;
+    switch (const_val->data.x_array.special) {
+        case ConstArraySpecialNone:
+            return;
+        case ConstArraySpecialUndef:
+            {
+                const_val->data.x_array.special = ConstArraySpecialNone;
+                size_t elem_count = const_val->type->data.array.len;
+                const_val->data.x_array.s_none.elements = create_const_vals(g, elem_count);
+                for (size_t i = 0; i < elem_count; i += 1) {
+                    ConstExprValue *element_val = &const_val->data.x_array.s_none.elements[i];
+                    element_val->type = const_val->type->data.array.child_type;
+                    init_const_undefined(g, element_val);
+                    ConstParent *parent = get_const_val_parent(g, element_val);
+                    if (parent != nullptr) {
+                        parent->id = ConstParentIdArray;
+                        parent->data.p_array.array_val = const_val;
+                        parent->data.p_array.elem_index = i;
+                    }
+                }
+                return;
+            }
+        case ConstArraySpecialBuf:
+            {
+                Buf *buf = const_val->data.x_array.s_buf;
+                assert(buf_len(buf) == const_val->type->data.array.len);
+                const_val->data.x_array.special = ConstArraySpecialNone;
+                const_val->data.x_array.s_buf = nullptr;
+                const_val->data.x_array.s_none.elements = create_const_vals(g, buf_len(buf));
+                for (size_t i = 0; i < buf_len(buf); i += 1) {
+                    ConstExprValue *this_char = &const_val->data.x_array.s_none.elements[i];
+                    this_char->special = ConstValSpecialStatic;
+                    this_char->type = g->builtin_types.entry_u8;
+                    bigint_init_unsigned(&this_char->data.x_bigint, (uint8_t)buf_ptr(buf)[i]);
+                }
+                return;
             }
-        }
     }
+    zig_unreachable();
 }
 
 ConstParent *get_const_val_parent(CodeGen *g, ConstExprValue *value) {
     assert(value->type);
     TypeTableEntry *type_entry = value->type;
     if (type_entry->id == TypeTableEntryIdArray) {
-        expand_undef_array(g, value);
+        // the parent of a packed byte array is tracked without expanding it
+        if (value->data.x_array.special != ConstArraySpecialBuf)
+            expand_undef_array(g, value);
         return &value->data.x_array.s_none.parent;
     } else if (type_entry->id == TypeTableEntryIdStruct) {
         return &value->data.x_struct.parent;
@@ -4386,6 +4808,7 @@ static const TypeTableEntryId all_type_ids[] = {
     TypeTableEntryIdBoundFn,
     TypeTableEntryIdArgTuple,
     TypeTableEntryIdOpaque,
+    TypeTableEntryIdVector,
 };
 
 TypeTableEntryId type_id_at_index(size_t index) {
@@ -4452,6 +4875,8 @@ size_t type_id_index(TypeTableEntryId id) {
             return 23;
         case TypeTableEntryIdOpaque:
             return 24;
+        case TypeTableEntryIdVector:
+            return 25;
     }
     zig_unreachable();
 }
@@ -4511,6 +4936,8 @@ const char *type_id_name(TypeTableEntryId id) {
             return "ArgTuple";
         case TypeTableEntryIdOpaque:
             return "Opaque";
+        case TypeTableEntryIdVector:
+            return "Vector";
     }
     zig_unreachable();
 }
@@ -14,6 +14,7 @@ void semantic_analyze(CodeGen *g);
 ErrorMsg *add_node_error(CodeGen *g, AstNode *node, Buf *msg);
 ErrorMsg *add_error_note(CodeGen *g, ErrorMsg *parent_msg, AstNode *node, Buf *msg);
 TypeTableEntry *new_type_table_entry(TypeTableEntryId id);
+size_t get_type_table_entry_count(void);
 TypeTableEntry *get_pointer_to_type(CodeGen *g, TypeTableEntry *child_type, bool is_const);
 TypeTableEntry *get_pointer_to_type_extra(CodeGen *g, TypeTableEntry *child_type, bool is_const,
         bool is_volatile, uint32_t bit_offset, uint32_t unaligned_bit_count);
@@ -26,6 +27,8 @@ TypeTableEntry *get_c_int_type(CodeGen *g, CIntType c_int_type);
 TypeTableEntry *get_fn_type(CodeGen *g, FnTypeId *fn_type_id);
 TypeTableEntry *get_maybe_type(CodeGen *g, TypeTableEntry *child_type);
 TypeTableEntry *get_array_type(CodeGen *g, TypeTableEntry *child_type, uint64_t array_size);
+TypeTableEntry *get_vector_type(CodeGen *g, TypeTableEntry *elem_type, uint32_t len);
+bool is_valid_vector_elem_type(TypeTableEntry *elem_type);
 TypeTableEntry *get_slice_type(CodeGen *g, TypeTableEntry *child_type, bool is_const);
 TypeTableEntry *get_partial_container_type(CodeGen *g, Scope *scope, ContainerKind kind,
         AstNode *decl_node, const char *name, ContainerLayout layout);
@@ -44,6 +47,7 @@ bool type_has_bits(TypeTableEntry *type_entry);
 
 
 ImportTableEntry *add_source_file(CodeGen *g, PackageTableEntry *package, Buf *abs_full_path, Buf *source_code);
+ImportTableEntry *add_prefetched_source_file(CodeGen *g, PackageTableEntry *package, Buf *abs_full_path);
 
 
 // TODO move these over, these used to be static
@@ -101,25 +105,27 @@ ScopeDecls *create_decls_scope(AstNode *node, Scope *parent, TypeTableEntry *con
 Scope *create_comptime_scope(AstNode *node, Scope *parent);
 
 void init_const_str_lit(CodeGen *g, ConstExprValue *const_val, Buf *str);
+// Keeps str rather than a copy of it, so str must never be modified afterwards.
+void init_const_str_lit_shared(CodeGen *g, ConstExprValue *const_val, Buf *str);
 ConstExprValue *create_const_str_lit(CodeGen *g, Buf *str);
 
 void init_const_c_str_lit(CodeGen *g, ConstExprValue *const_val, Buf *c_str);
 ConstExprValue *create_const_c_str_lit(CodeGen *g, Buf *c_str);
 
 void init_const_unsigned_negative(ConstExprValue *const_val, TypeTableEntry *type, uint64_t x, bool negative);
-ConstExprValue *create_const_unsigned_negative(TypeTableEntry *type, uint64_t x, bool negative);
+ConstExprValue *create_const_unsigned_negative(CodeGen *g, TypeTableEntry *type, uint64_t x, bool negative);
 
 void init_const_signed(ConstExprValue *const_val, TypeTableEntry *type, int64_t x);
-ConstExprValue *create_const_signed(TypeTableEntry *type, int64_t x);
+ConstExprValue *create_const_signed(CodeGen *g, TypeTableEntry *type, int64_t x);
 
 void init_const_usize(CodeGen *g, ConstExprValue *const_val, uint64_t x);
 ConstExprValue *create_const_usize(CodeGen *g, uint64_t x);
 
 void init_const_float(ConstExprValue *const_val, TypeTableEntry *type, double value);
-ConstExprValue *create_const_float(TypeTableEntry *type, double value);
+ConstExprValue *create_const_float(CodeGen *g, TypeTableEntry *type, double value);
 
 void init_const_enum_tag(ConstExprValue *const_val, TypeTableEntry *type, uint64_t tag);
-ConstExprValue *create_const_enum_tag(TypeTableEntry *type, uint64_t tag);
+ConstExprValue *create_const_enum_tag(CodeGen *g, TypeTableEntry *type, uint64_t tag);
 
 void init_const_bool(CodeGen *g, ConstExprValue *const_val, bool value);
 ConstExprValue *create_const_bool(CodeGen *g, bool value);
@@ -128,7 +134,7 @@ void init_const_type(CodeGen *g, ConstExprValue *const_val, TypeTableEntry *type
 ConstExprValue *create_const_type(CodeGen *g, TypeTableEntry *type_value);
 
 void init_const_runtime(ConstExprValue *const_val, TypeTableEntry *type);
-ConstExprValue *create_const_runtime(TypeTableEntry *type);
+ConstExprValue *create_const_runtime(CodeGen *g, TypeTableEntry *type);
 
 void init_const_ptr_ref(CodeGen *g, ConstExprValue *const_val, ConstExprValue *pointee_val, bool is_const);
 ConstExprValue *create_const_ptr_ref(CodeGen *g, ConstExprValue *pointee_val, bool is_const);
@@ -151,11 +157,13 @@ ConstExprValue *create_const_arg_tuple(CodeGen *g, size_t arg_index_start, size_
 
 void init_const_undefined(CodeGen *g, ConstExprValue *const_val);
 
-ConstExprValue *create_const_vals(size_t count);
+ConstExprValue *create_const_vals(CodeGen *g, size_t count);
 
 TypeTableEntry *make_int_type(CodeGen *g, bool is_signed, uint32_t size_in_bits);
 ConstParent *get_const_val_parent(CodeGen *g, ConstExprValue *value);
 FnTableEntry *get_extern_panic_fn(CodeGen *g);
+void queue_fn_analysis(CodeGen *g, FnTableEntry *fn_entry);
+void queue_fns_referenced_by_value(CodeGen *g, ConstExprValue *const_val);
 TypeTableEntry *create_enum_tag_type(CodeGen *g, TypeTableEntry *enum_type, TypeTableEntry *int_type);
 void expand_undef_array(CodeGen *g, ConstExprValue *const_val);
 void update_compile_var(CodeGen *g, Buf *name, ConstExprValue *value);
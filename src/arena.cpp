@@ -0,0 +1,86 @@
+/*
+ * Copyright (c) 2017 Andrew Kelley
+ *
+ * This file is part of zig, which is MIT licensed.
+ * See http://opensource.org/licenses/MIT
+ */
+
+#include "arena.hpp"
+#include "os.hpp"
+
+static const size_t default_chunk_size = 64 * 1024;
+
+void arena_init(Arena *arena, const char *name) {
+    *arena = {};
+    arena->name = name;
+}
+
+void arena_deinit(Arena *arena) {
+    ArenaChunk *chunk = arena->chunk;
+    while (chunk != nullptr) {
+        ArenaChunk *prev = chunk->prev;
+        free(chunk);
+        chunk = prev;
+    }
+    arena_init(arena, arena->name);
+}
+
+void *arena_alloc_slow(Arena *arena, size_t size, size_t align) {
+    // Big allocations get a chunk of their own so that we do not throw away
+    // the rest of the current chunk.
+    size_t chunk_size = max(default_chunk_size, size + align);
+    ArenaChunk *chunk = reinterpret_cast<ArenaChunk*>(calloc(1, sizeof(ArenaChunk) + chunk_size));
+    if (!chunk)
+        zig_panic("allocation failed");
+    chunk->size = chunk_size;
+    arena->chunk_count += 1;
+    arena->bytes_reserved += chunk_size;
+
+    uint8_t *chunk_mem = reinterpret_cast<uint8_t*>(chunk + 1);
+    uintptr_t addr = ((uintptr_t)chunk_mem + align - 1) & ~((uintptr_t)align - 1);
+    uint8_t *chunk_end = chunk_mem + chunk_size;
+
+    size_t cur_remaining = (arena->cur == nullptr) ? 0 : (size_t)(arena->end - arena->cur);
+    size_t new_remaining = (size_t)(chunk_end - (uint8_t *)(addr + size));
+    if (arena->chunk == nullptr || new_remaining >= cur_remaining) {
+        chunk->prev = arena->chunk;
+        arena->chunk = chunk;
+        arena->cur = (uint8_t *)(addr + size);
+        arena->end = chunk_end;
+    } else {
+        // keep bumping in the current chunk, which has more room left
+        chunk->prev = arena->chunk->prev;
+        arena->chunk->prev = chunk;
+    }
+
+    arena->alloc_count += 1;
+    arena->bytes_used += size;
+    return (void *)addr;
+}
+
+void arena_take(Arena *arena, Arena *other) {
+    if (other->chunk == nullptr)
+        return;
+    if (arena->chunk == nullptr) {
+        arena->chunk = other->chunk;
+        arena->cur = other->cur;
+        arena->end = other->end;
+    } else {
+        // keep bumping in our current chunk; other's chunks go right behind it
+        ArenaChunk *oldest = other->chunk;
+        while (oldest->prev != nullptr)
+            oldest = oldest->prev;
+        oldest->prev = arena->chunk->prev;
+        arena->chunk->prev = other->chunk;
+    }
+    arena->alloc_count += other->alloc_count;
+    arena->bytes_used += other->bytes_used;
+    arena->bytes_reserved += other->bytes_reserved;
+    arena->chunk_count += other->chunk_count;
+    arena_init(other, other->name);
+}
+
+void arena_print_stats(Arena *arena, FILE *f) {
+    fprintf(f, "%20s%14" ZIG_PRI_usize "%14" ZIG_PRI_usize "%16" ZIG_PRI_usize "%10" ZIG_PRI_usize "\n",
+            arena->name ? arena->name : "(arena)", arena->alloc_count, arena->bytes_used, arena->bytes_reserved, arena->chunk_count);
+}
@@ -0,0 +1,62 @@
+/*
+ * Copyright (c) 2017 Andrew Kelley
+ *
+ * This file is part of zig, which is MIT licensed.
+ * See http://opensource.org/licenses/MIT
+ */
+
+#ifndef ZIG_ARENA_HPP
+#define ZIG_ARENA_HPP
+
+#include "util.hpp"
+
+#include <stdint.h>
+#include <stdio.h>
+
+struct ArenaChunk {
+    ArenaChunk *prev;
+    size_t size;
+};
+
+// A bump pointer allocator. Individual allocations are never freed; all the
+// memory goes away at once with arena_deinit. A zero initialized Arena is
+// ready to use.
+struct Arena {
+    const char *name;
+    ArenaChunk *chunk;
+    uint8_t *cur;
+    uint8_t *end;
+
+    size_t alloc_count;
+    size_t bytes_used;
+    size_t bytes_reserved;
+    size_t chunk_count;
+};
+
+void arena_init(Arena *arena, const char *name);
+void arena_deinit(Arena *arena);
+void *arena_alloc_slow(Arena *arena, size_t size, size_t align);
+void arena_print_stats(Arena *arena, FILE *f);
+// Moves the allocations of other into arena, leaving other empty.
+void arena_take(Arena *arena, Arena *other);
+
+// The returned memory is zeroed.
+static inline void *arena_alloc_bytes(Arena *arena, size_t size, size_t align) {
+    assert(is_power_of_2(align));
+    uintptr_t addr = ((uintptr_t)arena->cur + align - 1) & ~((uintptr_t)align - 1);
+    if (arena->cur == nullptr || addr + size > (uintptr_t)arena->end)
+        return arena_alloc_slow(arena, size, align);
+    arena->cur = (uint8_t *)(addr + size);
+    arena->alloc_count += 1;
+    arena->bytes_used += size;
+    return (void *)addr;
+}
+
+// Drop-in replacement for allocate<T> for objects which live as long as the arena.
+template<typename T>
+__attribute__((malloc)) static inline T *arena_allocate(Arena *arena, size_t count) {
+    assert(count <= SIZE_MAX / sizeof(T));
+    return reinterpret_cast<T*>(arena_alloc_bytes(arena, count * sizeof(T), alignof(T)));
+}
+
+#endif
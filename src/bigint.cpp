@@ -58,13 +58,33 @@ static void to_twos_complement(BigInt *dest, const BigInt *op, size_t bit_count)
         BigInt negated = {0};
         bigint_negate(&negated, op);
 
-        BigInt inverted = {0};
-        bigint_not(&inverted, &negated, bit_count, false);
+        BigInt magnitude = {0};
+        to_twos_complement(&magnitude, &negated, bit_count);
 
-        BigInt one = {0};
-        bigint_init_unsigned(&one, 1);
+        // invert and add one digit by digit within bit_count bits, dropping the
+        // carry out of the top bit so that -2^n becomes 0 rather than 2^n
+        size_t digit_count = (bit_count + 63) / 64;
+        uint64_t *digits = allocate_nonzero<uint64_t>(digit_count);
+        const uint64_t *magnitude_digits = bigint_ptr(&magnitude);
+        uint64_t carry = 1;
+        for (size_t i = 0; i < digit_count; i += 1) {
+            uint64_t digit = (i < magnitude.digit_count) ? magnitude_digits[i] : 0;
+            digits[i] = ~digit + carry;
+            carry = (carry == 1 && digits[i] == 0) ? 1 : 0;
+        }
+        size_t leftover_bits = bit_count % 64;
+        if (leftover_bits != 0) {
+            digits[digit_count - 1] &= (1ULL << leftover_bits) - 1;
+        }
 
-        bigint_add(dest, &inverted, &one);
+        dest->is_negative = false;
+        dest->digit_count = digit_count;
+        if (digit_count == 1) {
+            dest->data.digit = digits[0];
+        } else {
+            dest->data.digits = digits;
+        }
+        bigint_normalize(dest);
         return;
     }
 
@@ -82,6 +102,15 @@ static void to_twos_complement(BigInt *dest, const BigInt *op, size_t bit_count)
     size_t digits_to_copy = bit_count / 64;
     size_t leftover_bits = bit_count % 64;
     dest->digit_count = digits_to_copy + ((leftover_bits == 0) ? 0 : 1);
+    if (dest->digit_count == 1) {
+        uint64_t digit = op_digits[0];
+        if (leftover_bits != 0) {
+            digit &= (1ULL << leftover_bits) - 1;
+        }
+        dest->data.digit = digit;
+        bigint_normalize(dest);
+        return;
+    }
     dest->data.digits = allocate_nonzero<uint64_t>(dest->digit_count);
     for (size_t i = 0; i < digits_to_copy; i += 1) {
         uint64_t digit = (i < op->digit_count) ? op_digits[i] : 0;
@@ -95,7 +124,9 @@ static void to_twos_complement(BigInt *dest, const BigInt *op, size_t bit_count)
 }
 
 static bool bit_at_index(const BigInt *bi, size_t index) {
-    size_t digit_index = bi->digit_count - (index / 64) - 1;
+    size_t digit_index = index / 64;
+    if (digit_index >= bi->digit_count)
+        return false;
     size_t digit_bit_index = index % 64;
     const uint64_t *digits = bigint_ptr(bi);
     uint64_t digit = digits[digit_index];
@@ -181,6 +212,19 @@ bool bigint_fits_in_bits(const BigInt *bn, size_t bit_count, bool is_signed) {
         return true;
     }
 
+    if (bn->digit_count == 1) {
+        uint64_t digit = bn->data.digit;
+        if (!is_signed) {
+            // the general path below counts no leading zeros for negative numbers
+            size_t bits_needed = bn->is_negative ? 64 : (64 - __builtin_clzll(digit));
+            return bit_count >= bits_needed;
+        }
+        if (bit_count > 64)
+            return true;
+        uint64_t max_magnitude = 1ULL << (bit_count - 1);
+        return bn->is_negative ? (digit <= max_magnitude) : (digit < max_magnitude);
+    }
+
     if (!is_signed) {
         size_t full_bits = bn->digit_count * 64;
         size_t leading_zero_count = bigint_clz(bn, full_bits);
@@ -355,7 +399,68 @@ static bool mul_u64_overflow(uint64_t op1, uint64_t op2, uint64_t *result) {
             (unsigned long long *)result);
 }
 
+// Nearly all constant folding is done on numbers of at most one digit. The
+// functions below handle those directly instead of going through the general
+// multi-digit code, which builds temporary BigInts.
+
+static inline bool bigint_is_small(const BigInt *op) {
+    return op->digit_count <= 1;
+}
+
+static inline uint64_t small_magnitude(const BigInt *op) {
+    return (op->digit_count == 0) ? 0 : op->data.digit;
+}
+
+// the low 64 bits of the two's complement representation
+static inline uint64_t small_twos_complement(const BigInt *op) {
+    uint64_t magnitude = small_magnitude(op);
+    return op->is_negative ? (0 - magnitude) : magnitude;
+}
+
+static void init_small(BigInt *dest, uint64_t magnitude, bool is_negative) {
+    bigint_init_unsigned(dest, magnitude);
+    dest->is_negative = is_negative && magnitude != 0;
+}
+
+// Sets dest to the low bit_count bits of a two's complement number.
+static void init_small_twos_complement(BigInt *dest, uint64_t bits, size_t bit_count, bool is_signed) {
+    assert(bit_count <= 64);
+    if (bit_count == 0) {
+        bigint_init_unsigned(dest, 0);
+        return;
+    }
+    if (bit_count < 64) {
+        bits &= (1ULL << bit_count) - 1;
+    }
+    if (is_signed && ((bits >> (bit_count - 1)) & 0x1) != 0) {
+        uint64_t magnitude = (bit_count == 64) ? (0 - bits) : ((1ULL << bit_count) - bits);
+        init_small(dest, magnitude, true);
+    } else {
+        init_small(dest, bits, false);
+    }
+}
+
+// Returns false if the sum does not fit in one digit.
+static bool add_small(BigInt *dest, uint64_t op1, bool op1_negative, uint64_t op2, bool op2_negative) {
+    if (op1_negative == op2_negative) {
+        uint64_t sum;
+        if (add_u64_overflow(op1, op2, &sum))
+            return false;
+        init_small(dest, sum, op1_negative);
+    } else if (op1 >= op2) {
+        init_small(dest, op1 - op2, op1_negative);
+    } else {
+        init_small(dest, op2 - op1, op2_negative);
+    }
+    return true;
+}
+
 void bigint_add(BigInt *dest, const BigInt *op1, const BigInt *op2) {
+    if (bigint_is_small(op1) && bigint_is_small(op2) &&
+        add_small(dest, small_magnitude(op1), op1->is_negative, small_magnitude(op2), op2->is_negative))
+    {
+        return;
+    }
     if (op1->digit_count == 0) {
         return bigint_init_bigint(dest, op2);
     }
@@ -373,39 +478,29 @@ void bigint_add(BigInt *dest, const BigInt *op1, const BigInt *op2) {
             bigint_normalize(dest);
             return;
         }
-        // TODO this code path is untested
-        size_t i = 1;
+        size_t digit_count = max(op1->digit_count, op2->digit_count);
         uint64_t first_digit = dest->data.digit;
-        dest->data.digits = allocate_nonzero<uint64_t>(max(op1->digit_count, op2->digit_count) + 1);
+        dest->data.digits = allocate_nonzero<uint64_t>(digit_count + 1);
         dest->data.digits[0] = first_digit;
 
-        for (;;) {
-            bool found_digit = false;
+        for (size_t i = 1; i < digit_count; i += 1) {
             uint64_t x = overflow;
             overflow = 0;
 
             if (i < op1->digit_count) {
-                found_digit = true;
                 uint64_t digit = op1_digits[i];
                 overflow += add_u64_overflow(x, digit, &x);
             }
 
             if (i < op2->digit_count) {
-                found_digit = true;
                 uint64_t digit = op2_digits[i];
                 overflow += add_u64_overflow(x, digit, &x);
             }
 
             dest->data.digits[i] = x;
-            x += 1;
-
-            if (!found_digit) {
-                break;
-            }
-        }
-        if (overflow > 0) {
-            dest->data.digits[i] = overflow;
         }
+        dest->data.digits[digit_count] = overflow;
+        dest->digit_count = digit_count + 1;
         bigint_normalize(dest);
         return;
     }
@@ -449,47 +544,54 @@ void bigint_add(BigInt *dest, const BigInt *op1, const BigInt *op2) {
     uint64_t first_digit = dest->data.digit;
     dest->data.digits = allocate_nonzero<uint64_t>(bigger_op->digit_count);
     dest->data.digits[0] = first_digit;
-    size_t i = 1;
 
-    for (;;) {
-        bool found_digit = false;
+    for (size_t i = 1; i < bigger_op->digit_count; i += 1) {
         uint64_t x = bigger_op_digits[i];
         uint64_t prev_overflow = overflow;
         overflow = 0;
 
         if (i < smaller_op->digit_count) {
-            found_digit = true;
             uint64_t digit = smaller_op_digits[i];
             overflow += sub_u64_overflow(x, digit, &x);
         }
         if (sub_u64_overflow(x, prev_overflow, &x)) {
-            found_digit = true;
             overflow += 1;
         }
         dest->data.digits[i] = x;
-        i += 1;
-
-        if (!found_digit)
-            break;
     }
     assert(overflow == 0);
-    dest->digit_count = i;
+    dest->digit_count = bigger_op->digit_count;
     bigint_normalize(dest);
 }
 
 void bigint_add_wrap(BigInt *dest, const BigInt *op1, const BigInt *op2, size_t bit_count, bool is_signed) {
+    if (bigint_is_small(op1) && bigint_is_small(op2) && bit_count <= 64) {
+        init_small_twos_complement(dest, small_twos_complement(op1) + small_twos_complement(op2),
+                bit_count, is_signed);
+        return;
+    }
     BigInt unwrapped = {0};
     bigint_add(&unwrapped, op1, op2);
     bigint_truncate(dest, &unwrapped, bit_count, is_signed);
 }
 
 void bigint_sub(BigInt *dest, const BigInt *op1, const BigInt *op2) {
+    if (bigint_is_small(op1) && bigint_is_small(op2) &&
+        add_small(dest, small_magnitude(op1), op1->is_negative, small_magnitude(op2), !op2->is_negative))
+    {
+        return;
+    }
     BigInt op2_negated = {0};
     bigint_negate(&op2_negated, op2);
     return bigint_add(dest, op1, &op2_negated);
 }
 
 void bigint_sub_wrap(BigInt *dest, const BigInt *op1, const BigInt *op2, size_t bit_count, bool is_signed) {
+    if (bigint_is_small(op1) && bigint_is_small(op2) && bit_count <= 64) {
+        init_small_twos_complement(dest, small_twos_complement(op1) - small_twos_complement(op2),
+                bit_count, is_signed);
+        return;
+    }
     BigInt op2_negated = {0};
     bigint_negate(&op2_negated, op2);
     return bigint_add_wrap(dest, op1, &op2_negated, bit_count, is_signed);
@@ -512,6 +614,13 @@ void bigint_mul(BigInt *dest, const BigInt *op1, const BigInt *op2) {
     if (op1->digit_count == 0 || op2->digit_count == 0) {
         return bigint_init_unsigned(dest, 0);
     }
+    uint64_t product;
+    if (op1->digit_count == 1 && op2->digit_count == 1 &&
+        !mul_u64_overflow(op1->data.digit, op2->data.digit, &product))
+    {
+        init_small(dest, product, op1->is_negative != op2->is_negative);
+        return;
+    }
     const uint64_t *op1_digits = bigint_ptr(op1);
     const uint64_t *op2_digits = bigint_ptr(op2);
 
@@ -527,6 +636,12 @@ void bigint_mul(BigInt *dest, const BigInt *op1, const BigInt *op2) {
 }
 
 void bigint_mul_wrap(BigInt *dest, const BigInt *op1, const BigInt *op2, size_t bit_count, bool is_signed) {
+    if (bigint_is_small(op1) && bigint_is_small(op2) && bit_count <= 64) {
+        // the low 64 bits of the product only depend on the low 64 bits of the operands
+        init_small_twos_complement(dest, small_twos_complement(op1) * small_twos_complement(op2),
+                bit_count, is_signed);
+        return;
+    }
     BigInt unwrapped = {0};
     bigint_mul(&unwrapped, op1, op2);
     bigint_truncate(dest, &unwrapped, bit_count, is_signed);
@@ -768,13 +883,12 @@ void bigint_shl(BigInt *dest, const BigInt *op1, const BigInt *op2) {
     const uint64_t *op1_digits = bigint_ptr(op1);
     uint64_t shift_amt = bigint_as_unsigned(op2);
 
-    if (op1->digit_count == 1) {
-        dest->data.digit = op1_digits[0] << shift_amt;
-        if (dest->data.digit > op1_digits[0]) {
-            dest->digit_count = 1;
-            dest->is_negative = op1->is_negative;
-            return;
-        }
+    if (op1->digit_count == 1 && shift_amt < 64 && (uint64_t)__builtin_clzll(op1_digits[0]) >= shift_amt) {
+        uint64_t digit = op1_digits[0];
+        dest->data.digit = digit << shift_amt;
+        dest->digit_count = 1;
+        dest->is_negative = op1->is_negative;
+        return;
     }
 
     uint64_t digit_shift_count = shift_amt / 64;
@@ -800,6 +914,12 @@ void bigint_shl(BigInt *dest, const BigInt *op1, const BigInt *op2) {
 }
 
 void bigint_shl_wrap(BigInt *dest, const BigInt *op1, const BigInt *op2, size_t bit_count, bool is_signed) {
+    if (bigint_is_small(op1) && bigint_is_small(op2) && !op2->is_negative && bit_count <= 64) {
+        uint64_t shift_amt = small_magnitude(op2);
+        uint64_t bits = (shift_amt >= 64) ? 0 : (small_twos_complement(op1) << shift_amt);
+        init_small_twos_complement(dest, bits, bit_count, is_signed);
+        return;
+    }
     BigInt unwrapped = {0};
     bigint_shl(&unwrapped, op1, op2);
     bigint_truncate(dest, &unwrapped, bit_count, is_signed);
@@ -873,6 +993,11 @@ void bigint_not(BigInt *dest, const BigInt *op, size_t bit_count, bool is_signed
         return;
     }
 
+    if (is_signed && bigint_is_small(op) && bit_count <= 64) {
+        init_small_twos_complement(dest, ~small_twos_complement(op), bit_count, true);
+        return;
+    }
+
     if (is_signed) {
         BigInt twos_comp = {0};
         to_twos_complement(&twos_comp, op, bit_count);
@@ -906,8 +1031,7 @@ void bigint_not(BigInt *dest, const BigInt *op, size_t bit_count, bool is_signed
         bigint_normalize(dest);
         return;
     }
-    // TODO this code path is untested
-    dest->digit_count = bit_count / 64;
+    dest->digit_count = (bit_count + 63) / 64;
     assert(dest->digit_count >= op->digit_count);
     dest->data.digits = allocate_nonzero<uint64_t>(dest->digit_count);
     size_t i = 0;
@@ -917,22 +1041,30 @@ void bigint_not(BigInt *dest, const BigInt *op, size_t bit_count, bool is_signed
     for (; i < dest->digit_count; i += 1) {
         dest->data.digits[i] = 0xffffffffffffffffULL;
     }
-    size_t digit_index = dest->digit_count - (bit_count / 64) - 1;
-    size_t digit_bit_index = bit_count % 64;
-    if (digit_index < dest->digit_count) {
-        uint64_t mask = (1ULL << digit_bit_index) - 1;
-        dest->data.digits[digit_index] &= mask;
+    size_t leftover_bits = bit_count % 64;
+    if (leftover_bits != 0) {
+        dest->data.digits[dest->digit_count - 1] &= (1ULL << leftover_bits) - 1;
     }
     bigint_normalize(dest);
 }
 
 void bigint_truncate(BigInt *dest, const BigInt *op, size_t bit_count, bool is_signed) {
+    if (bigint_is_small(op) && bit_count <= 64) {
+        init_small_twos_complement(dest, small_twos_complement(op), bit_count, is_signed);
+        return;
+    }
     BigInt twos_comp;
     to_twos_complement(&twos_comp, op, bit_count);
     from_twos_complement(dest, &twos_comp, bit_count, is_signed);
 }
 
 Cmp bigint_cmp(const BigInt *op1, const BigInt *op2) {
+    if (op1->digit_count == 1 && op2->digit_count == 1 && op1->is_negative == op2->is_negative) {
+        if (op1->data.digit == op2->data.digit)
+            return CmpEQ;
+        bool op1_is_bigger = (op1->data.digit > op2->data.digit);
+        return (op1_is_bigger != op1->is_negative) ? CmpGT : CmpLT;
+    }
     if (op1->is_negative && !op2->is_negative) {
         return CmpLT;
     } else if (!op1->is_negative && op2->is_negative) {
@@ -1019,6 +1151,13 @@ size_t bigint_ctz(const BigInt *bi, size_t bit_count) {
         return 0;
     if (bi->digit_count == 0)
         return bit_count;
+    if (bi->digit_count == 1 && bit_count <= 64) {
+        uint64_t bits = small_twos_complement(bi);
+        if (bit_count < 64) {
+            bits &= (1ULL << bit_count) - 1;
+        }
+        return (bits == 0) ? bit_count : __builtin_ctzll(bits);
+    }
 
     BigInt twos_comp = {0};
     to_twos_complement(&twos_comp, bi, bit_count);
@@ -1037,6 +1176,13 @@ size_t bigint_clz(const BigInt *bi, size_t bit_count) {
         return 0;
     if (bi->digit_count == 0)
         return bit_count;
+    if (bi->digit_count == 1 && bit_count <= 64) {
+        uint64_t bits = bi->data.digit;
+        if (bit_count < 64) {
+            bits &= (1ULL << bit_count) - 1;
+        }
+        return (bits == 0) ? bit_count : (bit_count - (64 - __builtin_clzll(bits)));
+    }
 
     size_t count = 0;
     for (size_t i = bit_count - 1;;) {
@@ -6,9 +6,11 @@
  */
 
 #include "buffer.hpp"
+#include "hash_map.hpp"
 #include <stdarg.h>
 #include <stdlib.h>
 #include <stdio.h>
+#include <mutex>
 
 Buf *buf_vprintf(const char *format, va_list ap) {
     va_list ap2;
@@ -62,16 +64,67 @@ void buf_appendf(Buf *buf, const char *format, ...) {
 // these functions are not static inline so they can be better used as template parameters
 bool buf_eql_buf(Buf *buf, Buf *other) {
     assert(buf->list.length);
+    if (buf == other)
+        return true;
+    if (buf_is_interned(buf) && buf_is_interned(other))
+        return false;
     return buf_eql_mem(buf, buf_ptr(other), buf_len(other));
 }
 
-uint32_t buf_hash(Buf *buf) {
-    assert(buf->list.length);
+static uint32_t hash_mem(const char *ptr, size_t len) {
     // FNV 32-bit hash
     uint32_t h = 2166136261;
-    for (size_t i = 0; i < buf_len(buf); i += 1) {
-        h = h ^ ((uint8_t)buf->list.at(i));
+    for (size_t i = 0; i < len; i += 1) {
+        h = h ^ ((uint8_t)ptr[i]);
         h = h * 16777619;
     }
     return h;
 }
+
+uint32_t buf_hash(Buf *buf) {
+    assert(buf->list.length);
+    if (buf_is_interned(buf))
+        return buf->interned_hash;
+    return hash_mem(buf_ptr(buf), buf_len(buf));
+}
+
+static HashMap<Buf *, Buf *, buf_hash, buf_eql_buf> intern_table;
+static bool intern_table_initialized = false;
+// files are tokenized on several threads at once
+static std::mutex intern_mutex;
+
+Buf *buf_intern(Buf *buf) {
+    if (buf_is_interned(buf))
+        return buf;
+
+    std::lock_guard<std::mutex> lock(intern_mutex);
+    if (!intern_table_initialized) {
+        intern_table.init(4096);
+        intern_table_initialized = true;
+    }
+
+    bool is_new;
+    auto entry = intern_table.get_or_insert(buf, &is_new);
+    if (!is_new)
+        return entry->value;
+
+    Buf *interned = buf_create_from_buf(buf);
+    interned->interned_hash = hash_mem(buf_ptr(buf), buf_len(buf));
+    interned->interned_self = interned;
+    // the key must outlive the caller's Buf
+    entry->key = interned;
+    entry->value = interned;
+    return interned;
+}
+
+Buf *buf_intern_mem(const char *ptr, size_t len) {
+    Buf buf = BUF_INIT;
+    buf_init_from_mem(&buf, ptr, len);
+    Buf *interned = buf_intern(&buf);
+    buf_deinit(&buf);
+    return interned;
+}
+
+Buf *buf_intern_str(const char *str) {
+    return buf_intern_mem(str, strlen(str));
+}
@@ -21,6 +21,10 @@
 // initialized buffer. The assertions should help with this.
 struct Buf {
     ZigList<char> list;
+    // Set only on Bufs returned by buf_intern. A copy of an interned Buf does
+    // not point to itself, so it is never mistaken for the original.
+    Buf *interned_self;
+    uint32_t interned_hash;
 };
 
 Buf *buf_sprintf(const char *format, ...)
@@ -167,6 +171,16 @@ static inline bool buf_ends_with_str(Buf *buf, const char *str) {
 bool buf_eql_buf(Buf *buf, Buf *other);
 uint32_t buf_hash(Buf *buf);
 
+// Returns the one interned Buf with these contents. Interned Bufs live forever,
+// must not be modified, cache their hash, and are equal only to themselves.
+Buf *buf_intern(Buf *buf);
+Buf *buf_intern_mem(const char *ptr, size_t len);
+Buf *buf_intern_str(const char *str);
+
+static inline bool buf_is_interned(Buf *buf) {
+    return buf->interned_self == buf;
+}
+
 static inline void buf_upcase(Buf *buf) {
     for (size_t i = 0; i < buf_len(buf); i += 1) {
         buf_ptr(buf)[i] = (char)toupper(buf_ptr(buf)[i]);
@@ -0,0 +1,37 @@
+/*
+ * Copyright (c) 2017 Andrew Kelley
+ *
+ * This file is part of zig, which is MIT licensed.
+ * See http://opensource.org/licenses/MIT
+ */
+
+#ifndef ZIG_CACHE_HASH_HPP
+#define ZIG_CACHE_HASH_HPP
+
+#include <stdint.h>
+#include <string.h>
+
+// Hashing used to key files in the cache directory. This is FNV-1a 64-bit:
+// fast, stable across runs and platforms, and not meant to be collision
+// resistant against an adversary.
+
+static const uint64_t CACHE_HASH_INIT = 14695981039346656037ULL;
+
+static inline void cache_hash_mem(uint64_t *hash, const void *mem, size_t len) {
+    const uint8_t *bytes = (const uint8_t *)mem;
+    for (size_t i = 0; i < len; i += 1) {
+        *hash = (*hash ^ bytes[i]) * 1099511628211ULL;
+    }
+}
+
+static inline void cache_hash_str(uint64_t *hash, const char *str) {
+    // include the null byte so that adjacent strings cannot run together
+    cache_hash_mem(hash, str, strlen(str) + 1);
+}
+
+static inline void cache_hash_bool(uint64_t *hash, bool b) {
+    uint8_t byte = b ? 1 : 0;
+    cache_hash_mem(hash, &byte, 1);
+}
+
+#endif
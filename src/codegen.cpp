@@ -15,8 +15,11 @@
 #include "ir.hpp"
 #include "link.hpp"
 #include "os.hpp"
+#include "parse_scheduler.hpp"
 #include "parseh.hpp"
+#include "profile.hpp"
 #include "target.hpp"
+#include "unchanged_build.hpp"
 #include "zig_llvm.hpp"
 
 #include <stdio.h>
@@ -73,6 +76,12 @@ CodeGen *codegen_create(Buf *root_src_path, const ZigTarget *target, OutType out
     g->memoized_fn_eval_table.init(16);
     g->exported_symbol_names.init(8);
     g->external_prototypes.init(8);
+    g->lazy_visited_values.init(16);
+    g->const_global_pool.init(64);
+    g->global_var_values.init(16);
+    arena_init(&g->ast_arena, "AST");
+    arena_init(&g->ir_arena, "IR");
+    arena_init(&g->const_arena, "Constants");
     g->is_test_build = false;
     g->want_h_file = (out_type == OutTypeObj || out_type == OutTypeLib);
 
@@ -203,6 +212,42 @@ void codegen_set_cache_dir(CodeGen *g, Buf *cache_dir) {
     g->cache_dir = cache_dir;
 }
 
+void codegen_set_codegen_threads(CodeGen *g, size_t thread_count) {
+    g->codegen_threads = thread_count;
+}
+
+void codegen_set_lto(CodeGen *g, ZigLLVMLtoMode lto) {
+    g->lto = lto;
+}
+
+void codegen_set_profile_generate(CodeGen *g, bool profile_generate) {
+    g->profile_generate = profile_generate;
+}
+
+void codegen_set_profile_use(CodeGen *g, Buf *profile_path) {
+    g->profile_use_path = profile_path;
+}
+
+void codegen_set_parse_threads(CodeGen *g, size_t thread_count) {
+    g->parse_threads = thread_count;
+}
+
+void codegen_set_timing_info(CodeGen *g, bool timing_info) {
+    g->timing_info = timing_info;
+}
+
+void codegen_set_skip_unchanged(CodeGen *g, bool skip_unchanged) {
+    g->skip_unchanged = skip_unchanged;
+}
+
+void codegen_set_lazy_analysis(CodeGen *g, bool lazy_analysis) {
+    g->lazy_analysis = lazy_analysis;
+}
+
+void codegen_set_report_switch_lowering(CodeGen *g, bool report_switch_lowering) {
+    g->report_switch_lowering = report_switch_lowering;
+}
+
 void codegen_set_libc_lib_dir(CodeGen *g, Buf *libc_lib_dir) {
     g->libc_lib_dir = libc_lib_dir;
 }
@@ -355,6 +400,16 @@ static LLVMCallConv get_llvm_cc(CodeGen *g, CallingConvention cc) {
     zig_unreachable();
 }
 
+// ReleaseFast and ReleaseSmall leave out the runtime safety checks.
+static bool want_safety_build_mode(CodeGen *g) {
+    return g->build_mode != BuildModeFastRelease && g->build_mode != BuildModeSmallRelease;
+}
+
+// ReleaseSmall optimizes like -Oz
+static unsigned get_llvm_size_level(CodeGen *g) {
+    return (g->build_mode == BuildModeSmallRelease) ? 2 : 0;
+}
+
 static LLVMValueRef fn_llvm_value(CodeGen *g, FnTableEntry *fn_table_entry) {
     if (fn_table_entry->llvm_value)
         return fn_table_entry->llvm_value;
@@ -428,7 +483,7 @@ static LLVMValueRef fn_llvm_value(CodeGen *g, FnTableEntry *fn_table_entry) {
     }
 
     if (fn_table_entry->body_node != nullptr) {
-        bool want_fn_safety = g->build_mode != BuildModeFastRelease && !fn_table_entry->def_scope->safety_off;
+        bool want_fn_safety = want_safety_build_mode(g) && !fn_table_entry->def_scope->safety_off;
         if (want_fn_safety) {
             if (g->libc_link_lib != nullptr) {
                 addLLVMFnAttr(fn_table_entry->llvm_value, "sspstrong");
@@ -439,6 +494,10 @@ static LLVMValueRef fn_llvm_value(CodeGen *g, FnTableEntry *fn_table_entry) {
 
     addLLVMFnAttr(fn_table_entry->llvm_value, "nounwind");
     addLLVMFnAttr(fn_table_entry->llvm_value, "nobuiltin");
+    if (g->build_mode == BuildModeSmallRelease) {
+        addLLVMFnAttr(fn_table_entry->llvm_value, "optsize");
+        addLLVMFnAttr(fn_table_entry->llvm_value, "minsize");
+    }
     if (g->build_mode == BuildModeDebug && fn_table_entry->fn_inline != FnInlineAlways) {
         ZigLLVMAddFunctionAttr(fn_table_entry->llvm_value, "no-frame-pointer-elim", "true");
         ZigLLVMAddFunctionAttr(fn_table_entry->llvm_value, "no-frame-pointer-elim-non-leaf", nullptr);
@@ -572,12 +631,22 @@ static LLVMValueRef get_int_overflow_fn(CodeGen *g, TypeTableEntry *type_entry,
     return fn_val;
 }
 
+// The element type of a vector, or the type itself otherwise.
+static TypeTableEntry *get_scalar_type(TypeTableEntry *type_entry) {
+    if (type_entry->id == TypeTableEntryIdVector)
+        return type_entry->data.vector.elem_type;
+    return type_entry;
+}
+
 static LLVMValueRef get_floor_ceil_fn(CodeGen *g, TypeTableEntry *type_entry, ZigLLVMFnId fn_id) {
-    assert(type_entry->id == TypeTableEntryIdFloat);
+    TypeTableEntry *float_type = get_scalar_type(type_entry);
+    assert(float_type->id == TypeTableEntryIdFloat);
+    uint32_t vector_len = (type_entry->id == TypeTableEntryIdVector) ? type_entry->data.vector.len : 0;
 
     ZigLLVMFnKey key = {};
     key.id = fn_id;
-    key.data.floor_ceil.bit_count = (uint32_t)type_entry->data.floating.bit_count;
+    key.data.floor_ceil.bit_count = (uint32_t)float_type->data.floating.bit_count;
+    key.data.floor_ceil.vector_len = vector_len;
 
     auto existing_entry = g->llvm_fn_table.maybe_get(key);
     if (existing_entry)
@@ -593,7 +662,12 @@ static LLVMValueRef get_floor_ceil_fn(CodeGen *g, TypeTableEntry *type_entry, Zi
     }
 
     char fn_name[64];
-    sprintf(fn_name, "llvm.%s.f%" ZIG_PRI_usize "", name, type_entry->data.floating.bit_count);
+    if (vector_len == 0) {
+        sprintf(fn_name, "llvm.%s.f%" ZIG_PRI_usize "", name, float_type->data.floating.bit_count);
+    } else {
+        sprintf(fn_name, "llvm.%s.v%" PRIu32 "f%" ZIG_PRI_usize "", name, vector_len,
+                float_type->data.floating.bit_count);
+    }
     LLVMTypeRef fn_type = LLVMFunctionType(type_entry->type_ref, &type_entry->type_ref, 1, false);
     LLVMValueRef fn_val = LLVMAddFunction(g->module, fn_name, fn_type);
 
@@ -634,7 +708,7 @@ static bool ir_want_fast_math(CodeGen *g, IrInstruction *instruction) {
 }
 
 static bool ir_want_debug_safety(CodeGen *g, IrInstruction *instruction) {
-    if (g->build_mode == BuildModeFastRelease)
+    if (!want_safety_build_mode(g))
         return false;
 
     // TODO memoize
@@ -710,6 +784,8 @@ static Buf *panic_msg_buf(PanicMsgId msg_id) {
             return buf_create_from_str("reached unreachable code");
         case PanicMsgIdInvalidErrorCode:
             return buf_create_from_str("invalid error code");
+        case PanicMsgIdShiftAmountTooBig:
+            return buf_create_from_str("shift amount is greater than the type size");
     }
     zig_unreachable();
 }
@@ -971,17 +1047,69 @@ static LLVMValueRef gen_widen_or_shorten(CodeGen *g, bool want_debug_safety, Typ
     }
 }
 
+// For a vector of i1, true if any element is set. Scalars are returned unchanged.
+static LLVMValueRef gen_any_elem_set(CodeGen *g, TypeTableEntry *type_entry, LLVMValueRef bits) {
+    if (type_entry->id != TypeTableEntryIdVector)
+        return bits;
+    LLVMTypeRef mask_type = LLVMIntType(type_entry->data.vector.len);
+    LLVMValueRef mask = LLVMBuildBitCast(g->builder, bits, mask_type, "");
+    return LLVMBuildICmp(g->builder, LLVMIntNE, mask, LLVMConstNull(mask_type), "");
+}
+
+// For a vector of i1, true if every element is set. Scalars are returned unchanged.
+static LLVMValueRef gen_all_elems_set(CodeGen *g, TypeTableEntry *type_entry, LLVMValueRef bits) {
+    if (type_entry->id != TypeTableEntryIdVector)
+        return bits;
+    LLVMTypeRef mask_type = LLVMIntType(type_entry->data.vector.len);
+    LLVMValueRef mask = LLVMBuildBitCast(g->builder, bits, mask_type, "");
+    return LLVMBuildICmp(g->builder, LLVMIntEQ, mask, LLVMConstAllOnes(mask_type), "");
+}
+
+// Repeats a scalar constant across every element when type_entry is a vector.
+static LLVMValueRef splat_const(TypeTableEntry *type_entry, LLVMValueRef scalar) {
+    if (type_entry->id != TypeTableEntryIdVector)
+        return scalar;
+    uint32_t len = type_entry->data.vector.len;
+    LLVMValueRef *elems = allocate<LLVMValueRef>(len);
+    for (uint32_t i = 0; i < len; i += 1) {
+        elems[i] = scalar;
+    }
+    return LLVMConstVector(elems, len);
+}
+
 static LLVMValueRef gen_overflow_op(CodeGen *g, TypeTableEntry *type_entry, AddSubMul op,
         LLVMValueRef val1, LLVMValueRef val2)
 {
-    LLVMValueRef fn_val = get_int_overflow_fn(g, type_entry, op);
-    LLVMValueRef params[] = {
-        val1,
-        val2,
-    };
-    LLVMValueRef result_struct = LLVMBuildCall(g->builder, fn_val, params, 2, "");
-    LLVMValueRef result = LLVMBuildExtractValue(g->builder, result_struct, 0, "");
-    LLVMValueRef overflow_bit = LLVMBuildExtractValue(g->builder, result_struct, 1, "");
+    LLVMValueRef result;
+    LLVMValueRef overflow_bit;
+    if (type_entry->id == TypeTableEntryIdVector) {
+        // the overflow intrinsics only accept scalars, so each element is
+        // computed on its own and the overflow bits are or'd together
+        LLVMValueRef fn_val = get_int_overflow_fn(g, type_entry->data.vector.elem_type, op);
+        result = LLVMGetUndef(type_entry->type_ref);
+        overflow_bit = LLVMConstNull(LLVMInt1Type());
+        for (uint32_t i = 0; i < type_entry->data.vector.len; i += 1) {
+            LLVMValueRef index = LLVMConstInt(LLVMInt32Type(), i, false);
+            LLVMValueRef params[] = {
+                LLVMBuildExtractElement(g->builder, val1, index, ""),
+                LLVMBuildExtractElement(g->builder, val2, index, ""),
+            };
+            LLVMValueRef result_struct = LLVMBuildCall(g->builder, fn_val, params, 2, "");
+            LLVMValueRef elem = LLVMBuildExtractValue(g->builder, result_struct, 0, "");
+            result = LLVMBuildInsertElement(g->builder, result, elem, index, "");
+            LLVMValueRef elem_overflow_bit = LLVMBuildExtractValue(g->builder, result_struct, 1, "");
+            overflow_bit = LLVMBuildOr(g->builder, overflow_bit, elem_overflow_bit, "");
+        }
+    } else {
+        LLVMValueRef fn_val = get_int_overflow_fn(g, type_entry, op);
+        LLVMValueRef params[] = {
+            val1,
+            val2,
+        };
+        LLVMValueRef result_struct = LLVMBuildCall(g->builder, fn_val, params, 2, "");
+        result = LLVMBuildExtractValue(g->builder, result_struct, 0, "");
+        overflow_bit = LLVMBuildExtractValue(g->builder, result_struct, 1, "");
+    }
     LLVMBasicBlockRef fail_block = LLVMAppendBasicBlock(g->cur_fn_val, "OverflowFail");
     LLVMBasicBlockRef ok_block = LLVMAppendBasicBlock(g->cur_fn_val, "OverflowOk");
     LLVMBuildCondBr(g->builder, overflow_bit, fail_block, ok_block);
@@ -1158,16 +1286,18 @@ static LLVMValueRef gen_overflow_shl_op(CodeGen *g, TypeTableEntry *type_entry,
     // if the values don't match, we have an overflow
     // for signed left shifting we do the same except arithmetic shift right
 
-    assert(type_entry->id == TypeTableEntryIdInt);
+    TypeTableEntry *scalar_type = get_scalar_type(type_entry);
+    assert(scalar_type->id == TypeTableEntryIdInt);
 
     LLVMValueRef result = LLVMBuildShl(g->builder, val1, val2, "");
     LLVMValueRef orig_val;
-    if (type_entry->data.integral.is_signed) {
+    if (scalar_type->data.integral.is_signed) {
         orig_val = LLVMBuildAShr(g->builder, result, val2, "");
     } else {
         orig_val = LLVMBuildLShr(g->builder, result, val2, "");
     }
     LLVMValueRef ok_bit = LLVMBuildICmp(g->builder, LLVMIntEQ, val1, orig_val, "");
+    ok_bit = gen_all_elems_set(g, type_entry, ok_bit);
 
     LLVMBasicBlockRef ok_block = LLVMAppendBasicBlock(g->cur_fn_val, "OverflowOk");
     LLVMBasicBlockRef fail_block = LLVMAppendBasicBlock(g->cur_fn_val, "OverflowFail");
@@ -1181,7 +1311,7 @@ static LLVMValueRef gen_overflow_shl_op(CodeGen *g, TypeTableEntry *type_entry,
 }
 
 static LLVMValueRef gen_floor(CodeGen *g, LLVMValueRef val, TypeTableEntry *type_entry) {
-    if (type_entry->id == TypeTableEntryIdInt)
+    if (get_scalar_type(type_entry)->id == TypeTableEntryIdInt)
         return val;
 
     LLVMValueRef floor_fn = get_floor_ceil_fn(g, type_entry, ZigLLVMFnIdFloor);
@@ -1189,7 +1319,7 @@ static LLVMValueRef gen_floor(CodeGen *g, LLVMValueRef val, TypeTableEntry *type
 }
 
 static LLVMValueRef gen_ceil(CodeGen *g, LLVMValueRef val, TypeTableEntry *type_entry) {
-    if (type_entry->id == TypeTableEntryIdInt)
+    if (get_scalar_type(type_entry)->id == TypeTableEntryIdInt)
         return val;
 
     LLVMValueRef ceil_fn = get_floor_ceil_fn(g, type_entry, ZigLLVMFnIdCeil);
@@ -1226,16 +1356,19 @@ static LLVMValueRef gen_div(CodeGen *g, bool want_debug_safety, bool want_fast_m
 {
     ZigLLVMSetFastMath(g->builder, want_fast_math);
 
+    // type_entry may be a vector, in which case the checks fail if they fail for any element
+    TypeTableEntry *scalar_type = get_scalar_type(type_entry);
     LLVMValueRef zero = LLVMConstNull(type_entry->type_ref);
     if (want_debug_safety) {
         LLVMValueRef is_zero_bit;
-        if (type_entry->id == TypeTableEntryIdInt) {
+        if (scalar_type->id == TypeTableEntryIdInt) {
             is_zero_bit = LLVMBuildICmp(g->builder, LLVMIntEQ, val2, zero, "");
-        } else if (type_entry->id == TypeTableEntryIdFloat) {
+        } else if (scalar_type->id == TypeTableEntryIdFloat) {
             is_zero_bit = LLVMBuildFCmp(g->builder, LLVMRealOEQ, val2, zero, "");
         } else {
             zig_unreachable();
         }
+        is_zero_bit = gen_any_elem_set(g, type_entry, is_zero_bit);
         LLVMBasicBlockRef div_zero_ok_block = LLVMAppendBasicBlock(g->cur_fn_val, "DivZeroOk");
         LLVMBasicBlockRef div_zero_fail_block = LLVMAppendBasicBlock(g->cur_fn_val, "DivZeroFail");
         LLVMBuildCondBr(g->builder, is_zero_bit, div_zero_fail_block, div_zero_ok_block);
@@ -1245,16 +1378,18 @@ static LLVMValueRef gen_div(CodeGen *g, bool want_debug_safety, bool want_fast_m
 
         LLVMPositionBuilderAtEnd(g->builder, div_zero_ok_block);
 
-        if (type_entry->id == TypeTableEntryIdInt && type_entry->data.integral.is_signed) {
-            LLVMValueRef neg_1_value = LLVMConstInt(type_entry->type_ref, -1, true);
+        if (scalar_type->id == TypeTableEntryIdInt && scalar_type->data.integral.is_signed) {
+            LLVMValueRef neg_1_value = splat_const(type_entry, LLVMConstInt(scalar_type->type_ref, -1, true));
             BigInt int_min_bi = {0};
-            eval_min_max_value_int(g, type_entry, &int_min_bi, false);
-            LLVMValueRef int_min_value = bigint_to_llvm_const(type_entry->type_ref, &int_min_bi);
+            eval_min_max_value_int(g, scalar_type, &int_min_bi, false);
+            LLVMValueRef int_min_value = splat_const(type_entry,
+                    bigint_to_llvm_const(scalar_type->type_ref, &int_min_bi));
             LLVMBasicBlockRef overflow_ok_block = LLVMAppendBasicBlock(g->cur_fn_val, "DivOverflowOk");
             LLVMBasicBlockRef overflow_fail_block = LLVMAppendBasicBlock(g->cur_fn_val, "DivOverflowFail");
             LLVMValueRef num_is_int_min = LLVMBuildICmp(g->builder, LLVMIntEQ, val1, int_min_value, "");
             LLVMValueRef den_is_neg_1 = LLVMBuildICmp(g->builder, LLVMIntEQ, val2, neg_1_value, "");
             LLVMValueRef overflow_fail_bit = LLVMBuildAnd(g->builder, num_is_int_min, den_is_neg_1, "");
+            overflow_fail_bit = gen_any_elem_set(g, type_entry, overflow_fail_bit);
             LLVMBuildCondBr(g->builder, overflow_fail_bit, overflow_fail_block, overflow_ok_block);
 
             LLVMPositionBuilderAtEnd(g->builder, overflow_fail_block);
@@ -1264,7 +1399,7 @@ static LLVMValueRef gen_div(CodeGen *g, bool want_debug_safety, bool want_fast_m
         }
     }
 
-    if (type_entry->id == TypeTableEntryIdFloat) {
+    if (scalar_type->id == TypeTableEntryIdFloat) {
         LLVMValueRef result = LLVMBuildFDiv(g->builder, val1, val2, "");
         switch (div_kind) {
             case DivKindFloat:
@@ -1275,6 +1410,7 @@ static LLVMValueRef gen_div(CodeGen *g, bool want_debug_safety, bool want_fast_m
                     LLVMBasicBlockRef ok_block = LLVMAppendBasicBlock(g->cur_fn_val, "DivExactOk");
                     LLVMBasicBlockRef fail_block = LLVMAppendBasicBlock(g->cur_fn_val, "DivExactFail");
                     LLVMValueRef ok_bit = LLVMBuildFCmp(g->builder, LLVMRealOEQ, floored, result, "");
+                    ok_bit = gen_all_elems_set(g, type_entry, ok_bit);
 
                     LLVMBuildCondBr(g->builder, ok_bit, ok_block, fail_block);
 
@@ -1297,13 +1433,13 @@ static LLVMValueRef gen_div(CodeGen *g, bool want_debug_safety, bool want_fast_m
         zig_unreachable();
     }
 
-    assert(type_entry->id == TypeTableEntryIdInt);
+    assert(scalar_type->id == TypeTableEntryIdInt);
 
     switch (div_kind) {
         case DivKindFloat:
             zig_unreachable();
         case DivKindTrunc:
-            if (type_entry->data.integral.is_signed) {
+            if (scalar_type->data.integral.is_signed) {
                 return LLVMBuildSDiv(g->builder, val1, val2, "");
             } else {
                 return LLVMBuildUDiv(g->builder, val1, val2, "");
@@ -1311,12 +1447,13 @@ static LLVMValueRef gen_div(CodeGen *g, bool want_debug_safety, bool want_fast_m
         case DivKindExact:
             if (want_debug_safety) {
                 LLVMValueRef remainder_val;
-                if (type_entry->data.integral.is_signed) {
+                if (scalar_type->data.integral.is_signed) {
                     remainder_val = LLVMBuildSRem(g->builder, val1, val2, "");
                 } else {
                     remainder_val = LLVMBuildURem(g->builder, val1, val2, "");
                 }
                 LLVMValueRef ok_bit = LLVMBuildICmp(g->builder, LLVMIntEQ, remainder_val, zero, "");
+                ok_bit = gen_all_elems_set(g, type_entry, ok_bit);
 
                 LLVMBasicBlockRef ok_block = LLVMAppendBasicBlock(g->cur_fn_val, "DivExactOk");
                 LLVMBasicBlockRef fail_block = LLVMAppendBasicBlock(g->cur_fn_val, "DivExactFail");
@@ -1327,14 +1464,14 @@ static LLVMValueRef gen_div(CodeGen *g, bool want_debug_safety, bool want_fast_m
 
                 LLVMPositionBuilderAtEnd(g->builder, ok_block);
             }
-            if (type_entry->data.integral.is_signed) {
+            if (scalar_type->data.integral.is_signed) {
                 return LLVMBuildExactSDiv(g->builder, val1, val2, "");
             } else {
                 return LLVMBuildExactUDiv(g->builder, val1, val2, "");
             }
         case DivKindFloor:
             {
-                if (!type_entry->data.integral.is_signed) {
+                if (!scalar_type->data.integral.is_signed) {
                     return LLVMBuildUDiv(g->builder, val1, val2, "");
                 }
                 // const result = @divTrunc(a, b);
@@ -1348,7 +1485,7 @@ static LLVMValueRef gen_div(CodeGen *g, bool want_debug_safety, bool want_fast_m
                 LLVMValueRef orig_num = LLVMBuildNSWMul(g->builder, result, val2, "");
                 LLVMValueRef orig_ok = LLVMBuildICmp(g->builder, LLVMIntEQ, orig_num, val1, "");
                 LLVMValueRef ok_bit = LLVMBuildOr(g->builder, orig_ok, is_pos, "");
-                LLVMValueRef one = LLVMConstInt(type_entry->type_ref, 1, true);
+                LLVMValueRef one = splat_const(type_entry, LLVMConstInt(scalar_type->type_ref, 1, true));
                 LLVMValueRef result_minus_1 = LLVMBuildNSWSub(g->builder, result, one, "");
                 return LLVMBuildSelect(g->builder, ok_bit, result, result_minus_1, "");
             }
@@ -1367,17 +1504,20 @@ static LLVMValueRef gen_rem(CodeGen *g, bool want_debug_safety, bool want_fast_m
 {
     ZigLLVMSetFastMath(g->builder, want_fast_math);
 
+    // type_entry may be a vector, in which case the check fails if it fails for any element
+    TypeTableEntry *scalar_type = get_scalar_type(type_entry);
     LLVMValueRef zero = LLVMConstNull(type_entry->type_ref);
     if (want_debug_safety) {
         LLVMValueRef is_zero_bit;
-        if (type_entry->id == TypeTableEntryIdInt) {
-            LLVMIntPredicate pred = type_entry->data.integral.is_signed ? LLVMIntSLE : LLVMIntEQ;
+        if (scalar_type->id == TypeTableEntryIdInt) {
+            LLVMIntPredicate pred = scalar_type->data.integral.is_signed ? LLVMIntSLE : LLVMIntEQ;
             is_zero_bit = LLVMBuildICmp(g->builder, pred, val2, zero, "");
-        } else if (type_entry->id == TypeTableEntryIdFloat) {
+        } else if (scalar_type->id == TypeTableEntryIdFloat) {
             is_zero_bit = LLVMBuildFCmp(g->builder, LLVMRealOEQ, val2, zero, "");
         } else {
             zig_unreachable();
         }
+        is_zero_bit = gen_any_elem_set(g, type_entry, is_zero_bit);
         LLVMBasicBlockRef rem_zero_ok_block = LLVMAppendBasicBlock(g->cur_fn_val, "RemZeroOk");
         LLVMBasicBlockRef rem_zero_fail_block = LLVMAppendBasicBlock(g->cur_fn_val, "RemZeroFail");
         LLVMBuildCondBr(g->builder, is_zero_bit, rem_zero_fail_block, rem_zero_ok_block);
@@ -1388,7 +1528,7 @@ static LLVMValueRef gen_rem(CodeGen *g, bool want_debug_safety, bool want_fast_m
         LLVMPositionBuilderAtEnd(g->builder, rem_zero_ok_block);
     }
 
-    if (type_entry->id == TypeTableEntryIdFloat) {
+    if (scalar_type->id == TypeTableEntryIdFloat) {
         if (rem_kind == RemKindRem) {
             return LLVMBuildFRem(g->builder, val1, val2, "");
         } else {
@@ -1399,8 +1539,8 @@ static LLVMValueRef gen_rem(CodeGen *g, bool want_debug_safety, bool want_fast_m
             return LLVMBuildSelect(g->builder, ltz, c, a, "");
         }
     } else {
-        assert(type_entry->id == TypeTableEntryIdInt);
-        if (type_entry->data.integral.is_signed) {
+        assert(scalar_type->id == TypeTableEntryIdInt);
+        if (scalar_type->data.integral.is_signed) {
             if (rem_kind == RemKindRem) {
                 return LLVMBuildSRem(g->builder, val1, val2, "");
             } else {
@@ -1417,6 +1557,138 @@ static LLVMValueRef gen_rem(CodeGen *g, bool want_debug_safety, bool want_fast_m
 
 }
 
+// LLVM leaves a shift by the element width or more undefined, and a vector
+// shift amount has the element type, so it can name one.
+static void gen_vector_shift_amount_check(CodeGen *g, TypeTableEntry *vector_type, LLVMValueRef amount) {
+    TypeTableEntry *elem_type = vector_type->data.vector.elem_type;
+    LLVMValueRef bit_count = splat_const(vector_type,
+            LLVMConstInt(elem_type->type_ref, elem_type->data.integral.bit_count, false));
+    LLVMValueRef too_big_bit = LLVMBuildICmp(g->builder, LLVMIntUGE, amount, bit_count, "");
+    too_big_bit = gen_any_elem_set(g, vector_type, too_big_bit);
+
+    LLVMBasicBlockRef fail_block = LLVMAppendBasicBlock(g->cur_fn_val, "ShiftAmountFail");
+    LLVMBasicBlockRef ok_block = LLVMAppendBasicBlock(g->cur_fn_val, "ShiftAmountOk");
+    LLVMBuildCondBr(g->builder, too_big_bit, fail_block, ok_block);
+
+    LLVMPositionBuilderAtEnd(g->builder, fail_block);
+    gen_debug_safety_crash(g, PanicMsgIdShiftAmountTooBig);
+
+    LLVMPositionBuilderAtEnd(g->builder, ok_block);
+}
+
+// Vector operations are elementwise. LLVM instructions accept vector operands,
+// and the safety checks fail if they fail for any element.
+static LLVMValueRef gen_vector_bin_op(CodeGen *g, IrInstructionBinOp *bin_op_instruction,
+        bool want_debug_safety, TypeTableEntry *vector_type, LLVMValueRef op1_value, LLVMValueRef op2_value)
+{
+    IrBinOp op_id = bin_op_instruction->op_id;
+    TypeTableEntry *elem_type = vector_type->data.vector.elem_type;
+    bool is_float = (elem_type->id == TypeTableEntryIdFloat);
+    bool is_signed = (elem_type->id == TypeTableEntryIdInt && elem_type->data.integral.is_signed);
+    bool want_fast_math = ir_want_fast_math(g, &bin_op_instruction->base);
+    if (is_float)
+        ZigLLVMSetFastMath(g->builder, want_fast_math);
+
+    switch (op_id) {
+        case IrBinOpCmpEq:
+        case IrBinOpCmpNotEq:
+        case IrBinOpCmpLessThan:
+        case IrBinOpCmpGreaterThan:
+        case IrBinOpCmpLessOrEq:
+        case IrBinOpCmpGreaterOrEq:
+            if (is_float) {
+                LLVMRealPredicate pred = cmp_op_to_real_predicate(op_id);
+                return LLVMBuildFCmp(g->builder, pred, op1_value, op2_value, "");
+            } else {
+                LLVMIntPredicate pred = cmp_op_to_int_predicate(op_id, is_signed);
+                return LLVMBuildICmp(g->builder, pred, op1_value, op2_value, "");
+            }
+        case IrBinOpBinOr:
+            return LLVMBuildOr(g->builder, op1_value, op2_value, "");
+        case IrBinOpBinXor:
+            return LLVMBuildXor(g->builder, op1_value, op2_value, "");
+        case IrBinOpBinAnd:
+            return LLVMBuildAnd(g->builder, op1_value, op2_value, "");
+        case IrBinOpBitShiftLeft:
+            if (want_debug_safety) {
+                gen_vector_shift_amount_check(g, vector_type, op2_value);
+                return gen_overflow_shl_op(g, vector_type, op1_value, op2_value);
+            } else if (is_signed) {
+                return ZigLLVMBuildNSWShl(g->builder, op1_value, op2_value, "");
+            } else {
+                return ZigLLVMBuildNUWShl(g->builder, op1_value, op2_value, "");
+            }
+        case IrBinOpBitShiftLeftWrap:
+            if (want_debug_safety)
+                gen_vector_shift_amount_check(g, vector_type, op2_value);
+            return LLVMBuildShl(g->builder, op1_value, op2_value, "");
+        case IrBinOpBitShiftRight:
+            if (want_debug_safety)
+                gen_vector_shift_amount_check(g, vector_type, op2_value);
+            if (is_signed) {
+                return LLVMBuildAShr(g->builder, op1_value, op2_value, "");
+            } else {
+                return LLVMBuildLShr(g->builder, op1_value, op2_value, "");
+            }
+        case IrBinOpAdd:
+            if (is_float) {
+                return LLVMBuildFAdd(g->builder, op1_value, op2_value, "");
+            } else if (want_debug_safety) {
+                return gen_overflow_op(g, vector_type, AddSubMulAdd, op1_value, op2_value);
+            } else if (is_signed) {
+                return LLVMBuildNSWAdd(g->builder, op1_value, op2_value, "");
+            } else {
+                return LLVMBuildNUWAdd(g->builder, op1_value, op2_value, "");
+            }
+        case IrBinOpAddWrap:
+            return LLVMBuildAdd(g->builder, op1_value, op2_value, "");
+        case IrBinOpSub:
+            if (is_float) {
+                return LLVMBuildFSub(g->builder, op1_value, op2_value, "");
+            } else if (want_debug_safety) {
+                return gen_overflow_op(g, vector_type, AddSubMulSub, op1_value, op2_value);
+            } else if (is_signed) {
+                return LLVMBuildNSWSub(g->builder, op1_value, op2_value, "");
+            } else {
+                return LLVMBuildNUWSub(g->builder, op1_value, op2_value, "");
+            }
+        case IrBinOpSubWrap:
+            return LLVMBuildSub(g->builder, op1_value, op2_value, "");
+        case IrBinOpMult:
+            if (is_float) {
+                return LLVMBuildFMul(g->builder, op1_value, op2_value, "");
+            } else if (want_debug_safety) {
+                return gen_overflow_op(g, vector_type, AddSubMulMul, op1_value, op2_value);
+            } else if (is_signed) {
+                return LLVMBuildNSWMul(g->builder, op1_value, op2_value, "");
+            } else {
+                return LLVMBuildNUWMul(g->builder, op1_value, op2_value, "");
+            }
+        case IrBinOpMultWrap:
+            return LLVMBuildMul(g->builder, op1_value, op2_value, "");
+        case IrBinOpDivUnspecified:
+            return gen_div(g, want_debug_safety, want_fast_math,
+                    op1_value, op2_value, vector_type, DivKindFloat);
+        case IrBinOpDivTrunc:
+            return gen_div(g, want_debug_safety, want_fast_math,
+                    op1_value, op2_value, vector_type, DivKindTrunc);
+        case IrBinOpDivFloor:
+            return gen_div(g, want_debug_safety, want_fast_math,
+                    op1_value, op2_value, vector_type, DivKindFloor);
+        case IrBinOpDivExact:
+            return gen_div(g, want_debug_safety, want_fast_math,
+                    op1_value, op2_value, vector_type, DivKindExact);
+        case IrBinOpRemRem:
+            return gen_rem(g, want_debug_safety, want_fast_math,
+                    op1_value, op2_value, vector_type, RemKindRem);
+        case IrBinOpRemMod:
+            return gen_rem(g, want_debug_safety, want_fast_math,
+                    op1_value, op2_value, vector_type, RemKindMod);
+        default:
+            zig_unreachable();
+    }
+}
+
 static LLVMValueRef ir_render_bin_op(CodeGen *g, IrExecutable *executable,
         IrInstructionBinOp *bin_op_instruction)
 {
@@ -1432,6 +1704,8 @@ static LLVMValueRef ir_render_bin_op(CodeGen *g, IrExecutable *executable,
 
     LLVMValueRef op1_value = ir_llvm_value(g, op1);
     LLVMValueRef op2_value = ir_llvm_value(g, op2);
+    if (type_entry->id == TypeTableEntryIdVector)
+        return gen_vector_bin_op(g, bin_op_instruction, want_debug_safety, type_entry, op1_value, op2_value);
     switch (op_id) {
         case IrBinOpInvalid:
         case IrBinOpArrayCat:
@@ -1578,6 +1852,67 @@ static LLVMValueRef ir_render_bin_op(CodeGen *g, IrExecutable *executable,
     zig_unreachable();
 }
 
+// An array and a vector of the same elements have the same layout in memory
+// unless the elements have padding bits, like bool and u7, which a vector
+// packs together.
+static bool vector_has_array_layout(CodeGen *g, TypeTableEntry *elem_type) {
+    if (elem_type->id == TypeTableEntryIdBool)
+        return false;
+    LLVMTypeRef elem_type_ref = elem_type->type_ref;
+    return LLVMABISizeOfType(g->target_data_ref, elem_type_ref) * 8 ==
+        LLVMSizeOfTypeInBits(g->target_data_ref, elem_type_ref);
+}
+
+static LLVMValueRef gen_array_to_vector(CodeGen *g, LLVMValueRef array_ptr, TypeTableEntry *vector_type) {
+    TypeTableEntry *elem_type = vector_type->data.vector.elem_type;
+    if (vector_has_array_layout(g, elem_type)) {
+        LLVMValueRef vector_ptr = LLVMBuildBitCast(g->builder, array_ptr,
+                LLVMPointerType(vector_type->type_ref, 0), "");
+        LLVMValueRef result = LLVMBuildLoad(g->builder, vector_ptr, "");
+        LLVMSetAlignment(result, LLVMABIAlignmentOfType(g->target_data_ref, elem_type->type_ref));
+        return result;
+    }
+
+    LLVMTypeRef usize_type_ref = g->builtin_types.entry_usize->type_ref;
+    LLVMValueRef result = LLVMGetUndef(vector_type->type_ref);
+    for (uint32_t i = 0; i < vector_type->data.vector.len; i += 1) {
+        LLVMValueRef indices[] = {
+            LLVMConstNull(usize_type_ref),
+            LLVMConstInt(usize_type_ref, i, false),
+        };
+        LLVMValueRef elem_ptr = LLVMBuildInBoundsGEP(g->builder, array_ptr, indices, 2, "");
+        LLVMValueRef elem = LLVMBuildLoad(g->builder, elem_ptr, "");
+        result = LLVMBuildInsertElement(g->builder, result, elem,
+                LLVMConstInt(LLVMInt32Type(), i, false), "");
+    }
+    return result;
+}
+
+static void gen_vector_to_array(CodeGen *g, LLVMValueRef vector, TypeTableEntry *vector_type,
+        LLVMValueRef array_ptr)
+{
+    TypeTableEntry *elem_type = vector_type->data.vector.elem_type;
+    if (vector_has_array_layout(g, elem_type)) {
+        LLVMValueRef vector_ptr = LLVMBuildBitCast(g->builder, array_ptr,
+                LLVMPointerType(vector_type->type_ref, 0), "");
+        LLVMValueRef store = LLVMBuildStore(g->builder, vector, vector_ptr);
+        LLVMSetAlignment(store, LLVMABIAlignmentOfType(g->target_data_ref, elem_type->type_ref));
+        return;
+    }
+
+    LLVMTypeRef usize_type_ref = g->builtin_types.entry_usize->type_ref;
+    for (uint32_t i = 0; i < vector_type->data.vector.len; i += 1) {
+        LLVMValueRef indices[] = {
+            LLVMConstNull(usize_type_ref),
+            LLVMConstInt(usize_type_ref, i, false),
+        };
+        LLVMValueRef elem_ptr = LLVMBuildInBoundsGEP(g->builder, array_ptr, indices, 2, "");
+        LLVMValueRef elem = LLVMBuildExtractElement(g->builder, vector,
+                LLVMConstInt(LLVMInt32Type(), i, false), "");
+        LLVMBuildStore(g->builder, elem, elem_ptr);
+    }
+}
+
 static LLVMValueRef ir_render_cast(CodeGen *g, IrExecutable *executable,
         IrInstructionCast *cast_instruction)
 {
@@ -1701,6 +2036,16 @@ static LLVMValueRef ir_render_cast(CodeGen *g, IrExecutable *executable,
             assert(wanted_type->id == TypeTableEntryIdInt);
             assert(actual_type->id == TypeTableEntryIdBool);
             return LLVMBuildZExt(g->builder, expr_val, wanted_type->type_ref, "");
+        case CastOpArrayToVector:
+            assert(actual_type->id == TypeTableEntryIdArray);
+            assert(wanted_type->id == TypeTableEntryIdVector);
+            return gen_array_to_vector(g, expr_val, wanted_type);
+        case CastOpVectorToArray:
+            assert(cast_instruction->tmp_ptr);
+            assert(actual_type->id == TypeTableEntryIdVector);
+            assert(wanted_type->id == TypeTableEntryIdArray);
+            gen_vector_to_array(g, expr_val, actual_type, cast_instruction->tmp_ptr);
+            return cast_instruction->tmp_ptr;
     }
     zig_unreachable();
 }
@@ -2422,15 +2767,223 @@ static LLVMValueRef ir_render_ctz(CodeGen *g, IrExecutable *executable, IrInstru
     return LLVMBuildCall(g->builder, fn_val, params, 2, "");
 }
 
+enum SwitchLowering {
+    SwitchLoweringLlvm,
+    SwitchLoweringJumpTable,
+    SwitchLoweringBinarySearch,
+};
+
+static const char *switch_lowering_name(SwitchLowering lowering) {
+    switch (lowering) {
+        case SwitchLoweringLlvm:
+            return "llvm switch";
+        case SwitchLoweringJumpTable:
+            return "jump table";
+        case SwitchLoweringBinarySearch:
+            return "binary search";
+    }
+    zig_unreachable();
+}
+
+struct SwitchLoweringCase {
+    // the case value mapped so that unsigned order matches the order of the switch type
+    uint64_t key;
+    LLVMValueRef value;
+    LLVMBasicBlockRef block;
+};
+
+static int compare_switch_lowering_cases(const void *a, const void *b) {
+    uint64_t key_a = ((const SwitchLoweringCase *)a)->key;
+    uint64_t key_b = ((const SwitchLoweringCase *)b)->key;
+    if (key_a < key_b)
+        return -1;
+    if (key_a > key_b)
+        return 1;
+    return 0;
+}
+
+// At -O0 LLVM lowers every switch to a chain of compares, so in debug builds
+// dense switches become a jump table and large sparse ones a binary search.
+static const size_t switch_jump_table_min_cases = 4;
+static const size_t switch_binary_search_min_cases = 8;
+// a jump table needs at least 40% of the slots between the smallest and the
+// largest case to be cases
+static const size_t switch_jump_table_min_density_percent = 40;
+// below this, a chain of compares is as fast as branching on the pivot
+static const size_t switch_binary_search_leaf_cases = 3;
+
+static bool ir_switch_br_targets_have_phi(IrInstructionSwitchBr *instruction) {
+    // The new blocks would become the predecessors of the targets.
+    IrBasicBlock *else_block = instruction->else_block;
+    if (else_block->instruction_list.length != 0 && else_block->instruction_list.at(0)->id == IrInstructionIdPhi)
+        return true;
+    for (size_t i = 0; i < instruction->case_count; i += 1) {
+        IrBasicBlock *block = instruction->cases[i].block;
+        if (block->instruction_list.length != 0 && block->instruction_list.at(0)->id == IrInstructionIdPhi)
+            return true;
+    }
+    return false;
+}
+
+static SwitchLowering choose_switch_lowering(CodeGen *g, IrInstructionSwitchBr *instruction,
+        LLVMValueRef target_value, SwitchLoweringCase *cases)
+{
+    if (g->build_mode != BuildModeDebug)
+        return SwitchLoweringLlvm;
+    if (instruction->case_count < switch_jump_table_min_cases)
+        return SwitchLoweringLlvm;
+    if (LLVMGetIntTypeWidth(LLVMTypeOf(target_value)) > 64)
+        return SwitchLoweringLlvm;
+    if (ir_switch_br_targets_have_phi(instruction))
+        return SwitchLoweringLlvm;
+
+    TypeTableEntry *target_type = instruction->target_value->value.type;
+    bool is_signed = (target_type->id == TypeTableEntryIdInt && target_type->data.integral.is_signed);
+    for (size_t i = 0; i < instruction->case_count; i += 1) {
+        IrInstructionSwitchBrCase *this_case = &instruction->cases[i];
+        LLVMValueRef case_value = ir_llvm_value(g, this_case->value);
+        if (!LLVMIsAConstantInt(case_value))
+            return SwitchLoweringLlvm;
+        cases[i].value = case_value;
+        cases[i].block = this_case->block->llvm_block;
+        if (is_signed) {
+            cases[i].key = ((uint64_t)LLVMConstIntGetSExtValue(case_value)) ^ (((uint64_t)1) << 63);
+        } else {
+            cases[i].key = LLVMConstIntGetZExtValue(case_value);
+        }
+    }
+    qsort(cases, instruction->case_count, sizeof(SwitchLoweringCase), compare_switch_lowering_cases);
+
+    uint64_t span = cases[instruction->case_count - 1].key - cases[0].key;
+    if (span < UINT32_MAX &&
+        instruction->case_count * 100 >= (span + 1) * switch_jump_table_min_density_percent)
+    {
+        return SwitchLoweringJumpTable;
+    }
+    if (instruction->case_count >= switch_binary_search_min_cases)
+        return SwitchLoweringBinarySearch;
+    return SwitchLoweringLlvm;
+}
+
+static void gen_switch_jump_table(CodeGen *g, LLVMValueRef target_value, LLVMBasicBlockRef else_block,
+        SwitchLoweringCase *cases, size_t case_count)
+{
+    LLVMTypeRef target_type_ref = LLVMTypeOf(target_value);
+    size_t table_len = (size_t)(cases[case_count - 1].key - cases[0].key + 1);
+
+    LLVMValueRef *table_values = allocate<LLVMValueRef>(table_len);
+    LLVMValueRef else_address = LLVMBlockAddress(g->cur_fn_val, else_block);
+    for (size_t i = 0; i < table_len; i += 1) {
+        table_values[i] = else_address;
+    }
+    for (size_t i = 0; i < case_count; i += 1) {
+        table_values[cases[i].key - cases[0].key] = LLVMBlockAddress(g->cur_fn_val, cases[i].block);
+    }
+    LLVMValueRef table_init = LLVMConstArray(LLVMTypeOf(else_address), table_values, (unsigned)table_len);
+    free(table_values);
+    LLVMValueRef table = LLVMAddGlobal(g->module, LLVMTypeOf(table_init), "");
+    LLVMSetInitializer(table, table_init);
+    LLVMSetLinkage(table, LLVMPrivateLinkage);
+    LLVMSetGlobalConstant(table, true);
+    LLVMSetUnnamedAddr(table, true);
+
+    // Subtracting the smallest case wraps every value outside of the table
+    // above its length, whether the switch type is signed or not.
+    LLVMBasicBlockRef table_block = LLVMAppendBasicBlock(g->cur_fn_val, "SwitchTable");
+    LLVMValueRef index = LLVMBuildSub(g->builder, target_value, cases[0].value, "");
+    LLVMValueRef in_table = LLVMBuildICmp(g->builder, LLVMIntULT, index,
+            LLVMConstInt(target_type_ref, table_len, false), "");
+    LLVMBuildCondBr(g->builder, in_table, table_block, else_block);
+
+    LLVMPositionBuilderAtEnd(g->builder, table_block);
+    LLVMTypeRef usize_type_ref = g->builtin_types.entry_usize->type_ref;
+    LLVMValueRef indices[] = {
+        LLVMConstNull(usize_type_ref),
+        (LLVMGetIntTypeWidth(target_type_ref) < LLVMGetIntTypeWidth(usize_type_ref)) ?
+            LLVMBuildZExt(g->builder, index, usize_type_ref, "") : index,
+    };
+    LLVMValueRef address_ptr = LLVMBuildInBoundsGEP(g->builder, table, indices, 2, "");
+    LLVMValueRef address = LLVMBuildLoad(g->builder, address_ptr, "");
+    LLVMValueRef indirect_br = LLVMBuildIndirectBr(g->builder, address, (unsigned)(case_count + 1));
+    LLVMAddDestination(indirect_br, else_block);
+    for (size_t i = 0; i < case_count; i += 1) {
+        LLVMAddDestination(indirect_br, cases[i].block);
+    }
+}
+
+static void gen_switch_binary_search(CodeGen *g, LLVMValueRef target_value, bool is_signed,
+        LLVMBasicBlockRef else_block, SwitchLoweringCase *cases, size_t case_count)
+{
+    if (case_count <= switch_binary_search_leaf_cases) {
+        for (size_t i = 0; i < case_count; i += 1) {
+            LLVMValueRef is_case = LLVMBuildICmp(g->builder, LLVMIntEQ, target_value, cases[i].value, "");
+            if (i + 1 == case_count) {
+                LLVMBuildCondBr(g->builder, is_case, cases[i].block, else_block);
+            } else {
+                LLVMBasicBlockRef next_block = LLVMAppendBasicBlock(g->cur_fn_val, "SwitchCompare");
+                LLVMBuildCondBr(g->builder, is_case, cases[i].block, next_block);
+                LLVMPositionBuilderAtEnd(g->builder, next_block);
+            }
+        }
+        return;
+    }
+
+    size_t pivot = case_count / 2;
+    LLVMBasicBlockRef low_block = LLVMAppendBasicBlock(g->cur_fn_val, "SwitchLow");
+    LLVMBasicBlockRef high_block = LLVMAppendBasicBlock(g->cur_fn_val, "SwitchHigh");
+    LLVMValueRef is_low = LLVMBuildICmp(g->builder, is_signed ? LLVMIntSLT : LLVMIntULT,
+            target_value, cases[pivot].value, "");
+    LLVMBuildCondBr(g->builder, is_low, low_block, high_block);
+
+    LLVMPositionBuilderAtEnd(g->builder, low_block);
+    gen_switch_binary_search(g, target_value, is_signed, else_block, cases, pivot);
+    LLVMPositionBuilderAtEnd(g->builder, high_block);
+    gen_switch_binary_search(g, target_value, is_signed, else_block, cases + pivot, case_count - pivot);
+}
+
+static void report_switch_lowering(IrInstructionSwitchBr *instruction, SwitchLowering lowering) {
+    AstNode *source_node = instruction->base.source_node;
+    fprintf(stderr, "%s:%" ZIG_PRI_usize ":%" ZIG_PRI_usize ": switch with %" ZIG_PRI_usize " cases: %s\n",
+            buf_ptr(source_node->owner->path), source_node->line + 1, source_node->column + 1,
+            instruction->case_count, switch_lowering_name(lowering));
+}
+
 static LLVMValueRef ir_render_switch_br(CodeGen *g, IrExecutable *executable, IrInstructionSwitchBr *instruction) {
     LLVMValueRef target_value = ir_llvm_value(g, instruction->target_value);
     LLVMBasicBlockRef else_block = instruction->else_block->llvm_block;
-    LLVMValueRef switch_instr = LLVMBuildSwitch(g->builder, target_value, else_block,
-            (unsigned)instruction->case_count);
-    for (size_t i = 0; i < instruction->case_count; i += 1) {
-        IrInstructionSwitchBrCase *this_case = &instruction->cases[i];
-        LLVMAddCase(switch_instr, ir_llvm_value(g, this_case->value), this_case->block->llvm_block);
+
+    SwitchLoweringCase *cases = allocate<SwitchLoweringCase>(instruction->case_count);
+    SwitchLowering lowering = choose_switch_lowering(g, instruction, target_value, cases);
+    if (g->report_switch_lowering)
+        report_switch_lowering(instruction, lowering);
+
+    // The dispatch may add blocks, but none of them branch to a block with a
+    // phi, so the block this instruction started in stays the exit block.
+    LLVMBasicBlockRef start_block = LLVMGetInsertBlock(g->builder);
+    switch (lowering) {
+        case SwitchLoweringLlvm:
+            {
+                LLVMValueRef switch_instr = LLVMBuildSwitch(g->builder, target_value, else_block,
+                        (unsigned)instruction->case_count);
+                for (size_t i = 0; i < instruction->case_count; i += 1) {
+                    IrInstructionSwitchBrCase *this_case = &instruction->cases[i];
+                    LLVMAddCase(switch_instr, ir_llvm_value(g, this_case->value), this_case->block->llvm_block);
+                }
+                break;
+            }
+        case SwitchLoweringJumpTable:
+            gen_switch_jump_table(g, target_value, else_block, cases, instruction->case_count);
+            break;
+        case SwitchLoweringBinarySearch:
+            {
+                TypeTableEntry *target_type = instruction->target_value->value.type;
+                bool is_signed = (target_type->id == TypeTableEntryIdInt && target_type->data.integral.is_signed);
+                gen_switch_binary_search(g, target_value, is_signed, else_block, cases, instruction->case_count);
+                break;
+            }
     }
+    LLVMPositionBuilderAtEnd(g->builder, start_block);
+    free(cases);
     return nullptr;
 }
 
@@ -2572,6 +3125,50 @@ static LLVMValueRef ir_render_fence(CodeGen *g, IrExecutable *executable, IrInst
     return nullptr;
 }
 
+static LLVMAtomicRMWBinOp to_LLVMAtomicRMWBinOp(AtomicRmwOp op, bool is_signed) {
+    switch (op) {
+        case AtomicRmwOpXchg: return LLVMAtomicRMWBinOpXchg;
+        case AtomicRmwOpAdd: return LLVMAtomicRMWBinOpAdd;
+        case AtomicRmwOpSub: return LLVMAtomicRMWBinOpSub;
+        case AtomicRmwOpAnd: return LLVMAtomicRMWBinOpAnd;
+        case AtomicRmwOpOr: return LLVMAtomicRMWBinOpOr;
+        case AtomicRmwOpXor: return LLVMAtomicRMWBinOpXor;
+        case AtomicRmwOpMax: return is_signed ? LLVMAtomicRMWBinOpMax : LLVMAtomicRMWBinOpUMax;
+        case AtomicRmwOpMin: return is_signed ? LLVMAtomicRMWBinOpMin : LLVMAtomicRMWBinOpUMin;
+    }
+    zig_unreachable();
+}
+
+static LLVMValueRef ir_render_atomic_rmw(CodeGen *g, IrExecutable *executable, IrInstructionAtomicRmw *instruction) {
+    TypeTableEntry *operand_type = instruction->base.value.type;
+    assert(operand_type->id == TypeTableEntryIdInt);
+    LLVMAtomicRMWBinOp op = to_LLVMAtomicRMWBinOp(instruction->op, operand_type->data.integral.is_signed);
+    LLVMAtomicOrdering atomic_order = to_LLVMAtomicOrdering(instruction->order);
+    LLVMValueRef ptr = ir_llvm_value(g, instruction->ptr);
+    LLVMValueRef operand = ir_llvm_value(g, instruction->operand);
+    return LLVMBuildAtomicRMW(g->builder, op, ptr, operand, atomic_order, false);
+}
+
+// Atomic loads and stores must state their alignment.
+static LLVMValueRef ir_render_atomic_load(CodeGen *g, IrExecutable *executable, IrInstructionAtomicLoad *instruction) {
+    TypeTableEntry *operand_type = instruction->base.value.type;
+    LLVMValueRef ptr = ir_llvm_value(g, instruction->ptr);
+    LLVMValueRef load_inst = LLVMBuildLoad(g->builder, ptr, "");
+    LLVMSetOrdering(load_inst, to_LLVMAtomicOrdering(instruction->order));
+    LLVMSetAlignment(load_inst, get_type_alignment(g, operand_type));
+    return load_inst;
+}
+
+static LLVMValueRef ir_render_atomic_store(CodeGen *g, IrExecutable *executable, IrInstructionAtomicStore *instruction) {
+    TypeTableEntry *operand_type = instruction->value->value.type;
+    LLVMValueRef ptr = ir_llvm_value(g, instruction->ptr);
+    LLVMValueRef value = ir_llvm_value(g, instruction->value);
+    LLVMValueRef store_inst = LLVMBuildStore(g->builder, value, ptr);
+    LLVMSetOrdering(store_inst, to_LLVMAtomicOrdering(instruction->order));
+    LLVMSetAlignment(store_inst, get_type_alignment(g, operand_type));
+    return nullptr;
+}
+
 static LLVMValueRef ir_render_truncate(CodeGen *g, IrExecutable *executable, IrInstructionTruncate *instruction) {
     LLVMValueRef target_val = ir_llvm_value(g, instruction->target);
     TypeTableEntry *dest_type = instruction->base.value.type;
@@ -3067,6 +3664,137 @@ static LLVMValueRef ir_render_panic(CodeGen *g, IrExecutable *executable, IrInst
     return nullptr;
 }
 
+static LLVMValueRef ir_render_splat(CodeGen *g, IrExecutable *executable, IrInstructionSplat *instruction) {
+    TypeTableEntry *vector_type = instruction->base.value.type;
+    uint32_t len = vector_type->data.vector.len;
+    LLVMValueRef scalar = ir_llvm_value(g, instruction->scalar);
+    LLVMTypeRef i32_type_ref = LLVMInt32Type();
+    LLVMValueRef one_elem = LLVMBuildInsertElement(g->builder,
+            LLVMGetUndef(LLVMVectorType(LLVMTypeOf(scalar), 1)), scalar, LLVMConstNull(i32_type_ref), "");
+    LLVMValueRef zero_mask = LLVMConstNull(LLVMVectorType(i32_type_ref, len));
+    return LLVMBuildShuffleVector(g->builder, one_elem, LLVMGetUndef(LLVMTypeOf(one_elem)), zero_mask, "");
+}
+
+static LLVMValueRef ir_render_shuffle(CodeGen *g, IrExecutable *executable, IrInstructionShuffle *instruction) {
+    LLVMValueRef a = ir_llvm_value(g, instruction->a);
+    LLVMValueRef b = ir_llvm_value(g, instruction->b);
+    uint32_t operand_len = instruction->a->value.type->data.vector.len;
+
+    // LLVM numbers the elements of b after the elements of a
+    LLVMTypeRef i32_type_ref = LLVMInt32Type();
+    LLVMValueRef *mask_elems = allocate<LLVMValueRef>(instruction->mask_len);
+    for (uint32_t i = 0; i < instruction->mask_len; i += 1) {
+        int32_t mask_index = instruction->mask_indexes[i];
+        uint32_t llvm_index = (mask_index >= 0) ? (uint32_t)mask_index : ~(uint32_t)mask_index + operand_len;
+        mask_elems[i] = LLVMConstInt(i32_type_ref, llvm_index, false);
+    }
+    LLVMValueRef mask = LLVMConstVector(mask_elems, instruction->mask_len);
+    return LLVMBuildShuffleVector(g->builder, a, b, mask, "");
+}
+
+static LLVMValueRef ir_render_extract_element(CodeGen *g, IrExecutable *executable,
+        IrInstructionExtractElement *instruction)
+{
+    LLVMValueRef vector = ir_llvm_value(g, instruction->vector);
+    LLVMValueRef index = ir_llvm_value(g, instruction->index);
+    return LLVMBuildExtractElement(g->builder, vector, index, "");
+}
+
+static LLVMValueRef ir_render_insert_element(CodeGen *g, IrExecutable *executable,
+        IrInstructionInsertElement *instruction)
+{
+    LLVMValueRef vector = ir_llvm_value(g, instruction->vector);
+    LLVMValueRef index = ir_llvm_value(g, instruction->index);
+    LLVMValueRef value = ir_llvm_value(g, instruction->value);
+    return LLVMBuildInsertElement(g->builder, vector, value, index, "");
+}
+
+// Combines two scalars or two vectors of elem_type, elementwise.
+static LLVMValueRef gen_reduce_step(CodeGen *g, ReduceOp op, TypeTableEntry *elem_type,
+        LLVMValueRef val1, LLVMValueRef val2)
+{
+    bool is_float = (elem_type->id == TypeTableEntryIdFloat);
+    bool is_signed = (elem_type->id == TypeTableEntryIdInt && elem_type->data.integral.is_signed);
+    switch (op) {
+        case ReduceOpAdd:
+            if (is_float) {
+                return LLVMBuildFAdd(g->builder, val1, val2, "");
+            } else {
+                return LLVMBuildAdd(g->builder, val1, val2, "");
+            }
+        case ReduceOpMul:
+            if (is_float) {
+                return LLVMBuildFMul(g->builder, val1, val2, "");
+            } else {
+                return LLVMBuildMul(g->builder, val1, val2, "");
+            }
+        case ReduceOpAnd:
+            return LLVMBuildAnd(g->builder, val1, val2, "");
+        case ReduceOpOr:
+            return LLVMBuildOr(g->builder, val1, val2, "");
+        case ReduceOpXor:
+            return LLVMBuildXor(g->builder, val1, val2, "");
+        case ReduceOpMin:
+        case ReduceOpMax:
+            {
+                bool is_min = (op == ReduceOpMin);
+                LLVMValueRef pick_first;
+                if (is_float) {
+                    pick_first = LLVMBuildFCmp(g->builder, is_min ? LLVMRealOLT : LLVMRealOGT, val1, val2, "");
+                } else if (is_signed) {
+                    pick_first = LLVMBuildICmp(g->builder, is_min ? LLVMIntSLT : LLVMIntSGT, val1, val2, "");
+                } else {
+                    pick_first = LLVMBuildICmp(g->builder, is_min ? LLVMIntULT : LLVMIntUGT, val1, val2, "");
+                }
+                return LLVMBuildSelect(g->builder, pick_first, val1, val2, "");
+            }
+    }
+    zig_unreachable();
+}
+
+static LLVMValueRef gen_shuffle_range(CodeGen *g, LLVMValueRef vector, uint32_t start, uint32_t len) {
+    LLVMTypeRef i32_type_ref = LLVMInt32Type();
+    LLVMValueRef *mask_elems = allocate<LLVMValueRef>(len);
+    for (uint32_t i = 0; i < len; i += 1) {
+        mask_elems[i] = LLVMConstInt(i32_type_ref, start + i, false);
+    }
+    LLVMValueRef mask = LLVMConstVector(mask_elems, len);
+    return LLVMBuildShuffleVector(g->builder, vector, LLVMGetUndef(LLVMTypeOf(vector)), mask, "");
+}
+
+// LLVM 4 has no reduction intrinsics. A vector with a power of two length is
+// folded in half until one element is left, which the backend turns into a
+// few shuffles and vector operations; other lengths combine one element at a
+// time.
+static LLVMValueRef ir_render_reduce(CodeGen *g, IrExecutable *executable, IrInstructionReduce *instruction) {
+    TypeTableEntry *vector_type = instruction->vector->value.type;
+    TypeTableEntry *elem_type = vector_type->data.vector.elem_type;
+    uint32_t len = vector_type->data.vector.len;
+    LLVMValueRef vector = ir_llvm_value(g, instruction->vector);
+    LLVMTypeRef i32_type_ref = LLVMInt32Type();
+
+    if (elem_type->id == TypeTableEntryIdFloat)
+        ZigLLVMSetFastMath(g->builder, ir_want_fast_math(g, &instruction->base));
+
+    if ((len & (len - 1)) == 0) {
+        while (len > 1) {
+            uint32_t half = len / 2;
+            LLVMValueRef low = gen_shuffle_range(g, vector, 0, half);
+            LLVMValueRef high = gen_shuffle_range(g, vector, half, half);
+            vector = gen_reduce_step(g, instruction->op, elem_type, low, high);
+            len = half;
+        }
+        return LLVMBuildExtractElement(g->builder, vector, LLVMConstNull(i32_type_ref), "");
+    }
+
+    LLVMValueRef result = LLVMBuildExtractElement(g->builder, vector, LLVMConstNull(i32_type_ref), "");
+    for (uint32_t i = 1; i < len; i += 1) {
+        LLVMValueRef elem = LLVMBuildExtractElement(g->builder, vector, LLVMConstInt(i32_type_ref, i, false), "");
+        result = gen_reduce_step(g, instruction->op, elem_type, result, elem);
+    }
+    return result;
+}
+
 static void set_debug_location(CodeGen *g, IrInstruction *instruction) {
     AstNode *source_node = instruction->source_node;
     Scope *scope = instruction->scope;
@@ -3122,6 +3850,7 @@ static LLVMValueRef ir_render_instruction(CodeGen *g, IrExecutable *executable,
         case IrInstructionIdSwitchVar:
         case IrInstructionIdOffsetOf:
         case IrInstructionIdTypeId:
+        case IrInstructionIdVectorType:
             zig_unreachable();
         case IrInstructionIdReturn:
             return ir_render_return(g, executable, (IrInstructionReturn *)instruction);
@@ -3175,6 +3904,12 @@ static LLVMValueRef ir_render_instruction(CodeGen *g, IrExecutable *executable,
             return ir_render_cmpxchg(g, executable, (IrInstructionCmpxchg *)instruction);
         case IrInstructionIdFence:
             return ir_render_fence(g, executable, (IrInstructionFence *)instruction);
+        case IrInstructionIdAtomicRmw:
+            return ir_render_atomic_rmw(g, executable, (IrInstructionAtomicRmw *)instruction);
+        case IrInstructionIdAtomicLoad:
+            return ir_render_atomic_load(g, executable, (IrInstructionAtomicLoad *)instruction);
+        case IrInstructionIdAtomicStore:
+            return ir_render_atomic_store(g, executable, (IrInstructionAtomicStore *)instruction);
         case IrInstructionIdTruncate:
             return ir_render_truncate(g, executable, (IrInstructionTruncate *)instruction);
         case IrInstructionIdBoolNot:
@@ -3215,6 +3950,16 @@ static LLVMValueRef ir_render_instruction(CodeGen *g, IrExecutable *executable,
             return ir_render_ptr_cast(g, executable, (IrInstructionPtrCast *)instruction);
         case IrInstructionIdBitCast:
             return ir_render_bit_cast(g, executable, (IrInstructionBitCast *)instruction);
+        case IrInstructionIdSplat:
+            return ir_render_splat(g, executable, (IrInstructionSplat *)instruction);
+        case IrInstructionIdShuffle:
+            return ir_render_shuffle(g, executable, (IrInstructionShuffle *)instruction);
+        case IrInstructionIdExtractElement:
+            return ir_render_extract_element(g, executable, (IrInstructionExtractElement *)instruction);
+        case IrInstructionIdInsertElement:
+            return ir_render_insert_element(g, executable, (IrInstructionInsertElement *)instruction);
+        case IrInstructionIdReduce:
+            return ir_render_reduce(g, executable, (IrInstructionReduce *)instruction);
         case IrInstructionIdWidenOrShorten:
             return ir_render_widen_or_shorten(g, executable, (IrInstructionWidenOrShorten *)instruction);
         case IrInstructionIdPtrToInt:
@@ -3278,7 +4023,8 @@ static LLVMValueRef gen_parent_ptr(CodeGen *g, ConstExprValue *val, ConstParent
 }
 
 static LLVMValueRef gen_const_ptr_array_recursive(CodeGen *g, ConstExprValue *array_const_val, size_t index) {
-    expand_undef_array(g, array_const_val);
+    if (array_const_val->data.x_array.special != ConstArraySpecialBuf)
+        expand_undef_array(g, array_const_val);
     ConstParent *parent = &array_const_val->data.x_array.s_none.parent;
     LLVMValueRef base_ptr = gen_parent_ptr(g, array_const_val, parent);
 
@@ -3333,6 +4079,7 @@ static LLVMValueRef pack_const_int(CodeGen *g, LLVMTypeRef big_int_type_ref, Con
         case TypeTableEntryIdArgTuple:
         case TypeTableEntryIdVoid:
         case TypeTableEntryIdOpaque:
+        case TypeTableEntryIdVector:
             zig_unreachable();
         case TypeTableEntryIdBool:
             return LLVMConstInt(big_int_type_ref, const_val->data.x_bool ? 1 : 0, false);
@@ -3505,6 +4252,10 @@ static LLVMValueRef gen_const_val(CodeGen *g, ConstExprValue *const_val) {
                 if (const_val->data.x_array.special == ConstArraySpecialUndef) {
                     return LLVMGetUndef(type_entry->type_ref);
                 }
+                if (const_val->data.x_array.special == ConstArraySpecialBuf) {
+                    Buf *buf = const_val->data.x_array.s_buf;
+                    return LLVMConstString(buf_ptr(buf), (unsigned)buf_len(buf), true);
+                }
 
                 LLVMValueRef *values = allocate<LLVMValueRef>(len);
                 for (uint64_t i = 0; i < len; i += 1) {
@@ -3513,6 +4264,15 @@ static LLVMValueRef gen_const_val(CodeGen *g, ConstExprValue *const_val) {
                 }
                 return LLVMConstArray(LLVMTypeOf(values[0]), values, (unsigned)len);
             }
+        case TypeTableEntryIdVector:
+            {
+                uint32_t len = type_entry->data.vector.len;
+                LLVMValueRef *values = allocate<LLVMValueRef>(len);
+                for (uint32_t i = 0; i < len; i += 1) {
+                    values[i] = gen_const_val(g, &const_val->data.x_array.s_none.elements[i]);
+                }
+                return LLVMConstVector(values, len);
+            }
         case TypeTableEntryIdEnum:
             {
                 LLVMTypeRef tag_type_ref = type_entry->data.enumeration.tag_type->type_ref;
@@ -3669,7 +4429,7 @@ static LLVMValueRef gen_const_val(CodeGen *g, ConstExprValue *const_val) {
 
 static void render_const_val(CodeGen *g, ConstExprValue *const_val) {
     if (!const_val->global_refs)
-        const_val->global_refs = allocate<ConstGlobalRefs>(1);
+        const_val->global_refs = arena_allocate<ConstGlobalRefs>(&g->const_arena, 1);
     if (!const_val->global_refs->llvm_value)
         const_val->global_refs->llvm_value = gen_const_val(g, const_val);
 
@@ -3677,9 +4437,71 @@ static void render_const_val(CodeGen *g, ConstExprValue *const_val) {
         LLVMSetInitializer(const_val->global_refs->llvm_global, const_val->global_refs->llvm_value);
 }
 
+// const_values_equal compares floats by value, so -0.0 and 0.0 are equal.
+// Values of these types could share a global with a constant whose bits differ.
+static bool type_has_float_bits(TypeTableEntry *type_entry) {
+    switch (type_entry->id) {
+        case TypeTableEntryIdFloat:
+            return true;
+        case TypeTableEntryIdArray:
+            return type_has_float_bits(type_entry->data.array.child_type);
+        case TypeTableEntryIdStruct:
+            for (size_t i = 0; i < type_entry->data.structure.src_field_count; i += 1) {
+                if (type_has_float_bits(type_entry->data.structure.fields[i].type_entry))
+                    return true;
+            }
+            return false;
+        case TypeTableEntryIdEnum:
+            for (size_t i = 0; i < type_entry->data.enumeration.src_field_count; i += 1) {
+                if (type_has_float_bits(type_entry->data.enumeration.fields[i].type_entry))
+                    return true;
+            }
+            return false;
+        case TypeTableEntryIdMaybe:
+            return type_has_float_bits(type_entry->data.maybe.child_type);
+        case TypeTableEntryIdErrorUnion:
+            return type_has_float_bits(type_entry->data.error.child_type);
+        default:
+            return false;
+    }
+}
+
+static bool is_const_val_poolable(CodeGen *g, ConstExprValue *const_val) {
+    if (const_val->special != ConstValSpecialStatic)
+        return false;
+    if (type_has_float_bits(const_val->type))
+        return false;
+    switch (const_val->type->id) {
+        case TypeTableEntryIdArray:
+        case TypeTableEntryIdStruct:
+        case TypeTableEntryIdEnum:
+        case TypeTableEntryIdMaybe:
+        case TypeTableEntryIdErrorUnion:
+        case TypeTableEntryIdPointer:
+        case TypeTableEntryIdInt:
+        case TypeTableEntryIdBool:
+            break;
+        default:
+            return false;
+    }
+    return g->global_var_values.maybe_get(const_val) == nullptr;
+}
+
 static void render_const_val_global(CodeGen *g, ConstExprValue *const_val, const char *name) {
     if (!const_val->global_refs)
-        const_val->global_refs = allocate<ConstGlobalRefs>(1);
+        const_val->global_refs = arena_allocate<ConstGlobalRefs>(&g->const_arena, 1);
+
+    bool poolable = !const_val->global_refs->llvm_global && name[0] == 0 && is_const_val_poolable(g, const_val);
+    if (poolable) {
+        auto entry = g->const_global_pool.maybe_get(const_val);
+        if (entry) {
+            ConstGlobalRefs *pooled_refs = entry->value;
+            const_val->global_refs->llvm_global = pooled_refs->llvm_global;
+            if (!const_val->global_refs->llvm_value)
+                const_val->global_refs->llvm_value = pooled_refs->llvm_value;
+            g->const_globals_pooled_count += 1;
+        }
+    }
 
     if (!const_val->global_refs->llvm_global) {
         LLVMTypeRef type_ref = const_val->global_refs->llvm_value ? LLVMTypeOf(const_val->global_refs->llvm_value) : const_val->type->type_ref;
@@ -3690,6 +4512,8 @@ static void render_const_val_global(CodeGen *g, ConstExprValue *const_val, const
         LLVMSetAlignment(global_value, get_type_alignment(g, const_val->type));
 
         const_val->global_refs->llvm_global = global_value;
+        if (poolable)
+            g->const_global_pool.put(const_val, const_val->global_refs);
     }
 
     if (const_val->global_refs->llvm_value)
@@ -3817,8 +4641,8 @@ static void gen_global_var(CodeGen *g, VariableTableEntry *var, LLVMValueRef ini
     assert(import);
 
     bool is_local_to_unit = true;
-    ZigLLVMCreateGlobalVariable(g->dbuilder, get_di_scope(g, var->parent_scope), buf_ptr(&var->name),
-        buf_ptr(&var->name), import->di_file,
+    ZigLLVMCreateGlobalVariable(g->dbuilder, get_di_scope(g, var->parent_scope), buf_ptr(var->name),
+        buf_ptr(var->name), import->di_file,
         (unsigned)(var->decl_node->line + 1),
         type_entry->di_type, is_local_to_unit);
     // TODO ^^ make an actual global variable
@@ -3858,6 +4682,16 @@ static void validate_inline_fns(CodeGen *g) {
     report_errors_and_maybe_exit(g);
 }
 
+static void time_llvm_passes(void *context, const char *fn_name, bool is_begin) {
+    CodeGen *g = reinterpret_cast<CodeGen *>(context);
+    if (is_begin) {
+        Buf *name = fn_name ? buf_create_from_str(fn_name) : buf_create_from_str("(module passes and emit)");
+        profile_begin(g, ProfileCategoryLLVMPasses, name, nullptr);
+    } else {
+        profile_end(g, g->profile_stack.last());
+    }
+}
+
 static void do_code_gen(CodeGen *g) {
     if (g->verbose) {
         fprintf(stderr, "\nCode Generation:\n");
@@ -3871,6 +4705,12 @@ static void do_code_gen(CodeGen *g) {
     generate_error_name_table(g);
     generate_enum_name_tables(g);
 
+    // a pointer to a global variable may be rendered before the variable itself,
+    // so mark them all before any constant global can be shared
+    for (size_t i = 0; i < g->global_vars.length; i += 1) {
+        g->global_var_values.put(g->global_vars.at(i)->var->value, true);
+    }
+
     // Generate module level variables
     for (size_t i = 0; i < g->global_vars.length; i += 1) {
         TldVar *tld_var = g->global_vars.at(i);
@@ -3904,7 +4744,7 @@ static void do_code_gen(CodeGen *g) {
 
         LLVMValueRef global_value;
         if (var->linkage == VarLinkageExternal) {
-            global_value = LLVMAddGlobal(g->module, var->value->type->type_ref, buf_ptr(&var->name));
+            global_value = LLVMAddGlobal(g->module, var->value->type->type_ref, buf_ptr(var->name));
 
             // TODO debug info for the extern variable
 
@@ -3912,7 +4752,7 @@ static void do_code_gen(CodeGen *g) {
         } else {
             bool exported = (var->linkage == VarLinkageExport);
             render_const_val(g, var->value);
-            render_const_val_global(g, var->value, buf_ptr(get_mangled_name(g, &var->name, exported)));
+            render_const_val_global(g, var->value, buf_ptr(get_mangled_name(g, var->name, exported)));
             global_value = var->value->global_refs->llvm_global;
 
             if (exported) {
@@ -4060,10 +4900,10 @@ static void do_code_gen(CodeGen *g) {
                 continue;
 
             if (var->src_arg_index == SIZE_MAX) {
-                var->value_ref = build_alloca(g, var->value->type, buf_ptr(&var->name));
+                var->value_ref = build_alloca(g, var->value->type, buf_ptr(var->name));
 
                 var->di_loc_var = ZigLLVMCreateAutoVariable(g->dbuilder, get_di_scope(g, var->parent_scope),
-                        buf_ptr(&var->name), import->di_file, (unsigned)(var->decl_node->line + 1),
+                        buf_ptr(var->name), import->di_file, (unsigned)(var->decl_node->line + 1),
                         var->value->type->di_type, !g->strip_debug_symbols, 0);
 
             } else {
@@ -4080,11 +4920,11 @@ static void do_code_gen(CodeGen *g) {
                     var->value_ref = LLVMGetParam(fn, (unsigned)var->gen_arg_index);
                 } else {
                     gen_type = var->value->type;
-                    var->value_ref = build_alloca(g, var->value->type, buf_ptr(&var->name));
+                    var->value_ref = build_alloca(g, var->value->type, buf_ptr(var->name));
                 }
                 if (var->decl_node) {
                     var->di_loc_var = ZigLLVMCreateParameterVariable(g->dbuilder, get_di_scope(g, var->parent_scope),
-                            buf_ptr(&var->name), import->di_file,
+                            buf_ptr(var->name), import->di_file,
                             (unsigned)(var->decl_node->line + 1),
                             gen_type->di_type, !g->strip_debug_symbols, 0, (unsigned)(var->gen_arg_index + 1));
                 }
@@ -4119,8 +4959,10 @@ static void do_code_gen(CodeGen *g) {
             }
         }
 
+        size_t llvm_gen_span = profile_begin(g, ProfileCategoryLLVMGen, &fn_table_entry->symbol_name,
+                fn_table_entry->body_node);
         ir_render(g, fn_table_entry);
-
+        profile_end(g, llvm_gen_span);
     }
     assert(!g->errors.length);
 
@@ -4144,14 +4986,48 @@ static void do_code_gen(CodeGen *g) {
     codegen_add_time_event(g, "LLVM Emit Object");
 
     char *err_msg = nullptr;
-    Buf *o_basename = buf_create_from_buf(g->root_out_name);
     const char *o_ext = target_o_file_ext(&g->zig_target);
+    ensure_cache_dir(g);
+
+    // the same file name llvm's own runtime defaults to
+    const char *pgo_gen_path = g->profile_generate ? "default.profraw" : nullptr;
+    const char *pgo_use_path = g->profile_use_path ? buf_ptr(g->profile_use_path) : nullptr;
+
+    // an object build must produce exactly one object file, so it is never split.
+    // with LTO the linker does the splitting, see construct_linker_job_elf
+    if (g->codegen_threads > 1 && g->out_type != OutTypeObj && g->lto == ZigLLVMLtoModeNone) {
+        ZigList<Buf *> output_paths = {0};
+        ZigList<const char *> output_path_ptrs = {0};
+        for (size_t i = 0; i < g->codegen_threads; i += 1) {
+            Buf *o_basename = buf_sprintf("%s.%" ZIG_PRI_usize "%s", buf_ptr(g->root_out_name), i, o_ext);
+            Buf *output_path = buf_alloc();
+            os_path_join(g->cache_dir, o_basename, output_path);
+            output_paths.append(output_path);
+            output_path_ptrs.append(buf_ptr(output_path));
+        }
+        if (ZigLLVMTargetMachineEmitToFiles(g->target_machine, g->module, output_path_ptrs.items,
+                    (unsigned)output_path_ptrs.length, &err_msg, g->build_mode == BuildModeDebug,
+                    get_llvm_size_level(g), pgo_gen_path, pgo_use_path))
+        {
+            zig_panic("unable to write object file: %s", err_msg);
+        }
+
+        validate_inline_fns(g);
+
+        for (size_t i = 0; i < output_paths.length; i += 1) {
+            g->link_objects.append(output_paths.at(i));
+        }
+        return;
+    }
+
+    Buf *o_basename = buf_create_from_buf(g->root_out_name);
     buf_append_str(o_basename, o_ext);
     Buf *output_path = buf_alloc();
     os_path_join(g->cache_dir, o_basename, output_path);
-    ensure_cache_dir(g);
     if (ZigLLVMTargetMachineEmitToFile(g->target_machine, g->module, buf_ptr(output_path),
-                LLVMObjectFile, &err_msg, g->build_mode == BuildModeDebug))
+                LLVMObjectFile, &err_msg, g->build_mode == BuildModeDebug, get_llvm_size_level(g), g->lto,
+                pgo_gen_path, pgo_use_path,
+                g->timing_info ? time_llvm_passes : nullptr, g))
     {
         zig_panic("unable to write object file: %s", err_msg);
     }
@@ -4259,7 +5135,7 @@ static void define_builtin_types(CodeGen *g) {
         for (size_t is_sign_i = 0; is_sign_i < array_length(is_signed_list); is_sign_i += 1) {
             bool is_signed = is_signed_list[is_sign_i];
             TypeTableEntry *entry = make_int_type(g, is_signed, size_in_bits);
-            g->primitive_type_table.put(&entry->name, entry);
+            g->primitive_type_table.put(buf_intern(&entry->name), entry);
             get_int_type_ptr(g, is_signed, size_in_bits)[0] = entry;
         }
     }
@@ -4280,7 +5156,7 @@ static void define_builtin_types(CodeGen *g) {
                 is_signed ? ZigLLVMEncoding_DW_ATE_signed() : ZigLLVMEncoding_DW_ATE_unsigned());
         entry->data.integral.is_signed = is_signed;
         entry->data.integral.bit_count = size_in_bits;
-        g->primitive_type_table.put(&entry->name, entry);
+        g->primitive_type_table.put(buf_intern(&entry->name), entry);
 
         get_c_int_type_ptr(g, info->id)[0] = entry;
     }
@@ -4294,7 +5170,7 @@ static void define_builtin_types(CodeGen *g) {
                 debug_size_in_bits,
                 ZigLLVMEncoding_DW_ATE_boolean());
         g->builtin_types.entry_bool = entry;
-        g->primitive_type_table.put(&entry->name, entry);
+        g->primitive_type_table.put(buf_intern(&entry->name), entry);
     }
 
     for (size_t sign_i = 0; sign_i < array_length(is_signed_list); sign_i += 1) {
@@ -4314,7 +5190,7 @@ static void define_builtin_types(CodeGen *g) {
         entry->di_type = ZigLLVMCreateDebugBasicType(g->dbuilder, buf_ptr(&entry->name),
                 debug_size_in_bits,
                 is_signed ? ZigLLVMEncoding_DW_ATE_signed() : ZigLLVMEncoding_DW_ATE_unsigned());
-        g->primitive_type_table.put(&entry->name, entry);
+        g->primitive_type_table.put(buf_intern(&entry->name), entry);
 
         if (is_signed) {
             g->builtin_types.entry_isize = entry;
@@ -4333,7 +5209,7 @@ static void define_builtin_types(CodeGen *g) {
                 debug_size_in_bits,
                 ZigLLVMEncoding_DW_ATE_float());
         g->builtin_types.entry_f32 = entry;
-        g->primitive_type_table.put(&entry->name, entry);
+        g->primitive_type_table.put(buf_intern(&entry->name), entry);
     }
     {
         TypeTableEntry *entry = new_type_table_entry(TypeTableEntryIdFloat);
@@ -4346,7 +5222,7 @@ static void define_builtin_types(CodeGen *g) {
                 debug_size_in_bits,
                 ZigLLVMEncoding_DW_ATE_float());
         g->builtin_types.entry_f64 = entry;
-        g->primitive_type_table.put(&entry->name, entry);
+        g->primitive_type_table.put(buf_intern(&entry->name), entry);
     }
     {
         TypeTableEntry *entry = new_type_table_entry(TypeTableEntryIdFloat);
@@ -4359,7 +5235,7 @@ static void define_builtin_types(CodeGen *g) {
                 debug_size_in_bits,
                 ZigLLVMEncoding_DW_ATE_float());
         g->builtin_types.entry_c_longdouble = entry;
-        g->primitive_type_table.put(&entry->name, entry);
+        g->primitive_type_table.put(buf_intern(&entry->name), entry);
     }
     {
         TypeTableEntry *entry = new_type_table_entry(TypeTableEntryIdVoid);
@@ -4370,7 +5246,7 @@ static void define_builtin_types(CodeGen *g) {
                 0,
                 ZigLLVMEncoding_DW_ATE_unsigned());
         g->builtin_types.entry_void = entry;
-        g->primitive_type_table.put(&entry->name, entry);
+        g->primitive_type_table.put(buf_intern(&entry->name), entry);
     }
     {
         TypeTableEntry *entry = new_type_table_entry(TypeTableEntryIdUnreachable);
@@ -4379,14 +5255,14 @@ static void define_builtin_types(CodeGen *g) {
         buf_init_from_str(&entry->name, "noreturn");
         entry->di_type = g->builtin_types.entry_void->di_type;
         g->builtin_types.entry_unreachable = entry;
-        g->primitive_type_table.put(&entry->name, entry);
+        g->primitive_type_table.put(buf_intern(&entry->name), entry);
     }
     {
         TypeTableEntry *entry = new_type_table_entry(TypeTableEntryIdMetaType);
         buf_init_from_str(&entry->name, "type");
         entry->zero_bits = true;
         g->builtin_types.entry_type = entry;
-        g->primitive_type_table.put(&entry->name, entry);
+        g->primitive_type_table.put(buf_intern(&entry->name), entry);
     }
 
     g->builtin_types.entry_u8 = get_int_type(g, false, 8);
@@ -4400,7 +5276,7 @@ static void define_builtin_types(CodeGen *g) {
 
     {
         g->builtin_types.entry_c_void = get_opaque_type(g, nullptr, nullptr, "c_void");
-        g->primitive_type_table.put(&g->builtin_types.entry_c_void->name, g->builtin_types.entry_c_void);
+        g->primitive_type_table.put(buf_intern(&g->builtin_types.entry_c_void->name), g->builtin_types.entry_c_void);
     }
 
     {
@@ -4415,7 +5291,7 @@ static void define_builtin_types(CodeGen *g) {
         entry->type_ref = g->err_tag_type->type_ref;
         entry->di_type = g->err_tag_type->di_type;
 
-        g->primitive_type_table.put(&entry->name, entry);
+        g->primitive_type_table.put(buf_intern(&entry->name), entry);
     }
 
 }
@@ -4426,7 +5302,7 @@ static BuiltinFnEntry *create_builtin_fn(CodeGen *g, BuiltinFnId id, const char
     buf_init_from_str(&builtin_fn->name, name);
     builtin_fn->id = id;
     builtin_fn->param_count = count;
-    g->builtin_fn_table.put(&builtin_fn->name, builtin_fn);
+    g->builtin_fn_table.put(buf_intern(&builtin_fn->name), builtin_fn);
     return builtin_fn;
 }
 
@@ -4529,6 +5405,9 @@ static void define_builtin_fns(CodeGen *g) {
     create_builtin_fn(g, BuiltinFnIdEmbedFile, "embedFile", 1);
     create_builtin_fn(g, BuiltinFnIdCmpExchange, "cmpxchg", 5);
     create_builtin_fn(g, BuiltinFnIdFence, "fence", 1);
+    create_builtin_fn(g, BuiltinFnIdAtomicRmw, "atomicRmw", 5);
+    create_builtin_fn(g, BuiltinFnIdAtomicLoad, "atomicLoad", 3);
+    create_builtin_fn(g, BuiltinFnIdAtomicStore, "atomicStore", 4);
     create_builtin_fn(g, BuiltinFnIdTruncate, "truncate", 2);
     create_builtin_fn(g, BuiltinFnIdCompileErr, "compileError", 1);
     create_builtin_fn(g, BuiltinFnIdCompileLog, "compileLog", SIZE_MAX);
@@ -4552,6 +5431,12 @@ static void define_builtin_fns(CodeGen *g) {
     create_builtin_fn(g, BuiltinFnIdMod, "mod", 2);
     create_builtin_fn(g, BuiltinFnIdInlineCall, "inlineCall", SIZE_MAX);
     create_builtin_fn(g, BuiltinFnIdTypeId, "typeId", 1);
+    create_builtin_fn(g, BuiltinFnIdVectorType, "Vector", 2);
+    create_builtin_fn(g, BuiltinFnIdSplat, "splat", 2);
+    create_builtin_fn(g, BuiltinFnIdShuffle, "shuffle", 4);
+    create_builtin_fn(g, BuiltinFnIdExtractElement, "extractElement", 2);
+    create_builtin_fn(g, BuiltinFnIdInsertElement, "insertElement", 3);
+    create_builtin_fn(g, BuiltinFnIdReduce, "reduce", 2);
 }
 
 static const char *bool_to_str(bool b) {
@@ -4563,6 +5448,7 @@ static const char *build_mode_to_str(BuildMode build_mode) {
         case BuildModeDebug: return "Mode.Debug";
         case BuildModeSafeRelease: return "Mode.ReleaseSafe";
         case BuildModeFastRelease: return "Mode.ReleaseFast";
+        case BuildModeSmallRelease: return "Mode.ReleaseSmall";
     }
     zig_unreachable();
 }
@@ -4675,12 +5561,34 @@ static void define_builtin_compile_vars(CodeGen *g) {
             "    SeqCst,\n"
             "};\n\n");
     }
+    {
+        buf_appendf(contents,
+            "pub const AtomicRmwOp = enum {\n"
+            "    Xchg,\n"
+            "    Add,\n"
+            "    Sub,\n"
+            "    And,\n"
+            "    Or,\n"
+            "    Xor,\n"
+            "    Max,\n"
+            "    Min,\n"
+            "};\n\n");
+        assert(AtomicRmwOpXchg == 0);
+        assert(AtomicRmwOpAdd == 1);
+        assert(AtomicRmwOpSub == 2);
+        assert(AtomicRmwOpAnd == 3);
+        assert(AtomicRmwOpOr == 4);
+        assert(AtomicRmwOpXor == 5);
+        assert(AtomicRmwOpMax == 6);
+        assert(AtomicRmwOpMin == 7);
+    }
     {
         buf_appendf(contents,
             "pub const Mode = enum {\n"
             "    Debug,\n"
             "    ReleaseSafe,\n"
             "    ReleaseFast,\n"
+            "    ReleaseSmall,\n"
             "};\n\n");
     }
     {
@@ -4701,6 +5609,25 @@ static void define_builtin_compile_vars(CodeGen *g) {
         assert(FloatModeOptimized == 0);
         assert(FloatModeStrict == 1);
     }
+    {
+        buf_appendf(contents,
+            "pub const ReduceOp = enum {\n"
+            "    Add,\n"
+            "    Mul,\n"
+            "    And,\n"
+            "    Or,\n"
+            "    Xor,\n"
+            "    Min,\n"
+            "    Max,\n"
+            "};\n\n");
+        assert(ReduceOpAdd == 0);
+        assert(ReduceOpMul == 1);
+        assert(ReduceOpAnd == 2);
+        assert(ReduceOpOr == 3);
+        assert(ReduceOpXor == 4);
+        assert(ReduceOpMin == 5);
+        assert(ReduceOpMax == 6);
+    }
     buf_appendf(contents, "pub const is_big_endian = %s;\n", bool_to_str(g->is_big_endian));
     buf_appendf(contents, "pub const is_test = %s;\n", bool_to_str(g->is_test_build));
     buf_appendf(contents, "pub const os = Os.%s;\n", cur_os);
@@ -4709,6 +5636,7 @@ static void define_builtin_compile_vars(CodeGen *g) {
     buf_appendf(contents, "pub const object_format = ObjectFormat.%s;\n", cur_obj_fmt);
     buf_appendf(contents, "pub const mode = %s;\n", build_mode_to_str(g->build_mode));
     buf_appendf(contents, "pub const link_libc = %s;\n", bool_to_str(g->libc_link_lib != nullptr));
+    buf_appendf(contents, "pub const profile_generate = %s;\n", bool_to_str(g->profile_generate));
 
     buf_appendf(contents, "pub const __zig_panic_implementation_provided = %s; // overwritten later\n",
             bool_to_str(false));
@@ -4750,7 +5678,19 @@ static void init(CodeGen *g) {
     }
 
     bool is_optimized = g->build_mode != BuildModeDebug;
-    LLVMCodeGenOptLevel opt_level = is_optimized ? LLVMCodeGenLevelAggressive : LLVMCodeGenLevelNone;
+    LLVMCodeGenOptLevel opt_level;
+    switch (g->build_mode) {
+        case BuildModeDebug:
+            opt_level = LLVMCodeGenLevelNone;
+            break;
+        case BuildModeSafeRelease:
+        case BuildModeFastRelease:
+            opt_level = LLVMCodeGenLevelAggressive;
+            break;
+        case BuildModeSmallRelease:
+            opt_level = LLVMCodeGenLevelDefault;
+            break;
+    }
 
     LLVMRelocMode reloc_mode = g->is_static ? LLVMRelocStatic : LLVMRelocPIC;
 
@@ -4855,7 +5795,7 @@ static ImportTableEntry *add_special_code(CodeGen *g, PackageTableEntry *package
         zig_panic("unable to open '%s': %s", buf_ptr(&path_to_code_src), err_str(err));
     }
     Buf *import_code = buf_alloc();
-    if ((err = os_fetch_file_path(abs_full_path, import_code))) {
+    if ((err = os_map_file_path(abs_full_path, import_code))) {
         zig_panic("unable to open '%s': %s", buf_ptr(&path_to_code_src), err_str(err));
     }
 
@@ -4893,10 +5833,10 @@ static void create_test_compile_var_and_add_test_runner(CodeGen *g) {
     TypeTableEntry *field_types[] = { str_type, fn_type, };
     TypeTableEntry *struct_type = get_struct_type(g, "ZigTestFn", field_names, field_types, 2);
 
-    ConstExprValue *test_fn_array = create_const_vals(1);
+    ConstExprValue *test_fn_array = create_const_vals(g, 1);
     test_fn_array->type = get_array_type(g, struct_type, g->test_fns.length);
     test_fn_array->special = ConstValSpecialStatic;
-    test_fn_array->data.x_array.s_none.elements = create_const_vals(g->test_fns.length);
+    test_fn_array->data.x_array.s_none.elements = create_const_vals(g, g->test_fns.length);
 
     for (size_t i = 0; i < g->test_fns.length; i += 1) {
         FnTableEntry *test_fn_entry = g->test_fns.at(i);
@@ -4907,7 +5847,7 @@ static void create_test_compile_var_and_add_test_runner(CodeGen *g) {
         this_val->data.x_struct.parent.id = ConstParentIdArray;
         this_val->data.x_struct.parent.data.p_array.array_val = test_fn_array;
         this_val->data.x_struct.parent.data.p_array.elem_index = i;
-        this_val->data.x_struct.fields = create_const_vals(2);
+        this_val->data.x_struct.fields = create_const_vals(g, 2);
 
         ConstExprValue *name_field = &this_val->data.x_struct.fields[0];
         ConstExprValue *name_array_val = create_const_str_lit(g, &test_fn_entry->symbol_name);
@@ -4942,7 +5882,7 @@ static void gen_root_source(CodeGen *g) {
     }
 
     Buf *source_code = buf_alloc();
-    if ((err = os_fetch_file_path(rel_full_path, source_code))) {
+    if ((err = os_map_file_path(rel_full_path, source_code))) {
         zig_panic("unable to open '%s': %s", buf_ptr(rel_full_path), err_str(err));
     }
 
@@ -4976,6 +5916,7 @@ static void gen_root_source(CodeGen *g) {
             semantic_analyze(g);
         }
     }
+    parse_scheduler_deinit(g);
 
     report_errors_and_maybe_exit(g);
     if (g->verbose) {
@@ -4996,10 +5937,24 @@ static void gen_global_asm(CodeGen *g) {
         if ((err = os_fetch_file_path(asm_file, &contents))) {
             zig_panic("Unable to read %s: %s", buf_ptr(asm_file), err_str(err));
         }
+        unchanged_build_add_dependency(g, asm_file, &contents);
         buf_append_buf(&g->global_asm, &contents);
     }
 }
 
+// the profile is read by LLVM, this only makes --skip-unchanged notice when it changes
+static void check_profile_use(CodeGen *g) {
+    if (g->profile_use_path == nullptr)
+        return;
+    Buf contents = BUF_INIT;
+    int err;
+    if ((err = os_fetch_file_path(g->profile_use_path, &contents))) {
+        fprintf(stderr, "unable to read profile '%s': %s\n", buf_ptr(g->profile_use_path), err_str(err));
+        exit(1);
+    }
+    unchanged_build_add_dependency(g, g->profile_use_path, &contents);
+}
+
 void codegen_add_object(CodeGen *g, Buf *object_path) {
     g->link_objects.append(object_path);
 }
@@ -5107,6 +6062,7 @@ static void get_c_type(CodeGen *g, TypeTableEntry *type_entry, Buf *out_buf) {
             }
         case TypeTableEntryIdOpaque:
         case TypeTableEntryIdArray:
+        case TypeTableEntryIdVector:
         case TypeTableEntryIdErrorUnion:
         case TypeTableEntryIdPureError:
         case TypeTableEntryIdEnum:
@@ -5242,6 +6198,17 @@ void codegen_print_timing_report(CodeGen *g, FILE *f) {
                 (next_te->time - te->time) / total);
     }
     fprintf(f, "%20s%12.4f%12.4f%12.4f%12.4f\n", "Total", 0.0, total, total, 1.0);
+
+    fprintf(f, "\n%20s%14s%14s%16s%10s\n", "Arena", "Allocations", "Bytes Used", "Bytes Reserved", "Chunks");
+    arena_print_stats(&g->ast_arena, f);
+    arena_print_stats(&g->ir_arena, f);
+    arena_print_stats(&g->const_arena, f);
+
+    profile_print_report(g, f);
+}
+
+int codegen_write_timing_trace(CodeGen *g, Buf *path) {
+    return profile_write_trace(g, path);
 }
 
 void codegen_add_time_event(CodeGen *g, const char *name) {
@@ -5252,10 +6219,18 @@ void codegen_build(CodeGen *g) {
     assert(g->out_type != OutTypeUnknown);
     init(g);
 
+    if (g->skip_unchanged && unchanged_build_load(g))
+        return;
+
+    size_t first_object_index = g->link_objects.length;
     gen_global_asm(g);
+    check_profile_use(g);
     gen_root_source(g);
     do_code_gen(g);
     gen_h_file(g);
+
+    if (g->skip_unchanged)
+        unchanged_build_save(g, first_object_index);
 }
 
 PackageTableEntry *codegen_create_package(CodeGen *g, const char *root_src_dir, const char *root_src_path) {
@@ -46,9 +46,19 @@ void codegen_set_test_filter(CodeGen *g, Buf *filter);
 void codegen_set_test_name_prefix(CodeGen *g, Buf *prefix);
 void codegen_set_lib_version(CodeGen *g, size_t major, size_t minor, size_t patch);
 void codegen_set_cache_dir(CodeGen *g, Buf *cache_dir);
+void codegen_set_codegen_threads(CodeGen *g, size_t thread_count);
+void codegen_set_lto(CodeGen *g, ZigLLVMLtoMode lto);
+void codegen_set_profile_generate(CodeGen *g, bool profile_generate);
+void codegen_set_profile_use(CodeGen *g, Buf *profile_path);
+void codegen_set_parse_threads(CodeGen *g, size_t thread_count);
+void codegen_set_timing_info(CodeGen *g, bool timing_info);
+void codegen_set_skip_unchanged(CodeGen *g, bool skip_unchanged);
+void codegen_set_lazy_analysis(CodeGen *g, bool lazy_analysis);
+void codegen_set_report_switch_lowering(CodeGen *g, bool report_switch_lowering);
 void codegen_set_output_h_path(CodeGen *g, Buf *h_path);
 void codegen_add_time_event(CodeGen *g, const char *name);
 void codegen_print_timing_report(CodeGen *g, FILE *f);
+int codegen_write_timing_trace(CodeGen *g, Buf *path);
 void codegen_build(CodeGen *g);
 
 PackageTableEntry *codegen_create_package(CodeGen *g, const char *root_src_dir, const char *root_src_path);
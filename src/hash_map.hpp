@@ -12,6 +12,16 @@
 
 #include <stdint.h>
 
+#if defined(__SSE2__)
+#include <emmintrin.h>
+#endif
+
+// Open addressing with linear probing, laid out like a Swiss table: the key
+// value pairs live in one array and a separate array of control bytes holds,
+// per slot, either CTRL_EMPTY or 7 bits of the key's hash. Lookups compare 16
+// control bytes at a time, so most misses and collisions are rejected without
+// touching the entries. Removal shifts the rest of the probe run back instead
+// of leaving tombstones.
 template<typename K, typename V, uint32_t (*HashFunction)(K key), bool (*EqualFn)(K a, K b)>
 class HashMap {
 public:
@@ -20,21 +30,18 @@ public:
     }
     void deinit(void) {
         free(_entries);
+        free(_ctrl);
+        free(_hashes);
     }
 
     struct Entry {
-        bool used;
-        int distance_from_start_index;
         K key;
         V value;
     };
 
     void clear() {
-        for (int i = 0; i < _capacity; i += 1) {
-            _entries[i].used = false;
-        }
+        memset(_ctrl, CTRL_EMPTY, _capacity + GROUP_WIDTH - 1);
         _size = 0;
-        _max_distance_from_start_index = 0;
         _modification_count += 1;
     }
 
@@ -43,30 +50,46 @@ public:
     }
 
     void put(const K &key, const V &value) {
+        bool is_new;
+        Entry *entry = get_or_insert(key, &is_new);
+        entry->key = key;
+        entry->value = value;
+    }
+
+    // Returns the existing entry for the key, or inserts one with a value
+    // initialized value and sets *is_new. Either way only one probe is done.
+    // The pointer is invalidated by the next insertion or removal.
+    Entry *get_or_insert(const K &key, bool *is_new) {
+        uint32_t hash = mix_hash(HashFunction(key));
+        int empty_index;
+        int index = find_index(key, hash, &empty_index);
+        if (index >= 0) {
+            *is_new = false;
+            return &_entries[index];
+        }
+
         _modification_count += 1;
-        internal_put(key, value);
-
-        // if we get too full (60%), double the capacity
-        if (_size * 5 >= _capacity * 3) {
-            Entry *old_entries = _entries;
-            int old_capacity = _capacity;
-            init_capacity(_capacity * 2);
-            // dump all of the old elements into the new table
-            for (int i = 0; i < old_capacity; i += 1) {
-                Entry *old_entry = &old_entries[i];
-                if (old_entry->used)
-                    internal_put(old_entry->key, old_entry->value);
-            }
-            free(old_entries);
+        // keep the table at most 3/4 full so probe runs stay short
+        if ((_size + 1) * 4 > _capacity * 3) {
+            grow();
+            empty_index = find_empty_index(hash);
         }
+        *is_new = true;
+        _size += 1;
+        set_ctrl(empty_index, hash_tag(hash));
+        _hashes[empty_index] = hash;
+        Entry *entry = &_entries[empty_index];
+        entry->key = key;
+        entry->value = V();
+        return entry;
     }
 
     Entry *put_unique(const K &key, const V &value) {
-        // TODO make this more efficient
-        Entry *entry = internal_get(key);
-        if (entry)
+        bool is_new;
+        Entry *entry = get_or_insert(key, &is_new);
+        if (!is_new)
             return entry;
-        put(key, value);
+        entry->value = value;
         return nullptr;
     }
 
@@ -82,39 +105,19 @@ public:
     }
 
     void maybe_remove(const K &key) {
-        if (maybe_get(key)) {
-            remove(key);
+        int empty_index;
+        int index = find_index(key, mix_hash(HashFunction(key)), &empty_index);
+        if (index >= 0) {
+            remove_index(index);
         }
     }
 
     void remove(const K &key) {
-        _modification_count += 1;
-        int start_index = key_to_index(key);
-        for (int roll_over = 0; roll_over <= _max_distance_from_start_index; roll_over += 1) {
-            int index = (start_index + roll_over) % _capacity;
-            Entry *entry = &_entries[index];
-
-            if (!entry->used)
-                zig_panic("key not found");
-
-            if (!EqualFn(entry->key, key))
-                continue;
-
-            for (; roll_over < _capacity; roll_over += 1) {
-                int next_index = (start_index + roll_over + 1) % _capacity;
-                Entry *next_entry = &_entries[next_index];
-                if (!next_entry->used || next_entry->distance_from_start_index == 0) {
-                    entry->used = false;
-                    _size -= 1;
-                    return;
-                }
-                *entry = *next_entry;
-                entry->distance_from_start_index -= 1;
-                entry = next_entry;
-            }
-            zig_panic("shifting everything in the table");
-        }
-        zig_panic("key not found");
+        int empty_index;
+        int index = find_index(key, mix_hash(HashFunction(key)), &empty_index);
+        if (index < 0)
+            zig_panic("key not found");
+        remove_index(index);
     }
 
     class Iterator {
@@ -125,8 +128,8 @@ public:
             if (_count >= _table->size())
                 return NULL;
             for (; _index < _table->_capacity; _index += 1) {
-                Entry *entry = &_table->_entries[_index];
-                if (entry->used) {
+                if (_table->_ctrl[_index] != CTRL_EMPTY) {
+                    Entry *entry = &_table->_entries[_index];
                     _index += 1;
                     _count += 1;
                     return entry;
@@ -154,88 +157,157 @@ public:
     }
 
 private:
+    static const int GROUP_WIDTH = 16;
+    static const uint8_t CTRL_EMPTY = 0x80;
 
     Entry *_entries;
+    // _capacity + GROUP_WIDTH - 1 bytes. The tail mirrors the first slots so that
+    // a group starting near the end of the table can be loaded without wrapping.
+    uint8_t *_ctrl;
+    // the mixed hash of each occupied slot, so growing and removing never rehash keys
+    uint32_t *_hashes;
+    // always a power of two, at least GROUP_WIDTH
     int _capacity;
     int _size;
-    int _max_distance_from_start_index;
     // this is used to detect bugs where a hashtable is edited while an iterator is running.
     uint32_t _modification_count;
 
     void init_capacity(int capacity) {
-        _capacity = capacity;
+        _capacity = GROUP_WIDTH;
+        while (_capacity < capacity)
+            _capacity *= 2;
         _entries = allocate<Entry>(_capacity);
+        _ctrl = allocate_nonzero<uint8_t>(_capacity + GROUP_WIDTH - 1);
+        _hashes = allocate<uint32_t>(_capacity);
         _size = 0;
-        _max_distance_from_start_index = 0;
-        for (int i = 0; i < _capacity; i += 1) {
-            _entries[i].used = false;
-        }
+        memset(_ctrl, CTRL_EMPTY, _capacity + GROUP_WIDTH - 1);
     }
 
-    void internal_put(K key, V value) {
-        int start_index = key_to_index(key);
-        for (int roll_over = 0, distance_from_start_index = 0;
-                roll_over < _capacity; roll_over += 1, distance_from_start_index += 1)
-        {
-            int index = (start_index + roll_over) % _capacity;
-            Entry *entry = &_entries[index];
-
-            if (entry->used && !EqualFn(entry->key, key)) {
-                if (entry->distance_from_start_index < distance_from_start_index) {
-                    // robin hood to the rescue
-                    Entry tmp = *entry;
-                    if (distance_from_start_index > _max_distance_from_start_index)
-                        _max_distance_from_start_index = distance_from_start_index;
-                    *entry = {
-                        true,
-                        distance_from_start_index,
-                        key,
-                        value,
-                    };
-                    key = tmp.key;
-                    value = tmp.value;
-                    distance_from_start_index = tmp.distance_from_start_index;
-                }
-                continue;
-            }
+    static uint32_t mix_hash(uint32_t h) {
+        // Several of the hash functions are weak in their low bits (aligned pointers,
+        // small integers) and the table is indexed with a mask, so spread them out.
+        h ^= h >> 16;
+        h *= 0x85ebca6b;
+        h ^= h >> 13;
+        h *= 0xc2b2ae35;
+        h ^= h >> 16;
+        return h;
+    }
 
-            if (!entry->used) {
-                // adding an entry. otherwise overwriting old value with
-                // same key
-                _size += 1;
-            }
+    static uint8_t hash_tag(uint32_t hash) {
+        // the high bit is clear, which is what distinguishes a full slot from CTRL_EMPTY
+        return (uint8_t)(hash >> 25);
+    }
 
-            if (distance_from_start_index > _max_distance_from_start_index)
-                _max_distance_from_start_index = distance_from_start_index;
-            *entry = {
-                true,
-                distance_from_start_index,
-                key,
-                value,
-            };
-            return;
+    // bit i of the result is set if control byte start + i equals byte
+    uint32_t match_group(int start, uint8_t byte) const {
+#if defined(__SSE2__)
+        __m128i group = _mm_loadu_si128((const __m128i *)&_ctrl[start]);
+        __m128i cmp = _mm_cmpeq_epi8(group, _mm_set1_epi8((char)byte));
+        return (uint32_t)_mm_movemask_epi8(cmp);
+#else
+        uint32_t mask = 0;
+        for (int i = 0; i < GROUP_WIDTH; i += 1) {
+            if (_ctrl[start + i] == byte)
+                mask |= 1u << i;
         }
-        zig_panic("put into a full HashMap");
+        return mask;
+#endif
     }
 
+    void set_ctrl(int index, uint8_t byte) {
+        _ctrl[index] = byte;
+        if (index < GROUP_WIDTH - 1)
+            _ctrl[_capacity + index] = byte;
+    }
 
-    Entry *internal_get(const K &key) const {
-        int start_index = key_to_index(key);
-        for (int roll_over = 0; roll_over <= _max_distance_from_start_index; roll_over += 1) {
-            int index = (start_index + roll_over) % _capacity;
-            Entry *entry = &_entries[index];
+    // Returns the slot holding key, or -1 and the first empty slot of the probe
+    // run, which is where the key belongs.
+    int find_index(const K &key, uint32_t hash, int *empty_index) const {
+        uint8_t tag = hash_tag(hash);
+        int mask = _capacity - 1;
+        int start = (int)(hash & (uint32_t)mask);
+        for (int probed = 0; probed < _capacity; probed += GROUP_WIDTH) {
+            uint32_t empties = match_group(start, CTRL_EMPTY);
+            uint32_t matches = match_group(start, tag);
+            if (empties) {
+                // slots past the first empty one are not part of this probe run
+                matches &= (empties & (0u - empties)) - 1;
+            }
+            while (matches) {
+                int index = (start + __builtin_ctz(matches)) & mask;
+                if (_hashes[index] == hash && EqualFn(_entries[index].key, key))
+                    return index;
+                matches &= matches - 1;
+            }
+            if (empties) {
+                *empty_index = (start + __builtin_ctz(empties)) & mask;
+                return -1;
+            }
+            start = (start + GROUP_WIDTH) & mask;
+        }
+        zig_panic("HashMap has no empty slot");
+    }
 
-            if (!entry->used)
-                return NULL;
+    int find_empty_index(uint32_t hash) const {
+        int mask = _capacity - 1;
+        int start = (int)(hash & (uint32_t)mask);
+        for (int probed = 0; probed < _capacity; probed += GROUP_WIDTH) {
+            uint32_t empties = match_group(start, CTRL_EMPTY);
+            if (empties)
+                return (start + __builtin_ctz(empties)) & mask;
+            start = (start + GROUP_WIDTH) & mask;
+        }
+        zig_panic("HashMap has no empty slot");
+    }
+
+    void grow() {
+        Entry *old_entries = _entries;
+        uint8_t *old_ctrl = _ctrl;
+        uint32_t *old_hashes = _hashes;
+        int old_capacity = _capacity;
+        int old_size = _size;
+        init_capacity(_capacity * 2);
+        // dump all of the old elements into the new table
+        for (int i = 0; i < old_capacity; i += 1) {
+            if (old_ctrl[i] == CTRL_EMPTY)
+                continue;
+            uint32_t hash = old_hashes[i];
+            int index = find_empty_index(hash);
+            set_ctrl(index, hash_tag(hash));
+            _hashes[index] = hash;
+            _entries[index] = old_entries[i];
+        }
+        _size = old_size;
+        free(old_entries);
+        free(old_ctrl);
+        free(old_hashes);
+    }
 
-            if (EqualFn(entry->key, key))
-                return entry;
+    void remove_index(int index) {
+        _modification_count += 1;
+        _size -= 1;
+        // Backward shift deletion: walk the rest of the probe run and move every
+        // entry whose home slot is at or before the hole into it. This keeps the
+        // invariant that every slot between an entry's home and the entry is full.
+        int mask = _capacity - 1;
+        int hole = index;
+        for (int next = (hole + 1) & mask; _ctrl[next] != CTRL_EMPTY; next = (next + 1) & mask) {
+            int home = (int)(_hashes[next] & (uint32_t)mask);
+            if (((next - home) & mask) >= ((next - hole) & mask)) {
+                set_ctrl(hole, _ctrl[next]);
+                _hashes[hole] = _hashes[next];
+                _entries[hole] = _entries[next];
+                hole = next;
+            }
         }
-        return NULL;
+        set_ctrl(hole, CTRL_EMPTY);
     }
 
-    int key_to_index(const K &key) const {
-        return (int)(HashFunction(key) % ((uint32_t)_capacity));
+    Entry *internal_get(const K &key) const {
+        int empty_index;
+        int index = find_index(key, mix_hash(HashFunction(key)), &empty_index);
+        return (index >= 0) ? &_entries[index] : NULL;
     }
 };
 
@@ -9,10 +9,13 @@
 #include "ast_render.hpp"
 #include "error.hpp"
 #include "ir.hpp"
+#include "ir_interpret.hpp"
 #include "ir_print.hpp"
 #include "os.hpp"
 #include "parseh.hpp"
+#include "profile.hpp"
 #include "range_set.hpp"
+#include "unchanged_build.hpp"
 
 struct IrExecContext {
     ConstExprValue *mem_slot_list;
@@ -50,6 +53,7 @@ static IrInstruction *ir_gen_node_extra(IrBuilder *irb, AstNode *node, Scope *sc
 static TypeTableEntry *ir_analyze_instruction(IrAnalyze *ira, IrInstruction *instruction);
 static IrInstruction *ir_implicit_cast(IrAnalyze *ira, IrInstruction *value, TypeTableEntry *expected_type);
 static IrInstruction *ir_get_deref(IrAnalyze *ira, IrInstruction *source_instruction, IrInstruction *ptr);
+static TypeTableEntry *ir_analyze_bin_op_vector(IrAnalyze *ira, IrInstructionBinOp *bin_op_instruction);
 
 ConstExprValue *const_ptr_pointee(CodeGen *g, ConstExprValue *const_val) {
     assert(const_val->type->id == TypeTableEntryIdPointer);
@@ -150,7 +154,7 @@ static void ir_ref_var(VariableTableEntry *var) {
 }
 
 static IrBasicBlock *ir_create_basic_block(IrBuilder *irb, Scope *scope, const char *name_hint) {
-    IrBasicBlock *result = allocate<IrBasicBlock>(1);
+    IrBasicBlock *result = arena_allocate<IrBasicBlock>(&irb->codegen->ir_arena, 1);
     result->scope = scope;
     result->name_hint = name_hint;
     result->debug_id = exec_next_debug_id(irb->exec);
@@ -381,6 +385,18 @@ static constexpr IrInstructionId ir_instruction_id(IrInstructionFence *) {
     return IrInstructionIdFence;
 }
 
+static constexpr IrInstructionId ir_instruction_id(IrInstructionAtomicRmw *) {
+    return IrInstructionIdAtomicRmw;
+}
+
+static constexpr IrInstructionId ir_instruction_id(IrInstructionAtomicLoad *) {
+    return IrInstructionIdAtomicLoad;
+}
+
+static constexpr IrInstructionId ir_instruction_id(IrInstructionAtomicStore *) {
+    return IrInstructionIdAtomicStore;
+}
+
 static constexpr IrInstructionId ir_instruction_id(IrInstructionTruncate *) {
     return IrInstructionIdTruncate;
 }
@@ -549,15 +565,40 @@ static constexpr IrInstructionId ir_instruction_id(IrInstructionTypeId *) {
     return IrInstructionIdTypeId;
 }
 
+static constexpr IrInstructionId ir_instruction_id(IrInstructionVectorType *) {
+    return IrInstructionIdVectorType;
+}
+
+static constexpr IrInstructionId ir_instruction_id(IrInstructionSplat *) {
+    return IrInstructionIdSplat;
+}
+
+static constexpr IrInstructionId ir_instruction_id(IrInstructionShuffle *) {
+    return IrInstructionIdShuffle;
+}
+
+static constexpr IrInstructionId ir_instruction_id(IrInstructionExtractElement *) {
+    return IrInstructionIdExtractElement;
+}
+
+static constexpr IrInstructionId ir_instruction_id(IrInstructionInsertElement *) {
+    return IrInstructionIdInsertElement;
+}
+
+static constexpr IrInstructionId ir_instruction_id(IrInstructionReduce *) {
+    return IrInstructionIdReduce;
+}
+
 template<typename T>
 static T *ir_create_instruction(IrBuilder *irb, Scope *scope, AstNode *source_node) {
-    T *special_instruction = allocate<T>(1);
+    irb->codegen->ir_instruction_count += 1;
+    T *special_instruction = arena_allocate<T>(&irb->codegen->ir_arena, 1);
     special_instruction->base.id = ir_instruction_id(special_instruction);
     special_instruction->base.scope = scope;
     special_instruction->base.source_node = source_node;
     special_instruction->base.debug_id = exec_next_debug_id(irb->exec);
     special_instruction->base.owner_bb = irb->current_basic_block;
-    special_instruction->base.value.global_refs = allocate<ConstGlobalRefs>(1);
+    special_instruction->base.value.global_refs = arena_allocate<ConstGlobalRefs>(&irb->codegen->ir_arena, 1);
     return special_instruction;
 }
 
@@ -762,7 +803,8 @@ static IrInstruction *ir_build_const_bound_fn(IrBuilder *irb, Scope *scope, AstN
 
 static IrInstruction *ir_create_const_str_lit(IrBuilder *irb, Scope *scope, AstNode *source_node, Buf *str) {
     IrInstructionConst *const_instruction = ir_create_instruction<IrInstructionConst>(irb, scope, source_node);
-    init_const_str_lit(irb->codegen, &const_instruction->base.value, str);
+    // the buffers of string literal nodes are never modified after parsing
+    init_const_str_lit_shared(irb->codegen, &const_instruction->base.value, str);
 
     return &const_instruction->base;
 }
@@ -1615,6 +1657,92 @@ static IrInstruction *ir_build_fence_from(IrBuilder *irb, IrInstruction *old_ins
     return new_instruction;
 }
 
+static IrInstruction *ir_build_atomic_rmw(IrBuilder *irb, Scope *scope, AstNode *source_node,
+    IrInstruction *operand_type, IrInstruction *ptr, IrInstruction *op_value, IrInstruction *operand,
+    IrInstruction *order_value, AtomicRmwOp op, AtomicOrder order)
+{
+    IrInstructionAtomicRmw *instruction = ir_build_instruction<IrInstructionAtomicRmw>(irb, scope, source_node);
+    instruction->operand_type = operand_type;
+    instruction->ptr = ptr;
+    instruction->op_value = op_value;
+    instruction->operand = operand;
+    instruction->order_value = order_value;
+    instruction->op = op;
+    instruction->order = order;
+
+    ir_ref_instruction(operand_type, irb->current_basic_block);
+    ir_ref_instruction(ptr, irb->current_basic_block);
+    ir_ref_instruction(op_value, irb->current_basic_block);
+    ir_ref_instruction(operand, irb->current_basic_block);
+    ir_ref_instruction(order_value, irb->current_basic_block);
+
+    return &instruction->base;
+}
+
+static IrInstruction *ir_build_atomic_rmw_from(IrBuilder *irb, IrInstruction *old_instruction,
+    IrInstruction *operand_type, IrInstruction *ptr, IrInstruction *op_value, IrInstruction *operand,
+    IrInstruction *order_value, AtomicRmwOp op, AtomicOrder order)
+{
+    IrInstruction *new_instruction = ir_build_atomic_rmw(irb, old_instruction->scope, old_instruction->source_node,
+        operand_type, ptr, op_value, operand, order_value, op, order);
+    ir_link_new_instruction(new_instruction, old_instruction);
+    return new_instruction;
+}
+
+static IrInstruction *ir_build_atomic_load(IrBuilder *irb, Scope *scope, AstNode *source_node,
+    IrInstruction *operand_type, IrInstruction *ptr, IrInstruction *order_value, AtomicOrder order)
+{
+    IrInstructionAtomicLoad *instruction = ir_build_instruction<IrInstructionAtomicLoad>(irb, scope, source_node);
+    instruction->operand_type = operand_type;
+    instruction->ptr = ptr;
+    instruction->order_value = order_value;
+    instruction->order = order;
+
+    ir_ref_instruction(operand_type, irb->current_basic_block);
+    ir_ref_instruction(ptr, irb->current_basic_block);
+    ir_ref_instruction(order_value, irb->current_basic_block);
+
+    return &instruction->base;
+}
+
+static IrInstruction *ir_build_atomic_load_from(IrBuilder *irb, IrInstruction *old_instruction,
+    IrInstruction *operand_type, IrInstruction *ptr, IrInstruction *order_value, AtomicOrder order)
+{
+    IrInstruction *new_instruction = ir_build_atomic_load(irb, old_instruction->scope, old_instruction->source_node,
+        operand_type, ptr, order_value, order);
+    ir_link_new_instruction(new_instruction, old_instruction);
+    return new_instruction;
+}
+
+static IrInstruction *ir_build_atomic_store(IrBuilder *irb, Scope *scope, AstNode *source_node,
+    IrInstruction *operand_type, IrInstruction *ptr, IrInstruction *value, IrInstruction *order_value,
+    AtomicOrder order)
+{
+    IrInstructionAtomicStore *instruction = ir_build_instruction<IrInstructionAtomicStore>(irb, scope, source_node);
+    instruction->operand_type = operand_type;
+    instruction->ptr = ptr;
+    instruction->value = value;
+    instruction->order_value = order_value;
+    instruction->order = order;
+
+    ir_ref_instruction(operand_type, irb->current_basic_block);
+    ir_ref_instruction(ptr, irb->current_basic_block);
+    ir_ref_instruction(value, irb->current_basic_block);
+    ir_ref_instruction(order_value, irb->current_basic_block);
+
+    return &instruction->base;
+}
+
+static IrInstruction *ir_build_atomic_store_from(IrBuilder *irb, IrInstruction *old_instruction,
+    IrInstruction *operand_type, IrInstruction *ptr, IrInstruction *value, IrInstruction *order_value,
+    AtomicOrder order)
+{
+    IrInstruction *new_instruction = ir_build_atomic_store(irb, old_instruction->scope, old_instruction->source_node,
+        operand_type, ptr, value, order_value, order);
+    ir_link_new_instruction(new_instruction, old_instruction);
+    return new_instruction;
+}
+
 static IrInstruction *ir_build_truncate(IrBuilder *irb, Scope *scope, AstNode *source_node, IrInstruction *dest_type, IrInstruction *target) {
     IrInstructionTruncate *instruction = ir_build_instruction<IrInstructionTruncate>(irb, scope, source_node);
     instruction->dest_type = dest_type;
@@ -2192,6 +2320,137 @@ static IrInstruction *ir_build_type_id(IrBuilder *irb, Scope *scope, AstNode *so
     return &instruction->base;
 }
 
+static IrInstruction *ir_build_vector_type(IrBuilder *irb, Scope *scope, AstNode *source_node,
+        IrInstruction *len, IrInstruction *elem_type)
+{
+    IrInstructionVectorType *instruction = ir_build_instruction<IrInstructionVectorType>(irb, scope, source_node);
+    instruction->len = len;
+    instruction->elem_type = elem_type;
+
+    ir_ref_instruction(len, irb->current_basic_block);
+    ir_ref_instruction(elem_type, irb->current_basic_block);
+
+    return &instruction->base;
+}
+
+static IrInstruction *ir_build_splat(IrBuilder *irb, Scope *scope, AstNode *source_node,
+        IrInstruction *len, IrInstruction *scalar)
+{
+    IrInstructionSplat *instruction = ir_build_instruction<IrInstructionSplat>(irb, scope, source_node);
+    instruction->len = len;
+    instruction->scalar = scalar;
+
+    if (len) ir_ref_instruction(len, irb->current_basic_block);
+    ir_ref_instruction(scalar, irb->current_basic_block);
+
+    return &instruction->base;
+}
+
+static IrInstruction *ir_build_splat_from(IrBuilder *irb, IrInstruction *old_instruction, IrInstruction *scalar) {
+    IrInstruction *new_instruction = ir_build_splat(irb, old_instruction->scope, old_instruction->source_node,
+            nullptr, scalar);
+    ir_link_new_instruction(new_instruction, old_instruction);
+    return new_instruction;
+}
+
+static IrInstruction *ir_build_shuffle(IrBuilder *irb, Scope *scope, AstNode *source_node,
+        IrInstruction *elem_type, IrInstruction *a, IrInstruction *b, IrInstruction *mask,
+        int32_t *mask_indexes, uint32_t mask_len)
+{
+    IrInstructionShuffle *instruction = ir_build_instruction<IrInstructionShuffle>(irb, scope, source_node);
+    instruction->elem_type = elem_type;
+    instruction->a = a;
+    instruction->b = b;
+    instruction->mask = mask;
+    instruction->mask_indexes = mask_indexes;
+    instruction->mask_len = mask_len;
+
+    if (elem_type) ir_ref_instruction(elem_type, irb->current_basic_block);
+    ir_ref_instruction(a, irb->current_basic_block);
+    ir_ref_instruction(b, irb->current_basic_block);
+    if (mask) ir_ref_instruction(mask, irb->current_basic_block);
+
+    return &instruction->base;
+}
+
+static IrInstruction *ir_build_shuffle_from(IrBuilder *irb, IrInstruction *old_instruction,
+        IrInstruction *a, IrInstruction *b, int32_t *mask_indexes, uint32_t mask_len)
+{
+    IrInstruction *new_instruction = ir_build_shuffle(irb, old_instruction->scope, old_instruction->source_node,
+            nullptr, a, b, nullptr, mask_indexes, mask_len);
+    ir_link_new_instruction(new_instruction, old_instruction);
+    return new_instruction;
+}
+
+static IrInstruction *ir_build_extract_element(IrBuilder *irb, Scope *scope, AstNode *source_node,
+        IrInstruction *vector, IrInstruction *index)
+{
+    IrInstructionExtractElement *instruction = ir_build_instruction<IrInstructionExtractElement>(irb, scope, source_node);
+    instruction->vector = vector;
+    instruction->index = index;
+
+    ir_ref_instruction(vector, irb->current_basic_block);
+    ir_ref_instruction(index, irb->current_basic_block);
+
+    return &instruction->base;
+}
+
+static IrInstruction *ir_build_extract_element_from(IrBuilder *irb, IrInstruction *old_instruction,
+        IrInstruction *vector, IrInstruction *index)
+{
+    IrInstruction *new_instruction = ir_build_extract_element(irb, old_instruction->scope,
+            old_instruction->source_node, vector, index);
+    ir_link_new_instruction(new_instruction, old_instruction);
+    return new_instruction;
+}
+
+static IrInstruction *ir_build_insert_element(IrBuilder *irb, Scope *scope, AstNode *source_node,
+        IrInstruction *vector, IrInstruction *index, IrInstruction *value)
+{
+    IrInstructionInsertElement *instruction = ir_build_instruction<IrInstructionInsertElement>(irb, scope, source_node);
+    instruction->vector = vector;
+    instruction->index = index;
+    instruction->value = value;
+
+    ir_ref_instruction(vector, irb->current_basic_block);
+    ir_ref_instruction(index, irb->current_basic_block);
+    ir_ref_instruction(value, irb->current_basic_block);
+
+    return &instruction->base;
+}
+
+static IrInstruction *ir_build_insert_element_from(IrBuilder *irb, IrInstruction *old_instruction,
+        IrInstruction *vector, IrInstruction *index, IrInstruction *value)
+{
+    IrInstruction *new_instruction = ir_build_insert_element(irb, old_instruction->scope,
+            old_instruction->source_node, vector, index, value);
+    ir_link_new_instruction(new_instruction, old_instruction);
+    return new_instruction;
+}
+
+static IrInstruction *ir_build_reduce(IrBuilder *irb, Scope *scope, AstNode *source_node,
+        IrInstruction *op_value, IrInstruction *vector, ReduceOp op)
+{
+    IrInstructionReduce *instruction = ir_build_instruction<IrInstructionReduce>(irb, scope, source_node);
+    instruction->op_value = op_value;
+    instruction->vector = vector;
+    instruction->op = op;
+
+    if (op_value) ir_ref_instruction(op_value, irb->current_basic_block);
+    ir_ref_instruction(vector, irb->current_basic_block);
+
+    return &instruction->base;
+}
+
+static IrInstruction *ir_build_reduce_from(IrBuilder *irb, IrInstruction *old_instruction,
+        IrInstruction *vector, ReduceOp op)
+{
+    IrInstruction *new_instruction = ir_build_reduce(irb, old_instruction->scope, old_instruction->source_node,
+            nullptr, vector, op);
+    ir_link_new_instruction(new_instruction, old_instruction);
+    return new_instruction;
+}
+
 static IrInstruction *ir_instruction_br_get_dep(IrInstructionBr *instruction, size_t index) {
     return nullptr;
 }
@@ -2573,6 +2832,36 @@ static IrInstruction *ir_instruction_fence_get_dep(IrInstructionFence *instructi
     }
 }
 
+static IrInstruction *ir_instruction_atomicrmw_get_dep(IrInstructionAtomicRmw *instruction, size_t index) {
+    switch (index) {
+        case 0: return instruction->operand_type;
+        case 1: return instruction->ptr;
+        case 2: return instruction->op_value;
+        case 3: return instruction->operand;
+        case 4: return instruction->order_value;
+        default: return nullptr;
+    }
+}
+
+static IrInstruction *ir_instruction_atomicload_get_dep(IrInstructionAtomicLoad *instruction, size_t index) {
+    switch (index) {
+        case 0: return instruction->operand_type;
+        case 1: return instruction->ptr;
+        case 2: return instruction->order_value;
+        default: return nullptr;
+    }
+}
+
+static IrInstruction *ir_instruction_atomicstore_get_dep(IrInstructionAtomicStore *instruction, size_t index) {
+    switch (index) {
+        case 0: return instruction->operand_type;
+        case 1: return instruction->ptr;
+        case 2: return instruction->value;
+        case 3: return instruction->order_value;
+        default: return nullptr;
+    }
+}
+
 static IrInstruction *ir_instruction_truncate_get_dep(IrInstructionTruncate *instruction, size_t index) {
     switch (index) {
         case 0: return instruction->dest_type;
@@ -2881,6 +3170,61 @@ static IrInstruction *ir_instruction_typeid_get_dep(IrInstructionTypeId *instruc
     }
 }
 
+static IrInstruction *ir_instruction_vectortype_get_dep(IrInstructionVectorType *instruction, size_t index) {
+    switch (index) {
+        case 0: return instruction->len;
+        case 1: return instruction->elem_type;
+        default: return nullptr;
+    }
+}
+
+static IrInstruction *ir_instruction_splat_get_dep(IrInstructionSplat *instruction, size_t index) {
+    switch (index) {
+        case 0: return instruction->scalar;
+        case 1: return instruction->len;
+        default: return nullptr;
+    }
+}
+
+static IrInstruction *ir_instruction_shuffle_get_dep(IrInstructionShuffle *instruction, size_t index) {
+    switch (index) {
+        case 0: return instruction->a;
+        case 1: return instruction->b;
+        case 2: return instruction->elem_type;
+        case 3: return instruction->mask;
+        default: return nullptr;
+    }
+}
+
+static IrInstruction *ir_instruction_extractelement_get_dep(IrInstructionExtractElement *instruction,
+        size_t index)
+{
+    switch (index) {
+        case 0: return instruction->vector;
+        case 1: return instruction->index;
+        default: return nullptr;
+    }
+}
+
+static IrInstruction *ir_instruction_insertelement_get_dep(IrInstructionInsertElement *instruction,
+        size_t index)
+{
+    switch (index) {
+        case 0: return instruction->vector;
+        case 1: return instruction->index;
+        case 2: return instruction->value;
+        default: return nullptr;
+    }
+}
+
+static IrInstruction *ir_instruction_reduce_get_dep(IrInstructionReduce *instruction, size_t index) {
+    switch (index) {
+        case 0: return instruction->vector;
+        case 1: return instruction->op_value;
+        default: return nullptr;
+    }
+}
+
 static IrInstruction *ir_instruction_get_dep(IrInstruction *instruction, size_t index) {
     switch (instruction->id) {
         case IrInstructionIdInvalid:
@@ -2993,6 +3337,12 @@ static IrInstruction *ir_instruction_get_dep(IrInstruction *instruction, size_t
             return ir_instruction_cmpxchg_get_dep((IrInstructionCmpxchg *) instruction, index);
         case IrInstructionIdFence:
             return ir_instruction_fence_get_dep((IrInstructionFence *) instruction, index);
+        case IrInstructionIdAtomicRmw:
+            return ir_instruction_atomicrmw_get_dep((IrInstructionAtomicRmw *) instruction, index);
+        case IrInstructionIdAtomicLoad:
+            return ir_instruction_atomicload_get_dep((IrInstructionAtomicLoad *) instruction, index);
+        case IrInstructionIdAtomicStore:
+            return ir_instruction_atomicstore_get_dep((IrInstructionAtomicStore *) instruction, index);
         case IrInstructionIdTruncate:
             return ir_instruction_truncate_get_dep((IrInstructionTruncate *) instruction, index);
         case IrInstructionIdIntType:
@@ -3075,6 +3425,18 @@ static IrInstruction *ir_instruction_get_dep(IrInstruction *instruction, size_t
             return ir_instruction_offsetof_get_dep((IrInstructionOffsetOf *) instruction, index);
         case IrInstructionIdTypeId:
             return ir_instruction_typeid_get_dep((IrInstructionTypeId *) instruction, index);
+        case IrInstructionIdVectorType:
+            return ir_instruction_vectortype_get_dep((IrInstructionVectorType *) instruction, index);
+        case IrInstructionIdSplat:
+            return ir_instruction_splat_get_dep((IrInstructionSplat *) instruction, index);
+        case IrInstructionIdShuffle:
+            return ir_instruction_shuffle_get_dep((IrInstructionShuffle *) instruction, index);
+        case IrInstructionIdExtractElement:
+            return ir_instruction_extractelement_get_dep((IrInstructionExtractElement *) instruction, index);
+        case IrInstructionIdInsertElement:
+            return ir_instruction_insertelement_get_dep((IrInstructionInsertElement *) instruction, index);
+        case IrInstructionIdReduce:
+            return ir_instruction_reduce_get_dep((IrInstructionReduce *) instruction, index);
     }
     zig_unreachable();
 }
@@ -3248,10 +3610,10 @@ static VariableTableEntry *create_local_var(CodeGen *codegen, AstNode *node, Sco
     variable_entry->mem_slot_index = SIZE_MAX;
     variable_entry->is_comptime = is_comptime;
     variable_entry->src_arg_index = SIZE_MAX;
-    variable_entry->value = create_const_vals(1);
+    variable_entry->value = create_const_vals(codegen, 1);
 
     if (name) {
-        buf_init_from_buf(&variable_entry->name, name);
+        variable_entry->name = buf_intern(name);
 
         VariableTableEntry *existing_var = find_variable(codegen, parent_scope, name);
         if (existing_var && !existing_var->shadowable) {
@@ -3282,7 +3644,7 @@ static VariableTableEntry *create_local_var(CodeGen *codegen, AstNode *node, Sco
         // TODO make this name not actually be in scope. user should be able to make a variable called "_anon"
         // might already be solved, let's just make sure it has test coverage
         // maybe we put a prefix on this so the debug info doesn't clobber user debug info for same named variables
-        buf_init_from_str(&variable_entry->name, "_anon");
+        variable_entry->name = buf_intern_str("_anon");
     }
 
     variable_entry->src_is_const = src_is_const;
@@ -4094,6 +4456,81 @@ static IrInstruction *ir_gen_builtin_fn_call(IrBuilder *irb, Scope *scope, AstNo
 
                 return ir_build_fence(irb, scope, node, arg0_value, AtomicOrderUnordered);
             }
+        case BuiltinFnIdAtomicRmw:
+            {
+                AstNode *arg0_node = node->data.fn_call_expr.params.at(0);
+                IrInstruction *arg0_value = ir_gen_node(irb, arg0_node, scope);
+                if (arg0_value == irb->codegen->invalid_instruction)
+                    return arg0_value;
+
+                AstNode *arg1_node = node->data.fn_call_expr.params.at(1);
+                IrInstruction *arg1_value = ir_gen_node(irb, arg1_node, scope);
+                if (arg1_value == irb->codegen->invalid_instruction)
+                    return arg1_value;
+
+                AstNode *arg2_node = node->data.fn_call_expr.params.at(2);
+                IrInstruction *arg2_value = ir_gen_node(irb, arg2_node, scope);
+                if (arg2_value == irb->codegen->invalid_instruction)
+                    return arg2_value;
+
+                AstNode *arg3_node = node->data.fn_call_expr.params.at(3);
+                IrInstruction *arg3_value = ir_gen_node(irb, arg3_node, scope);
+                if (arg3_value == irb->codegen->invalid_instruction)
+                    return arg3_value;
+
+                AstNode *arg4_node = node->data.fn_call_expr.params.at(4);
+                IrInstruction *arg4_value = ir_gen_node(irb, arg4_node, scope);
+                if (arg4_value == irb->codegen->invalid_instruction)
+                    return arg4_value;
+
+                return ir_build_atomic_rmw(irb, scope, node, arg0_value, arg1_value, arg2_value, arg3_value,
+                    arg4_value, AtomicRmwOpXchg, AtomicOrderUnordered);
+            }
+        case BuiltinFnIdAtomicLoad:
+            {
+                AstNode *arg0_node = node->data.fn_call_expr.params.at(0);
+                IrInstruction *arg0_value = ir_gen_node(irb, arg0_node, scope);
+                if (arg0_value == irb->codegen->invalid_instruction)
+                    return arg0_value;
+
+                AstNode *arg1_node = node->data.fn_call_expr.params.at(1);
+                IrInstruction *arg1_value = ir_gen_node(irb, arg1_node, scope);
+                if (arg1_value == irb->codegen->invalid_instruction)
+                    return arg1_value;
+
+                AstNode *arg2_node = node->data.fn_call_expr.params.at(2);
+                IrInstruction *arg2_value = ir_gen_node(irb, arg2_node, scope);
+                if (arg2_value == irb->codegen->invalid_instruction)
+                    return arg2_value;
+
+                return ir_build_atomic_load(irb, scope, node, arg0_value, arg1_value, arg2_value,
+                    AtomicOrderUnordered);
+            }
+        case BuiltinFnIdAtomicStore:
+            {
+                AstNode *arg0_node = node->data.fn_call_expr.params.at(0);
+                IrInstruction *arg0_value = ir_gen_node(irb, arg0_node, scope);
+                if (arg0_value == irb->codegen->invalid_instruction)
+                    return arg0_value;
+
+                AstNode *arg1_node = node->data.fn_call_expr.params.at(1);
+                IrInstruction *arg1_value = ir_gen_node(irb, arg1_node, scope);
+                if (arg1_value == irb->codegen->invalid_instruction)
+                    return arg1_value;
+
+                AstNode *arg2_node = node->data.fn_call_expr.params.at(2);
+                IrInstruction *arg2_value = ir_gen_node(irb, arg2_node, scope);
+                if (arg2_value == irb->codegen->invalid_instruction)
+                    return arg2_value;
+
+                AstNode *arg3_node = node->data.fn_call_expr.params.at(3);
+                IrInstruction *arg3_value = ir_gen_node(irb, arg3_node, scope);
+                if (arg3_value == irb->codegen->invalid_instruction)
+                    return arg3_value;
+
+                return ir_build_atomic_store(irb, scope, node, arg0_value, arg1_value, arg2_value, arg3_value,
+                    AtomicOrderUnordered);
+            }
         case BuiltinFnIdDivExact:
             {
                 AstNode *arg0_node = node->data.fn_call_expr.params.at(0);
@@ -4448,11 +4885,111 @@ static IrInstruction *ir_gen_builtin_fn_call(IrBuilder *irb, Scope *scope, AstNo
 
                 return ir_build_type_id(irb, scope, node, arg0_value);
             }
-    }
-    zig_unreachable();
-}
+        case BuiltinFnIdVectorType:
+            {
+                AstNode *arg0_node = node->data.fn_call_expr.params.at(0);
+                IrInstruction *arg0_value = ir_gen_node(irb, arg0_node, scope);
+                if (arg0_value == irb->codegen->invalid_instruction)
+                    return arg0_value;
 
-static IrInstruction *ir_gen_fn_call(IrBuilder *irb, Scope *scope, AstNode *node) {
+                AstNode *arg1_node = node->data.fn_call_expr.params.at(1);
+                IrInstruction *arg1_value = ir_gen_node(irb, arg1_node, scope);
+                if (arg1_value == irb->codegen->invalid_instruction)
+                    return arg1_value;
+
+                return ir_build_vector_type(irb, scope, node, arg0_value, arg1_value);
+            }
+        case BuiltinFnIdSplat:
+            {
+                AstNode *arg0_node = node->data.fn_call_expr.params.at(0);
+                IrInstruction *arg0_value = ir_gen_node(irb, arg0_node, scope);
+                if (arg0_value == irb->codegen->invalid_instruction)
+                    return arg0_value;
+
+                AstNode *arg1_node = node->data.fn_call_expr.params.at(1);
+                IrInstruction *arg1_value = ir_gen_node(irb, arg1_node, scope);
+                if (arg1_value == irb->codegen->invalid_instruction)
+                    return arg1_value;
+
+                return ir_build_splat(irb, scope, node, arg0_value, arg1_value);
+            }
+        case BuiltinFnIdShuffle:
+            {
+                AstNode *arg0_node = node->data.fn_call_expr.params.at(0);
+                IrInstruction *arg0_value = ir_gen_node(irb, arg0_node, scope);
+                if (arg0_value == irb->codegen->invalid_instruction)
+                    return arg0_value;
+
+                AstNode *arg1_node = node->data.fn_call_expr.params.at(1);
+                IrInstruction *arg1_value = ir_gen_node(irb, arg1_node, scope);
+                if (arg1_value == irb->codegen->invalid_instruction)
+                    return arg1_value;
+
+                AstNode *arg2_node = node->data.fn_call_expr.params.at(2);
+                IrInstruction *arg2_value = ir_gen_node(irb, arg2_node, scope);
+                if (arg2_value == irb->codegen->invalid_instruction)
+                    return arg2_value;
+
+                AstNode *arg3_node = node->data.fn_call_expr.params.at(3);
+                IrInstruction *arg3_value = ir_gen_node(irb, arg3_node, scope);
+                if (arg3_value == irb->codegen->invalid_instruction)
+                    return arg3_value;
+
+                return ir_build_shuffle(irb, scope, node, arg0_value, arg1_value, arg2_value, arg3_value,
+                        nullptr, 0);
+            }
+        case BuiltinFnIdExtractElement:
+            {
+                AstNode *arg0_node = node->data.fn_call_expr.params.at(0);
+                IrInstruction *arg0_value = ir_gen_node(irb, arg0_node, scope);
+                if (arg0_value == irb->codegen->invalid_instruction)
+                    return arg0_value;
+
+                AstNode *arg1_node = node->data.fn_call_expr.params.at(1);
+                IrInstruction *arg1_value = ir_gen_node(irb, arg1_node, scope);
+                if (arg1_value == irb->codegen->invalid_instruction)
+                    return arg1_value;
+
+                return ir_build_extract_element(irb, scope, node, arg0_value, arg1_value);
+            }
+        case BuiltinFnIdInsertElement:
+            {
+                AstNode *arg0_node = node->data.fn_call_expr.params.at(0);
+                IrInstruction *arg0_value = ir_gen_node(irb, arg0_node, scope);
+                if (arg0_value == irb->codegen->invalid_instruction)
+                    return arg0_value;
+
+                AstNode *arg1_node = node->data.fn_call_expr.params.at(1);
+                IrInstruction *arg1_value = ir_gen_node(irb, arg1_node, scope);
+                if (arg1_value == irb->codegen->invalid_instruction)
+                    return arg1_value;
+
+                AstNode *arg2_node = node->data.fn_call_expr.params.at(2);
+                IrInstruction *arg2_value = ir_gen_node(irb, arg2_node, scope);
+                if (arg2_value == irb->codegen->invalid_instruction)
+                    return arg2_value;
+
+                return ir_build_insert_element(irb, scope, node, arg0_value, arg1_value, arg2_value);
+            }
+        case BuiltinFnIdReduce:
+            {
+                AstNode *arg0_node = node->data.fn_call_expr.params.at(0);
+                IrInstruction *arg0_value = ir_gen_node(irb, arg0_node, scope);
+                if (arg0_value == irb->codegen->invalid_instruction)
+                    return arg0_value;
+
+                AstNode *arg1_node = node->data.fn_call_expr.params.at(1);
+                IrInstruction *arg1_value = ir_gen_node(irb, arg1_node, scope);
+                if (arg1_value == irb->codegen->invalid_instruction)
+                    return arg1_value;
+
+                return ir_build_reduce(irb, scope, node, arg0_value, arg1_value, ReduceOpAdd);
+            }
+    }
+    zig_unreachable();
+}
+
+static IrInstruction *ir_gen_fn_call(IrBuilder *irb, Scope *scope, AstNode *node) {
     assert(node->type == NodeTypeFnCallExpr);
 
     if (node->data.fn_call_expr.is_builtin)
@@ -5878,6 +6415,8 @@ static IrInstruction *ir_gen_container_decl(IrBuilder *irb, Scope *parent_scope,
     }
 
 
+    irb->exec->declares_container = true;
+
     VisibMod visib_mod = VisibModPub;
     TldContainer *tld_container = allocate<TldContainer>(1);
     init_tld(&tld_container->base, TldIdContainer, name, visib_mod, node, parent_scope);
@@ -6104,6 +6643,105 @@ static bool ir_goto_pass2(IrBuilder *irb) {
     return true;
 }
 
+// Pure instructions whose builder references exactly the operands that
+// ir_instruction_get_dep lists, so removing one can give its operands back
+// their references.
+static bool ir_instruction_is_removable(IrInstruction *instruction) {
+    switch (instruction->id) {
+        case IrInstructionIdConst:
+        case IrInstructionIdVarPtr:
+        case IrInstructionIdUnOp:
+        case IrInstructionIdBinOp:
+        case IrInstructionIdLoadPtr:
+        case IrInstructionIdCast:
+        case IrInstructionIdFieldPtr:
+        case IrInstructionIdElemPtr:
+        case IrInstructionIdTypeOf:
+        case IrInstructionIdRef:
+        case IrInstructionIdUnwrapMaybe:
+        case IrInstructionIdArrayType:
+        case IrInstructionIdSliceType:
+            return true;
+        default:
+            return false;
+    }
+}
+
+// Pass 2 never reaches a basic block nothing branches to, and skips an
+// instruction nothing refers to, but only after walking over it and while its
+// operands still count the reference. Expansions like inline for and switch
+// leave a lot of both behind, so take them out of the pass 1 IR right away,
+// following chains of instructions that only fed dead ones.
+static void ir_remove_dead_code(IrBuilder *irb) {
+    IrExecutable *exec = irb->exec;
+    ZigList<IrInstruction *> dead_list = {0};
+
+    size_t live_bb_count = 0;
+    for (size_t bb_i = 0; bb_i < exec->basic_block_list.length; bb_i += 1) {
+        IrBasicBlock *bb = exec->basic_block_list.at(bb_i);
+        exec->gen_instruction_count += bb->instruction_list.length;
+        if (bb_i != 0 && bb->ref_count == 0) {
+            // What it refers to keeps the references; pass 2 relies on block ref counts.
+            exec->dead_block_count += 1;
+            exec->dead_instruction_count += bb->instruction_list.length;
+            continue;
+        }
+        exec->basic_block_list.at(live_bb_count) = bb;
+        live_bb_count += 1;
+
+        for (size_t instr_i = 0; instr_i < bb->instruction_list.length; instr_i += 1) {
+            IrInstruction *instruction = bb->instruction_list.at(instr_i);
+            // code after the end of the block stays for the "unreachable code" error
+            if (instr_is_unreachable(instruction))
+                break;
+            if (instruction->ref_count == 0 && ir_instruction_is_removable(instruction)) {
+                instruction->is_dead = true;
+                dead_list.append(instruction);
+            }
+        }
+    }
+    exec->basic_block_list.resize(live_bb_count);
+
+    for (size_t dead_i = 0; dead_i < dead_list.length; dead_i += 1) {
+        IrInstruction *instruction = dead_list.at(dead_i);
+        // the builder counts the variable, not its declaration
+        if (instruction->id == IrInstructionIdVarPtr)
+            continue;
+        for (size_t dep_i = 0; ; dep_i += 1) {
+            IrInstruction *dep_instruction = ir_instruction_get_dep(instruction, dep_i);
+            if (dep_instruction == nullptr)
+                break;
+            assert(dep_instruction->ref_count != 0);
+            dep_instruction->ref_count -= 1;
+            if (dep_instruction->ref_count == 0 && !dep_instruction->is_dead &&
+                ir_instruction_is_removable(dep_instruction))
+            {
+                dep_instruction->is_dead = true;
+                dead_list.append(dep_instruction);
+            }
+        }
+    }
+
+    if (dead_list.length != 0) {
+        for (size_t bb_i = 0; bb_i < exec->basic_block_list.length; bb_i += 1) {
+            ZigList<IrInstruction *> *list = &exec->basic_block_list.at(bb_i)->instruction_list;
+            size_t live_count = 0;
+            for (size_t instr_i = 0; instr_i < list->length; instr_i += 1) {
+                IrInstruction *instruction = list->items[instr_i];
+                if (!instruction->is_dead) {
+                    list->items[live_count] = instruction;
+                    live_count += 1;
+                }
+            }
+            list->resize(live_count);
+        }
+    }
+    exec->dead_instruction_count += dead_list.length;
+    irb->codegen->ir_dead_instruction_count += exec->dead_instruction_count;
+    irb->codegen->ir_dead_block_count += exec->dead_block_count;
+    dead_list.deinit();
+}
+
 bool ir_gen(CodeGen *codegen, AstNode *node, Scope *scope, IrExecutable *ir_executable) {
     assert(node->owner);
 
@@ -6131,6 +6769,8 @@ bool ir_gen(CodeGen *codegen, AstNode *node, Scope *scope, IrExecutable *ir_exec
         return false;
     }
 
+    ir_remove_dead_code(irb);
+
     return true;
 }
 
@@ -6697,6 +7337,10 @@ static void eval_const_expr_implicit_cast(CastOp cast_op,
             bigint_init_unsigned(&const_val->data.x_bigint, other_val->data.x_bool ? 1 : 0);
             const_val->special = ConstValSpecialStatic;
             break;
+        case CastOpArrayToVector:
+        case CastOpVectorToArray:
+            // folded by ir_analyze_array_to_vector and ir_analyze_vector_to_array
+            zig_unreachable();
     }
 }
 static IrInstruction *ir_resolve_cast(IrAnalyze *ira, IrInstruction *source_instr, IrInstruction *value,
@@ -6940,31 +7584,214 @@ static ConstExprValue *ir_resolve_const(IrAnalyze *ira, IrInstruction *value, Un
     zig_unreachable();
 }
 
+// Pass 1 IR can be analyzed again as long as nothing it created during
+// generation holds on to the scope it was generated in, and analyzing it
+// does not leave state behind in its scopes.
+static bool ir_exec_is_reusable(IrExecutable *exec) {
+    if (exec->declares_container)
+        return false;
+    for (size_t bb_i = 0; bb_i < exec->basic_block_list.length; bb_i += 1) {
+        IrBasicBlock *bb = exec->basic_block_list.at(bb_i);
+        for (size_t instr_i = 0; instr_i < bb->instruction_list.length; instr_i += 1) {
+            switch (bb->instruction_list.at(instr_i)->id) {
+                case IrInstructionIdSetDebugSafety:
+                case IrInstructionIdSetFloatMode:
+                case IrInstructionIdCImport:
+                    return false;
+                default:
+                    break;
+            }
+        }
+    }
+    return true;
+}
+
+// Copies src into dest and gives dest its own array elements and struct
+// fields, so that writing through one of the two does not change the other.
+static void copy_const_val_aggregates(CodeGen *g, ConstExprValue *dest, ConstExprValue *src) {
+    *dest = *src;
+    if (src->special != ConstValSpecialStatic || src->type == nullptr)
+        return;
+
+    TypeTableEntry *type_entry = src->type;
+    if ((type_entry->id == TypeTableEntryIdArray || type_entry->id == TypeTableEntryIdVector) &&
+        src->data.x_array.special == ConstArraySpecialNone)
+    {
+        size_t elem_count = (type_entry->id == TypeTableEntryIdArray) ?
+            type_entry->data.array.len : type_entry->data.vector.len;
+        dest->data.x_array.s_none.elements = create_const_vals(g, elem_count);
+        for (size_t i = 0; i < elem_count; i += 1) {
+            ConstExprValue *elem_val = &dest->data.x_array.s_none.elements[i];
+            ConstGlobalRefs *global_refs = elem_val->global_refs;
+            copy_const_val_aggregates(g, elem_val, &src->data.x_array.s_none.elements[i]);
+            elem_val->global_refs = global_refs;
+            ConstParent *parent = get_const_val_parent(g, elem_val);
+            if (parent != nullptr) {
+                parent->id = ConstParentIdArray;
+                parent->data.p_array.array_val = dest;
+                parent->data.p_array.elem_index = i;
+            }
+        }
+    } else if (type_entry->id == TypeTableEntryIdStruct && src->data.x_struct.fields != nullptr) {
+        size_t field_count = type_entry->data.structure.src_field_count;
+        dest->data.x_struct.fields = create_const_vals(g, field_count);
+        for (size_t i = 0; i < field_count; i += 1) {
+            ConstExprValue *field_val = &dest->data.x_struct.fields[i];
+            ConstGlobalRefs *global_refs = field_val->global_refs;
+            copy_const_val_aggregates(g, field_val, &src->data.x_struct.fields[i]);
+            field_val->global_refs = global_refs;
+            ConstParent *parent = get_const_val_parent(g, field_val);
+            if (parent != nullptr) {
+                parent->id = ConstParentIdStruct;
+                parent->data.p_struct.struct_val = dest;
+                parent->data.p_struct.field_index = i;
+            }
+        }
+    }
+}
+
+static void ir_cache_fn_body(CodeGen *codegen, FnTableEntry *fn_entry, IrCachedExecutable *cached, Scope *scope) {
+    cached->scope = scope;
+    cached->in_use = true;
+    IrExecutable *exec = &cached->exec;
+    for (size_t bb_i = 0; bb_i < exec->basic_block_list.length; bb_i += 1) {
+        IrBasicBlock *bb = exec->basic_block_list.at(bb_i);
+        for (size_t instr_i = 0; instr_i < bb->instruction_list.length; instr_i += 1) {
+            IrInstruction *instruction = bb->instruction_list.at(instr_i);
+            ConstExprValue *gen_value = create_const_vals(codegen, 1);
+            copy_const_val_aggregates(codegen, gen_value, &instruction->value);
+            cached->gen_values.append(gen_value);
+            if (instruction->id == IrInstructionIdDeclVar)
+                cached->local_vars.append(((IrInstructionDeclVar *)instruction)->var);
+        }
+    }
+    fn_entry->comptime_ir_cache.append(cached);
+}
+
+// Points the parameter variables the cached IR refers to at the arguments in
+// scope. Both scopes were forked from the function's definition scope with
+// one variable per parameter.
+static bool ir_rebind_cached_params(FnTableEntry *fn_entry, IrCachedExecutable *cached, Scope *scope) {
+    Scope *fndef_scope = &fn_entry->fndef_scope->base;
+    Scope *cached_scope = cached->scope;
+    while (scope != fndef_scope && cached_scope != fndef_scope) {
+        if (scope->id != ScopeIdVarDecl || cached_scope->id != ScopeIdVarDecl)
+            return false;
+        VariableTableEntry *var = ((ScopeVarDecl *)scope)->var;
+        VariableTableEntry *cached_var = ((ScopeVarDecl *)cached_scope)->var;
+        cached_var->value = var->value;
+        scope = scope->parent;
+        cached_scope = cached_scope->parent;
+    }
+    return scope == cached_scope;
+}
+
+static IrCachedExecutable *ir_get_cached_fn_body(CodeGen *codegen, FnTableEntry *fn_entry, Scope *scope) {
+    for (size_t i = 0; i < fn_entry->comptime_ir_cache.length; i += 1) {
+        IrCachedExecutable *cached = fn_entry->comptime_ir_cache.at(i);
+        if (cached->in_use || !ir_rebind_cached_params(fn_entry, cached, scope))
+            continue;
+
+        // forget what the previous analysis associated with the old IR and
+        // put the IR back the way pass 1 left it
+        size_t gen_value_i = 0;
+        IrExecutable *exec = &cached->exec;
+        for (size_t bb_i = 0; bb_i < exec->basic_block_list.length; bb_i += 1) {
+            IrBasicBlock *bb = exec->basic_block_list.at(bb_i);
+            bb->other = nullptr;
+            bb->ref_instruction = nullptr;
+            bb->must_be_comptime_source_instr = nullptr;
+            for (size_t instr_i = 0; instr_i < bb->instruction_list.length; instr_i += 1) {
+                IrInstruction *instruction = bb->instruction_list.at(instr_i);
+                instruction->other = nullptr;
+                copy_const_val_aggregates(codegen, &instruction->value, cached->gen_values.at(gen_value_i));
+                gen_value_i += 1;
+            }
+        }
+        for (size_t i = 0; i < cached->local_vars.length; i += 1) {
+            VariableTableEntry *var = cached->local_vars.at(i);
+            var->value = create_const_vals(codegen, 1);
+            var->ref_count = 0;
+        }
+        cached->in_use = true;
+        codegen->comptime_ir_reused_count += 1;
+        return cached;
+    }
+    return nullptr;
+}
+
 IrInstruction *ir_eval_const_value(CodeGen *codegen, Scope *scope, AstNode *node,
         TypeTableEntry *expected_type, size_t *backward_branch_count, size_t backward_branch_quota,
         FnTableEntry *fn_entry, Buf *c_import_buf, AstNode *source_node, Buf *exec_name,
         IrExecutable *parent_exec)
 {
-    IrExecutable ir_executable = {0};
-    ir_executable.source_node = source_node;
-    ir_executable.parent_exec = parent_exec;
-    ir_executable.name = exec_name;
-    ir_executable.is_inline = true;
-    ir_executable.fn_entry = fn_entry;
-    ir_executable.c_import_buf = c_import_buf;
-    ir_executable.begin_scope = scope;
-    ir_gen(codegen, node, scope, &ir_executable);
-
-    if (ir_executable.invalid)
-        return codegen->invalid_instruction;
+    // Only compile time function calls pass fn_entry. Their body's pass 1 IR
+    // depends on nothing but the function, so it is generated once per
+    // nesting level and reused by later calls.
+    bool is_fn_body = (fn_entry != nullptr && node == fn_entry->body_node);
+    IrCachedExecutable *cached = is_fn_body ? ir_get_cached_fn_body(codegen, fn_entry, scope) : nullptr;
+    bool is_reused = (cached != nullptr);
+    IrExecutable stack_executable = {0};
+    IrExecutable *ir_executable = &stack_executable;
+    if (is_reused) {
+        ir_executable = &cached->exec;
+    } else {
+        ir_executable->source_node = source_node;
+        ir_executable->parent_exec = parent_exec;
+        ir_executable->name = exec_name;
+        ir_executable->is_inline = true;
+        ir_executable->fn_entry = fn_entry;
+        ir_executable->c_import_buf = c_import_buf;
+        ir_executable->begin_scope = scope;
+        ir_gen(codegen, node, scope, ir_executable);
+
+        if (ir_executable->invalid)
+            return codegen->invalid_instruction;
+
+        // the cache entry takes over the generated IR
+        if (is_fn_body && ir_exec_is_reusable(ir_executable)) {
+            cached = allocate<IrCachedExecutable>(1);
+            cached->exec = stack_executable;
+            ir_executable = &cached->exec;
+            ir_cache_fn_body(codegen, fn_entry, cached, scope);
+        }
+    }
 
     if (codegen->verbose) {
         fprintf(stderr, "\nSource: ");
         ast_render(codegen, stderr, node, 4);
-        fprintf(stderr, "\n{ // (IR)\n");
-        ir_print(codegen, stderr, &ir_executable, 4);
+        fprintf(stderr, is_reused ? "\n{ // (IR, reused)\n" : "\n{ // (IR)\n");
+        ir_print(codegen, stderr, ir_executable, 4);
         fprintf(stderr, "}\n");
     }
+
+    // Bodies that only compute with integers, bools and arrays of them are
+    // executed directly instead of analyzed. A function whose body the
+    // interpreter does not handle is not tried again; one that only gave up
+    // on the values of this call is.
+    if (is_fn_body && !fn_entry->comptime_not_interpretable) {
+        ConstExprValue interpreted_val = {};
+        InterpretResult interpret_result = ir_interpret_fn_body(codegen, ir_executable, expected_type,
+                backward_branch_count, backward_branch_quota, &interpreted_val);
+        if (interpret_result == InterpretResultOk) {
+            codegen->comptime_interpreted_count += 1;
+            if (cached != nullptr)
+                cached->in_use = false;
+            if (codegen->verbose) {
+                fprintf(stderr, "{ // (interpreted)\n}\n");
+            }
+            IrInstructionConst *const_instruction = arena_allocate<IrInstructionConst>(&codegen->ir_arena, 1);
+            const_instruction->base.id = IrInstructionIdConst;
+            const_instruction->base.scope = scope;
+            const_instruction->base.source_node = source_node;
+            const_instruction->base.value = interpreted_val;
+            const_instruction->base.value.global_refs = arena_allocate<ConstGlobalRefs>(&codegen->ir_arena, 1);
+            return &const_instruction->base;
+        }
+        if (interpret_result == InterpretResultUnsupported)
+            fn_entry->comptime_not_interpretable = true;
+    }
+
     IrExecutable analyzed_executable = {0};
     analyzed_executable.source_node = source_node;
     analyzed_executable.parent_exec = parent_exec;
@@ -6975,7 +7802,9 @@ IrInstruction *ir_eval_const_value(CodeGen *codegen, Scope *scope, AstNode *node
     analyzed_executable.backward_branch_count = backward_branch_count;
     analyzed_executable.backward_branch_quota = backward_branch_quota;
     analyzed_executable.begin_scope = scope;
-    TypeTableEntry *result_type = ir_analyze(codegen, &ir_executable, &analyzed_executable, expected_type, node);
+    TypeTableEntry *result_type = ir_analyze(codegen, ir_executable, &analyzed_executable, expected_type, node);
+    if (cached != nullptr)
+        cached->in_use = false;
     if (type_is_invalid(result_type))
         return codegen->invalid_instruction;
 
@@ -7465,6 +8294,61 @@ static IrInstruction *ir_analyze_err_to_int(IrAnalyze *ira, IrInstruction *sourc
     return result;
 }
 
+static IrInstruction *ir_analyze_array_to_vector(IrAnalyze *ira, IrInstruction *source_instr,
+        IrInstruction *array, TypeTableEntry *vector_type)
+{
+    if (instr_is_comptime(array)) {
+        ConstExprValue *array_val = ir_resolve_const(ira, array, UndefOk);
+        if (!array_val)
+            return ira->codegen->invalid_instruction;
+
+        IrInstruction *result = ir_create_const(&ira->new_irb, source_instr->scope,
+                source_instr->source_node, vector_type);
+        if (array_val->special == ConstValSpecialUndef) {
+            result->value.special = ConstValSpecialUndef;
+            return result;
+        }
+        expand_undef_array(ira->codegen, array_val);
+
+        // undefined elements stay undefined in the vector
+        uint32_t len = vector_type->data.vector.len;
+        result->value.data.x_array.s_none.elements = create_const_vals(ira->codegen, len);
+        for (uint32_t i = 0; i < len; i += 1) {
+            copy_const_val(&result->value.data.x_array.s_none.elements[i],
+                    &array_val->data.x_array.s_none.elements[i], true);
+        }
+        return result;
+    }
+
+    return ir_resolve_cast(ira, source_instr, array, vector_type, CastOpArrayToVector, false);
+}
+
+static IrInstruction *ir_analyze_vector_to_array(IrAnalyze *ira, IrInstruction *source_instr,
+        IrInstruction *vector, TypeTableEntry *array_type)
+{
+    if (instr_is_comptime(vector)) {
+        ConstExprValue *vector_val = ir_resolve_const(ira, vector, UndefOk);
+        if (!vector_val)
+            return ira->codegen->invalid_instruction;
+
+        IrInstruction *result = ir_create_const(&ira->new_irb, source_instr->scope,
+                source_instr->source_node, array_type);
+        if (vector_val->special == ConstValSpecialUndef) {
+            result->value.special = ConstValSpecialUndef;
+            return result;
+        }
+        uint64_t len = array_type->data.array.len;
+        result->value.data.x_array.s_none.elements = create_const_vals(ira->codegen, len);
+        for (uint64_t i = 0; i < len; i += 1) {
+            copy_const_val(&result->value.data.x_array.s_none.elements[i],
+                    &vector_val->data.x_array.s_none.elements[i], true);
+        }
+        return result;
+    }
+
+    return ir_resolve_cast(ira, source_instr, vector, array_type, CastOpVectorToArray, true);
+}
+
 static IrInstruction *ir_analyze_cast(IrAnalyze *ira, IrInstruction *source_instr,
     TypeTableEntry *wanted_type, IrInstruction *value)
 {
@@ -7518,6 +8402,22 @@ static IrInstruction *ir_analyze_cast(IrAnalyze *ira, IrInstruction *source_inst
         return ir_resolve_cast(ira, source_instr, value, wanted_type, CastOpFloatToInt, false);
     }
 
+    // explicit cast from [N]T to @Vector(N, T)
+    if (wanted_type->id == TypeTableEntryIdVector && actual_type->id == TypeTableEntryIdArray &&
+        actual_type->data.array.len == wanted_type->data.vector.len &&
+        actual_type->data.array.child_type == wanted_type->data.vector.elem_type)
+    {
+        return ir_analyze_array_to_vector(ira, source_instr, value, wanted_type);
+    }
+
+    // explicit cast from @Vector(N, T) to [N]T
+    if (wanted_type->id == TypeTableEntryIdArray && actual_type->id == TypeTableEntryIdVector &&
+        wanted_type->data.array.len == actual_type->data.vector.len &&
+        wanted_type->data.array.child_type == actual_type->data.vector.elem_type)
+    {
+        return ir_analyze_vector_to_array(ira, source_instr, value, wanted_type);
+    }
+
     // explicit cast from [N]T to []const T
     if (is_slice(wanted_type) && actual_type->id == TypeTableEntryIdArray) {
         TypeTableEntry *ptr_type = wanted_type->data.structure.fields[slice_ptr_index].type_entry;
@@ -7949,11 +8849,25 @@ static bool ir_resolve_comptime(IrAnalyze *ira, IrInstruction *value, bool *out)
     return ir_resolve_bool(ira, value, out);
 }
 
+static ConstExprValue *get_builtin_value(CodeGen *codegen, const char *name) {
+    Tld *tld = codegen->compile_var_import->decls_scope->decl_table.get(buf_create_from_str(name));
+    resolve_top_level_decl(codegen, tld, false, nullptr);
+    assert(tld->id == TldIdVar);
+    TldVar *tld_var = (TldVar *)tld;
+    ConstExprValue *var_value = tld_var->var->value;
+    assert(var_value != nullptr);
+    return var_value;
+}
+
 static bool ir_resolve_atomic_order(IrAnalyze *ira, IrInstruction *value, AtomicOrder *out) {
     if (type_is_invalid(value->value.type))
         return false;
 
-    IrInstruction *casted_value = ir_implicit_cast(ira, value, ira->codegen->builtin_types.entry_atomic_order_enum);
+    ConstExprValue *atomic_order_val = get_builtin_value(ira->codegen, "AtomicOrder");
+    assert(atomic_order_val->type->id == TypeTableEntryIdMetaType);
+    TypeTableEntry *atomic_order_type = atomic_order_val->data.x_type;
+
+    IrInstruction *casted_value = ir_implicit_cast(ira, value, atomic_order_type);
     if (type_is_invalid(casted_value->value.type))
         return false;
 
@@ -7965,6 +8879,26 @@ static bool ir_resolve_atomic_order(IrAnalyze *ira, IrInstruction *value, Atomic
     return true;
 }
 
+static bool ir_resolve_atomic_rmw_op(IrAnalyze *ira, IrInstruction *value, AtomicRmwOp *out) {
+    if (type_is_invalid(value->value.type))
+        return false;
+
+    ConstExprValue *atomic_rmw_op_val = get_builtin_value(ira->codegen, "AtomicRmwOp");
+    assert(atomic_rmw_op_val->type->id == TypeTableEntryIdMetaType);
+    TypeTableEntry *atomic_rmw_op_type = atomic_rmw_op_val->data.x_type;
+
+    IrInstruction *casted_value = ir_implicit_cast(ira, value, atomic_rmw_op_type);
+    if (type_is_invalid(casted_value->value.type))
+        return false;
+
+    ConstExprValue *const_val = ir_resolve_const(ira, casted_value, UndefBad);
+    if (!const_val)
+        return false;
+
+    *out = (AtomicRmwOp)const_val->data.x_enum.tag;
+    return true;
+}
+
 static bool ir_resolve_global_linkage(IrAnalyze *ira, IrInstruction *value, GlobalLinkageId *out) {
     if (type_is_invalid(value->value.type))
         return false;
@@ -8000,8 +8934,12 @@ static Buf *ir_resolve_str(IrAnalyze *ira, IrInstruction *value) {
 
     assert(ptr_field->data.x_ptr.special == ConstPtrSpecialBaseArray);
     ConstExprValue *array_val = ptr_field->data.x_ptr.data.base_array.array_val;
-    expand_undef_array(ira->codegen, array_val);
     size_t len = bigint_as_unsigned(&len_field->data.x_bigint);
+    if (array_val->data.x_array.special == ConstArraySpecialBuf) {
+        size_t start = ptr_field->data.x_ptr.data.base_array.elem_index;
+        return buf_create_from_mem(buf_ptr(array_val->data.x_array.s_buf) + start, len);
+    }
+    expand_undef_array(ira->codegen, array_val);
     Buf *result = buf_alloc();
     buf_resize(result, len);
     for (size_t i = 0; i < len; i += 1) {
@@ -8019,16 +8957,6 @@ static Buf *ir_resolve_str(IrAnalyze *ira, IrInstruction *value) {
     return result;
 }
 
-static ConstExprValue *get_builtin_value(CodeGen *codegen, const char *name) {
-    Tld *tld = codegen->compile_var_import->decls_scope->decl_table.get(buf_create_from_str(name));
-    resolve_top_level_decl(codegen, tld, false, nullptr);
-    assert(tld->id == TldIdVar);
-    TldVar *tld_var = (TldVar *)tld;
-    ConstExprValue *var_value = tld_var->var->value;
-    assert(var_value != nullptr);
-    return var_value;
-}
-
 static TypeTableEntry *ir_analyze_instruction_return(IrAnalyze *ira,
     IrInstructionReturn *return_instruction)
 {
@@ -8120,6 +9048,8 @@ static bool resolve_cmp_op_id(IrBinOp op_id, Cmp cmp) {
 static TypeTableEntry *ir_analyze_bin_op_cmp(IrAnalyze *ira, IrInstructionBinOp *bin_op_instruction) {
     IrInstruction *op1 = bin_op_instruction->op1->other;
     IrInstruction *op2 = bin_op_instruction->op2->other;
+    if (op1->value.type->id == TypeTableEntryIdVector || op2->value.type->id == TypeTableEntryIdVector)
+        return ir_analyze_bin_op_vector(ira, bin_op_instruction);
 
     IrBinOp op_id = bin_op_instruction->op_id;
     bool is_equality_cmp = (op_id == IrBinOpCmpEq || op_id == IrBinOpCmpNotEq);
@@ -8207,6 +9137,7 @@ static TypeTableEntry *ir_analyze_bin_op_cmp(IrAnalyze *ira, IrInstructionBinOp
 
         case TypeTableEntryIdUnreachable:
         case TypeTableEntryIdArray:
+        case TypeTableEntryIdVector:
         case TypeTableEntryIdStruct:
         case TypeTableEntryIdUndefLit:
         case TypeTableEntryIdNullLit:
@@ -8465,12 +9396,223 @@ static int ir_eval_math_op(TypeTableEntry *type_entry, ConstExprValue *op1_val,
     return 0;
 }
 
-static TypeTableEntry *ir_analyze_bin_op_math(IrAnalyze *ira, IrInstructionBinOp *bin_op_instruction) {
-    IrInstruction *op1 = bin_op_instruction->op1->other;
-    IrInstruction *op2 = bin_op_instruction->op2->other;
-    IrInstruction *instructions[] = {op1, op2};
-    TypeTableEntry *resolved_type = ir_resolve_peer_types(ira, bin_op_instruction->base.source_node, instructions, 2);
-    if (type_is_invalid(resolved_type))
+static void ir_add_math_op_error(IrAnalyze *ira, IrInstruction *source_instr, int err) {
+    if (err == ErrorDivByZero) {
+        ir_add_error(ira, source_instr, buf_sprintf("division by zero is undefined"));
+    } else if (err == ErrorOverflow) {
+        ir_add_error(ira, source_instr, buf_sprintf("operation caused overflow"));
+    } else if (err == ErrorExactDivRemainder) {
+        ir_add_error(ira, source_instr, buf_sprintf("exact division had a remainder"));
+    } else if (err == ErrorNegativeDenominator) {
+        ir_add_error(ira, source_instr, buf_sprintf("negative denominator"));
+    } else {
+        zig_unreachable();
+    }
+}
+
+static bool is_cmp_op(IrBinOp op_id) {
+    switch (op_id) {
+        case IrBinOpCmpEq:
+        case IrBinOpCmpNotEq:
+        case IrBinOpCmpLessThan:
+        case IrBinOpCmpGreaterThan:
+        case IrBinOpCmpLessOrEq:
+        case IrBinOpCmpGreaterOrEq:
+            return true;
+        default:
+            return false;
+    }
+}
+
+static bool vector_op_allowed(TypeTableEntry *elem_type, IrBinOp op_id) {
+    switch (elem_type->id) {
+        case TypeTableEntryIdBool:
+            return op_id == IrBinOpCmpEq || op_id == IrBinOpCmpNotEq ||
+                op_id == IrBinOpBinOr || op_id == IrBinOpBinXor || op_id == IrBinOpBinAnd;
+        case TypeTableEntryIdInt:
+            switch (op_id) {
+                case IrBinOpBinOr:
+                case IrBinOpBinXor:
+                case IrBinOpBinAnd:
+                case IrBinOpBitShiftLeft:
+                case IrBinOpBitShiftLeftWrap:
+                case IrBinOpBitShiftRight:
+                case IrBinOpAdd:
+                case IrBinOpAddWrap:
+                case IrBinOpSub:
+                case IrBinOpSubWrap:
+                case IrBinOpMult:
+                case IrBinOpMultWrap:
+                case IrBinOpDivTrunc:
+                case IrBinOpDivFloor:
+                case IrBinOpDivExact:
+                case IrBinOpRemRem:
+                case IrBinOpRemMod:
+                    return true;
+                default:
+                    return is_cmp_op(op_id);
+            }
+        case TypeTableEntryIdFloat:
+            switch (op_id) {
+                case IrBinOpAdd:
+                case IrBinOpSub:
+                case IrBinOpMult:
+                case IrBinOpDivUnspecified:
+                case IrBinOpDivFloor:
+                case IrBinOpRemRem:
+                case IrBinOpRemMod:
+                    return true;
+                default:
+                    return is_cmp_op(op_id);
+            }
+        default:
+            zig_unreachable();
+    }
+}
+
+static bool is_shift_op(IrBinOp op_id) {
+    return op_id == IrBinOpBitShiftLeft || op_id == IrBinOpBitShiftLeftWrap || op_id == IrBinOpBitShiftRight;
+}
+
+// A vector shift amount has the element type, so it can name a shift as wide
+// as the element or wider.
+static bool vector_shift_amount_fits(TypeTableEntry *elem_type, ConstExprValue *amount_val) {
+    BigInt bit_count;
+    bigint_init_unsigned(&bit_count, elem_type->data.integral.bit_count);
+    return bigint_cmp_zero(&amount_val->data.x_bigint) != CmpLT &&
+        bigint_cmp(&amount_val->data.x_bigint, &bit_count) == CmpLT;
+}
+
+static int ir_eval_vector_elem_op(CodeGen *g, TypeTableEntry *elem_type, ConstExprValue *op1_val,
+        IrBinOp op_id, ConstExprValue *op2_val, ConstExprValue *out_val)
+{
+    if (is_cmp_op(op_id)) {
+        Cmp cmp_result;
+        if (elem_type->id == TypeTableEntryIdFloat) {
+            cmp_result = bigfloat_cmp(&op1_val->data.x_bigfloat, &op2_val->data.x_bigfloat);
+        } else if (elem_type->id == TypeTableEntryIdInt) {
+            cmp_result = bigint_cmp(&op1_val->data.x_bigint, &op2_val->data.x_bigint);
+        } else {
+            cmp_result = (op1_val->data.x_bool == op2_val->data.x_bool) ? CmpEQ : CmpGT;
+        }
+        out_val->data.x_bool = resolve_cmp_op_id(op_id, cmp_result);
+        out_val->type = g->builtin_types.entry_bool;
+        out_val->special = ConstValSpecialStatic;
+        return 0;
+    }
+    if (elem_type->id == TypeTableEntryIdBool) {
+        bool a = op1_val->data.x_bool;
+        bool b = op2_val->data.x_bool;
+        if (op_id == IrBinOpBinOr) {
+            out_val->data.x_bool = a || b;
+        } else if (op_id == IrBinOpBinXor) {
+            out_val->data.x_bool = a != b;
+        } else if (op_id == IrBinOpBinAnd) {
+            out_val->data.x_bool = a && b;
+        } else {
+            zig_unreachable();
+        }
+        out_val->type = elem_type;
+        out_val->special = ConstValSpecialStatic;
+        return 0;
+    }
+    return ir_eval_math_op(elem_type, op1_val, op_id, op2_val, out_val);
+}
+
+// A comptime vector can have undefined elements. Operations that compute
+// with the elements need all of them defined, as scalar operations do.
+static ConstExprValue *ir_resolve_vector_elems(IrAnalyze *ira, IrInstruction *vector) {
+    ConstExprValue *vector_val = ir_resolve_const(ira, vector, UndefBad);
+    if (!vector_val)
+        return nullptr;
+    for (uint32_t i = 0; i < vector_val->type->data.vector.len; i += 1) {
+        if (vector_val->data.x_array.s_none.elements[i].special == ConstValSpecialUndef) {
+            ir_add_error(ira, vector,
+                buf_sprintf("use of undefined value in element %" PRIu32 " of '%s'",
+                    i, buf_ptr(&vector_val->type->name)));
+            return nullptr;
+        }
+    }
+    return vector_val;
+}
+
+// Both operands must have the same vector type; a scalar operand is not
+// broadcast, @splat does that.
+static TypeTableEntry *ir_analyze_bin_op_vector(IrAnalyze *ira, IrInstructionBinOp *bin_op_instruction) {
+    IrInstruction *op1 = bin_op_instruction->op1->other;
+    IrInstruction *op2 = bin_op_instruction->op2->other;
+    IrBinOp op_id = bin_op_instruction->op_id;
+
+    TypeTableEntry *vector_type = (op1->value.type->id == TypeTableEntryIdVector) ?
+        op1->value.type : op2->value.type;
+    TypeTableEntry *elem_type = vector_type->data.vector.elem_type;
+    uint32_t len = vector_type->data.vector.len;
+
+    IrInstruction *casted_op1 = ir_implicit_cast(ira, op1, vector_type);
+    if (casted_op1 == ira->codegen->invalid_instruction)
+        return ira->codegen->builtin_types.entry_invalid;
+
+    IrInstruction *casted_op2 = ir_implicit_cast(ira, op2, vector_type);
+    if (casted_op2 == ira->codegen->invalid_instruction)
+        return ira->codegen->builtin_types.entry_invalid;
+
+    if (elem_type->id == TypeTableEntryIdInt && !elem_type->data.integral.is_signed) {
+        if (op_id == IrBinOpDivUnspecified) {
+            op_id = IrBinOpDivTrunc;
+        } else if (op_id == IrBinOpRemUnspecified) {
+            op_id = IrBinOpRemRem;
+        }
+    }
+
+    if (!vector_op_allowed(elem_type, op_id)) {
+        ir_add_error(ira, &bin_op_instruction->base,
+            buf_sprintf("operator not allowed for type '%s'", buf_ptr(&vector_type->name)));
+        return ira->codegen->builtin_types.entry_invalid;
+    }
+
+    TypeTableEntry *result_type = is_cmp_op(op_id) ?
+        get_vector_type(ira->codegen, ira->codegen->builtin_types.entry_bool, len) : vector_type;
+
+    if (instr_is_comptime(casted_op1) && instr_is_comptime(casted_op2)) {
+        ConstExprValue *op1_val = ir_resolve_vector_elems(ira, casted_op1);
+        if (!op1_val)
+            return ira->codegen->builtin_types.entry_invalid;
+        ConstExprValue *op2_val = ir_resolve_vector_elems(ira, casted_op2);
+        if (!op2_val)
+            return ira->codegen->builtin_types.entry_invalid;
+
+        ConstExprValue *out_val = ir_build_const_from(ira, &bin_op_instruction->base);
+        out_val->data.x_array.s_none.elements = create_const_vals(ira->codegen, len);
+        for (uint32_t i = 0; i < len; i += 1) {
+            if (is_shift_op(op_id) && !vector_shift_amount_fits(elem_type, &op2_val->data.x_array.s_none.elements[i])) {
+                ir_add_error(ira, &bin_op_instruction->base,
+                    buf_sprintf("shift amount is too large for '%s'", buf_ptr(&elem_type->name)));
+                return ira->codegen->builtin_types.entry_invalid;
+            }
+            int err;
+            if ((err = ir_eval_vector_elem_op(ira->codegen, elem_type, &op1_val->data.x_array.s_none.elements[i],
+                op_id, &op2_val->data.x_array.s_none.elements[i], &out_val->data.x_array.s_none.elements[i])))
+            {
+                ir_add_math_op_error(ira, &bin_op_instruction->base, err);
+                return ira->codegen->builtin_types.entry_invalid;
+            }
+        }
+        return result_type;
+    }
+
+    ir_build_bin_op_from(&ira->new_irb, &bin_op_instruction->base, op_id, casted_op1, casted_op2,
+            bin_op_instruction->safety_check_on);
+    return result_type;
+}
+
+static TypeTableEntry *ir_analyze_bin_op_math(IrAnalyze *ira, IrInstructionBinOp *bin_op_instruction) {
+    IrInstruction *op1 = bin_op_instruction->op1->other;
+    IrInstruction *op2 = bin_op_instruction->op2->other;
+    if (op1->value.type->id == TypeTableEntryIdVector || op2->value.type->id == TypeTableEntryIdVector)
+        return ir_analyze_bin_op_vector(ira, bin_op_instruction);
+    IrInstruction *instructions[] = {op1, op2};
+    TypeTableEntry *resolved_type = ir_resolve_peer_types(ira, bin_op_instruction->base.source_node, instructions, 2);
+    if (type_is_invalid(resolved_type))
         return resolved_type;
     IrBinOp op_id = bin_op_instruction->op_id;
 
@@ -8609,21 +9751,7 @@ static TypeTableEntry *ir_analyze_bin_op_math(IrAnalyze *ira, IrInstructionBinOp
 
         int err;
         if ((err = ir_eval_math_op(resolved_type, op1_val, op_id, op2_val, out_val))) {
-            if (err == ErrorDivByZero) {
-                ir_add_error(ira, &bin_op_instruction->base, buf_sprintf("division by zero is undefined"));
-                return ira->codegen->builtin_types.entry_invalid;
-            } else if (err == ErrorOverflow) {
-                ir_add_error(ira, &bin_op_instruction->base, buf_sprintf("operation caused overflow"));
-                return ira->codegen->builtin_types.entry_invalid;
-            } else if (err == ErrorExactDivRemainder) {
-                ir_add_error(ira, &bin_op_instruction->base, buf_sprintf("exact division had a remainder"));
-                return ira->codegen->builtin_types.entry_invalid;
-            } else if (err == ErrorNegativeDenominator) {
-                ir_add_error(ira, &bin_op_instruction->base, buf_sprintf("negative denominator"));
-                return ira->codegen->builtin_types.entry_invalid;
-            } else {
-                zig_unreachable();
-            }
+            ir_add_math_op_error(ira, &bin_op_instruction->base, err);
             return ira->codegen->builtin_types.entry_invalid;
         }
 
@@ -8748,7 +9876,7 @@ static TypeTableEntry *ir_analyze_array_cat(IrAnalyze *ira, IrInstructionBinOp *
 
         result_type = get_pointer_to_type(ira->codegen, child_type, true);
 
-        out_array_val = create_const_vals(1);
+        out_array_val = create_const_vals(ira->codegen, 1);
         out_array_val->special = ConstValSpecialStatic;
         out_array_val->type = get_array_type(ira->codegen, child_type, new_len);
         out_val->data.x_ptr.special = ConstPtrSpecialBaseArray;
@@ -8756,9 +9884,27 @@ static TypeTableEntry *ir_analyze_array_cat(IrAnalyze *ira, IrInstructionBinOp *
         out_val->data.x_ptr.data.base_array.array_val = out_array_val;
         out_val->data.x_ptr.data.base_array.elem_index = 0;
     }
-    out_array_val->data.x_array.s_none.elements = create_const_vals(new_len);
+
+    if (op1_array_val->data.x_array.special == ConstArraySpecialBuf &&
+        op2_array_val->data.x_array.special == ConstArraySpecialBuf)
+    {
+        Buf *out_buf = buf_alloc();
+        buf_append_mem(out_buf, buf_ptr(op1_array_val->data.x_array.s_buf) + op1_array_index,
+                op1_array_end - op1_array_index);
+        buf_append_mem(out_buf, buf_ptr(op2_array_val->data.x_array.s_buf) + op2_array_index,
+                op2_array_end - op2_array_index);
+        if (buf_len(out_buf) < new_len)
+            buf_append_char(out_buf, 0);
+        assert(buf_len(out_buf) == new_len);
+        out_array_val->data.x_array.special = ConstArraySpecialBuf;
+        out_array_val->data.x_array.s_buf = out_buf;
+        return result_type;
+    }
+
+    out_array_val->data.x_array.s_none.elements = create_const_vals(ira->codegen, new_len);
 
     expand_undef_array(ira->codegen, op1_array_val);
+    expand_undef_array(ira->codegen, op2_array_val);
 
     size_t next_index = 0;
     for (size_t i = op1_array_index; i < op1_array_end; i += 1, next_index += 1) {
@@ -8812,7 +9958,19 @@ static TypeTableEntry *ir_analyze_array_mult(IrAnalyze *ira, IrInstructionBinOp
 
     ConstExprValue *out_val = ir_build_const_from(ira, &instruction->base);
 
-    out_val->data.x_array.s_none.elements = create_const_vals(new_array_len);
+    TypeTableEntry *child_type = array_type->data.array.child_type;
+
+    if (array_val->data.x_array.special == ConstArraySpecialBuf) {
+        Buf *out_buf = buf_alloc();
+        for (uint64_t x = 0; x < mult_amt; x += 1) {
+            buf_append_buf(out_buf, array_val->data.x_array.s_buf);
+        }
+        out_val->data.x_array.special = ConstArraySpecialBuf;
+        out_val->data.x_array.s_buf = out_buf;
+        return get_array_type(ira->codegen, child_type, new_array_len);
+    }
+
+    out_val->data.x_array.s_none.elements = create_const_vals(ira->codegen, new_array_len);
 
     expand_undef_array(ira->codegen, array_val);
 
@@ -8825,7 +9983,6 @@ static TypeTableEntry *ir_analyze_array_mult(IrAnalyze *ira, IrInstructionBinOp
     }
     assert(i == new_array_len);
 
-    TypeTableEntry *child_type = array_type->data.array.child_type;
     return get_array_type(ira->codegen, child_type, new_array_len);
 }
 
@@ -8943,6 +10100,7 @@ static TypeTableEntry *ir_analyze_instruction_decl_var(IrAnalyze *ira, IrInstruc
         case TypeTableEntryIdFloat:
         case TypeTableEntryIdPointer:
         case TypeTableEntryIdArray:
+        case TypeTableEntryIdVector:
         case TypeTableEntryIdStruct:
         case TypeTableEntryIdMaybe:
         case TypeTableEntryIdErrorUnion:
@@ -9061,7 +10219,7 @@ static bool ir_analyze_fn_call_generic_arg(IrAnalyze *ira, AstNode *fn_proto_nod
         if (!arg_val)
             return false;
     } else {
-        arg_val = create_const_runtime(casted_arg->value.type);
+        arg_val = create_const_runtime(ira->codegen, casted_arg->value.type);
     }
     if (arg_part_of_generic_id) {
         generic_id->params[generic_id->param_count] = *arg_val;
@@ -9243,15 +10401,20 @@ static TypeTableEntry *ir_analyze_fn_call(IrAnalyze *ira, IrInstructionCall *cal
 
         IrInstruction *result;
 
+        ira->codegen->comptime_call_count += 1;
         auto entry = ira->codegen->memoized_fn_eval_table.maybe_get(exec_scope);
         if (entry) {
+            ira->codegen->comptime_call_memoized_count += 1;
             result = entry->value;
         } else {
             // Analyze the fn body block like any other constant expression.
             AstNode *body_node = fn_entry->body_node;
+            size_t comptime_span = profile_begin(ira->codegen, ProfileCategoryComptimeCall,
+                    &fn_entry->symbol_name, call_instruction->base.source_node);
             result = ir_eval_const_value(ira->codegen, exec_scope, body_node, return_type,
                 ira->new_irb.exec->backward_branch_count, ira->new_irb.exec->backward_branch_quota, fn_entry,
                 nullptr, call_instruction->base.source_node, nullptr, ira->new_irb.exec);
+            profile_end(ira->codegen, comptime_span);
             if (type_is_invalid(result->value.type))
                 return ira->codegen->builtin_types.entry_invalid;
 
@@ -9303,7 +10466,7 @@ static TypeTableEntry *ir_analyze_fn_call(IrAnalyze *ira, IrInstructionCall *cal
         GenericFnTypeId *generic_id = allocate<GenericFnTypeId>(1);
         generic_id->fn_entry = fn_entry;
         generic_id->param_count = 0;
-        generic_id->params = create_const_vals(new_fn_arg_count);
+        generic_id->params = create_const_vals(ira->codegen, new_fn_arg_count);
         size_t next_proto_i = 0;
 
         if (first_arg_ptr) {
@@ -9558,6 +10721,7 @@ static TypeTableEntry *ir_analyze_unary_prefix_op_err(IrAnalyze *ira, IrInstruct
         case TypeTableEntryIdFloat:
         case TypeTableEntryIdPointer:
         case TypeTableEntryIdArray:
+        case TypeTableEntryIdVector:
         case TypeTableEntryIdStruct:
         case TypeTableEntryIdMaybe:
         case TypeTableEntryIdErrorUnion:
@@ -9640,6 +10804,7 @@ static TypeTableEntry *ir_analyze_maybe(IrAnalyze *ira, IrInstructionUnOp *un_op
         case TypeTableEntryIdFloat:
         case TypeTableEntryIdPointer:
         case TypeTableEntryIdArray:
+        case TypeTableEntryIdVector:
         case TypeTableEntryIdStruct:
         case TypeTableEntryIdNumLitFloat:
         case TypeTableEntryIdNumLitInt:
@@ -10280,7 +11445,7 @@ static TypeTableEntry *ir_analyze_decl_ref(IrAnalyze *ira, IrInstruction *source
             TldVar *tld_var = (TldVar *)tld;
             VariableTableEntry *var = tld_var->var;
             if (tld_var->extern_lib_name != nullptr) {
-                add_link_lib_symbol(ira->codegen, tld_var->extern_lib_name, &var->name);
+                add_link_lib_symbol(ira->codegen, tld_var->extern_lib_name, var->name);
             }
 
             return ir_analyze_var_ptr(ira, source_instruction, var, false, false);
@@ -10296,7 +11461,7 @@ static TypeTableEntry *ir_analyze_decl_ref(IrAnalyze *ira, IrInstruction *source
 
             // TODO instead of allocating this every time, put it in the tld value and we can reference
             // the same one every time
-            ConstExprValue *const_val = create_const_vals(1);
+            ConstExprValue *const_val = create_const_vals(ira->codegen, 1);
             const_val->special = ConstValSpecialStatic;
             const_val->type = fn_entry->type_entry;
             const_val->data.x_fn.fn_entry = fn_entry;
@@ -10344,7 +11509,7 @@ static TypeTableEntry *ir_analyze_instruction_field_ptr(IrAnalyze *ira, IrInstru
         }
     } else if (container_type->id == TypeTableEntryIdArray) {
         if (buf_eql_str(field_name, "len")) {
-            ConstExprValue *len_val = create_const_vals(1);
+            ConstExprValue *len_val = create_const_vals(ira->codegen, 1);
             init_const_usize(ira->codegen, len_val, container_type->data.array.len);
 
             TypeTableEntry *usize = ira->codegen->builtin_types.entry_usize;
@@ -10367,7 +11532,7 @@ static TypeTableEntry *ir_analyze_instruction_field_ptr(IrAnalyze *ira, IrInstru
         ConstExprValue *child_val = const_ptr_pointee(ira->codegen, container_ptr_val);
 
         if (buf_eql_str(field_name, "len")) {
-            ConstExprValue *len_val = create_const_vals(1);
+            ConstExprValue *len_val = create_const_vals(ira->codegen, 1);
             size_t len = child_val->data.x_arg_tuple.end_index - child_val->data.x_arg_tuple.start_index;
             init_const_usize(ira->codegen, len_val, len);
 
@@ -10413,13 +11578,13 @@ static TypeTableEntry *ir_analyze_instruction_field_ptr(IrAnalyze *ira, IrInstru
                         bool ptr_is_const = true;
                         bool ptr_is_volatile = false;
                         return ir_analyze_const_ptr(ira, &field_ptr_instruction->base,
-                                create_const_enum_tag(child_type, field->value), child_type,
+                                create_const_enum_tag(ira->codegen, child_type, field->value), child_type,
                                 ConstPtrMutComptimeConst, ptr_is_const, ptr_is_volatile);
                     } else {
                         bool ptr_is_const = true;
                         bool ptr_is_volatile = false;
                         return ir_analyze_const_ptr(ira, &field_ptr_instruction->base,
-                            create_const_unsigned_negative(child_type->data.enumeration.tag_type, field->value, false),
+                            create_const_unsigned_negative(ira->codegen, child_type->data.enumeration.tag_type, field->value, false),
                             child_type->data.enumeration.tag_type,
                             ConstPtrMutComptimeConst, ptr_is_const, ptr_is_volatile);
                     }
@@ -10440,7 +11605,7 @@ static TypeTableEntry *ir_analyze_instruction_field_ptr(IrAnalyze *ira, IrInstru
         } else if (child_type->id == TypeTableEntryIdPureError) {
             auto err_table_entry = ira->codegen->error_table.maybe_get(field_name);
             if (err_table_entry) {
-                ConstExprValue *const_val = create_const_vals(1);
+                ConstExprValue *const_val = create_const_vals(ira->codegen, 1);
                 const_val->special = ConstValSpecialStatic;
                 const_val->type = child_type;
                 const_val->data.x_pure_err = err_table_entry->value;
@@ -10459,7 +11624,7 @@ static TypeTableEntry *ir_analyze_instruction_field_ptr(IrAnalyze *ira, IrInstru
                 bool ptr_is_const = true;
                 bool ptr_is_volatile = false;
                 return ir_analyze_const_ptr(ira, &field_ptr_instruction->base,
-                    create_const_unsigned_negative(ira->codegen->builtin_types.entry_num_lit_int,
+                    create_const_unsigned_negative(ira->codegen, ira->codegen->builtin_types.entry_num_lit_int,
                         child_type->data.integral.bit_count, false),
                     ira->codegen->builtin_types.entry_num_lit_int,
                     ConstPtrMutComptimeConst, ptr_is_const, ptr_is_volatile);
@@ -10481,7 +11646,7 @@ static TypeTableEntry *ir_analyze_instruction_field_ptr(IrAnalyze *ira, IrInstru
                 bool ptr_is_const = true;
                 bool ptr_is_volatile = false;
                 return ir_analyze_const_ptr(ira, &field_ptr_instruction->base,
-                    create_const_unsigned_negative(ira->codegen->builtin_types.entry_num_lit_int,
+                    create_const_unsigned_negative(ira->codegen, ira->codegen->builtin_types.entry_num_lit_int,
                         child_type->data.floating.bit_count, false),
                     ira->codegen->builtin_types.entry_num_lit_int,
                     ConstPtrMutComptimeConst, ptr_is_const, ptr_is_volatile);
@@ -10621,6 +11786,7 @@ static TypeTableEntry *ir_analyze_instruction_typeof(IrAnalyze *ira, IrInstructi
         case TypeTableEntryIdFloat:
         case TypeTableEntryIdPointer:
         case TypeTableEntryIdArray:
+        case TypeTableEntryIdVector:
         case TypeTableEntryIdStruct:
         case TypeTableEntryIdMaybe:
         case TypeTableEntryIdErrorUnion:
@@ -10719,7 +11885,7 @@ static TypeTableEntry *ir_analyze_instruction_set_global_align(IrAnalyze *ira,
 
         if (tld_var->var->linkage == VarLinkageExternal) {
             ErrorMsg *msg = ir_add_error(ira, &instruction->base,
-                    buf_sprintf("cannot set alignment of external variable '%s'", buf_ptr(&tld_var->var->name)));
+                    buf_sprintf("cannot set alignment of external variable '%s'", buf_ptr(tld_var->var->name)));
             add_error_note(ira->codegen, msg, tld->source_node, buf_sprintf("declared here"));
             return ira->codegen->builtin_types.entry_invalid;
         }
@@ -10777,7 +11943,7 @@ static TypeTableEntry *ir_analyze_instruction_set_global_section(IrAnalyze *ira,
 
         if (tld_var->var->linkage == VarLinkageExternal) {
             ErrorMsg *msg = ir_add_error(ira, &instruction->base,
-                    buf_sprintf("cannot set section of external variable '%s'", buf_ptr(&tld_var->var->name)));
+                    buf_sprintf("cannot set section of external variable '%s'", buf_ptr(tld_var->var->name)));
             add_error_note(ira->codegen, msg, tld->source_node, buf_sprintf("declared here"));
             return ira->codegen->builtin_types.entry_invalid;
         }
@@ -10845,6 +12011,8 @@ static TypeTableEntry *ir_analyze_instruction_set_global_linkage(IrAnalyze *ira,
     }
     *set_global_linkage_node = source_node;
     *dest_linkage_ptr = linkage_scalar;
+    if (tld->id == TldIdFn && linkage_scalar != GlobalLinkageIdInternal)
+        queue_fn_analysis(ira->codegen, ((TldFn *)tld)->fn_entry);
 
     ir_build_const_from(ira, &instruction->base);
     return ira->codegen->builtin_types.entry_void;
@@ -11031,6 +12199,7 @@ static TypeTableEntry *ir_analyze_instruction_slice_type(IrAnalyze *ira,
         case TypeTableEntryIdFloat:
         case TypeTableEntryIdPointer:
         case TypeTableEntryIdArray:
+        case TypeTableEntryIdVector:
         case TypeTableEntryIdStruct:
         case TypeTableEntryIdNumLitFloat:
         case TypeTableEntryIdNumLitInt:
@@ -11138,6 +12307,7 @@ static TypeTableEntry *ir_analyze_instruction_array_type(IrAnalyze *ira,
         case TypeTableEntryIdFloat:
         case TypeTableEntryIdPointer:
         case TypeTableEntryIdArray:
+        case TypeTableEntryIdVector:
         case TypeTableEntryIdStruct:
         case TypeTableEntryIdNumLitFloat:
         case TypeTableEntryIdNumLitInt:
@@ -11194,6 +12364,7 @@ static TypeTableEntry *ir_analyze_instruction_size_of(IrAnalyze *ira,
         case TypeTableEntryIdFloat:
         case TypeTableEntryIdPointer:
         case TypeTableEntryIdArray:
+        case TypeTableEntryIdVector:
         case TypeTableEntryIdStruct:
         case TypeTableEntryIdMaybe:
         case TypeTableEntryIdErrorUnion:
@@ -11565,6 +12736,7 @@ static TypeTableEntry *ir_analyze_instruction_switch_target(IrAnalyze *ira,
         case TypeTableEntryIdBoundFn:
         case TypeTableEntryIdArgTuple:
         case TypeTableEntryIdOpaque:
+        case TypeTableEntryIdVector:
             ir_add_error(ira, &switch_target_instruction->base,
                 buf_sprintf("invalid switch target type '%s'", buf_ptr(&target_type->name)));
             return ira->codegen->builtin_types.entry_invalid;
@@ -11681,7 +12853,16 @@ static TypeTableEntry *ir_analyze_instruction_import(IrAnalyze *ira, IrInstructi
         return ira->codegen->builtin_types.entry_namespace;
     }
 
-    if ((err = os_fetch_file_path(abs_full_path, import_code))) {
+    ImportTableEntry *target_import = add_prefetched_source_file(ira->codegen, target_package, abs_full_path);
+    if (target_import) {
+        scan_import(ira->codegen, target_import);
+
+        ConstExprValue *out_val = ir_build_const_from(ira, &import_instruction->base);
+        out_val->data.x_import = target_import;
+        return ira->codegen->builtin_types.entry_namespace;
+    }
+
+    if ((err = os_map_file_path(abs_full_path, import_code))) {
         if (err == ErrorFileNotFound) {
             ir_add_error_node(ira, source_node,
                     buf_sprintf("unable to find '%s'", buf_ptr(import_target_path)));
@@ -11692,7 +12873,7 @@ static TypeTableEntry *ir_analyze_instruction_import(IrAnalyze *ira, IrInstructi
             return ira->codegen->builtin_types.entry_invalid;
         }
     }
-    ImportTableEntry *target_import = add_source_file(ira->codegen, target_package, abs_full_path, import_code);
+    target_import = add_source_file(ira->codegen, target_package, abs_full_path, import_code);
 
     scan_import(ira->codegen, target_import);
 
@@ -11764,7 +12945,7 @@ static TypeTableEntry *ir_analyze_container_init_fields(IrAnalyze *ira, IrInstru
     ConstExprValue const_val = {};
     const_val.special = ConstValSpecialStatic;
     const_val.type = container_type;
-    const_val.data.x_struct.fields = create_const_vals(actual_field_count);
+    const_val.data.x_struct.fields = create_const_vals(ira->codegen, actual_field_count);
     for (size_t i = 0; i < instr_field_count; i += 1) {
         IrInstructionContainerInitFieldsField *field = &fields[i];
 
@@ -11879,7 +13060,7 @@ static TypeTableEntry *ir_analyze_instruction_container_init_list(IrAnalyze *ira
             ConstExprValue const_val = {};
             const_val.special = ConstValSpecialStatic;
             const_val.type = fixed_size_array_type;
-            const_val.data.x_array.s_none.elements = create_const_vals(elem_count);
+            const_val.data.x_array.s_none.elements = create_const_vals(ira->codegen, elem_count);
 
             bool is_comptime = ir_should_inline(ira->new_irb.exec, instruction->base.scope);
 
@@ -12042,6 +13223,7 @@ static TypeTableEntry *ir_analyze_min_max(IrAnalyze *ira, IrInstruction *source_
         case TypeTableEntryIdUnreachable:
         case TypeTableEntryIdPointer:
         case TypeTableEntryIdArray:
+        case TypeTableEntryIdVector:
         case TypeTableEntryIdStruct:
         case TypeTableEntryIdNumLitFloat:
         case TypeTableEntryIdNumLitInt:
@@ -12316,6 +13498,434 @@ static TypeTableEntry *ir_analyze_instruction_type_id(IrAnalyze *ira,
     return result_type;
 }
 
+static bool ir_resolve_vector_len(IrAnalyze *ira, IrInstruction *value, uint32_t *out) {
+    uint64_t len;
+    if (!ir_resolve_usize(ira, value, &len))
+        return false;
+
+    if (len == 0 || len > UINT32_MAX) {
+        ir_add_error(ira, value, buf_sprintf("vector length %" ZIG_PRI_u64 " out of range", len));
+        return false;
+    }
+    *out = (uint32_t)len;
+    return true;
+}
+
+static bool ir_check_vector_elem_type(IrAnalyze *ira, IrInstruction *source_instr, TypeTableEntry *elem_type) {
+    if (!is_valid_vector_elem_type(elem_type)) {
+        ir_add_error(ira, source_instr,
+            buf_sprintf("vector element type must be an integer, float or bool, found '%s'",
+                buf_ptr(&elem_type->name)));
+        return false;
+    }
+    return true;
+}
+
+static bool ir_check_vector(IrAnalyze *ira, IrInstruction *value) {
+    if (value->value.type->id != TypeTableEntryIdVector) {
+        ir_add_error(ira, value,
+            buf_sprintf("expected vector, found '%s'", buf_ptr(&value->value.type->name)));
+        return false;
+    }
+    return true;
+}
+
+static TypeTableEntry *ir_analyze_instruction_vector_type(IrAnalyze *ira,
+        IrInstructionVectorType *instruction)
+{
+    uint32_t len;
+    if (!ir_resolve_vector_len(ira, instruction->len->other, &len))
+        return ira->codegen->builtin_types.entry_invalid;
+
+    IrInstruction *elem_type_value = instruction->elem_type->other;
+    TypeTableEntry *elem_type = ir_resolve_type(ira, elem_type_value);
+    if (type_is_invalid(elem_type))
+        return ira->codegen->builtin_types.entry_invalid;
+    if (!ir_check_vector_elem_type(ira, elem_type_value, elem_type))
+        return ira->codegen->builtin_types.entry_invalid;
+
+    ConstExprValue *out_val = ir_build_const_from(ira, &instruction->base);
+    out_val->data.x_type = get_vector_type(ira->codegen, elem_type, len);
+    return ira->codegen->builtin_types.entry_type;
+}
+
+static TypeTableEntry *ir_analyze_instruction_splat(IrAnalyze *ira, IrInstructionSplat *instruction) {
+    uint32_t len;
+    if (!ir_resolve_vector_len(ira, instruction->len->other, &len))
+        return ira->codegen->builtin_types.entry_invalid;
+
+    IrInstruction *scalar = instruction->scalar->other;
+    TypeTableEntry *elem_type = scalar->value.type;
+    if (type_is_invalid(elem_type))
+        return ira->codegen->builtin_types.entry_invalid;
+    if (!ir_check_vector_elem_type(ira, scalar, elem_type))
+        return ira->codegen->builtin_types.entry_invalid;
+
+    TypeTableEntry *vector_type = get_vector_type(ira->codegen, elem_type, len);
+
+    if (instr_is_comptime(scalar)) {
+        ConstExprValue *scalar_val = ir_resolve_const(ira, scalar, UndefBad);
+        if (!scalar_val)
+            return ira->codegen->builtin_types.entry_invalid;
+
+        ConstExprValue *out_val = ir_build_const_from(ira, &instruction->base);
+        out_val->data.x_array.s_none.elements = create_const_vals(ira->codegen, len);
+        for (uint32_t i = 0; i < len; i += 1) {
+            copy_const_val(&out_val->data.x_array.s_none.elements[i], scalar_val, true);
+        }
+        return vector_type;
+    }
+
+    ir_build_splat_from(&ira->new_irb, &instruction->base, scalar);
+    return vector_type;
+}
+
+static TypeTableEntry *ir_analyze_instruction_shuffle(IrAnalyze *ira, IrInstructionShuffle *instruction) {
+    IrInstruction *elem_type_value = instruction->elem_type->other;
+    TypeTableEntry *elem_type = ir_resolve_type(ira, elem_type_value);
+    if (type_is_invalid(elem_type))
+        return ira->codegen->builtin_types.entry_invalid;
+    if (!ir_check_vector_elem_type(ira, elem_type_value, elem_type))
+        return ira->codegen->builtin_types.entry_invalid;
+
+    IrInstruction *a = instruction->a->other;
+    if (type_is_invalid(a->value.type))
+        return ira->codegen->builtin_types.entry_invalid;
+    if (a->value.type->id != TypeTableEntryIdVector || a->value.type->data.vector.elem_type != elem_type) {
+        ir_add_error(ira, a,
+            buf_sprintf("expected vector of '%s', found '%s'",
+                buf_ptr(&elem_type->name), buf_ptr(&a->value.type->name)));
+        return ira->codegen->builtin_types.entry_invalid;
+    }
+    TypeTableEntry *operand_type = a->value.type;
+    uint32_t operand_len = operand_type->data.vector.len;
+
+    IrInstruction *b = ir_implicit_cast(ira, instruction->b->other, operand_type);
+    if (type_is_invalid(b->value.type))
+        return ira->codegen->builtin_types.entry_invalid;
+
+    // the mask is a [N]i32 or a @Vector(N, i32) known at compile time
+    IrInstruction *mask = instruction->mask->other;
+    TypeTableEntry *mask_type = mask->value.type;
+    if (type_is_invalid(mask_type))
+        return ira->codegen->builtin_types.entry_invalid;
+    TypeTableEntry *i32_type = ira->codegen->builtin_types.entry_i32;
+    uint32_t mask_len;
+    if (mask_type->id == TypeTableEntryIdArray && mask_type->data.array.len != 0 &&
+        mask_type->data.array.len <= UINT32_MAX)
+    {
+        mask_len = (uint32_t)mask_type->data.array.len;
+        mask = ir_implicit_cast(ira, mask, get_array_type(ira->codegen, i32_type, mask_len));
+    } else if (mask_type->id == TypeTableEntryIdVector) {
+        mask_len = mask_type->data.vector.len;
+        mask = ir_implicit_cast(ira, mask, get_vector_type(ira->codegen, i32_type, mask_len));
+    } else {
+        ir_add_error(ira, mask,
+            buf_sprintf("expected array or vector of 'i32', found '%s'", buf_ptr(&mask_type->name)));
+        return ira->codegen->builtin_types.entry_invalid;
+    }
+    if (type_is_invalid(mask->value.type))
+        return ira->codegen->builtin_types.entry_invalid;
+    ConstExprValue *mask_val = ir_resolve_const(ira, mask, UndefBad);
+    if (!mask_val)
+        return ira->codegen->builtin_types.entry_invalid;
+    if (mask_val->type->id == TypeTableEntryIdArray)
+        expand_undef_array(ira->codegen, mask_val);
+
+    // an entry selects a[entry] when it is positive or zero and b[~entry] otherwise
+    int32_t *mask_indexes = allocate<int32_t>(mask_len);
+    for (uint32_t i = 0; i < mask_len; i += 1) {
+        ConstExprValue *elem_val = &mask_val->data.x_array.s_none.elements[i];
+        if (elem_val->special == ConstValSpecialUndef) {
+            ir_add_error(ira, mask, buf_sprintf("use of undefined value"));
+            return ira->codegen->builtin_types.entry_invalid;
+        }
+        int32_t mask_index = (int32_t)bigint_as_signed(&elem_val->data.x_bigint);
+        uint32_t operand_index = (mask_index >= 0) ? (uint32_t)mask_index : ~(uint32_t)mask_index;
+        if (operand_index >= operand_len) {
+            ir_add_error(ira, mask,
+                buf_sprintf("mask index %" PRIu32 " selects element %" PRIu32 " of '%s' which has %" PRIu32 " elements",
+                    i, operand_index, buf_ptr(&operand_type->name), operand_len));
+            return ira->codegen->builtin_types.entry_invalid;
+        }
+        mask_indexes[i] = mask_index;
+    }
+
+    TypeTableEntry *result_type = get_vector_type(ira->codegen, elem_type, mask_len);
+
+    if (instr_is_comptime(a) && instr_is_comptime(b)) {
+        ConstExprValue *a_val = ir_resolve_const(ira, a, UndefOk);
+        if (!a_val)
+            return ira->codegen->builtin_types.entry_invalid;
+        ConstExprValue *b_val = ir_resolve_const(ira, b, UndefOk);
+        if (!b_val)
+            return ira->codegen->builtin_types.entry_invalid;
+
+        ConstExprValue *out_val = ir_build_const_from(ira, &instruction->base);
+        out_val->data.x_array.s_none.elements = create_const_vals(ira->codegen, mask_len);
+        for (uint32_t i = 0; i < mask_len; i += 1) {
+            int32_t mask_index = mask_indexes[i];
+            ConstExprValue *src_val = (mask_index >= 0) ? a_val : b_val;
+            ConstExprValue *elem_val = &out_val->data.x_array.s_none.elements[i];
+            if (src_val->special == ConstValSpecialUndef) {
+                elem_val->type = elem_type;
+                elem_val->special = ConstValSpecialUndef;
+                continue;
+            }
+            uint32_t operand_index = (mask_index >= 0) ? (uint32_t)mask_index : ~(uint32_t)mask_index;
+            copy_const_val(elem_val, &src_val->data.x_array.s_none.elements[operand_index], true);
+        }
+        return result_type;
+    }
+
+    ir_build_shuffle_from(&ira->new_irb, &instruction->base, a, b, mask_indexes, mask_len);
+    return result_type;
+}
+
+static TypeTableEntry *ir_analyze_instruction_extract_element(IrAnalyze *ira,
+        IrInstructionExtractElement *instruction)
+{
+    IrInstruction *vector = instruction->vector->other;
+    if (type_is_invalid(vector->value.type))
+        return ira->codegen->builtin_types.entry_invalid;
+    if (!ir_check_vector(ira, vector))
+        return ira->codegen->builtin_types.entry_invalid;
+    TypeTableEntry *vector_type = vector->value.type;
+    TypeTableEntry *elem_type = vector_type->data.vector.elem_type;
+
+    IrInstruction *index = ir_implicit_cast(ira, instruction->index->other, ira->codegen->builtin_types.entry_usize);
+    if (type_is_invalid(index->value.type))
+        return ira->codegen->builtin_types.entry_invalid;
+
+    if (instr_is_comptime(index)) {
+        ConstExprValue *index_val = ir_resolve_const(ira, index, UndefBad);
+        if (!index_val)
+            return ira->codegen->builtin_types.entry_invalid;
+        uint64_t index_int = bigint_as_unsigned(&index_val->data.x_bigint);
+        if (index_int >= vector_type->data.vector.len) {
+            ir_add_error(ira, index,
+                buf_sprintf("index %" ZIG_PRI_u64 " outside vector of size %" PRIu32,
+                    index_int, vector_type->data.vector.len));
+            return ira->codegen->builtin_types.entry_invalid;
+        }
+
+        if (instr_is_comptime(vector)) {
+            ConstExprValue *vector_val = ir_resolve_const(ira, vector, UndefOk);
+            if (!vector_val)
+                return ira->codegen->builtin_types.entry_invalid;
+
+            ConstExprValue *out_val = ir_build_const_from(ira, &instruction->base);
+            if (vector_val->special == ConstValSpecialUndef) {
+                out_val->special = ConstValSpecialUndef;
+                return elem_type;
+            }
+            copy_const_val(out_val, &vector_val->data.x_array.s_none.elements[index_int], true);
+            return elem_type;
+        }
+    }
+
+    ir_build_extract_element_from(&ira->new_irb, &instruction->base, vector, index);
+    return elem_type;
+}
+
+static TypeTableEntry *ir_analyze_instruction_insert_element(IrAnalyze *ira,
+        IrInstructionInsertElement *instruction)
+{
+    IrInstruction *vector = instruction->vector->other;
+    if (type_is_invalid(vector->value.type))
+        return ira->codegen->builtin_types.entry_invalid;
+    if (!ir_check_vector(ira, vector))
+        return ira->codegen->builtin_types.entry_invalid;
+    TypeTableEntry *vector_type = vector->value.type;
+    uint32_t len = vector_type->data.vector.len;
+
+    IrInstruction *index = ir_implicit_cast(ira, instruction->index->other, ira->codegen->builtin_types.entry_usize);
+    if (type_is_invalid(index->value.type))
+        return ira->codegen->builtin_types.entry_invalid;
+
+    IrInstruction *value = ir_implicit_cast(ira, instruction->value->other, vector_type->data.vector.elem_type);
+    if (type_is_invalid(value->value.type))
+        return ira->codegen->builtin_types.entry_invalid;
+
+    if (instr_is_comptime(index)) {
+        ConstExprValue *index_val = ir_resolve_const(ira, index, UndefBad);
+        if (!index_val)
+            return ira->codegen->builtin_types.entry_invalid;
+        uint64_t index_int = bigint_as_unsigned(&index_val->data.x_bigint);
+        if (index_int >= len) {
+            ir_add_error(ira, index,
+                buf_sprintf("index %" ZIG_PRI_u64 " outside vector of size %" PRIu32, index_int, len));
+            return ira->codegen->builtin_types.entry_invalid;
+        }
+
+        if (instr_is_comptime(vector) && instr_is_comptime(value)) {
+            // filling in an undefined vector one element at a time is fine;
+            // the elements not written yet stay undefined
+            ConstExprValue *vector_val = ir_resolve_const(ira, vector, UndefOk);
+            if (!vector_val)
+                return ira->codegen->builtin_types.entry_invalid;
+            ConstExprValue *value_val = ir_resolve_const(ira, value, UndefOk);
+            if (!value_val)
+                return ira->codegen->builtin_types.entry_invalid;
+
+            ConstExprValue *out_val = ir_build_const_from(ira, &instruction->base);
+            out_val->data.x_array.s_none.elements = create_const_vals(ira->codegen, len);
+            for (uint32_t i = 0; i < len; i += 1) {
+                ConstExprValue *elem_val = &out_val->data.x_array.s_none.elements[i];
+                if (i == index_int) {
+                    copy_const_val(elem_val, value_val, true);
+                } else if (vector_val->special == ConstValSpecialUndef) {
+                    elem_val->type = vector_type->data.vector.elem_type;
+                    elem_val->special = ConstValSpecialUndef;
+                } else {
+                    copy_const_val(elem_val, &vector_val->data.x_array.s_none.elements[i], true);
+                }
+            }
+            return vector_type;
+        }
+    }
+
+    ir_build_insert_element_from(&ira->new_irb, &instruction->base, vector, index, value);
+    return vector_type;
+}
+
+static bool ir_resolve_reduce_op(IrAnalyze *ira, IrInstruction *value, ReduceOp *out) {
+    if (type_is_invalid(value->value.type))
+        return false;
+
+    ConstExprValue *reduce_op_val = get_builtin_value(ira->codegen, "ReduceOp");
+    assert(reduce_op_val->type->id == TypeTableEntryIdMetaType);
+    TypeTableEntry *reduce_op_type = reduce_op_val->data.x_type;
+
+    IrInstruction *casted_value = ir_implicit_cast(ira, value, reduce_op_type);
+    if (type_is_invalid(casted_value->value.type))
+        return false;
+
+    ConstExprValue *const_val = ir_resolve_const(ira, casted_value, UndefBad);
+    if (!const_val)
+        return false;
+
+    *out = (ReduceOp)const_val->data.x_enum.tag;
+    return true;
+}
+
+static bool reduce_op_allowed(TypeTableEntry *elem_type, ReduceOp op) {
+    switch (elem_type->id) {
+        case TypeTableEntryIdBool:
+            return op == ReduceOpAnd || op == ReduceOpOr || op == ReduceOpXor;
+        case TypeTableEntryIdInt:
+            return true;
+        case TypeTableEntryIdFloat:
+            return op == ReduceOpAdd || op == ReduceOpMul || op == ReduceOpMin || op == ReduceOpMax;
+        default:
+            zig_unreachable();
+    }
+}
+
+// Folds elem_val into acc_val. Integer addition and multiplication wrap,
+// as they do at runtime.
+static void ir_eval_reduce_op(TypeTableEntry *elem_type, ReduceOp op, ConstExprValue *acc_val,
+        ConstExprValue *elem_val)
+{
+    bool is_int = (elem_type->id == TypeTableEntryIdInt);
+    bool is_float = (elem_type->id == TypeTableEntryIdFloat);
+    BigInt int_result;
+    BigFloat float_result;
+    switch (op) {
+        case ReduceOpAdd:
+            if (is_int) {
+                bigint_add_wrap(&int_result, &acc_val->data.x_bigint, &elem_val->data.x_bigint,
+                        elem_type->data.integral.bit_count, elem_type->data.integral.is_signed);
+                acc_val->data.x_bigint = int_result;
+            } else {
+                bigfloat_add(&float_result, &acc_val->data.x_bigfloat, &elem_val->data.x_bigfloat);
+                acc_val->data.x_bigfloat = float_result;
+            }
+            return;
+        case ReduceOpMul:
+            if (is_int) {
+                bigint_mul_wrap(&int_result, &acc_val->data.x_bigint, &elem_val->data.x_bigint,
+                        elem_type->data.integral.bit_count, elem_type->data.integral.is_signed);
+                acc_val->data.x_bigint = int_result;
+            } else {
+                bigfloat_mul(&float_result, &acc_val->data.x_bigfloat, &elem_val->data.x_bigfloat);
+                acc_val->data.x_bigfloat = float_result;
+            }
+            return;
+        case ReduceOpAnd:
+            if (is_int) {
+                bigint_and(&int_result, &acc_val->data.x_bigint, &elem_val->data.x_bigint);
+                acc_val->data.x_bigint = int_result;
+            } else {
+                acc_val->data.x_bool = acc_val->data.x_bool && elem_val->data.x_bool;
+            }
+            return;
+        case ReduceOpOr:
+            if (is_int) {
+                bigint_or(&int_result, &acc_val->data.x_bigint, &elem_val->data.x_bigint);
+                acc_val->data.x_bigint = int_result;
+            } else {
+                acc_val->data.x_bool = acc_val->data.x_bool || elem_val->data.x_bool;
+            }
+            return;
+        case ReduceOpXor:
+            if (is_int) {
+                bigint_xor(&int_result, &acc_val->data.x_bigint, &elem_val->data.x_bigint);
+                acc_val->data.x_bigint = int_result;
+            } else {
+                acc_val->data.x_bool = acc_val->data.x_bool != elem_val->data.x_bool;
+            }
+            return;
+        case ReduceOpMin:
+        case ReduceOpMax:
+            {
+                Cmp cmp = is_float ?
+                    bigfloat_cmp(&elem_val->data.x_bigfloat, &acc_val->data.x_bigfloat) :
+                    bigint_cmp(&elem_val->data.x_bigint, &acc_val->data.x_bigint);
+                if (cmp == ((op == ReduceOpMin) ? CmpLT : CmpGT))
+                    copy_const_val(acc_val, elem_val, true);
+                return;
+            }
+    }
+    zig_unreachable();
+}
+
+static TypeTableEntry *ir_analyze_instruction_reduce(IrAnalyze *ira, IrInstructionReduce *instruction) {
+    ReduceOp op;
+    if (!ir_resolve_reduce_op(ira, instruction->op_value->other, &op))
+        return ira->codegen->builtin_types.entry_invalid;
+
+    IrInstruction *vector = instruction->vector->other;
+    if (type_is_invalid(vector->value.type))
+        return ira->codegen->builtin_types.entry_invalid;
+    if (!ir_check_vector(ira, vector))
+        return ira->codegen->builtin_types.entry_invalid;
+    TypeTableEntry *vector_type = vector->value.type;
+    TypeTableEntry *elem_type = vector_type->data.vector.elem_type;
+
+    if (!reduce_op_allowed(elem_type, op)) {
+        ir_add_error(ira, instruction->op_value->other,
+            buf_sprintf("reduction not allowed for type '%s'", buf_ptr(&vector_type->name)));
+        return ira->codegen->builtin_types.entry_invalid;
+    }
+
+    if (instr_is_comptime(vector)) {
+        ConstExprValue *vector_val = ir_resolve_vector_elems(ira, vector);
+        if (!vector_val)
+            return ira->codegen->builtin_types.entry_invalid;
+
+        ConstExprValue *out_val = ir_build_const_from(ira, &instruction->base);
+        copy_const_val(out_val, &vector_val->data.x_array.s_none.elements[0], true);
+        for (uint32_t i = 1; i < vector_type->data.vector.len; i += 1) {
+            ir_eval_reduce_op(elem_type, op, out_val, &vector_val->data.x_array.s_none.elements[i]);
+        }
+        return elem_type;
+    }
+
+    ir_build_reduce_from(&ira->new_irb, &instruction->base, vector, op);
+    return elem_type;
+}
+
 static TypeTableEntry *ir_analyze_instruction_type_name(IrAnalyze *ira, IrInstructionTypeName *instruction) {
     IrInstruction *type_value = instruction->type_value->other;
     TypeTableEntry *type_entry = ir_resolve_type(ira, type_value);
@@ -12347,6 +13957,9 @@ static TypeTableEntry *ir_analyze_instruction_c_import(IrAnalyze *ira, IrInstruc
 
     find_libc_include_path(ira->codegen);
 
+    // the headers clang reads are not tracked, so the result can't be reused
+    ira->codegen->skip_unchanged_uncacheable = true;
+
     ImportTableEntry *child_import = allocate<ImportTableEntry>(1);
     child_import->decls_scope = create_decls_scope(node, nullptr, nullptr, child_import);
     child_import->c_import_node = node;
@@ -12462,9 +14075,9 @@ static TypeTableEntry *ir_analyze_instruction_embed_file(IrAnalyze *ira, IrInstr
     os_path_resolve(&source_dir_path, rel_file_path, &file_path);
 
     // load from file system into const expr
-    Buf file_contents = BUF_INIT;
+    Buf *file_contents = buf_alloc();
     int err;
-    if ((err = os_fetch_file_path(&file_path, &file_contents))) {
+    if ((err = os_fetch_file_path(&file_path, file_contents))) {
         if (err == ErrorFileNotFound) {
             ir_add_error(ira, instruction->name, buf_sprintf("unable to find '%s'", buf_ptr(&file_path)));
             return ira->codegen->builtin_types.entry_invalid;
@@ -12474,13 +14087,12 @@ static TypeTableEntry *ir_analyze_instruction_embed_file(IrAnalyze *ira, IrInstr
         }
     }
 
-    // TODO add dependency on the file we embedded so that we know if it changes
-    // we'll have to invalidate the cache
+    unchanged_build_add_dependency(ira->codegen, buf_create_from_buf(&file_path), file_contents);
 
     ConstExprValue *out_val = ir_build_const_from(ira, &instruction->base);
-    init_const_str_lit(ira->codegen, out_val, &file_contents);
+    init_const_str_lit_shared(ira->codegen, out_val, file_contents);
 
-    return get_array_type(ira->codegen, ira->codegen->builtin_types.entry_u8, buf_len(&file_contents));
+    return get_array_type(ira->codegen, ira->codegen->builtin_types.entry_u8, buf_len(file_contents));
 }
 
 static TypeTableEntry *ir_analyze_instruction_cmpxchg(IrAnalyze *ira, IrInstructionCmpxchg *instruction) {
@@ -12567,6 +14179,135 @@ static TypeTableEntry *ir_analyze_instruction_fence(IrAnalyze *ira, IrInstructio
     return ira->codegen->builtin_types.entry_void;
 }
 
+// LLVM only lowers atomic operations on integers and pointers whose size is a
+// power of 2 bytes, and atomicrmw only on integers.
+static TypeTableEntry *ir_resolve_atomic_operand_type(IrAnalyze *ira, IrInstruction *op, bool allow_ptr) {
+    TypeTableEntry *operand_type = ir_resolve_type(ira, op);
+    if (type_is_invalid(operand_type))
+        return ira->codegen->builtin_types.entry_invalid;
+
+    if (operand_type->id == TypeTableEntryIdInt) {
+        uint32_t bit_count = operand_type->data.integral.bit_count;
+        if (bit_count < 8) {
+            ir_add_error(ira, op,
+                buf_sprintf("expected integer type 8 bits or larger, found %" PRIu32 "-bit integer type", bit_count));
+            return ira->codegen->builtin_types.entry_invalid;
+        }
+        if (!is_power_of_2(bit_count)) {
+            ir_add_error(ira, op,
+                buf_sprintf("%" PRIu32 "-bit integer type is not a power of 2", bit_count));
+            return ira->codegen->builtin_types.entry_invalid;
+        }
+    } else if (!(allow_ptr && operand_type->id == TypeTableEntryIdPointer)) {
+        ir_add_error(ira, op,
+            buf_sprintf("expected %s type, found '%s'", allow_ptr ? "integer or pointer" : "integer",
+                buf_ptr(&operand_type->name)));
+        return ira->codegen->builtin_types.entry_invalid;
+    }
+    return operand_type;
+}
+
+static TypeTableEntry *ir_analyze_instruction_atomic_rmw(IrAnalyze *ira, IrInstructionAtomicRmw *instruction) {
+    TypeTableEntry *operand_type = ir_resolve_atomic_operand_type(ira, instruction->operand_type->other, false);
+    if (type_is_invalid(operand_type))
+        return ira->codegen->builtin_types.entry_invalid;
+
+    IrInstruction *ptr = instruction->ptr->other;
+    if (type_is_invalid(ptr->value.type))
+        return ira->codegen->builtin_types.entry_invalid;
+
+    IrInstruction *casted_ptr = ir_implicit_cast(ira, ptr, get_pointer_to_type(ira->codegen, operand_type, false));
+    if (type_is_invalid(casted_ptr->value.type))
+        return ira->codegen->builtin_types.entry_invalid;
+
+    AtomicRmwOp op;
+    if (!ir_resolve_atomic_rmw_op(ira, instruction->op_value->other, &op))
+        return ira->codegen->builtin_types.entry_invalid;
+
+    IrInstruction *operand = instruction->operand->other;
+    if (type_is_invalid(operand->value.type))
+        return ira->codegen->builtin_types.entry_invalid;
+
+    IrInstruction *casted_operand = ir_implicit_cast(ira, operand, operand_type);
+    if (type_is_invalid(casted_operand->value.type))
+        return ira->codegen->builtin_types.entry_invalid;
+
+    IrInstruction *order_value = instruction->order_value->other;
+    AtomicOrder order;
+    if (!ir_resolve_atomic_order(ira, order_value, &order))
+        return ira->codegen->builtin_types.entry_invalid;
+    if (order == AtomicOrderUnordered) {
+        ir_add_error(ira, order_value, buf_sprintf("@atomicRmw atomic ordering must not be Unordered"));
+        return ira->codegen->builtin_types.entry_invalid;
+    }
+
+    ir_build_atomic_rmw_from(&ira->new_irb, &instruction->base, instruction->operand_type->other, casted_ptr,
+        instruction->op_value->other, casted_operand, order_value, op, order);
+    return operand_type;
+}
+
+static TypeTableEntry *ir_analyze_instruction_atomic_load(IrAnalyze *ira, IrInstructionAtomicLoad *instruction) {
+    TypeTableEntry *operand_type = ir_resolve_atomic_operand_type(ira, instruction->operand_type->other, true);
+    if (type_is_invalid(operand_type))
+        return ira->codegen->builtin_types.entry_invalid;
+
+    IrInstruction *ptr = instruction->ptr->other;
+    if (type_is_invalid(ptr->value.type))
+        return ira->codegen->builtin_types.entry_invalid;
+
+    IrInstruction *casted_ptr = ir_implicit_cast(ira, ptr, get_pointer_to_type(ira->codegen, operand_type, true));
+    if (type_is_invalid(casted_ptr->value.type))
+        return ira->codegen->builtin_types.entry_invalid;
+
+    IrInstruction *order_value = instruction->order_value->other;
+    AtomicOrder order;
+    if (!ir_resolve_atomic_order(ira, order_value, &order))
+        return ira->codegen->builtin_types.entry_invalid;
+    if (order == AtomicOrderRelease || order == AtomicOrderAcqRel) {
+        ir_add_error(ira, order_value, buf_sprintf("@atomicLoad atomic ordering must not be Release or AcqRel"));
+        return ira->codegen->builtin_types.entry_invalid;
+    }
+
+    ir_build_atomic_load_from(&ira->new_irb, &instruction->base, instruction->operand_type->other, casted_ptr,
+        order_value, order);
+    return operand_type;
+}
+
+static TypeTableEntry *ir_analyze_instruction_atomic_store(IrAnalyze *ira, IrInstructionAtomicStore *instruction) {
+    TypeTableEntry *operand_type = ir_resolve_atomic_operand_type(ira, instruction->operand_type->other, true);
+    if (type_is_invalid(operand_type))
+        return ira->codegen->builtin_types.entry_invalid;
+
+    IrInstruction *ptr = instruction->ptr->other;
+    if (type_is_invalid(ptr->value.type))
+        return ira->codegen->builtin_types.entry_invalid;
+
+    IrInstruction *casted_ptr = ir_implicit_cast(ira, ptr, get_pointer_to_type(ira->codegen, operand_type, false));
+    if (type_is_invalid(casted_ptr->value.type))
+        return ira->codegen->builtin_types.entry_invalid;
+
+    IrInstruction *value = instruction->value->other;
+    if (type_is_invalid(value->value.type))
+        return ira->codegen->builtin_types.entry_invalid;
+
+    IrInstruction *casted_value = ir_implicit_cast(ira, value, operand_type);
+    if (type_is_invalid(casted_value->value.type))
+        return ira->codegen->builtin_types.entry_invalid;
+
+    IrInstruction *order_value = instruction->order_value->other;
+    AtomicOrder order;
+    if (!ir_resolve_atomic_order(ira, order_value, &order))
+        return ira->codegen->builtin_types.entry_invalid;
+    if (order == AtomicOrderAcquire || order == AtomicOrderAcqRel) {
+        ir_add_error(ira, order_value, buf_sprintf("@atomicStore atomic ordering must not be Acquire or AcqRel"));
+        return ira->codegen->builtin_types.entry_invalid;
+    }
+
+    ir_build_atomic_store_from(&ira->new_irb, &instruction->base, instruction->operand_type->other, casted_ptr,
+        casted_value, order_value, order);
+    return ira->codegen->builtin_types.entry_void;
+}
+
 static TypeTableEntry *ir_analyze_instruction_truncate(IrAnalyze *ira, IrInstructionTruncate *instruction) {
     IrInstruction *dest_type_value = instruction->dest_type->other;
     TypeTableEntry *dest_type = ir_resolve_type(ira, dest_type_value);
@@ -13002,7 +14743,7 @@ static TypeTableEntry *ir_analyze_instruction_slice(IrAnalyze *ira, IrInstructio
         }
 
         ConstExprValue *out_val = ir_build_const_from(ira, &instruction->base);
-        out_val->data.x_struct.fields = create_const_vals(2);
+        out_val->data.x_struct.fields = create_const_vals(ira->codegen, 2);
 
         ConstExprValue *ptr_val = &out_val->data.x_struct.fields[slice_ptr_index];
 
@@ -13377,6 +15118,54 @@ static TypeTableEntry *ir_analyze_instruction_test_comptime(IrAnalyze *ira, IrIn
     return ira->codegen->builtin_types.entry_bool;
 }
 
+static bool ir_check_switch_int_ranges(IrAnalyze *ira, IrInstructionCheckSwitchProngs *instruction,
+        TypeTableEntry *switch_type, RangeSet *rs)
+{
+    for (size_t range_i = 0; range_i < instruction->range_count; range_i += 1) {
+        IrInstructionCheckSwitchProngsRange *range = &instruction->ranges[range_i];
+
+        IrInstruction *start_value = range->start->other;
+        if (type_is_invalid(start_value->value.type))
+            return false;
+
+        IrInstruction *end_value = range->end->other;
+        if (type_is_invalid(end_value->value.type))
+            return false;
+
+        ConstExprValue *start_val = ir_resolve_const(ira, start_value, UndefBad);
+        if (!start_val)
+            return false;
+
+        ConstExprValue *end_val = ir_resolve_const(ira, end_value, UndefBad);
+        if (!end_val)
+            return false;
+
+        if (bigint_cmp(&start_val->data.x_bigint, &end_val->data.x_bigint) == CmpGT) {
+            ir_add_error(ira, start_value, buf_sprintf("range start value is greater than the end value"));
+            return false;
+        }
+
+        AstNode *prev_node = rangeset_add_range(rs, &start_val->data.x_bigint, &end_val->data.x_bigint,
+                start_value->source_node);
+        if (prev_node != nullptr) {
+            ErrorMsg *msg = ir_add_error(ira, start_value, buf_sprintf("duplicate switch value"));
+            add_error_note(ira->codegen, msg, prev_node, buf_sprintf("previous value is here"));
+            return false;
+        }
+    }
+    if (!instruction->have_else_prong) {
+        BigInt min_val;
+        eval_min_max_value_int(ira->codegen, switch_type, &min_val, false);
+        BigInt max_val;
+        eval_min_max_value_int(ira->codegen, switch_type, &max_val, true);
+        if (!rangeset_spans(rs, &min_val, &max_val)) {
+            ir_add_error(ira, &instruction->base, buf_sprintf("switch must handle all possibilities"));
+            return false;
+        }
+    }
+    return true;
+}
+
 static TypeTableEntry *ir_analyze_instruction_check_switch_prongs(IrAnalyze *ira,
         IrInstructionCheckSwitchProngs *instruction)
 {
@@ -13439,43 +15228,10 @@ static TypeTableEntry *ir_analyze_instruction_check_switch_prongs(IrAnalyze *ira
         }
     } else if (switch_type->id == TypeTableEntryIdInt) {
         RangeSet rs = {0};
-        for (size_t range_i = 0; range_i < instruction->range_count; range_i += 1) {
-            IrInstructionCheckSwitchProngsRange *range = &instruction->ranges[range_i];
-
-            IrInstruction *start_value = range->start->other;
-            if (type_is_invalid(start_value->value.type))
-                return ira->codegen->builtin_types.entry_invalid;
-
-            IrInstruction *end_value = range->end->other;
-            if (type_is_invalid(end_value->value.type))
-                return ira->codegen->builtin_types.entry_invalid;
-
-            ConstExprValue *start_val = ir_resolve_const(ira, start_value, UndefBad);
-            if (!start_val)
-                return ira->codegen->builtin_types.entry_invalid;
-
-            ConstExprValue *end_val = ir_resolve_const(ira, end_value, UndefBad);
-            if (!end_val)
-                return ira->codegen->builtin_types.entry_invalid;
-
-            AstNode *prev_node = rangeset_add_range(&rs, &start_val->data.x_bigint, &end_val->data.x_bigint,
-                    start_value->source_node);
-            if (prev_node != nullptr) {
-                ErrorMsg *msg = ir_add_error(ira, start_value, buf_sprintf("duplicate switch value"));
-                add_error_note(ira->codegen, msg, prev_node, buf_sprintf("previous value is here"));
-                return ira->codegen->builtin_types.entry_invalid;
-            }
-        }
-        if (!instruction->have_else_prong) {
-            BigInt min_val;
-            eval_min_max_value_int(ira->codegen, switch_type, &min_val, false);
-            BigInt max_val;
-            eval_min_max_value_int(ira->codegen, switch_type, &max_val, true);
-            if (!rangeset_spans(&rs, &min_val, &max_val)) {
-                ir_add_error(ira, &instruction->base, buf_sprintf("switch must handle all possibilities"));
-                return ira->codegen->builtin_types.entry_invalid;
-            }
-        }
+        bool ok = ir_check_switch_int_ranges(ira, instruction, switch_type, &rs);
+        rangeset_deinit(&rs);
+        if (!ok)
+            return ira->codegen->builtin_types.entry_invalid;
     } else if (!instruction->have_else_prong) {
         ir_add_error(ira, &instruction->base,
             buf_sprintf("else prong required when switching on type '%s'", buf_ptr(&switch_type->name)));
@@ -13622,6 +15378,8 @@ static void buf_write_value_bytes(CodeGen *codegen, uint8_t *buf, ConstExprValue
             }
         case TypeTableEntryIdArray:
             zig_panic("TODO buf_write_value_bytes array type");
+        case TypeTableEntryIdVector:
+            zig_panic("TODO buf_write_value_bytes vector type");
         case TypeTableEntryIdStruct:
             zig_panic("TODO buf_write_value_bytes struct type");
         case TypeTableEntryIdMaybe:
@@ -13683,6 +15441,8 @@ static void buf_read_value_bytes(CodeGen *codegen, uint8_t *buf, ConstExprValue
             }
         case TypeTableEntryIdArray:
             zig_panic("TODO buf_read_value_bytes array type");
+        case TypeTableEntryIdVector:
+            zig_panic("TODO buf_read_value_bytes vector type");
         case TypeTableEntryIdStruct:
             zig_panic("TODO buf_read_value_bytes struct type");
         case TypeTableEntryIdMaybe:
@@ -13869,7 +15629,7 @@ static TypeTableEntry *ir_analyze_instruction_decl_ref(IrAnalyze *ira,
                 return ira->codegen->builtin_types.entry_invalid;
 
             if (tld_var->extern_lib_name != nullptr) {
-                add_link_lib_symbol(ira->codegen, tld_var->extern_lib_name, &var->name);
+                add_link_lib_symbol(ira->codegen, tld_var->extern_lib_name, var->name);
             }
 
             if (lval.is_ptr) {
@@ -14025,6 +15785,12 @@ static TypeTableEntry *ir_analyze_instruction_nocast(IrAnalyze *ira, IrInstructi
             return ir_analyze_instruction_cmpxchg(ira, (IrInstructionCmpxchg *)instruction);
         case IrInstructionIdFence:
             return ir_analyze_instruction_fence(ira, (IrInstructionFence *)instruction);
+        case IrInstructionIdAtomicRmw:
+            return ir_analyze_instruction_atomic_rmw(ira, (IrInstructionAtomicRmw *)instruction);
+        case IrInstructionIdAtomicLoad:
+            return ir_analyze_instruction_atomic_load(ira, (IrInstructionAtomicLoad *)instruction);
+        case IrInstructionIdAtomicStore:
+            return ir_analyze_instruction_atomic_store(ira, (IrInstructionAtomicStore *)instruction);
         case IrInstructionIdTruncate:
             return ir_analyze_instruction_truncate(ira, (IrInstructionTruncate *)instruction);
         case IrInstructionIdIntType:
@@ -14083,6 +15849,18 @@ static TypeTableEntry *ir_analyze_instruction_nocast(IrAnalyze *ira, IrInstructi
             return ir_analyze_instruction_offset_of(ira, (IrInstructionOffsetOf *)instruction);
         case IrInstructionIdTypeId:
             return ir_analyze_instruction_type_id(ira, (IrInstructionTypeId *)instruction);
+        case IrInstructionIdVectorType:
+            return ir_analyze_instruction_vector_type(ira, (IrInstructionVectorType *)instruction);
+        case IrInstructionIdSplat:
+            return ir_analyze_instruction_splat(ira, (IrInstructionSplat *)instruction);
+        case IrInstructionIdShuffle:
+            return ir_analyze_instruction_shuffle(ira, (IrInstructionShuffle *)instruction);
+        case IrInstructionIdExtractElement:
+            return ir_analyze_instruction_extract_element(ira, (IrInstructionExtractElement *)instruction);
+        case IrInstructionIdInsertElement:
+            return ir_analyze_instruction_insert_element(ira, (IrInstructionInsertElement *)instruction);
+        case IrInstructionIdReduce:
+            return ir_analyze_instruction_reduce(ira, (IrInstructionReduce *)instruction);
         case IrInstructionIdMaybeWrap:
         case IrInstructionIdErrWrapCode:
         case IrInstructionIdErrWrapPayload:
@@ -14125,7 +15903,7 @@ TypeTableEntry *ir_analyze(CodeGen *codegen, IrExecutable *old_exec, IrExecutabl
     ira->new_irb.exec = new_exec;
 
     ira->exec_context.mem_slot_count = ira->old_irb.exec->mem_slot_count;
-    ira->exec_context.mem_slot_list = create_const_vals(ira->exec_context.mem_slot_count);
+    ira->exec_context.mem_slot_list = create_const_vals(codegen, ira->exec_context.mem_slot_count);
 
     IrBasicBlock *old_entry_bb = ira->old_irb.exec->basic_block_list.at(0);
     IrBasicBlock *new_entry_bb = ir_get_new_bb(ira, old_entry_bb, nullptr);
@@ -14188,6 +15966,9 @@ bool ir_has_side_effects(IrInstruction *instruction) {
         case IrInstructionIdCUndef:
         case IrInstructionIdCmpxchg:
         case IrInstructionIdFence:
+        case IrInstructionIdAtomicRmw:
+        case IrInstructionIdAtomicLoad:
+        case IrInstructionIdAtomicStore:
         case IrInstructionIdMemset:
         case IrInstructionIdMemcpy:
         case IrInstructionIdBreakpoint:
@@ -14263,6 +16044,12 @@ bool ir_has_side_effects(IrInstruction *instruction) {
         case IrInstructionIdFieldParentPtr:
         case IrInstructionIdOffsetOf:
         case IrInstructionIdTypeId:
+        case IrInstructionIdVectorType:
+        case IrInstructionIdSplat:
+        case IrInstructionIdShuffle:
+        case IrInstructionIdExtractElement:
+        case IrInstructionIdInsertElement:
+        case IrInstructionIdReduce:
             return false;
         case IrInstructionIdAsm:
             {
@@ -14340,3 +16127,25 @@ FnTableEntry *ir_create_inline_fn(CodeGen *codegen, Buf *fn_name, VariableTableE
     return fn_entry;
 }
 
+
+void ir_queue_referenced_fns(CodeGen *codegen, IrExecutable *exec) {
+    for (size_t bb_i = 0; bb_i < exec->basic_block_list.length; bb_i += 1) {
+        IrBasicBlock *bb = exec->basic_block_list.at(bb_i);
+        for (size_t instr_i = 0; instr_i < bb->instruction_list.length; instr_i += 1) {
+            IrInstruction *instruction = bb->instruction_list.at(instr_i);
+            queue_fns_referenced_by_value(codegen, &instruction->value);
+            if (instruction->id == IrInstructionIdCall) {
+                IrInstructionCall *call_instruction = (IrInstructionCall *)instruction;
+                if (call_instruction->fn_entry != nullptr)
+                    queue_fn_analysis(codegen, call_instruction->fn_entry);
+            }
+            // operands that are comptime known are not always in a basic block
+            for (size_t dep_i = 0; ; dep_i += 1) {
+                IrInstruction *dep_instruction = ir_instruction_get_dep(instruction, dep_i);
+                if (dep_instruction == nullptr)
+                    break;
+                queue_fns_referenced_by_value(codegen, &dep_instruction->value);
+            }
+        }
+    }
+}
@@ -25,5 +25,6 @@ bool ir_has_side_effects(IrInstruction *instruction);
 ConstExprValue *const_ptr_pointee(CodeGen *codegen, ConstExprValue *const_val);
 
 FnTableEntry *ir_create_inline_fn(CodeGen *codegen, Buf *fn_name, VariableTableEntry *var, Scope *parent_scope);
+void ir_queue_referenced_fns(CodeGen *codegen, IrExecutable *exec);
 
 #endif
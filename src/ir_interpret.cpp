@@ -0,0 +1,997 @@
+/*
+ * Copyright (c) 2017 Andrew Kelley
+ *
+ * This file is part of zig, which is MIT licensed.
+ * See http://opensource.org/licenses/MIT
+ */
+
+#include "ir_interpret.hpp"
+#include "analyze.hpp"
+
+// A fast path for compile time function calls whose values are all integers
+// of at most 64 bits, bools and arrays of them. Rather than analyzing the
+// pass 1 IR, which creates a new instruction and a BigInt for every executed
+// instruction, the interpreter executes it directly: the value of each
+// instruction lives in a register indexed by its debug_id and arithmetic is
+// done on native integers.
+//
+// The interpreter has to agree with ir_analyze on every body it accepts. When
+// it meets an instruction, a type or a value it does not handle, or anything
+// ir_analyze would report as an error, it gives up without side effects and
+// the call is analyzed as usual, which then reports the error.
+
+// Larger arrays are left to ir_analyze.
+static const size_t max_array_len = 1 << 16;
+
+enum InterpValueId {
+    // the instruction has not been executed
+    InterpValueIdNone,
+    InterpValueIdUndef,
+    InterpValueIdVoid,
+    InterpValueIdBool,
+    InterpValueIdInt,
+    InterpValueIdType,
+    InterpValueIdPtr,
+    InterpValueIdArray,
+};
+
+struct InterpArray {
+    __int128 *elements;
+    bool *is_undef;
+};
+
+struct InterpPtr {
+    size_t slot;
+    // SIZE_MAX when the pointer is to the whole slot
+    size_t elem_index;
+    bool is_const;
+    // the pointer is to the len field of the array in slot
+    bool is_array_len;
+};
+
+struct InterpValue {
+    InterpValueId id;
+    // Integers are either of a fixed width int type of at most 64 bits or
+    // of the number literal type. Undefined values have the type they were
+    // casted to, or the undefined literal type.
+    TypeTableEntry *type;
+    union {
+        __int128 x_int;
+        bool x_bool;
+        TypeTableEntry *x_type;
+        InterpPtr x_ptr;
+        InterpArray *x_array;
+    } data;
+};
+
+struct Interp {
+    CodeGen *g;
+    IrExecutable *exec;
+    // the value of each instruction, indexed by debug_id
+    InterpValue *regs;
+    // The local variables, indexed by mem_slot_index, followed by a read only
+    // copy of each parameter that has been referenced, in param_vars order.
+    ZigList<InterpValue> slots;
+    ZigList<VariableTableEntry *> param_vars;
+    ZigList<InterpArray *> arrays;
+    IrBasicBlock *current_bb;
+    IrBasicBlock *prev_bb;
+    // set when giving up on something that does not depend on the arguments
+    bool unsupported;
+};
+
+static bool is_small_int_type(TypeTableEntry *type) {
+    return type->id == TypeTableEntryIdInt && type->data.integral.bit_count <= 64;
+}
+
+static bool is_scalar_type(TypeTableEntry *type) {
+    return is_small_int_type(type) || type->id == TypeTableEntryIdBool;
+}
+
+static bool is_supported_array_type(TypeTableEntry *type) {
+    return type->id == TypeTableEntryIdArray && type->data.array.len != 0 &&
+        type->data.array.len <= max_array_len && is_scalar_type(type->data.array.child_type);
+}
+
+static bool int_fits_in_type(__int128 x, TypeTableEntry *type) {
+    if (type->id == TypeTableEntryIdNumLitInt)
+        return x >= (__int128)INT64_MIN && x <= (__int128)UINT64_MAX;
+    assert(is_small_int_type(type));
+    uint32_t bit_count = type->data.integral.bit_count;
+    if (type->data.integral.is_signed) {
+        if (bit_count == 0)
+            return x == 0;
+        __int128 limit = (__int128)1 << (bit_count - 1);
+        return x >= -limit && x < limit;
+    }
+    return x >= 0 && x < ((__int128)1 << bit_count);
+}
+
+static __int128 int_wrap(unsigned __int128 x, TypeTableEntry *type) {
+    assert(is_small_int_type(type));
+    uint32_t bit_count = type->data.integral.bit_count;
+    if (bit_count == 0)
+        return 0;
+    unsigned __int128 bits = x & ((((unsigned __int128)1) << bit_count) - 1);
+    if (type->data.integral.is_signed && (bits >> (bit_count - 1)) != 0)
+        return (__int128)bits - ((__int128)1 << bit_count);
+    return (__int128)bits;
+}
+
+static void set_int(InterpValue *out, TypeTableEntry *type, __int128 x) {
+    out->id = InterpValueIdInt;
+    out->type = type;
+    out->data.x_int = x;
+}
+
+static void set_bool(Interp *interp, InterpValue *out, bool x) {
+    out->id = InterpValueIdBool;
+    out->type = interp->g->builtin_types.entry_bool;
+    out->data.x_bool = x;
+}
+
+static void set_void(Interp *interp, InterpValue *out) {
+    out->id = InterpValueIdVoid;
+    out->type = interp->g->builtin_types.entry_void;
+}
+
+static InterpValue *get_value(Interp *interp, IrInstruction *instruction) {
+    return &interp->regs[instruction->debug_id];
+}
+
+// Returns nullptr unless the instruction produced a defined integer.
+static InterpValue *get_int(Interp *interp, IrInstruction *instruction) {
+    InterpValue *value = get_value(interp, instruction);
+    return (value->id == InterpValueIdInt) ? value : nullptr;
+}
+
+static InterpArray *create_array(Interp *interp, TypeTableEntry *array_type) {
+    size_t len = array_type->data.array.len;
+    InterpArray *array = allocate<InterpArray>(1);
+    array->elements = allocate<__int128>(len);
+    array->is_undef = allocate<bool>(len);
+    interp->arrays.append(array);
+    return array;
+}
+
+// Arrays are values: a register or slot never shares its elements with another one.
+static void copy_value(Interp *interp, InterpValue *dest, InterpValue *src) {
+    *dest = *src;
+    if (src->id == InterpValueIdArray) {
+        size_t len = src->type->data.array.len;
+        dest->data.x_array = create_array(interp, src->type);
+        memcpy(dest->data.x_array->elements, src->data.x_array->elements, len * sizeof(__int128));
+        memcpy(dest->data.x_array->is_undef, src->data.x_array->is_undef, len * sizeof(bool));
+    }
+}
+
+static bool bigint_to_native(BigInt *bigint, __int128 *out) {
+    if (bigint_fits_in_bits(bigint, 64, true)) {
+        *out = bigint_as_signed(bigint);
+        return true;
+    }
+    // the unsigned check doesn't look at the sign
+    if (!bigint->is_negative && bigint_fits_in_bits(bigint, 64, false)) {
+        *out = bigint_as_unsigned(bigint);
+        return true;
+    }
+    return false;
+}
+
+static bool value_from_const(Interp *interp, ConstExprValue *const_val, InterpValue *out) {
+    TypeTableEntry *type = const_val->type;
+    if (type == nullptr)
+        return false;
+    if (type->id == TypeTableEntryIdUndefLit ||
+        (const_val->special == ConstValSpecialUndef && is_scalar_type(type)))
+    {
+        out->id = InterpValueIdUndef;
+        out->type = type;
+        return true;
+    }
+    if (const_val->special != ConstValSpecialStatic)
+        return false;
+
+    switch (type->id) {
+        case TypeTableEntryIdVoid:
+            set_void(interp, out);
+            return true;
+        case TypeTableEntryIdBool:
+            set_bool(interp, out, const_val->data.x_bool);
+            return true;
+        case TypeTableEntryIdMetaType:
+            out->id = InterpValueIdType;
+            out->type = type;
+            out->data.x_type = const_val->data.x_type;
+            return true;
+        case TypeTableEntryIdInt:
+        case TypeTableEntryIdNumLitInt:
+            {
+                if (type->id == TypeTableEntryIdInt && !is_small_int_type(type))
+                    return false;
+                __int128 x;
+                if (!bigint_to_native(&const_val->data.x_bigint, &x))
+                    return false;
+                set_int(out, type, x);
+                return true;
+            }
+        default:
+            return false;
+    }
+}
+
+// The implicit casts ir_analyze does between the supported types. Arrays are
+// not copied; the caller copies the result if it is stored.
+static bool implicit_cast(Interp *interp, InterpValue *value, TypeTableEntry *wanted_type, InterpValue *out) {
+    if (value->id == InterpValueIdNone || value->id == InterpValueIdPtr)
+        return false;
+    if (wanted_type == nullptr || value->type == wanted_type) {
+        *out = *value;
+        return true;
+    }
+
+    if (value->id == InterpValueIdUndef) {
+        if (value->type->id != TypeTableEntryIdUndefLit)
+            return false;
+        if (is_scalar_type(wanted_type)) {
+            out->id = InterpValueIdUndef;
+            out->type = wanted_type;
+            return true;
+        }
+        if (is_supported_array_type(wanted_type)) {
+            out->id = InterpValueIdArray;
+            out->type = wanted_type;
+            out->data.x_array = create_array(interp, wanted_type);
+            memset(out->data.x_array->is_undef, 1, wanted_type->data.array.len * sizeof(bool));
+            return true;
+        }
+        return false;
+    }
+
+    if (value->id == InterpValueIdInt && is_small_int_type(wanted_type)) {
+        TypeTableEntry *actual_type = value->type;
+        if (actual_type->id == TypeTableEntryIdNumLitInt) {
+            if (!int_fits_in_type(value->data.x_int, wanted_type))
+                return false;
+        } else if (actual_type->data.integral.is_signed == wanted_type->data.integral.is_signed) {
+            if (wanted_type->data.integral.bit_count < actual_type->data.integral.bit_count)
+                return false;
+        } else if (!wanted_type->data.integral.is_signed ||
+            wanted_type->data.integral.bit_count <= actual_type->data.integral.bit_count)
+        {
+            return false;
+        }
+        set_int(out, wanted_type, value->data.x_int);
+        return true;
+    }
+
+    return false;
+}
+
+// ir_resolve_peer_types for two integers, restricted to the cases where one
+// side's type is used unchanged.
+static TypeTableEntry *resolve_int_peer_type(InterpValue *op1, InterpValue *op2) {
+    if (op1->type == op2->type)
+        return op1->type;
+    if (op1->type->id == TypeTableEntryIdNumLitInt && op2->type->id == TypeTableEntryIdInt)
+        return int_fits_in_type(op1->data.x_int, op2->type) ? op2->type : nullptr;
+    if (op2->type->id == TypeTableEntryIdNumLitInt && op1->type->id == TypeTableEntryIdInt)
+        return int_fits_in_type(op2->data.x_int, op1->type) ? op1->type : nullptr;
+    return nullptr;
+}
+
+static bool interp_cmp(Interp *interp, IrBinOp op_id, InterpValue *op1, InterpValue *op2, InterpValue *out) {
+    bool is_equality_cmp = (op_id == IrBinOpCmpEq || op_id == IrBinOpCmpNotEq);
+    Cmp cmp;
+    if (op1->id == InterpValueIdBool && op2->id == InterpValueIdBool) {
+        if (!is_equality_cmp)
+            return false;
+        cmp = (op1->data.x_bool == op2->data.x_bool) ? CmpEQ : CmpLT;
+    } else if (op1->id == InterpValueIdType && op2->id == InterpValueIdType) {
+        if (!is_equality_cmp)
+            return false;
+        cmp = (op1->data.x_type == op2->data.x_type) ? CmpEQ : CmpLT;
+    } else if (op1->id == InterpValueIdInt && op2->id == InterpValueIdInt) {
+        if (resolve_int_peer_type(op1, op2) == nullptr)
+            return false;
+        __int128 a = op1->data.x_int;
+        __int128 b = op2->data.x_int;
+        cmp = (a < b) ? CmpLT : ((a > b) ? CmpGT : CmpEQ);
+    } else {
+        return false;
+    }
+
+    bool result;
+    switch (op_id) {
+        case IrBinOpCmpEq:
+            result = (cmp == CmpEQ);
+            break;
+        case IrBinOpCmpNotEq:
+            result = (cmp != CmpEQ);
+            break;
+        case IrBinOpCmpLessThan:
+            result = (cmp == CmpLT);
+            break;
+        case IrBinOpCmpGreaterThan:
+            result = (cmp == CmpGT);
+            break;
+        case IrBinOpCmpLessOrEq:
+            result = (cmp != CmpGT);
+            break;
+        case IrBinOpCmpGreaterOrEq:
+            result = (cmp != CmpLT);
+            break;
+        default:
+            zig_unreachable();
+    }
+    set_bool(interp, out, result);
+    return true;
+}
+
+static bool interp_math(IrBinOp op_id, InterpValue *op1, InterpValue *op2, InterpValue *out) {
+    if (op1->id != InterpValueIdInt || op2->id != InterpValueIdInt)
+        return false;
+    TypeTableEntry *type = resolve_int_peer_type(op1, op2);
+    if (type == nullptr)
+        return false;
+    bool is_num_lit = (type->id == TypeTableEntryIdNumLitInt);
+    __int128 a = op1->data.x_int;
+    __int128 b = op2->data.x_int;
+
+    // Division by zero, a negative denominator and the cases where ir_analyze
+    // asks for @divTrunc, @divFloor, @rem or @mod are all errors.
+    bool is_signed_div = is_num_lit ? ((a <= 0) != (b <= 0)) : type->data.integral.is_signed;
+    if (op_id == IrBinOpDivUnspecified) {
+        if (b == 0 || (is_signed_div && a % b != 0 && (a < 0) != (b < 0)))
+            return false;
+        op_id = IrBinOpDivTrunc;
+    } else if (op_id == IrBinOpRemUnspecified) {
+        if (b <= 0 || (is_signed_div && a % b != 0 && a < 0))
+            return false;
+        op_id = IrBinOpRemRem;
+    }
+
+    if (is_num_lit) {
+        if (op_id == IrBinOpBitShiftLeftWrap) {
+            op_id = IrBinOpBitShiftLeft;
+        } else if (op_id == IrBinOpAddWrap) {
+            op_id = IrBinOpAdd;
+        } else if (op_id == IrBinOpSubWrap) {
+            op_id = IrBinOpSub;
+        } else if (op_id == IrBinOpMultWrap) {
+            op_id = IrBinOpMult;
+        }
+    }
+
+    // BigInt keeps a sign and a magnitude, so bitwise operations on negative
+    // numbers are left to it.
+    bool is_bitwise = (op_id == IrBinOpBinOr || op_id == IrBinOpBinXor || op_id == IrBinOpBinAnd ||
+        op_id == IrBinOpBitShiftLeft || op_id == IrBinOpBitShiftLeftWrap || op_id == IrBinOpBitShiftRight);
+    if (is_bitwise && (a < 0 || b < 0))
+        return false;
+
+    unsigned __int128 ua = (unsigned __int128)a;
+    unsigned __int128 ub = (unsigned __int128)b;
+    __int128 result;
+    switch (op_id) {
+        case IrBinOpBinOr:
+            result = a | b;
+            break;
+        case IrBinOpBinXor:
+            result = a ^ b;
+            break;
+        case IrBinOpBinAnd:
+            result = a & b;
+            break;
+        case IrBinOpBitShiftLeft:
+            {
+                // shift unsigned and give up if any bit of a is shifted out
+                // or the result no longer fits the signed register
+                if (b >= 128) {
+                    if (a != 0)
+                        return false;
+                    result = 0;
+                    break;
+                }
+                unsigned __int128 shifted = ua << (unsigned)b;
+                if ((shifted >> (unsigned)b) != ua || (shifted >> 127) != 0)
+                    return false;
+                result = (__int128)shifted;
+                break;
+            }
+        case IrBinOpBitShiftLeftWrap:
+            result = (b >= 64) ? 0 : int_wrap(ua << b, type);
+            break;
+        case IrBinOpBitShiftRight:
+            if (b >= 64)
+                return false;
+            result = a >> b;
+            break;
+        case IrBinOpAdd:
+            result = a + b;
+            break;
+        case IrBinOpAddWrap:
+            result = int_wrap(ua + ub, type);
+            break;
+        case IrBinOpSub:
+            result = a - b;
+            break;
+        case IrBinOpSubWrap:
+            result = int_wrap(ua - ub, type);
+            break;
+        case IrBinOpMult:
+            if (__builtin_mul_overflow(a, b, &result))
+                return false;
+            break;
+        case IrBinOpMultWrap:
+            result = int_wrap(ua * ub, type);
+            break;
+        case IrBinOpDivTrunc:
+            if (b == 0)
+                return false;
+            result = a / b;
+            break;
+        case IrBinOpDivFloor:
+            if (b == 0)
+                return false;
+            result = a / b;
+            if (a % b != 0 && (a < 0) != (b < 0))
+                result -= 1;
+            break;
+        case IrBinOpDivExact:
+            if (b == 0 || a % b != 0)
+                return false;
+            result = a / b;
+            break;
+        case IrBinOpRemRem:
+            if (b <= 0)
+                return false;
+            result = a % b;
+            break;
+        case IrBinOpRemMod:
+            if (b <= 0)
+                return false;
+            result = a % b;
+            if (result < 0)
+                result += b;
+            break;
+        default:
+            return false;
+    }
+
+    if (!int_fits_in_type(result, type))
+        return false;
+    set_int(out, type, result);
+    return true;
+}
+
+static bool interp_bin_op(Interp *interp, IrInstructionBinOp *instruction, InterpValue *out) {
+    InterpValue *op1 = get_value(interp, instruction->op1);
+    InterpValue *op2 = get_value(interp, instruction->op2);
+    switch (instruction->op_id) {
+        case IrBinOpBoolOr:
+        case IrBinOpBoolAnd:
+            if (op1->id != InterpValueIdBool || op2->id != InterpValueIdBool)
+                return false;
+            set_bool(interp, out, (instruction->op_id == IrBinOpBoolOr) ?
+                    (op1->data.x_bool || op2->data.x_bool) : (op1->data.x_bool && op2->data.x_bool));
+            return true;
+        case IrBinOpCmpEq:
+        case IrBinOpCmpNotEq:
+        case IrBinOpCmpLessThan:
+        case IrBinOpCmpGreaterThan:
+        case IrBinOpCmpLessOrEq:
+        case IrBinOpCmpGreaterOrEq:
+            return interp_cmp(interp, instruction->op_id, op1, op2, out);
+        default:
+            return interp_math(instruction->op_id, op1, op2, out);
+    }
+}
+
+static bool interp_un_op(IrInstructionUnOp *instruction, InterpValue *value, InterpValue *out) {
+    if (value->id != InterpValueIdInt)
+        return false;
+    TypeTableEntry *type = value->type;
+    bool is_num_lit = (type->id == TypeTableEntryIdNumLitInt);
+    __int128 x = value->data.x_int;
+    switch (instruction->op_id) {
+        case IrUnOpBinNot:
+            if (is_num_lit)
+                return false;
+            if (type->data.integral.is_signed) {
+                set_int(out, type, -x - 1);
+            } else {
+                set_int(out, type, int_wrap(~(unsigned __int128)x, type));
+            }
+            return true;
+        case IrUnOpNegation:
+            if (!is_num_lit && !type->data.integral.is_signed)
+                return false;
+            if (!int_fits_in_type(-x, type))
+                return false;
+            set_int(out, type, -x);
+            return true;
+        case IrUnOpNegationWrap:
+            if (is_num_lit || !type->data.integral.is_signed)
+                return false;
+            set_int(out, type, int_wrap(-(unsigned __int128)x, type));
+            return true;
+        default:
+            return false;
+    }
+}
+
+static InterpValue *get_slot(Interp *interp, size_t slot) {
+    return &interp->slots.at(slot);
+}
+
+static bool interp_var_ptr(Interp *interp, VariableTableEntry *var, InterpValue *out) {
+    size_t slot;
+    bool is_const;
+    if (var->mem_slot_index != SIZE_MAX) {
+        if (var->mem_slot_index >= interp->exec->mem_slot_count)
+            return false;
+        slot = var->mem_slot_index;
+        InterpValue *slot_val = get_slot(interp, slot);
+        if (slot_val->id == InterpValueIdNone)
+            return false;
+        // ir_get_var_ptr lets the instruction decide about type variables; don't bother
+        is_const = var->src_is_const || slot_val->id == InterpValueIdType;
+    } else {
+        // a parameter of the call
+        slot = SIZE_MAX;
+        for (size_t i = 0; i < interp->param_vars.length; i += 1) {
+            if (interp->param_vars.at(i) == var) {
+                slot = interp->exec->mem_slot_count + i;
+                break;
+            }
+        }
+        if (slot == SIZE_MAX) {
+            InterpValue param_val;
+            if (var->value->special != ConstValSpecialStatic || !value_from_const(interp, var->value, &param_val))
+                return false;
+            slot = interp->slots.length;
+            interp->slots.append(param_val);
+            interp->param_vars.append(var);
+        }
+        is_const = true;
+    }
+    out->id = InterpValueIdPtr;
+    out->type = nullptr;
+    out->data.x_ptr.slot = slot;
+    out->data.x_ptr.elem_index = SIZE_MAX;
+    out->data.x_ptr.is_const = is_const;
+    out->data.x_ptr.is_array_len = false;
+    return true;
+}
+
+static bool interp_decl_var(Interp *interp, IrInstructionDeclVar *instruction) {
+    VariableTableEntry *var = instruction->var;
+    if (var->mem_slot_index == SIZE_MAX || var->mem_slot_index >= interp->exec->mem_slot_count) {
+        interp->unsupported = true;
+        return false;
+    }
+
+    // ir_analyze only keeps the value of variables it knows at compile time
+    if (!var->gen_is_const) {
+        if (var->is_comptime == nullptr) {
+            interp->unsupported = true;
+            return false;
+        }
+        InterpValue *is_comptime = get_value(interp, var->is_comptime);
+        if (is_comptime->id != InterpValueIdBool || !is_comptime->data.x_bool)
+            return false;
+    }
+
+    TypeTableEntry *explicit_type = nullptr;
+    if (instruction->var_type != nullptr) {
+        InterpValue *var_type = get_value(interp, instruction->var_type);
+        if (var_type->id != InterpValueIdType)
+            return false;
+        explicit_type = var_type->data.x_type;
+        if (!is_scalar_type(explicit_type) && !is_supported_array_type(explicit_type))
+            return false;
+    }
+
+    InterpValue init_val;
+    if (!implicit_cast(interp, get_value(interp, instruction->init_value), explicit_type, &init_val))
+        return false;
+    if (init_val.type == nullptr)
+        return false;
+    copy_value(interp, get_slot(interp, var->mem_slot_index), &init_val);
+    return true;
+}
+
+static bool interp_load_ptr(Interp *interp, InterpValue *ptr, InterpValue *out) {
+    if (ptr->id != InterpValueIdPtr)
+        return false;
+    InterpValue *slot_val = get_slot(interp, ptr->data.x_ptr.slot);
+    if (ptr->data.x_ptr.is_array_len) {
+        set_int(out, interp->g->builtin_types.entry_usize, slot_val->type->data.array.len);
+        return true;
+    }
+    if (ptr->data.x_ptr.elem_index == SIZE_MAX) {
+        if (slot_val->id == InterpValueIdNone)
+            return false;
+        copy_value(interp, out, slot_val);
+        return true;
+    }
+
+    TypeTableEntry *child_type = slot_val->type->data.array.child_type;
+    InterpArray *array = slot_val->data.x_array;
+    size_t index = ptr->data.x_ptr.elem_index;
+    if (array->is_undef[index]) {
+        out->id = InterpValueIdUndef;
+        out->type = child_type;
+    } else if (child_type->id == TypeTableEntryIdBool) {
+        set_bool(interp, out, array->elements[index] != 0);
+    } else {
+        set_int(out, child_type, array->elements[index]);
+    }
+    return true;
+}
+
+static bool interp_store_ptr(Interp *interp, InterpValue *ptr, InterpValue *value) {
+    if (ptr->id != InterpValueIdPtr || ptr->data.x_ptr.is_const || ptr->data.x_ptr.is_array_len)
+        return false;
+    InterpValue *slot_val = get_slot(interp, ptr->data.x_ptr.slot);
+    if (ptr->data.x_ptr.elem_index == SIZE_MAX) {
+        InterpValue casted_val;
+        if (!implicit_cast(interp, value, slot_val->type, &casted_val))
+            return false;
+        copy_value(interp, slot_val, &casted_val);
+        return true;
+    }
+
+    TypeTableEntry *child_type = slot_val->type->data.array.child_type;
+    InterpValue casted_val;
+    if (!implicit_cast(interp, value, child_type, &casted_val))
+        return false;
+    InterpArray *array = slot_val->data.x_array;
+    size_t index = ptr->data.x_ptr.elem_index;
+    array->is_undef[index] = (casted_val.id == InterpValueIdUndef);
+    if (casted_val.id == InterpValueIdBool) {
+        array->elements[index] = casted_val.data.x_bool;
+    } else if (casted_val.id == InterpValueIdInt) {
+        array->elements[index] = casted_val.data.x_int;
+    }
+    return true;
+}
+
+static bool interp_elem_ptr(Interp *interp, IrInstructionElemPtr *instruction, InterpValue *out) {
+    InterpValue *array_ptr = get_value(interp, instruction->array_ptr);
+    if (array_ptr->id != InterpValueIdPtr || array_ptr->data.x_ptr.elem_index != SIZE_MAX ||
+        array_ptr->data.x_ptr.is_array_len)
+    {
+        return false;
+    }
+    InterpValue *array_val = get_slot(interp, array_ptr->data.x_ptr.slot);
+    if (array_val->id != InterpValueIdArray)
+        return false;
+
+    InterpValue index_val;
+    if (!implicit_cast(interp, get_value(interp, instruction->elem_index),
+                interp->g->builtin_types.entry_usize, &index_val) ||
+        index_val.id != InterpValueIdInt)
+    {
+        return false;
+    }
+    if (index_val.data.x_int >= (__int128)array_val->type->data.array.len)
+        return false;
+
+    *out = *array_ptr;
+    out->data.x_ptr.elem_index = (size_t)index_val.data.x_int;
+    return true;
+}
+
+static bool interp_field_ptr(Interp *interp, IrInstructionFieldPtr *instruction, InterpValue *out) {
+    InterpValue *container_ptr = get_value(interp, instruction->container_ptr);
+    if (container_ptr->id != InterpValueIdPtr || container_ptr->data.x_ptr.elem_index != SIZE_MAX ||
+        container_ptr->data.x_ptr.is_array_len)
+    {
+        return false;
+    }
+    InterpValue *container_val = get_slot(interp, container_ptr->data.x_ptr.slot);
+    if (container_val->id != InterpValueIdArray || !buf_eql_str(instruction->field_name, "len"))
+        return false;
+
+    *out = *container_ptr;
+    out->data.x_ptr.is_const = true;
+    out->data.x_ptr.is_array_len = true;
+    return true;
+}
+
+// Only the explicit casts between integer types, such as u8(x).
+static bool interp_call(Interp *interp, IrInstructionCall *instruction, InterpValue *out) {
+    InterpValue *fn_ref = get_value(interp, instruction->fn_ref);
+    if (fn_ref->id != InterpValueIdType || instruction->arg_count != 1)
+        return false;
+    TypeTableEntry *wanted_type = fn_ref->data.x_type;
+    InterpValue *value = get_int(interp, instruction->args[0]);
+    if (value == nullptr || !is_small_int_type(wanted_type))
+        return false;
+    if (!int_fits_in_type(value->data.x_int, wanted_type))
+        return false;
+    set_int(out, wanted_type, value->data.x_int);
+    return true;
+}
+
+static bool interp_decl_ref(Interp *interp, IrInstructionDeclRef *instruction, InterpValue *out) {
+    Tld *tld = instruction->tld;
+    if (instruction->lval.is_ptr || tld->id != TldIdVar || tld->resolution != TldResolutionOk)
+        return false;
+    TldVar *tld_var = (TldVar *)tld;
+    VariableTableEntry *var = tld_var->var;
+    if (!var->src_is_const || tld_var->extern_lib_name != nullptr ||
+        var->value->special != ConstValSpecialStatic)
+    {
+        return false;
+    }
+    return value_from_const(interp, var->value, out);
+}
+
+static bool interp_array_type(Interp *interp, IrInstructionArrayType *instruction, InterpValue *out) {
+    InterpValue *child_type = get_value(interp, instruction->child_type);
+    if (child_type->id != InterpValueIdType || !is_scalar_type(child_type->data.x_type))
+        return false;
+    InterpValue size_val;
+    if (!implicit_cast(interp, get_value(interp, instruction->size),
+                interp->g->builtin_types.entry_usize, &size_val) ||
+        size_val.id != InterpValueIdInt)
+    {
+        return false;
+    }
+    out->id = InterpValueIdType;
+    out->type = interp->g->builtin_types.entry_type;
+    out->data.x_type = get_array_type(interp->g, child_type->data.x_type, (uint64_t)size_val.data.x_int);
+    return true;
+}
+
+static bool interp_jump(Interp *interp, IrBasicBlock *dest_block,
+        size_t *backward_branch_count, size_t backward_branch_quota)
+{
+    if (dest_block->debug_id <= interp->current_bb->debug_id) {
+        // exceeding the quota is an error, which ir_analyze reports
+        if (*backward_branch_count >= backward_branch_quota)
+            return false;
+        *backward_branch_count += 1;
+    }
+    interp->prev_bb = interp->current_bb;
+    interp->current_bb = dest_block;
+    return true;
+}
+
+static bool interp_phi(Interp *interp, IrInstructionPhi *instruction, InterpValue *out) {
+    for (size_t i = 0; i < instruction->incoming_count; i += 1) {
+        if (instruction->incoming_blocks[i] == interp->prev_bb) {
+            InterpValue *value = get_value(interp, instruction->incoming_values[i]);
+            if (value->id == InterpValueIdNone)
+                return false;
+            *out = *value;
+            return true;
+        }
+    }
+    return false;
+}
+
+static bool value_to_const(Interp *interp, InterpValue *value, ConstExprValue *out_val) {
+    TypeTableEntry *type = value->type;
+    switch (value->id) {
+        case InterpValueIdVoid:
+            break;
+        case InterpValueIdBool:
+            out_val->data.x_bool = value->data.x_bool;
+            break;
+        case InterpValueIdType:
+            out_val->data.x_type = value->data.x_type;
+            break;
+        case InterpValueIdInt:
+            if (value->data.x_int < 0) {
+                bigint_init_signed(&out_val->data.x_bigint, (int64_t)value->data.x_int);
+            } else {
+                bigint_init_unsigned(&out_val->data.x_bigint, (uint64_t)value->data.x_int);
+            }
+            break;
+        case InterpValueIdArray:
+            {
+                size_t len = type->data.array.len;
+                TypeTableEntry *child_type = type->data.array.child_type;
+                InterpArray *array = value->data.x_array;
+                bool any_defined = false;
+                for (size_t i = 0; i < len; i += 1) {
+                    any_defined = any_defined || !array->is_undef[i];
+                }
+                // an entirely undefined array is represented differently
+                if (!any_defined)
+                    return false;
+
+                out_val->data.x_array.special = ConstArraySpecialNone;
+                out_val->data.x_array.s_none.elements = create_const_vals(interp->g, len);
+                for (size_t i = 0; i < len; i += 1) {
+                    ConstExprValue *elem_val = &out_val->data.x_array.s_none.elements[i];
+                    elem_val->type = child_type;
+                    if (array->is_undef[i]) {
+                        init_const_undefined(interp->g, elem_val);
+                    } else if (child_type->id == TypeTableEntryIdBool) {
+                        elem_val->special = ConstValSpecialStatic;
+                        elem_val->data.x_bool = (array->elements[i] != 0);
+                    } else {
+                        elem_val->special = ConstValSpecialStatic;
+                        if (array->elements[i] < 0) {
+                            bigint_init_signed(&elem_val->data.x_bigint, (int64_t)array->elements[i]);
+                        } else {
+                            bigint_init_unsigned(&elem_val->data.x_bigint, (uint64_t)array->elements[i]);
+                        }
+                    }
+                }
+                break;
+            }
+        default:
+            // undefined results are reported by ir_analyze
+            return false;
+    }
+    out_val->type = type;
+    out_val->special = ConstValSpecialStatic;
+    return true;
+}
+
+static bool interp_instruction(Interp *interp, IrInstruction *instruction) {
+    InterpValue *out = get_value(interp, instruction);
+    switch (instruction->id) {
+        case IrInstructionIdConst:
+            if (!value_from_const(interp, &instruction->value, out)) {
+                interp->unsupported = true;
+                return false;
+            }
+            return true;
+        case IrInstructionIdDeclVar:
+            if (!interp_decl_var(interp, (IrInstructionDeclVar *)instruction))
+                return false;
+            set_void(interp, out);
+            return true;
+        case IrInstructionIdVarPtr:
+            return interp_var_ptr(interp, ((IrInstructionVarPtr *)instruction)->var, out);
+        case IrInstructionIdLoadPtr:
+            return interp_load_ptr(interp, get_value(interp, ((IrInstructionLoadPtr *)instruction)->ptr), out);
+        case IrInstructionIdStorePtr:
+            {
+                IrInstructionStorePtr *store_instruction = (IrInstructionStorePtr *)instruction;
+                if (!interp_store_ptr(interp, get_value(interp, store_instruction->ptr),
+                            get_value(interp, store_instruction->value)))
+                {
+                    return false;
+                }
+                set_void(interp, out);
+                return true;
+            }
+        case IrInstructionIdElemPtr:
+            return interp_elem_ptr(interp, (IrInstructionElemPtr *)instruction, out);
+        case IrInstructionIdFieldPtr:
+            return interp_field_ptr(interp, (IrInstructionFieldPtr *)instruction, out);
+        case IrInstructionIdBinOp:
+            return interp_bin_op(interp, (IrInstructionBinOp *)instruction, out);
+        case IrInstructionIdUnOp:
+            {
+                IrInstructionUnOp *un_op_instruction = (IrInstructionUnOp *)instruction;
+                return interp_un_op(un_op_instruction, get_value(interp, un_op_instruction->value), out);
+            }
+        case IrInstructionIdBoolNot:
+            {
+                InterpValue *value = get_value(interp, ((IrInstructionBoolNot *)instruction)->value);
+                if (value->id != InterpValueIdBool)
+                    return false;
+                set_bool(interp, out, !value->data.x_bool);
+                return true;
+            }
+        case IrInstructionIdPhi:
+            return interp_phi(interp, (IrInstructionPhi *)instruction, out);
+        case IrInstructionIdCheckStatementIsVoid:
+            {
+                InterpValue *value = get_value(interp, ((IrInstructionCheckStatementIsVoid *)instruction)->statement_value);
+                if (value->id != InterpValueIdVoid)
+                    return false;
+                set_void(interp, out);
+                return true;
+            }
+        case IrInstructionIdCall:
+            return interp_call(interp, (IrInstructionCall *)instruction, out);
+        case IrInstructionIdDeclRef:
+            return interp_decl_ref(interp, (IrInstructionDeclRef *)instruction, out);
+        case IrInstructionIdArrayType:
+            return interp_array_type(interp, (IrInstructionArrayType *)instruction, out);
+        default:
+            interp->unsupported = true;
+            return false;
+    }
+}
+
+static bool interp_run(Interp *interp, TypeTableEntry *return_type,
+        size_t *backward_branch_count, size_t backward_branch_quota, ConstExprValue *out_val)
+{
+    interp->current_bb = interp->exec->basic_block_list.at(0);
+    for (;;) {
+        IrBasicBlock *bb = interp->current_bb;
+        bool jumped = false;
+        for (size_t i = 0; i < bb->instruction_list.length && !jumped; i += 1) {
+            IrInstruction *instruction = bb->instruction_list.at(i);
+            switch (instruction->id) {
+                case IrInstructionIdReturn:
+                    {
+                        InterpValue *value = get_value(interp, ((IrInstructionReturn *)instruction)->value);
+                        InterpValue result;
+                        if (!implicit_cast(interp, value, return_type, &result))
+                            return false;
+                        return value_to_const(interp, &result, out_val);
+                    }
+                case IrInstructionIdBr:
+                    if (!interp_jump(interp, ((IrInstructionBr *)instruction)->dest_block,
+                                backward_branch_count, backward_branch_quota))
+                    {
+                        return false;
+                    }
+                    jumped = true;
+                    break;
+                case IrInstructionIdCondBr:
+                    {
+                        IrInstructionCondBr *cond_br_instruction = (IrInstructionCondBr *)instruction;
+                        InterpValue *condition = get_value(interp, cond_br_instruction->condition);
+                        if (condition->id != InterpValueIdBool)
+                            return false;
+                        IrBasicBlock *dest_block = condition->data.x_bool ?
+                            cond_br_instruction->then_block : cond_br_instruction->else_block;
+                        if (!interp_jump(interp, dest_block, backward_branch_count, backward_branch_quota))
+                            return false;
+                        jumped = true;
+                        break;
+                    }
+                default:
+                    if (!interp_instruction(interp, instruction))
+                        return false;
+                    break;
+            }
+        }
+        if (!jumped)
+            return false;
+    }
+}
+
+// Fails without modifying anything but the types it looked up when the body
+// is not one the interpreter handles, or when it would fail to evaluate. On
+// success *backward_branch_count has been advanced as ir_analyze would have.
+InterpretResult ir_interpret_fn_body(CodeGen *g, IrExecutable *exec, TypeTableEntry *return_type,
+        size_t *backward_branch_count, size_t backward_branch_quota, ConstExprValue *out_val)
+{
+    if (return_type->id != TypeTableEntryIdVoid && return_type->id != TypeTableEntryIdMetaType &&
+        !is_scalar_type(return_type) && !is_supported_array_type(return_type))
+    {
+        return InterpretResultUnsupported;
+    }
+
+    Interp interp = {};
+    interp.g = g;
+    interp.exec = exec;
+    interp.regs = allocate<InterpValue>(exec->next_debug_id);
+    interp.slots.resize(exec->mem_slot_count);
+    for (size_t i = 0; i < exec->mem_slot_count; i += 1) {
+        interp.slots.at(i).id = InterpValueIdNone;
+    }
+
+    size_t old_backward_branch_count = *backward_branch_count;
+    bool ok = interp_run(&interp, return_type, backward_branch_count, backward_branch_quota, out_val);
+    if (!ok)
+        *backward_branch_count = old_backward_branch_count;
+
+    for (size_t i = 0; i < interp.arrays.length; i += 1) {
+        InterpArray *array = interp.arrays.at(i);
+        free(array->elements);
+        free(array->is_undef);
+        free(array);
+    }
+    interp.arrays.deinit();
+    interp.param_vars.deinit();
+    interp.slots.deinit();
+    free(interp.regs);
+    if (ok)
+        return InterpretResultOk;
+    return interp.unsupported ? InterpretResultUnsupported : InterpretResultGaveUp;
+}
@@ -0,0 +1,26 @@
+/*
+ * Copyright (c) 2017 Andrew Kelley
+ *
+ * This file is part of zig, which is MIT licensed.
+ * See http://opensource.org/licenses/MIT
+ */
+
+#ifndef ZIG_IR_INTERPRET_HPP
+#define ZIG_IR_INTERPRET_HPP
+
+#include "all_types.hpp"
+
+enum InterpretResult {
+    InterpretResultOk,
+    // the body uses an instruction, a constant or a type the interpreter
+    // never handles, so no call of it can be interpreted
+    InterpretResultUnsupported,
+    // the values of this call led to something left to ir_analyze, such as
+    // an overflow, so another call may still be interpreted
+    InterpretResultGaveUp,
+};
+
+InterpretResult ir_interpret_fn_body(CodeGen *g, IrExecutable *exec, TypeTableEntry *return_type,
+        size_t *backward_branch_count, size_t backward_branch_quota, ConstExprValue *out_val);
+
+#endif
@@ -168,7 +168,7 @@ static void ir_print_bin_op(IrPrint *irp, IrInstructionBinOp *bin_op_instruction
 
 static void ir_print_decl_var(IrPrint *irp, IrInstructionDeclVar *decl_var_instruction) {
     const char *var_or_const = decl_var_instruction->var->gen_is_const ? "const" : "var";
-    const char *name = buf_ptr(&decl_var_instruction->var->name);
+    const char *name = buf_ptr(decl_var_instruction->var->name);
     if (decl_var_instruction->var_type) {
         fprintf(irp->f, "%s %s: ", var_or_const, name);
         ir_print_other_instruction(irp, decl_var_instruction->var_type);
@@ -298,7 +298,7 @@ static void ir_print_elem_ptr(IrPrint *irp, IrInstructionElemPtr *instruction) {
 }
 
 static void ir_print_var_ptr(IrPrint *irp, IrInstructionVarPtr *instruction) {
-    fprintf(irp->f, "&%s", buf_ptr(&instruction->var->name));
+    fprintf(irp->f, "&%s", buf_ptr(instruction->var->name));
 }
 
 static void ir_print_load_ptr(IrPrint *irp, IrInstructionLoadPtr *instruction) {
@@ -593,6 +593,42 @@ static void ir_print_fence(IrPrint *irp, IrInstructionFence *instruction) {
     fprintf(irp->f, ")");
 }
 
+static void ir_print_atomic_rmw(IrPrint *irp, IrInstructionAtomicRmw *instruction) {
+    fprintf(irp->f, "@atomicRmw(");
+    ir_print_other_instruction(irp, instruction->operand_type);
+    fprintf(irp->f, ", ");
+    ir_print_other_instruction(irp, instruction->ptr);
+    fprintf(irp->f, ", ");
+    ir_print_other_instruction(irp, instruction->op_value);
+    fprintf(irp->f, ", ");
+    ir_print_other_instruction(irp, instruction->operand);
+    fprintf(irp->f, ", ");
+    ir_print_other_instruction(irp, instruction->order_value);
+    fprintf(irp->f, ")");
+}
+
+static void ir_print_atomic_load(IrPrint *irp, IrInstructionAtomicLoad *instruction) {
+    fprintf(irp->f, "@atomicLoad(");
+    ir_print_other_instruction(irp, instruction->operand_type);
+    fprintf(irp->f, ", ");
+    ir_print_other_instruction(irp, instruction->ptr);
+    fprintf(irp->f, ", ");
+    ir_print_other_instruction(irp, instruction->order_value);
+    fprintf(irp->f, ")");
+}
+
+static void ir_print_atomic_store(IrPrint *irp, IrInstructionAtomicStore *instruction) {
+    fprintf(irp->f, "@atomicStore(");
+    ir_print_other_instruction(irp, instruction->operand_type);
+    fprintf(irp->f, ", ");
+    ir_print_other_instruction(irp, instruction->ptr);
+    fprintf(irp->f, ", ");
+    ir_print_other_instruction(irp, instruction->value);
+    fprintf(irp->f, ", ");
+    ir_print_other_instruction(irp, instruction->order_value);
+    fprintf(irp->f, ")");
+}
+
 static void ir_print_truncate(IrPrint *irp, IrInstructionTruncate *instruction) {
     fprintf(irp->f, "@truncate(");
     ir_print_other_instruction(irp, instruction->dest_type);
@@ -904,6 +940,93 @@ static void ir_print_type_id(IrPrint *irp, IrInstructionTypeId *instruction) {
     fprintf(irp->f, ")");
 }
 
+static void ir_print_vector_type(IrPrint *irp, IrInstructionVectorType *instruction) {
+    fprintf(irp->f, "@Vector(");
+    ir_print_other_instruction(irp, instruction->len);
+    fprintf(irp->f, ",");
+    ir_print_other_instruction(irp, instruction->elem_type);
+    fprintf(irp->f, ")");
+}
+
+static void ir_print_splat(IrPrint *irp, IrInstructionSplat *instruction) {
+    fprintf(irp->f, "@splat(");
+    if (instruction->len != nullptr) {
+        ir_print_other_instruction(irp, instruction->len);
+    } else {
+        fprintf(irp->f, "%" PRIu32, instruction->base.value.type->data.vector.len);
+    }
+    fprintf(irp->f, ",");
+    ir_print_other_instruction(irp, instruction->scalar);
+    fprintf(irp->f, ")");
+}
+
+static void ir_print_shuffle(IrPrint *irp, IrInstructionShuffle *instruction) {
+    fprintf(irp->f, "@shuffle(");
+    if (instruction->elem_type != nullptr) {
+        ir_print_other_instruction(irp, instruction->elem_type);
+        fprintf(irp->f, ",");
+    }
+    ir_print_other_instruction(irp, instruction->a);
+    fprintf(irp->f, ",");
+    ir_print_other_instruction(irp, instruction->b);
+    fprintf(irp->f, ",");
+    if (instruction->mask != nullptr) {
+        ir_print_other_instruction(irp, instruction->mask);
+    } else {
+        fprintf(irp->f, "{");
+        for (uint32_t i = 0; i < instruction->mask_len; i += 1) {
+            if (i != 0)
+                fprintf(irp->f, ",");
+            fprintf(irp->f, "%" PRId32, instruction->mask_indexes[i]);
+        }
+        fprintf(irp->f, "}");
+    }
+    fprintf(irp->f, ")");
+}
+
+static void ir_print_extract_element(IrPrint *irp, IrInstructionExtractElement *instruction) {
+    fprintf(irp->f, "@extractElement(");
+    ir_print_other_instruction(irp, instruction->vector);
+    fprintf(irp->f, ",");
+    ir_print_other_instruction(irp, instruction->index);
+    fprintf(irp->f, ")");
+}
+
+static void ir_print_insert_element(IrPrint *irp, IrInstructionInsertElement *instruction) {
+    fprintf(irp->f, "@insertElement(");
+    ir_print_other_instruction(irp, instruction->vector);
+    fprintf(irp->f, ",");
+    ir_print_other_instruction(irp, instruction->index);
+    fprintf(irp->f, ",");
+    ir_print_other_instruction(irp, instruction->value);
+    fprintf(irp->f, ")");
+}
+
+static const char *reduce_op_str(ReduceOp op) {
+    switch (op) {
+        case ReduceOpAdd: return "Add";
+        case ReduceOpMul: return "Mul";
+        case ReduceOpAnd: return "And";
+        case ReduceOpOr: return "Or";
+        case ReduceOpXor: return "Xor";
+        case ReduceOpMin: return "Min";
+        case ReduceOpMax: return "Max";
+    }
+    zig_unreachable();
+}
+
+static void ir_print_reduce(IrPrint *irp, IrInstructionReduce *instruction) {
+    fprintf(irp->f, "@reduce(");
+    if (instruction->op_value != nullptr) {
+        ir_print_other_instruction(irp, instruction->op_value);
+    } else {
+        fprintf(irp->f, "%s", reduce_op_str(instruction->op));
+    }
+    fprintf(irp->f, ",");
+    ir_print_other_instruction(irp, instruction->vector);
+    fprintf(irp->f, ")");
+}
+
 static void ir_print_instruction(IrPrint *irp, IrInstruction *instruction) {
     ir_print_prefix(irp, instruction);
     switch (instruction->id) {
@@ -1068,6 +1191,15 @@ static void ir_print_instruction(IrPrint *irp, IrInstruction *instruction) {
         case IrInstructionIdFence:
             ir_print_fence(irp, (IrInstructionFence *)instruction);
             break;
+        case IrInstructionIdAtomicRmw:
+            ir_print_atomic_rmw(irp, (IrInstructionAtomicRmw *)instruction);
+            break;
+        case IrInstructionIdAtomicLoad:
+            ir_print_atomic_load(irp, (IrInstructionAtomicLoad *)instruction);
+            break;
+        case IrInstructionIdAtomicStore:
+            ir_print_atomic_store(irp, (IrInstructionAtomicStore *)instruction);
+            break;
         case IrInstructionIdTruncate:
             ir_print_truncate(irp, (IrInstructionTruncate *)instruction);
             break;
@@ -1194,6 +1326,24 @@ static void ir_print_instruction(IrPrint *irp, IrInstruction *instruction) {
         case IrInstructionIdTypeId:
             ir_print_type_id(irp, (IrInstructionTypeId *)instruction);
             break;
+        case IrInstructionIdVectorType:
+            ir_print_vector_type(irp, (IrInstructionVectorType *)instruction);
+            break;
+        case IrInstructionIdSplat:
+            ir_print_splat(irp, (IrInstructionSplat *)instruction);
+            break;
+        case IrInstructionIdShuffle:
+            ir_print_shuffle(irp, (IrInstructionShuffle *)instruction);
+            break;
+        case IrInstructionIdExtractElement:
+            ir_print_extract_element(irp, (IrInstructionExtractElement *)instruction);
+            break;
+        case IrInstructionIdInsertElement:
+            ir_print_insert_element(irp, (IrInstructionInsertElement *)instruction);
+            break;
+        case IrInstructionIdReduce:
+            ir_print_reduce(irp, (IrInstructionReduce *)instruction);
+            break;
     }
     fprintf(irp->f, "\n");
 }
@@ -10,6 +10,7 @@
 #include "config.h"
 #include "codegen.hpp"
 #include "analyze.hpp"
+#include "cache_hash.hpp"
 
 struct LinkJob {
     CodeGen *codegen;
@@ -31,11 +32,92 @@ static const char *get_libc_static_file(CodeGen *g, const char *file) {
     return buf_ptr(out_buf);
 }
 
-static Buf *build_o(CodeGen *parent_gen, const char *oname) {
+// Identifies the running compiler binary. A rebuilt compiler keeps its version
+// string, so the version alone would let it reuse objects built by the old one.
+static uint64_t get_compiler_id(void) {
+    static bool have_compiler_id = false;
+    static uint64_t compiler_id;
+    if (have_compiler_id)
+        return compiler_id;
+
+    Buf *self_exe_path = buf_alloc();
+    Buf *contents = buf_alloc();
+    int err;
+    if ((err = os_self_exe_path(self_exe_path))) {
+        zig_panic("unable to find the compiler executable: %s", err_str(err));
+    }
+    if ((err = os_map_file_path(self_exe_path, contents))) {
+        zig_panic("unable to open '%s': %s", buf_ptr(self_exe_path), err_str(err));
+    }
+    compiler_id = CACHE_HASH_INIT;
+    cache_hash_mem(&compiler_id, buf_ptr(contents), buf_len(contents));
+    have_compiler_id = true;
+    return compiler_id;
+}
+
+// builtin.zig and compiler_rt.zig import nothing but the generated "builtin"
+// package, which is itself derived from the options hashed here. Their objects
+// only depend on these inputs, so one can be shared between every link job that
+// agrees on them. This does not hold for a source that imports std.
+static Buf *get_cached_o_path(CodeGen *parent_gen, const char *oname, Buf *source_path) {
+    Buf *source_code = buf_alloc();
+    int err;
+    if ((err = os_fetch_file_path(source_path, source_code))) {
+        zig_panic("unable to open '%s': %s", buf_ptr(source_path), err_str(err));
+    }
+
+    uint64_t hash = CACHE_HASH_INIT;
+    cache_hash_str(&hash, ZIG_VERSION_STRING);
+    uint64_t compiler_id = get_compiler_id();
+    cache_hash_mem(&hash, &compiler_id, sizeof(uint64_t));
+    cache_hash_mem(&hash, buf_ptr(source_code), buf_len(source_code));
+    cache_hash_str(&hash, buf_ptr(&parent_gen->triple_str));
+    cache_hash_mem(&hash, &parent_gen->build_mode, sizeof(BuildMode));
+    cache_hash_bool(&hash, parent_gen->strip_debug_symbols);
+    cache_hash_bool(&hash, parent_gen->is_static);
+    cache_hash_str(&hash, parent_gen->mmacosx_version_min ? buf_ptr(parent_gen->mmacosx_version_min) : "");
+    cache_hash_str(&hash, parent_gen->mios_version_min ? buf_ptr(parent_gen->mios_version_min) : "");
+    cache_hash_bool(&hash, parent_gen->is_native_target);
+    if (parent_gen->is_native_target) {
+        // native builds tune for the host CPU
+        cache_hash_str(&hash, ZigLLVMGetHostCPUName());
+        cache_hash_str(&hash, ZigLLVMGetNativeFeatures());
+    }
+
+    const char *o_ext = target_o_file_ext(&parent_gen->zig_target);
+    Buf *o_out_name = buf_sprintf("%s-%016" ZIG_PRI_x64 "%s", oname, hash, o_ext);
+    Buf *output_path = buf_alloc();
+    os_path_join(parent_gen->cache_dir, o_out_name, output_path);
+    return output_path;
+}
+
+// Sources that import std can't be cached: their key would have to cover
+// every file they import.
+static Buf *build_o(CodeGen *parent_gen, const char *oname, bool cacheable) {
     Buf *source_basename = buf_sprintf("%s.zig", oname);
     Buf *full_path = buf_alloc();
     os_path_join(parent_gen->zig_std_special_dir, source_basename, full_path);
 
+    Buf *output_path;
+    bool cache_hit = false;
+    int err;
+    if (cacheable) {
+        output_path = get_cached_o_path(parent_gen, oname, full_path);
+        if ((err = os_file_exists(output_path, &cache_hit))) {
+            zig_panic("unable to check if file exists: %s", buf_ptr(output_path));
+        }
+    } else {
+        const char *o_ext = target_o_file_ext(&parent_gen->zig_target);
+        output_path = buf_alloc();
+        os_path_join(parent_gen->cache_dir, buf_sprintf("%s%s", oname, o_ext), output_path);
+    }
+    if (cache_hit) {
+        if (parent_gen->verbose) {
+            fprintf(stderr, "using cached %s\n", buf_ptr(output_path));
+        }
+        return output_path;
+    }
+
     ZigTarget *child_target = parent_gen->is_native_target ? nullptr : &parent_gen->zig_target;
     CodeGen *child_gen = codegen_create(full_path, child_target, OutTypeObj, parent_gen->build_mode);
 
@@ -46,8 +128,13 @@ static Buf *build_o(CodeGen *parent_gen, const char *oname) {
 
     codegen_set_strip(child_gen, parent_gen->strip_debug_symbols);
     codegen_set_is_static(child_gen, parent_gen->is_static);
+    // Not bitcode even in --lto builds: LLD could internalize or drop the
+    // compiler_rt functions before LTO codegen emits the calls to them.
 
-    codegen_set_out_name(child_gen, buf_create_from_str(oname));
+    // The object is emitted under a name of its own and renamed into place, so
+    // that a build that crashes or races with another one never leaves a partial
+    // object where a later build would take it for a cache hit.
+    codegen_set_out_name(child_gen, buf_sprintf("%s-%" PRIu32, oname, os_get_pid()));
 
     codegen_set_verbose(child_gen, parent_gen->verbose);
     codegen_set_errmsg_color(child_gen, parent_gen->err_color);
@@ -56,11 +143,18 @@ static Buf *build_o(CodeGen *parent_gen, const char *oname) {
     codegen_set_mios_version_min(child_gen, parent_gen->mios_version_min);
 
     codegen_build(child_gen);
-    const char *o_ext = target_o_file_ext(&child_gen->zig_target);
-    Buf *o_out_name = buf_sprintf("%s%s", oname, o_ext);
-    Buf *output_path = buf_alloc();
-    os_path_join(parent_gen->cache_dir, o_out_name, output_path);
-    codegen_link(child_gen, buf_ptr(output_path));
+    codegen_link(child_gen, nullptr);
+
+    assert(child_gen->link_objects.length == 1);
+    Buf *tmp_path = child_gen->link_objects.at(0);
+    if ((err = os_rename(tmp_path, output_path))) {
+        // on Windows a rename does not replace the object another build moved into place first
+        bool exists;
+        if (os_file_exists(output_path, &exists) || !exists) {
+            zig_panic("unable to rename '%s' to '%s': %s", buf_ptr(tmp_path), buf_ptr(output_path), err_str(err));
+        }
+        os_delete_file(tmp_path);
+    }
 
     return output_path;
 }
@@ -146,6 +240,20 @@ static void add_rpath(LinkJob *lj, Buf *rpath) {
     lj->rpath_table.put(rpath, true);
 }
 
+// optimization level of the code the linker generates from LTO bitcode
+static unsigned get_lto_opt_level(CodeGen *g) {
+    switch (g->build_mode) {
+        case BuildModeDebug:
+            return 0;
+        case BuildModeSafeRelease:
+        case BuildModeFastRelease:
+            return 3;
+        case BuildModeSmallRelease:
+            return 2;
+    }
+    zig_unreachable();
+}
+
 static void construct_linker_job_elf(LinkJob *lj) {
     CodeGen *g = lj->codegen;
 
@@ -160,6 +268,18 @@ static void construct_linker_job_elf(LinkJob *lj) {
 
     lj->args.append("--gc-sections");
 
+    if (g->lto != ZigLLVMLtoModeNone) {
+        lj->args.append(buf_ptr(buf_sprintf("--lto-O%u", get_lto_opt_level(g))));
+        // --codegen-threads splits link time code generation instead of the root module
+        if (g->codegen_threads > 1) {
+            if (g->lto == ZigLLVMLtoModeThin) {
+                lj->args.append(buf_ptr(buf_sprintf("--thinlto-jobs=%" ZIG_PRI_usize, g->codegen_threads)));
+            } else {
+                lj->args.append(buf_ptr(buf_sprintf("--lto-partitions=%" ZIG_PRI_usize, g->codegen_threads)));
+            }
+        }
+    }
+
     lj->args.append("-m");
     lj->args.append(getLDMOption(&g->zig_target));
 
@@ -260,13 +380,18 @@ static void construct_linker_job_elf(LinkJob *lj) {
     }
 
     if (g->libc_link_lib == nullptr && (g->out_type == OutTypeExe || g->out_type == OutTypeLib)) {
-        Buf *builtin_o_path = build_o(g, "builtin");
+        Buf *builtin_o_path = build_o(g, "builtin", true);
         lj->args.append(buf_ptr(builtin_o_path));
 
-        Buf *compiler_rt_o_path = build_o(g, "compiler_rt");
+        Buf *compiler_rt_o_path = build_o(g, "compiler_rt", true);
         lj->args.append(buf_ptr(compiler_rt_o_path));
     }
 
+    if (g->profile_generate && g->out_type == OutTypeExe) {
+        Buf *profile_rt_o_path = build_o(g, "profile_rt", false);
+        lj->args.append(buf_ptr(profile_rt_o_path));
+    }
+
     for (size_t i = 0; i < g->link_libs_list.length; i += 1) {
         LinkLib *link_lib = g->link_libs_list.at(i);
         if (buf_eql_str(link_lib->name, "c")) {
@@ -336,6 +461,13 @@ static void construct_linker_job_coff(LinkJob *lj) {
         lj->args.append("-MACHINE:ARM");
     }
 
+    if (g->lto != ZigLLVMLtoModeNone) {
+        lj->args.append(buf_ptr(buf_sprintf("-OPT:lldlto=%u", get_lto_opt_level(g))));
+        if (g->codegen_threads > 1) {
+            lj->args.append(buf_ptr(buf_sprintf("-OPT:lldltojobs=%" ZIG_PRI_usize, g->codegen_threads)));
+        }
+    }
+
     if (g->windows_subsystem_windows) {
         lj->args.append("/SUBSYSTEM:windows");
     } else if (g->windows_subsystem_console) {
@@ -398,10 +530,10 @@ static void construct_linker_job_coff(LinkJob *lj) {
     }
 
     if (g->libc_link_lib == nullptr && (g->out_type == OutTypeExe || g->out_type == OutTypeLib)) {
-        Buf *builtin_o_path = build_o(g, "builtin");
+        Buf *builtin_o_path = build_o(g, "builtin", true);
         lj->args.append(buf_ptr(builtin_o_path));
 
-        Buf *compiler_rt_o_path = build_o(g, "compiler_rt");
+        Buf *compiler_rt_o_path = build_o(g, "compiler_rt", true);
         lj->args.append(buf_ptr(compiler_rt_o_path));
     }
 
@@ -30,21 +30,31 @@ static int usage(const char *arg0) {
         "Compile Options:\n"
         "  --assembly [source]          add assembly file to build\n"
         "  --cache-dir [path]           override the cache directory\n"
+        "  --codegen-threads [count]    split code generation across count threads\n"
         "  --color [auto|off|on]        enable or disable colored error messages\n"
         "  --enable-timing-info         print timing diagnostics\n"
+        "  --lazy-analysis              only analyze functions that emitted code refers to\n"
         "  --libc-include-dir [path]    directory where libc stdlib.h resides\n"
+        "  --lto=[thin|full]            emit bitcode and optimize across objects at link time\n"
         "  --name [name]                override output name\n"
         "  --output [file]              override destination path\n"
         "  --output-h [file]            override generated header file path\n"
+        "  --parse-threads [count]      parse imports ahead of analysis on count threads\n"
         "  --pkg-begin [name] [path]    make package available to import and push current pkg\n"
         "  --pkg-end                    pop current pkg\n"
+        "  --profile-generate           count executed branches into default.profraw\n"
+        "  --profile-use [file]         optimize with a profile merged by llvm-profdata\n"
         "  --release-fast               build with optimizations on and safety off\n"
         "  --release-safe               build with optimizations on and safety on\n"
+        "  --release-small              build optimized for size with safety off\n"
+        "  --skip-unchanged             skip the build when no option or source file changed\n"
         "  --static                     output will be statically linked\n"
         "  --strip                      exclude debug symbols\n"
+        "  --switch-lowering            print how each switch is lowered in debug builds\n"
         "  --target-arch [name]         specify target architecture\n"
         "  --target-environ [name]      specify target environment\n"
         "  --target-os [name]           specify target operating system\n"
+        "  --timing-trace [file]        write timings as a Chrome trace event file\n"
         "  --verbose                    turn on compiler debug output\n"
         "  --zig-std-dir [path]         directory where zig standard library resides\n"
         "  -dirafter [dir]              same as -isystem but do it last\n"
@@ -154,6 +164,17 @@ static void add_package(CodeGen *g, CliPkg *cli_pkg, PackageTableEntry *pkg) {
     }
 }
 
+static void report_timing_info(CodeGen *g, bool timing_info, const char *timing_trace) {
+    if (timing_info)
+        codegen_print_timing_report(g, stdout);
+    if (timing_trace) {
+        int err;
+        if ((err = codegen_write_timing_trace(g, buf_create_from_str(timing_trace)))) {
+            fprintf(stderr, "unable to write %s: %s\n", timing_trace, err_str(err));
+        }
+    }
+}
+
 int main(int argc, char **argv) {
     os_init();
 
@@ -199,7 +220,16 @@ int main(int argc, char **argv) {
     size_t ver_minor = 0;
     size_t ver_patch = 0;
     bool timing_info = false;
+    const char *timing_trace = nullptr;
     const char *cache_dir = nullptr;
+    size_t codegen_threads = 1;
+    size_t parse_threads = 1;
+    bool skip_unchanged = false;
+    bool lazy_analysis = false;
+    ZigLLVMLtoMode lto = ZigLLVMLtoModeNone;
+    bool profile_generate = false;
+    const char *profile_use = nullptr;
+    bool report_switch_lowering = false;
     CliPkg *cur_pkg = allocate<CliPkg>(1);
     BuildMode build_mode = BuildModeDebug;
 
@@ -324,6 +354,8 @@ int main(int argc, char **argv) {
                 build_mode = BuildModeFastRelease;
             } else if (strcmp(arg, "--release-safe") == 0) {
                 build_mode = BuildModeSafeRelease;
+            } else if (strcmp(arg, "--release-small") == 0) {
+                build_mode = BuildModeSmallRelease;
             } else if (strcmp(arg, "--strip") == 0) {
                 strip = true;
             } else if (strcmp(arg, "--static") == 0) {
@@ -342,6 +374,18 @@ int main(int argc, char **argv) {
                 each_lib_rpath = true;
             } else if (strcmp(arg, "--enable-timing-info") == 0) {
                 timing_info = true;
+            } else if (strcmp(arg, "--skip-unchanged") == 0) {
+                skip_unchanged = true;
+            } else if (strcmp(arg, "--lazy-analysis") == 0) {
+                lazy_analysis = true;
+            } else if (strcmp(arg, "--lto=thin") == 0) {
+                lto = ZigLLVMLtoModeThin;
+            } else if (strcmp(arg, "--lto=full") == 0) {
+                lto = ZigLLVMLtoModeFull;
+            } else if (strcmp(arg, "--profile-generate") == 0) {
+                profile_generate = true;
+            } else if (strcmp(arg, "--switch-lowering") == 0) {
+                report_switch_lowering = true;
             } else if (arg[1] == 'L' && arg[2] != 0) {
                 // alias for --library-path
                 lib_dirs.append(&arg[2]);
@@ -412,6 +456,24 @@ int main(int argc, char **argv) {
                     asm_files.append(argv[i]);
                 } else if (strcmp(arg, "--cache-dir") == 0) {
                     cache_dir = argv[i];
+                } else if (strcmp(arg, "--codegen-threads") == 0) {
+                    int thread_count = atoi(argv[i]);
+                    if (thread_count < 1) {
+                        fprintf(stderr, "--codegen-threads expects a positive integer\n");
+                        return usage(arg0);
+                    }
+                    codegen_threads = (size_t)thread_count;
+                } else if (strcmp(arg, "--parse-threads") == 0) {
+                    int thread_count = atoi(argv[i]);
+                    if (thread_count < 1) {
+                        fprintf(stderr, "--parse-threads expects a positive integer\n");
+                        return usage(arg0);
+                    }
+                    parse_threads = (size_t)thread_count;
+                } else if (strcmp(arg, "--profile-use") == 0) {
+                    profile_use = argv[i];
+                } else if (strcmp(arg, "--timing-trace") == 0) {
+                    timing_trace = argv[i];
                 } else if (strcmp(arg, "--target-arch") == 0) {
                     target_arch = argv[i];
                 } else if (strcmp(arg, "--target-os") == 0) {
@@ -578,6 +640,41 @@ int main(int argc, char **argv) {
             codegen_set_is_test(g, cmd == CmdTest);
             codegen_set_linker_script(g, linker_script);
             codegen_set_cache_dir(g, full_cache_dir);
+            codegen_set_codegen_threads(g, codegen_threads);
+            if (lto != ZigLLVMLtoModeNone && g->zig_target.oformat == ZigLLVM_MachO) {
+                fprintf(stderr, "--lto is not supported by the MachO linker\n");
+                return EXIT_FAILURE;
+            }
+            codegen_set_lto(g, lto);
+            if (profile_generate || profile_use != nullptr) {
+                // LLVM only instruments and applies profiles in optimized builds
+                if (build_mode == BuildModeDebug) {
+                    fprintf(stderr, "--profile-generate and --profile-use require --release-fast, --release-safe or --release-small\n");
+                    return EXIT_FAILURE;
+                }
+                // profile_rt finds the counters through ELF section bounds and
+                // writes them with std.os.linux, which supports x86_64 and i386
+                if (profile_generate && (g->zig_target.os != ZigLLVM_Linux ||
+                    (g->zig_target.arch.arch != ZigLLVM_x86_64 && g->zig_target.arch.arch != ZigLLVM_x86)))
+                {
+                    fprintf(stderr, "--profile-generate is only supported when targeting Linux on x86_64 or i386\n");
+                    return EXIT_FAILURE;
+                }
+                // the counters are written when the program exits, and a
+                // library does not control that
+                if (profile_generate && out_type == OutTypeLib) {
+                    fprintf(stderr, "--profile-generate is not supported for libraries\n");
+                    return EXIT_FAILURE;
+                }
+            }
+            codegen_set_profile_generate(g, profile_generate);
+            if (profile_use != nullptr)
+                codegen_set_profile_use(g, buf_create_from_str(profile_use));
+            codegen_set_parse_threads(g, parse_threads);
+            codegen_set_skip_unchanged(g, skip_unchanged);
+            codegen_set_lazy_analysis(g, lazy_analysis);
+            codegen_set_report_switch_lowering(g, report_switch_lowering);
+            codegen_set_timing_info(g, timing_info || timing_trace != nullptr);
             if (each_lib_rpath)
                 codegen_set_each_lib_rpath(g, each_lib_rpath);
 
@@ -653,14 +750,12 @@ int main(int argc, char **argv) {
                 }
                 codegen_build(g);
                 codegen_link(g, out_file);
-                if (timing_info)
-                    codegen_print_timing_report(g, stdout);
+                report_timing_info(g, timing_info, timing_trace);
                 return EXIT_SUCCESS;
             } else if (cmd == CmdParseH) {
                 codegen_parseh(g, in_file_buf);
                 ast_render_decls(g, stdout, 4, g->root_import);
-                if (timing_info)
-                    codegen_print_timing_report(g, stdout);
+                report_timing_info(g, timing_info, timing_trace);
                 return EXIT_SUCCESS;
             } else if (cmd == CmdTest) {
                 codegen_build(g);
@@ -671,8 +766,8 @@ int main(int argc, char **argv) {
                 if (term.how != TerminationIdClean || term.code != 0) {
                     fprintf(stderr, "\nTests failed. Use the following command to reproduce the failure:\n");
                     fprintf(stderr, "./test\n");
-                } else if (timing_info) {
-                    codegen_print_timing_report(g, stdout);
+                } else {
+                    report_timing_info(g, timing_info, timing_trace);
                 }
                 return (term.how == TerminationIdClean) ? term.code : -1;
             } else {
@@ -32,6 +32,7 @@
 #include <sys/types.h>
 #include <sys/stat.h>
 #include <sys/wait.h>
+#include <sys/mman.h>
 #include <fcntl.h>
 #include <limits.h>
 
@@ -41,6 +42,7 @@
 #if defined(__MACH__)
 #include <mach/clock.h>
 #include <mach/mach.h>
+#include <mach-o/dyld.h>
 #endif
 
 #if defined(ZIG_OS_WINDOWS)
@@ -595,6 +597,64 @@ int os_fetch_file_path(Buf *full_path, Buf *out_contents) {
     return result;
 }
 
+int os_map_file_path(Buf *full_path, Buf *out_contents) {
+#if defined(ZIG_OS_POSIX)
+    int fd = open(buf_ptr(full_path), O_RDONLY|O_CLOEXEC);
+    if (fd == -1) {
+        switch (errno) {
+            case EACCES:
+                return ErrorAccess;
+            case EINTR:
+                return ErrorInterrupted;
+            case ENFILE:
+            case EMFILE:
+            case ENOMEM:
+                return ErrorSystemResources;
+            case ENOENT:
+                return ErrorFileNotFound;
+            default:
+                return ErrorFileSystem;
+        }
+    }
+    struct stat st;
+    if (fstat(fd, &st) == -1) {
+        close(fd);
+        return ErrorFileSystem;
+    }
+    if (!S_ISREG(st.st_mode) || st.st_size == 0) {
+        // pipes and the like can't be mapped, and mapping nothing fails
+        close(fd);
+        return os_fetch_file_path(full_path, out_contents);
+    }
+
+    // Reserve room for the file plus the null terminator that Buf promises,
+    // then map the file over the front of it. The rest of the last file page
+    // and the extra page, if one is needed, read as zero.
+    size_t file_size = (size_t)st.st_size;
+    size_t page_size = (size_t)sysconf(_SC_PAGESIZE);
+    size_t map_size = (file_size + 1 + page_size - 1) & ~(page_size - 1);
+    void *base = mmap(nullptr, map_size, PROT_READ, MAP_PRIVATE|MAP_ANONYMOUS, -1, 0);
+    if (base == MAP_FAILED) {
+        close(fd);
+        return ErrorSystemResources;
+    }
+    void *file_base = mmap(base, file_size, PROT_READ, MAP_PRIVATE|MAP_FIXED, fd, 0);
+    close(fd);
+    if (file_base == MAP_FAILED) {
+        munmap(base, map_size);
+        return ErrorFileSystem;
+    }
+
+    buf_deinit(out_contents);
+    out_contents->list.items = (char *)base;
+    out_contents->list.length = file_size + 1;
+    out_contents->list.capacity = file_size + 1;
+    return 0;
+#else
+    return os_fetch_file_path(full_path, out_contents);
+#endif
+}
+
 int os_get_cwd(Buf *out_cwd) {
 #if defined(ZIG_OS_WINDOWS)
     buf_resize(out_cwd, 4096);
@@ -720,6 +780,57 @@ int os_rename(Buf *src_path, Buf *dest_path) {
     return 0;
 }
 
+int os_self_exe_path(Buf *out_path) {
+#if defined(ZIG_OS_WINDOWS)
+    buf_resize(out_path, 256);
+    for (;;) {
+        DWORD copied_amt = GetModuleFileName(nullptr, buf_ptr(out_path), (DWORD)buf_len(out_path));
+        if (copied_amt == 0) {
+            return ErrorFileNotFound;
+        }
+        if (copied_amt < buf_len(out_path)) {
+            buf_resize(out_path, copied_amt);
+            return 0;
+        }
+        buf_resize(out_path, buf_len(out_path) * 2);
+    }
+#elif defined(ZIG_OS_DARWIN)
+    uint32_t u32_len = 0;
+    _NSGetExecutablePath(nullptr, &u32_len);
+    buf_resize(out_path, u32_len);
+    if (_NSGetExecutablePath(buf_ptr(out_path), &u32_len) != 0) {
+        return ErrorFileNotFound;
+    }
+    buf_resize(out_path, strlen(buf_ptr(out_path)));
+    return 0;
+#elif defined(ZIG_OS_LINUX)
+    buf_resize(out_path, 256);
+    for (;;) {
+        ssize_t amt = readlink("/proc/self/exe", buf_ptr(out_path), buf_len(out_path));
+        if (amt == -1) {
+            return ErrorFileNotFound;
+        }
+        if ((size_t)amt < buf_len(out_path)) {
+            buf_resize(out_path, amt);
+            return 0;
+        }
+        buf_resize(out_path, buf_len(out_path) * 2);
+    }
+#else
+    return ErrorFileNotFound;
+#endif
+}
+
+uint32_t os_get_pid(void) {
+#if defined(ZIG_OS_WINDOWS)
+    return (uint32_t)GetCurrentProcessId();
+#elif defined(ZIG_OS_POSIX)
+    return (uint32_t)getpid();
+#else
+#error "missing os_get_pid implementation"
+#endif
+}
+
 double os_get_time(void) {
 #if defined(ZIG_OS_WINDOWS)
     unsigned __int64 time;
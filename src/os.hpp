@@ -49,6 +49,10 @@ int os_copy_file(Buf *src_path, Buf *dest_path);
 
 int os_fetch_file(FILE *file, Buf *out_contents);
 int os_fetch_file_path(Buf *full_path, Buf *out_contents);
+// Like os_fetch_file_path, but the contents are a read-only mapping of the file
+// that stays alive until the process exits. The Buf must not be modified,
+// resized or deinitialized.
+int os_map_file_path(Buf *full_path, Buf *out_contents);
 
 int os_get_cwd(Buf *out_cwd);
 
@@ -62,6 +66,9 @@ int os_file_exists(Buf *full_path, bool *result);
 int os_rename(Buf *src_path, Buf *dest_path);
 double os_get_time(void);
 
+int os_self_exe_path(Buf *out_path);
+uint32_t os_get_pid(void);
+
 bool os_is_sep(uint8_t c);
 
 #if defined(__APPLE__)
@@ -0,0 +1,327 @@
+/*
+ * Copyright (c) 2017 Andrew Kelley
+ *
+ * This file is part of zig, which is MIT licensed.
+ * See http://opensource.org/licenses/MIT
+ */
+
+#include "parse_scheduler.hpp"
+#include "hash_map.hpp"
+#include "os.hpp"
+#include "parser.hpp"
+#include "profile.hpp"
+
+#include <condition_variable>
+#include <mutex>
+#include <thread>
+
+// Files are tokenized and parsed ahead of semantic analysis. Whenever a file's
+// tokens are available, every @import("...") with a string literal argument is
+// resolved the same way ir_analyze_instruction_import would resolve it and the
+// target is queued for a worker thread, which in turn scans the target's
+// tokens. When analysis reaches the @import the AST is usually ready.
+//
+// Workers parse into their own arena and number the nodes of each file from
+// zero. The main thread claims files in the order analysis asks for them and
+// only then offsets the node indices by g->next_node_index, so create_index
+// comes out exactly as if every file had been parsed on the main thread.
+//
+// A file that fails to read, tokenize or parse is not reported by the worker;
+// the import falls back to add_source_file, which reports the error as usual.
+// That way a syntax error in a file that is never analyzed is not an error.
+
+enum ParseJobState {
+    ParseJobStateQueued,
+    ParseJobStateRunning,
+    ParseJobStateDone,
+    // handed to the main thread, or the file was parsed there to begin with
+    ParseJobStateClaimed,
+};
+
+struct ParseJob {
+    ParseJobState state;
+    PackageTableEntry *package;
+    Buf *abs_full_path;
+    // null if the file could not be read, tokenized or parsed
+    ImportTableEntry *import_entry;
+    uint32_t node_count;
+    Arena ast_arena;
+    // for --enable-timing-info; thread 0 is the main thread
+    double start_time;
+    double end_time;
+    uint32_t thread_index;
+};
+
+struct ParseScheduler {
+    std::mutex mutex;
+    std::condition_variable work_available;
+    std::condition_variable job_done;
+    HashMap<Buf *, ParseJob *, buf_hash, buf_eql_buf> jobs;
+    ZigList<ParseJob *> queue;
+    size_t queue_index;
+    ZigList<std::thread *> workers;
+    size_t max_workers;
+    bool shutting_down;
+};
+
+static void run_job(ParseScheduler *ps, ParseJob *job, uint32_t thread_index);
+
+static void worker_main(ParseScheduler *ps, uint32_t thread_index) {
+    std::unique_lock<std::mutex> lock(ps->mutex);
+    for (;;) {
+        if (ps->shutting_down)
+            return;
+        if (ps->queue_index >= ps->queue.length) {
+            ps->work_available.wait(lock);
+            continue;
+        }
+        ParseJob *job = ps->queue.at(ps->queue_index);
+        ps->queue_index += 1;
+        // the main thread may have taken it already
+        if (job->state != ParseJobStateQueued)
+            continue;
+
+        job->state = ParseJobStateRunning;
+        lock.unlock();
+        run_job(ps, job, thread_index);
+        lock.lock();
+        job->state = ParseJobStateDone;
+        ps->job_done.notify_all();
+    }
+}
+
+// Must be called with the mutex held. Returns the new job, or null if the
+// file already has one.
+static ParseJob *add_job(ParseScheduler *ps, PackageTableEntry *package, Buf *abs_full_path) {
+    bool is_new;
+    auto entry = ps->jobs.get_or_insert(abs_full_path, &is_new);
+    if (!is_new)
+        return nullptr;
+
+    ParseJob *job = allocate<ParseJob>(1);
+    job->package = package;
+    job->abs_full_path = abs_full_path;
+    arena_init(&job->ast_arena, "AST");
+    entry->value = job;
+    return job;
+}
+
+static void queue_job(ParseScheduler *ps, PackageTableEntry *package, Buf *abs_full_path) {
+    std::lock_guard<std::mutex> lock(ps->mutex);
+    if (ps->shutting_down)
+        return;
+    ParseJob *job = add_job(ps, package, abs_full_path);
+    if (job == nullptr)
+        return;
+
+    ps->queue.append(job);
+    if (ps->workers.length < ps->max_workers &&
+        ps->queue.length - ps->queue_index > ps->workers.length)
+    {
+        uint32_t thread_index = (uint32_t)ps->workers.length + 1;
+        ps->workers.append(new std::thread(worker_main, ps, thread_index));
+    }
+    ps->work_available.notify_one();
+}
+
+// Mirrors the path resolution in ir_analyze_instruction_import.
+static Buf *resolve_import(PackageTableEntry *package, Buf *importer_path, Buf *import_target_str,
+        PackageTableEntry **out_package)
+{
+    Buf *import_target_path;
+    Buf *search_dir;
+    auto package_entry = package->package_table.maybe_get(import_target_str);
+    if (package_entry) {
+        PackageTableEntry *target_package = package_entry->value;
+        *out_package = target_package;
+        import_target_path = &target_package->root_src_path;
+        search_dir = &target_package->root_src_dir;
+    } else {
+        *out_package = package;
+        import_target_path = import_target_str;
+        search_dir = buf_alloc();
+        os_path_dirname(importer_path, search_dir);
+    }
+
+    Buf full_path = BUF_INIT;
+    os_path_join(search_dir, import_target_path, &full_path);
+    Buf *abs_full_path = buf_alloc();
+    if (os_path_real(&full_path, abs_full_path))
+        return nullptr;
+    return abs_full_path;
+}
+
+static void scan_imports(ParseScheduler *ps, PackageTableEntry *package, Buf *abs_full_path,
+        Buf *source_code, ZigList<Token> *tokens)
+{
+    Buf *import_symbol = buf_intern_str("import");
+    for (size_t i = 0; i + 4 < tokens->length; i += 1) {
+        if (tokens->at(i).id != TokenIdAtSign)
+            continue;
+        Token *name_token = &tokens->at(i + 1);
+        if (name_token->id != TokenIdSymbol || name_token->data.str_lit.symbol != import_symbol)
+            continue;
+        Token *str_token = &tokens->at(i + 3);
+        if (tokens->at(i + 2).id != TokenIdLParen ||
+            str_token->id != TokenIdStringLiteral || str_token->data.str_lit.is_c_str ||
+            tokens->at(i + 4).id != TokenIdRParen)
+        {
+            continue;
+        }
+
+        Buf *import_target_str = token_str_lit_value(source_code, str_token);
+        PackageTableEntry *target_package;
+        Buf *target_path = resolve_import(package, abs_full_path, import_target_str, &target_package);
+        if (target_path != nullptr)
+            queue_job(ps, target_package, target_path);
+    }
+}
+
+static void run_job(ParseScheduler *ps, ParseJob *job, uint32_t thread_index) {
+    job->thread_index = thread_index;
+    job->start_time = os_get_time();
+    job->end_time = job->start_time;
+
+    Buf *source_code = buf_alloc();
+    if (os_map_file_path(job->abs_full_path, source_code))
+        return;
+
+    Tokenization tokenization = {0};
+    tokenize(source_code, &tokenization);
+    if (tokenization.err)
+        return;
+
+    // queue this file's imports before parsing it so other workers can start on them
+    scan_imports(ps, job->package, job->abs_full_path, source_code, tokenization.tokens);
+
+    ImportTableEntry *import_entry = allocate<ImportTableEntry>(1);
+    import_entry->package = job->package;
+    import_entry->source_code = source_code;
+    import_entry->line_offsets = tokenization.line_offsets;
+    import_entry->path = job->abs_full_path;
+
+    uint32_t node_count = 0;
+    import_entry->root = ast_try_parse(source_code, tokenization.tokens, import_entry,
+            &node_count, &job->ast_arena);
+    if (import_entry->root == nullptr)
+        return;
+
+    job->node_count = node_count;
+    job->import_entry = import_entry;
+    job->end_time = os_get_time();
+}
+
+static void renumber_node(AstNode **node_ptr, void *context) {
+    uint32_t base = *reinterpret_cast<uint32_t *>(context);
+    (*node_ptr)->create_index += base;
+    ast_visit_node_children(*node_ptr, renumber_node, context);
+}
+
+static ParseScheduler *get_scheduler(CodeGen *g) {
+    if (g->parse_scheduler == nullptr) {
+        // threads are opt in with --parse-threads; the main thread parses too,
+        // and --verbose prints every file as it is parsed
+        size_t thread_count = g->parse_threads;
+        if (thread_count <= 1 || g->verbose)
+            return nullptr;
+
+        ParseScheduler *ps = new ParseScheduler();
+        ps->jobs.init(64);
+        ps->max_workers = thread_count - 1;
+        g->parse_scheduler = ps;
+    }
+    return g->parse_scheduler;
+}
+
+// Called for files parsed on the main thread. Queues their imports and makes
+// sure the file itself is never parsed again by a worker.
+void parse_scheduler_scan_imports(CodeGen *g, PackageTableEntry *package, Buf *abs_full_path,
+        Buf *source_code, ZigList<Token> *tokens)
+{
+    ParseScheduler *ps = get_scheduler(g);
+    if (ps == nullptr)
+        return;
+
+    {
+        std::lock_guard<std::mutex> lock(ps->mutex);
+        if (ps->shutting_down)
+            return;
+        ParseJob *job = add_job(ps, package, abs_full_path);
+        if (job != nullptr)
+            job->state = ParseJobStateClaimed;
+    }
+    scan_imports(ps, package, abs_full_path, source_code, tokens);
+}
+
+// Returns the parsed import, waiting for its worker if it is still running,
+// or null if the file has to go through add_source_file.
+ImportTableEntry *parse_scheduler_claim(CodeGen *g, PackageTableEntry *package, Buf *abs_full_path) {
+    ParseScheduler *ps = g->parse_scheduler;
+    if (ps == nullptr)
+        return nullptr;
+
+    ParseJob *job;
+    {
+        std::unique_lock<std::mutex> lock(ps->mutex);
+        auto entry = ps->jobs.maybe_get(abs_full_path);
+        if (entry == nullptr)
+            return nullptr;
+        job = entry->value;
+        if (job->state == ParseJobStateClaimed)
+            return nullptr;
+        if (job->state == ParseJobStateQueued) {
+            // don't wait for a worker to get to it
+            job->state = ParseJobStateRunning;
+            lock.unlock();
+            run_job(ps, job, 0);
+            lock.lock();
+        } else {
+            while (job->state == ParseJobStateRunning)
+                ps->job_done.wait(lock);
+        }
+        job->state = ParseJobStateClaimed;
+    }
+
+    ImportTableEntry *import_entry = job->import_entry;
+    if (import_entry == nullptr)
+        return nullptr;
+
+    profile_add_span(g, ProfileCategoryParse, abs_full_path, job->start_time, job->end_time, job->thread_index);
+
+    // the first importer to be analyzed decides the package, as it would without prefetching
+    import_entry->package = package;
+    uint32_t base = g->next_node_index;
+    renumber_node(&import_entry->root, &base);
+    g->next_node_index += job->node_count;
+    arena_take(&g->ast_arena, &job->ast_arena);
+    return import_entry;
+}
+
+void parse_scheduler_deinit(CodeGen *g) {
+    ParseScheduler *ps = g->parse_scheduler;
+    if (ps == nullptr)
+        return;
+
+    {
+        std::lock_guard<std::mutex> lock(ps->mutex);
+        ps->shutting_down = true;
+    }
+    ps->work_available.notify_all();
+    for (size_t i = 0; i < ps->workers.length; i += 1) {
+        ps->workers.at(i)->join();
+        delete ps->workers.at(i);
+    }
+    // unclaimed ASTs are dropped; nothing points into their arenas
+    auto it = ps->jobs.entry_iterator();
+    for (;;) {
+        auto *entry = it.next();
+        if (!entry)
+            break;
+        arena_deinit(&entry->value->ast_arena);
+    }
+    ps->jobs.deinit();
+    ps->queue.deinit();
+    ps->workers.deinit();
+    delete ps;
+    g->parse_scheduler = nullptr;
+}
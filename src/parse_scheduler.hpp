@@ -0,0 +1,19 @@
+/*
+ * Copyright (c) 2017 Andrew Kelley
+ *
+ * This file is part of zig, which is MIT licensed.
+ * See http://opensource.org/licenses/MIT
+ */
+
+#ifndef ZIG_PARSE_SCHEDULER_HPP
+#define ZIG_PARSE_SCHEDULER_HPP
+
+#include "all_types.hpp"
+#include "tokenizer.hpp"
+
+void parse_scheduler_scan_imports(CodeGen *g, PackageTableEntry *package, Buf *abs_full_path,
+        Buf *source_code, ZigList<Token> *tokens);
+ImportTableEntry *parse_scheduler_claim(CodeGen *g, PackageTableEntry *package, Buf *abs_full_path);
+void parse_scheduler_deinit(CodeGen *g);
+
+#endif
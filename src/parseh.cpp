@@ -97,7 +97,7 @@ static uint32_t get_next_anon_index(Context *c) {
 }
 
 static void add_global_alias(Context *c, Buf *name, Tld *tld) {
-    c->import->decls_scope->decl_table.put(name, tld);
+    c->import->decls_scope->decl_table.put(buf_intern(name), tld);
 }
 
 static void add_global_weak_alias(Context *c, Buf *name, Tld *tld) {
@@ -163,7 +163,7 @@ static Tld *create_global_str_lit_var(Context *c, Buf *name, Buf *value) {
 }
 
 static Tld *create_global_num_lit_unsigned_negative_type(Context *c, Buf *name, uint64_t x, bool negative, TypeTableEntry *type_entry) {
-    ConstExprValue *var_val = create_const_unsigned_negative(type_entry, x, negative);
+    ConstExprValue *var_val = create_const_unsigned_negative(c->codegen, type_entry, x, negative);
     TldVar *tld_var = create_global_var(c, name, var_val, true);
     return &tld_var->base;
 }
@@ -173,7 +173,7 @@ static Tld *create_global_num_lit_unsigned_negative(Context *c, Buf *name, uint6
 }
 
 static Tld *create_global_num_lit_float(Context *c, Buf *name, double value) {
-    ConstExprValue *var_val = create_const_float(c->codegen->builtin_types.entry_num_lit_float, value);
+    ConstExprValue *var_val = create_const_float(c->codegen, c->codegen->builtin_types.entry_num_lit_float, value);
     TldVar *tld_var = create_global_var(c, name, var_val, true);
     return &tld_var->base;
 }
@@ -186,14 +186,14 @@ static ConstExprValue *create_const_int_ap(Context *c, TypeTableEntry *type, con
             emit_warning(c, source_decl, "integer overflow\n");
             return nullptr;
         } else {
-            return create_const_signed(type, aps_int.getExtValue());
+            return create_const_signed(c->codegen, type, aps_int.getExtValue());
         }
     } else {
         if (aps_int > INT64_MAX) {
             emit_warning(c, source_decl, "integer overflow\n");
             return nullptr;
         } else {
-            return create_const_unsigned_negative(type, aps_int.getExtValue(), false);
+            return create_const_unsigned_negative(c->codegen, type, aps_int.getExtValue(), false);
         }
     }
 }
@@ -1055,7 +1055,7 @@ static void visit_var_decl(Context *c, const VarDecl *var_decl) {
     }
 
     if (is_extern) {
-        TldVar *tld_var = create_global_var(c, name, create_const_runtime(var_type), is_const);
+        TldVar *tld_var = create_global_var(c, name, create_const_runtime(c->codegen, var_type), is_const);
         tld_var->var->linkage = VarLinkageExternal;
         add_global(c, &tld_var->base);
         return;
@@ -13,6 +13,7 @@
 #include <stdio.h>
 #include <limits.h>
 #include <errno.h>
+#include <setjmp.h>
 
 struct ParseContext {
     Buf *buf;
@@ -21,6 +22,9 @@ struct ParseContext {
     ImportTableEntry *owner;
     ErrColor err_color;
     uint32_t *next_node_index;
+    Arena *arena;
+    // set by ast_try_parse; syntax errors jump here instead of exiting
+    jmp_buf *error_jmp;
     // These buffers are used freqently so we preallocate them once here.
     Buf *void_buf;
     Buf *empty_buf;
@@ -36,6 +40,9 @@ static void ast_asm_error(ParseContext *pc, AstNode *node, size_t offset, const
     //SrcPos pos = node->data.asm_expr.offset_map.at(offset);
     SrcPos pos = { node->line, node->column };
 
+    if (pc->error_jmp)
+        longjmp(*pc->error_jmp, 1);
+
     va_list ap;
     va_start(ap, format);
     Buf *msg = buf_vprintf(format, ap);
@@ -51,6 +58,9 @@ static void ast_asm_error(ParseContext *pc, AstNode *node, size_t offset, const
 __attribute__ ((format (printf, 3, 4)))
 __attribute__ ((noreturn))
 static void ast_error(ParseContext *pc, Token *token, const char *format, ...) {
+    if (pc->error_jmp)
+        longjmp(*pc->error_jmp, 1);
+
     va_list ap;
     va_start(ap, format);
     Buf *msg = buf_vprintf(format, ap);
@@ -67,7 +77,7 @@ static void ast_error(ParseContext *pc, Token *token, const char *format, ...) {
 }
 
 static AstNode *ast_create_node_no_line_info(ParseContext *pc, NodeType type) {
-    AstNode *node = allocate<AstNode>(1);
+    AstNode *node = arena_allocate<AstNode>(pc->arena, 1);
     node->type = type;
     node->owner = pc->owner;
     node->create_index = *pc->next_node_index;
@@ -181,9 +191,12 @@ static void parse_asm_template(ParseContext *pc, AstNode *node) {
     }
 }
 
-static Buf *token_buf(Token *token) {
-    assert(token->id == TokenIdStringLiteral || token->id == TokenIdSymbol);
-    return &token->data.str_lit.str;
+static Buf *token_buf(ParseContext *pc, Token *token) {
+    if (token->id == TokenIdSymbol) {
+        assert(token->data.str_lit.symbol);
+        return token->data.str_lit.symbol;
+    }
+    return token_str_lit_value(pc->buf, token);
 }
 
 static BigInt *token_bigint(Token *token) {
@@ -203,7 +216,7 @@ static uint8_t token_char_lit(Token *token) {
 
 static void ast_buf_from_token(ParseContext *pc, Token *token, Buf *buf) {
     if (token->id == TokenIdSymbol) {
-        buf_init_from_buf(buf, token_buf(token));
+        buf_init_from_buf(buf, token_buf(pc, token));
     } else {
         buf_init_from_mem(buf, buf_ptr(pc->buf) + token->start_pos, token->end_pos - token->start_pos);
     }
@@ -283,7 +296,7 @@ static AstNode *ast_parse_param_decl(ParseContext *pc, size_t *token_index) {
     if (token->id == TokenIdSymbol) {
         Token *next_token = &pc->tokens->at(*token_index + 1);
         if (next_token->id == TokenIdColon) {
-            node->data.param_decl.name = token_buf(token);
+            node->data.param_decl.name = token_buf(pc, token);
             *token_index += 2;
         }
     }
@@ -429,8 +442,8 @@ static void ast_parse_asm_input_item(ParseContext *pc, size_t *token_index, AstN
     ast_eat_token(pc, token_index, TokenIdRParen);
 
     AsmInput *asm_input = allocate<AsmInput>(1);
-    asm_input->asm_symbolic_name = token_buf(alias);
-    asm_input->constraint = token_buf(constraint);
+    asm_input->asm_symbolic_name = token_buf(pc, alias);
+    asm_input->constraint = token_buf(pc, constraint);
     asm_input->expr = expr_node;
     node->data.asm_expr.input_list.append(asm_input);
 }
@@ -452,7 +465,7 @@ static void ast_parse_asm_output_item(ParseContext *pc, size_t *token_index, Ast
     Token *token = &pc->tokens->at(*token_index);
     *token_index += 1;
     if (token->id == TokenIdSymbol) {
-        asm_output->variable_name = token_buf(token);
+        asm_output->variable_name = token_buf(pc, token);
     } else if (token->id == TokenIdArrow) {
         asm_output->return_type = ast_parse_type_expr(pc, token_index, true);
     } else {
@@ -461,8 +474,8 @@ static void ast_parse_asm_output_item(ParseContext *pc, size_t *token_index, Ast
 
     ast_eat_token(pc, token_index, TokenIdRParen);
 
-    asm_output->asm_symbolic_name = token_buf(alias);
-    asm_output->constraint = token_buf(constraint);
+    asm_output->asm_symbolic_name = token_buf(pc, alias);
+    asm_output->constraint = token_buf(pc, constraint);
     node->data.asm_expr.output_list.append(asm_output);
 }
 
@@ -482,7 +495,7 @@ static void ast_parse_asm_clobbers(ParseContext *pc, size_t *token_index, AstNod
         ast_expect_token(pc, string_tok, TokenIdStringLiteral);
         *token_index += 1;
 
-        Buf *clobber_buf = token_buf(string_tok);
+        Buf *clobber_buf = token_buf(pc, string_tok);
         node->data.asm_expr.clobber_list.append(clobber_buf);
 
         Token *comma = &pc->tokens->at(*token_index);
@@ -611,7 +624,7 @@ static AstNode *ast_parse_asm_expr(ParseContext *pc, size_t *token_index, bool m
 
     Token *template_tok = ast_eat_token(pc, token_index, TokenIdStringLiteral);
 
-    node->data.asm_expr.asm_template = token_buf(template_tok);
+    node->data.asm_expr.asm_template = token_buf(pc, template_tok);
     parse_asm_template(pc, node);
 
     ast_parse_asm_output(pc, token_index, node);
@@ -638,7 +651,7 @@ static AstNode *ast_parse_goto_expr(ParseContext *pc, size_t *token_index, bool
     AstNode *node = ast_create_node(pc, NodeTypeGoto, goto_token);
 
     Token *dest_symbol = ast_eat_token(pc, token_index, TokenIdSymbol);
-    node->data.goto_expr.name = token_buf(dest_symbol);
+    node->data.goto_expr.name = token_buf(pc, dest_symbol);
     return node;
 }
 
@@ -684,7 +697,7 @@ static AstNode *ast_parse_primary_expr(ParseContext *pc, size_t *token_index, bo
         return node;
     } else if (token->id == TokenIdStringLiteral) {
         AstNode *node = ast_create_node(pc, NodeTypeStringLiteral, token);
-        node->data.string_literal.buf = token_buf(token);
+        node->data.string_literal.buf = token_buf(pc, token);
         node->data.string_literal.c = token->data.str_lit.is_c_str;
         *token_index += 1;
         return node;
@@ -731,7 +744,7 @@ static AstNode *ast_parse_primary_expr(ParseContext *pc, size_t *token_index, bo
         *token_index += 1;
         Token *name_tok = ast_eat_token(pc, token_index, TokenIdSymbol);
         AstNode *name_node = ast_create_node(pc, NodeTypeSymbol, name_tok);
-        name_node->data.symbol_expr.symbol = token_buf(name_tok);
+        name_node->data.symbol_expr.symbol = token_buf(pc, name_tok);
 
         AstNode *node = ast_create_node(pc, NodeTypeFnCallExpr, token);
         node->data.fn_call_expr.fn_ref_expr = name_node;
@@ -743,7 +756,7 @@ static AstNode *ast_parse_primary_expr(ParseContext *pc, size_t *token_index, bo
     } else if (token->id == TokenIdSymbol) {
         *token_index += 1;
         AstNode *node = ast_create_node(pc, NodeTypeSymbol, token);
-        node->data.symbol_expr.symbol = token_buf(token);
+        node->data.symbol_expr.symbol = token_buf(pc, token);
         return node;
     }
 
@@ -823,7 +836,7 @@ static AstNode *ast_parse_curly_suffix_expr(ParseContext *pc, size_t *token_inde
 
                         AstNode *field_node = ast_create_node(pc, NodeTypeStructValueField, token);
 
-                        field_node->data.struct_val_field.name = token_buf(field_name_tok);
+                        field_node->data.struct_val_field.name = token_buf(pc, field_name_tok);
                         field_node->data.struct_val_field.expr = ast_parse_expression(pc, token_index, true);
 
                         node->data.container_init_expr.entries.append(field_node);
@@ -938,7 +951,7 @@ static AstNode *ast_parse_suffix_op_expr(ParseContext *pc, size_t *token_index,
 
             AstNode *node = ast_create_node(pc, NodeTypeFieldAccessExpr, first_token);
             node->data.field_access_expr.struct_expr = primary_expr;
-            node->data.field_access_expr.field_name = token_buf(name_token);
+            node->data.field_access_expr.field_name = token_buf(pc, name_token);
 
             primary_expr = node;
         } else {
@@ -1392,17 +1405,17 @@ static AstNode *ast_parse_if_try_test_expr(ParseContext *pc, size_t *token_index
         node->data.try_expr.target_node = condition;
         node->data.try_expr.var_is_ptr = var_is_ptr;
         if (var_name_tok != nullptr) {
-            node->data.try_expr.var_symbol = token_buf(var_name_tok);
+            node->data.try_expr.var_symbol = token_buf(pc, var_name_tok);
         }
         node->data.try_expr.then_node = body_node;
-        node->data.try_expr.err_symbol = token_buf(err_name_tok);
+        node->data.try_expr.err_symbol = token_buf(pc, err_name_tok);
         node->data.try_expr.else_node = else_node;
         return node;
     } else if (var_name_tok != nullptr) {
         AstNode *node = ast_create_node(pc, NodeTypeTestExpr, if_token);
         node->data.test_expr.target_node = condition;
         node->data.test_expr.var_is_ptr = var_is_ptr;
-        node->data.test_expr.var_symbol = token_buf(var_name_tok);
+        node->data.test_expr.var_symbol = token_buf(pc, var_name_tok);
         node->data.test_expr.then_node = body_node;
         node->data.test_expr.else_node = else_node;
         return node;
@@ -1548,7 +1561,7 @@ static AstNode *ast_parse_variable_declaration_expr(ParseContext *pc, size_t *to
     node->data.variable_declaration.visib_mod = visib_mod;
 
     Token *name_token = ast_eat_token(pc, token_index, TokenIdSymbol);
-    node->data.variable_declaration.symbol = token_buf(name_token);
+    node->data.variable_declaration.symbol = token_buf(pc, name_token);
 
     Token *eq_or_colon = &pc->tokens->at(*token_index);
     *token_index += 1;
@@ -1645,7 +1658,7 @@ static AstNode *ast_parse_while_expr(ParseContext *pc, size_t *token_index, bool
         }
 
         Token *var_name_tok = ast_eat_token(pc, token_index, TokenIdSymbol);
-        node->data.while_expr.var_symbol = token_buf(var_name_tok);
+        node->data.while_expr.var_symbol = token_buf(pc, var_name_tok);
         ast_eat_token(pc, token_index, TokenIdBinOr);
     }
 
@@ -1668,7 +1681,7 @@ static AstNode *ast_parse_while_expr(ParseContext *pc, size_t *token_index, bool
             *token_index += 1;
 
             Token *err_name_tok = ast_eat_token(pc, token_index, TokenIdSymbol);
-            node->data.while_expr.err_symbol = token_buf(err_name_tok);
+            node->data.while_expr.err_symbol = token_buf(pc, err_name_tok);
 
             ast_eat_token(pc, token_index, TokenIdBinOr);
         }
@@ -1682,7 +1695,7 @@ static AstNode *ast_parse_while_expr(ParseContext *pc, size_t *token_index, bool
 static AstNode *ast_parse_symbol(ParseContext *pc, size_t *token_index) {
     Token *token = ast_eat_token(pc, token_index, TokenIdSymbol);
     AstNode *node = ast_create_node(pc, NodeTypeSymbol, token);
-    node->data.symbol_expr.symbol = token_buf(token);
+    node->data.symbol_expr.symbol = token_buf(pc, token);
     return node;
 }
 
@@ -2069,7 +2082,7 @@ static AstNode *ast_parse_label(ParseContext *pc, size_t *token_index, bool mand
     *token_index += 2;
 
     AstNode *node = ast_create_node(pc, NodeTypeLabel, symbol_token);
-    node->data.label.name = token_buf(symbol_token);
+    node->data.label.name = token_buf(pc, symbol_token);
     return node;
 }
 
@@ -2204,7 +2217,7 @@ static AstNode *ast_parse_fn_proto(ParseContext *pc, size_t *token_index, bool m
     Token *fn_name = &pc->tokens->at(*token_index);
     if (fn_name->id == TokenIdSymbol) {
         *token_index += 1;
-        node->data.fn_proto.name = token_buf(fn_name);
+        node->data.fn_proto.name = token_buf(pc, fn_name);
     } else {
         node->data.fn_proto.name = pc->empty_buf;
     }
@@ -2283,7 +2296,7 @@ static AstNode *ast_parse_extern_decl(ParseContext *pc, size_t *token_index, boo
     Token *lib_name_tok = &pc->tokens->at(*token_index);
     Buf *lib_name = nullptr;
     if (lib_name_tok->id == TokenIdStringLiteral) {
-        lib_name = token_buf(lib_name_tok);
+        lib_name = token_buf(pc, lib_name_tok);
         *token_index += 1;
     }
 
@@ -2406,7 +2419,7 @@ static AstNode *ast_parse_container_decl(ParseContext *pc, size_t *token_index,
             *token_index += 1;
 
             field_node->data.struct_field.visib_mod = visib_mod;
-            field_node->data.struct_field.name = token_buf(token);
+            field_node->data.struct_field.name = token_buf(pc, token);
 
             Token *token = &pc->tokens->at(*token_index);
             if (token->id == TokenIdComma || token->id == TokenIdRBrace) {
@@ -2453,7 +2466,7 @@ static AstNode *ast_parse_error_value_decl(ParseContext *pc, size_t *token_index
     ast_eat_token(pc, token_index, TokenIdSemicolon);
 
     AstNode *node = ast_create_node(pc, NodeTypeErrorValueDecl, first_token);
-    node->data.error_value_decl.name = token_buf(name_tok);
+    node->data.error_value_decl.name = token_buf(pc, name_tok);
 
     return node;
 }
@@ -2472,7 +2485,7 @@ static AstNode *ast_parse_test_decl_node(ParseContext *pc, size_t *token_index)
     Token *name_tok = ast_eat_token(pc, token_index, TokenIdStringLiteral);
 
     AstNode *node = ast_create_node(pc, NodeTypeTestDecl, first_token);
-    node->data.test_decl.name = token_buf(name_tok);
+    node->data.test_decl.name = token_buf(pc, name_tok);
     node->data.test_decl.body = ast_parse_block(pc, token_index, true);
 
     return node;
@@ -2559,17 +2572,38 @@ static AstNode *ast_parse_root(ParseContext *pc, size_t *token_index) {
     return node;
 }
 
+static void init_parse_context(ParseContext *pc, Buf *buf, ZigList<Token> *tokens, ImportTableEntry *owner,
+        ErrColor err_color, uint32_t *next_node_index, Arena *arena)
+{
+    pc->void_buf = buf_create_from_str("void");
+    pc->empty_buf = buf_create_from_str("");
+    pc->err_color = err_color;
+    pc->owner = owner;
+    pc->buf = buf;
+    pc->tokens = tokens;
+    pc->next_node_index = next_node_index;
+    pc->arena = arena;
+}
+
 AstNode *ast_parse(Buf *buf, ZigList<Token> *tokens, ImportTableEntry *owner,
-        ErrColor err_color, uint32_t *next_node_index)
+        ErrColor err_color, uint32_t *next_node_index, Arena *arena)
+{
+    ParseContext pc = {0};
+    init_parse_context(&pc, buf, tokens, owner, err_color, next_node_index, arena);
+    size_t token_index = 0;
+    pc.root = ast_parse_root(&pc, &token_index);
+    return pc.root;
+}
+
+AstNode *ast_try_parse(Buf *buf, ZigList<Token> *tokens, ImportTableEntry *owner,
+        uint32_t *next_node_index, Arena *arena)
 {
     ParseContext pc = {0};
-    pc.void_buf = buf_create_from_str("void");
-    pc.empty_buf = buf_create_from_str("");
-    pc.err_color = err_color;
-    pc.owner = owner;
-    pc.buf = buf;
-    pc.tokens = tokens;
-    pc.next_node_index = next_node_index;
+    init_parse_context(&pc, buf, tokens, owner, ErrColorOff, next_node_index, arena);
+    jmp_buf error_jmp;
+    pc.error_jmp = &error_jmp;
+    if (setjmp(error_jmp))
+        return nullptr;
     size_t token_index = 0;
     pc.root = ast_parse_root(&pc, &token_index);
     return pc.root;
@@ -2705,13 +2739,16 @@ void ast_visit_node_children(AstNode *node, void (*visit)(AstNode **, void *cont
             break;
         case NodeTypeWhileExpr:
             visit_field(&node->data.while_expr.condition, visit, context);
+            visit_field(&node->data.while_expr.continue_expr, visit, context);
             visit_field(&node->data.while_expr.body, visit, context);
+            visit_field(&node->data.while_expr.else_node, visit, context);
             break;
         case NodeTypeForExpr:
             visit_field(&node->data.for_expr.elem_node, visit, context);
             visit_field(&node->data.for_expr.array_expr, visit, context);
             visit_field(&node->data.for_expr.index_node, visit, context);
             visit_field(&node->data.for_expr.body, visit, context);
+            visit_field(&node->data.for_expr.else_node, visit, context);
             break;
         case NodeTypeSwitchExpr:
             visit_field(&node->data.switch_expr.expr, visit, context);
@@ -2736,7 +2773,7 @@ void ast_visit_node_children(AstNode *node, void (*visit)(AstNode **, void *cont
             visit_field(&node->data.comptime_expr.expr, visit, context);
             break;
         case NodeTypeBreak:
-            // none
+            visit_field(&node->data.break_expr.expr, visit, context);
             break;
         case NodeTypeContinue:
             // none
@@ -18,7 +18,10 @@ void ast_token_error(Token *token, const char *format, ...);
 
 // This function is provided by generated code, generated by parsergen.cpp
 AstNode * ast_parse(Buf *buf, ZigList<Token> *tokens, ImportTableEntry *owner, ErrColor err_color,
-        uint32_t *next_node_index);
+        uint32_t *next_node_index, Arena *arena);
+// Like ast_parse, but returns null on a syntax error instead of reporting it and exiting.
+AstNode *ast_try_parse(Buf *buf, ZigList<Token> *tokens, ImportTableEntry *owner,
+        uint32_t *next_node_index, Arena *arena);
 
 void ast_print(AstNode *node, int indent);
 
@@ -0,0 +1,268 @@
+/*
+ * Copyright (c) 2017 Andrew Kelley
+ *
+ * This file is part of zig, which is MIT licensed.
+ * See http://opensource.org/licenses/MIT
+ */
+
+#include "profile.hpp"
+#include "analyze.hpp"
+#include "error.hpp"
+#include "hash_map.hpp"
+#include "os.hpp"
+
+#include <inttypes.h>
+#include <stdlib.h>
+
+// indexed by ProfileCategory
+static const char *profile_category_names[] = {
+    "Parse",
+    "IR Gen",
+    "Analysis",
+    "Comptime Call",
+    "LLVM IR Gen",
+    "LLVM Passes",
+};
+
+static const size_t report_rows_per_category = 10;
+
+size_t profile_begin(CodeGen *g, ProfileCategory category, Buf *name, AstNode *source_node) {
+    if (!g->timing_info)
+        return SIZE_MAX;
+
+    size_t span_index = g->profile_spans.length;
+    ProfileSpan *span = g->profile_spans.add_one();
+    span->category = category;
+    span->name = name;
+    span->source_node = source_node;
+    span->child_time = 0.0;
+    span->thread_index = 0;
+    g->profile_stack.append(span_index);
+    span->start = os_get_time();
+    return span_index;
+}
+
+void profile_end(CodeGen *g, size_t span_index) {
+    if (span_index == SIZE_MAX)
+        return;
+
+    double end = os_get_time();
+    assert(g->profile_stack.length != 0 && g->profile_stack.last() == span_index);
+    g->profile_stack.pop();
+    ProfileSpan *span = &g->profile_spans.at(span_index);
+    span->end = end;
+    if (g->profile_stack.length != 0) {
+        g->profile_spans.at(g->profile_stack.last()).child_time += end - span->start;
+    }
+}
+
+void profile_add_span(CodeGen *g, ProfileCategory category, Buf *name, double start, double end,
+        uint32_t thread_index)
+{
+    if (!g->timing_info)
+        return;
+
+    ProfileSpan *span = g->profile_spans.add_one();
+    span->category = category;
+    span->name = name;
+    span->source_node = nullptr;
+    span->start = start;
+    span->end = end;
+    span->child_time = 0.0;
+    span->thread_index = thread_index;
+    if (thread_index == 0 && g->profile_stack.length != 0) {
+        g->profile_spans.at(g->profile_stack.last()).child_time += end - start;
+    }
+}
+
+static Buf *span_label(ProfileSpan *span) {
+    if (span->source_node == nullptr)
+        return span->name;
+    AstNode *node = span->source_node;
+    return buf_sprintf("%s (%s:%" ZIG_PRI_usize ":%" ZIG_PRI_usize ")", buf_ptr(span->name),
+            buf_ptr(node->owner->path), node->line + 1, node->column + 1);
+}
+
+struct ProfileRow {
+    Buf *label;
+    size_t count;
+    double total;
+    double self;
+};
+
+static int compare_rows(const void *a, const void *b) {
+    const ProfileRow *row_a = reinterpret_cast<const ProfileRow *>(a);
+    const ProfileRow *row_b = reinterpret_cast<const ProfileRow *>(b);
+    if (row_a->self > row_b->self)
+        return -1;
+    if (row_a->self < row_b->self)
+        return 1;
+    return 0;
+}
+
+static void print_category(CodeGen *g, FILE *f, ProfileCategory category) {
+    ZigList<ProfileRow> rows = {0};
+    HashMap<Buf *, size_t, buf_hash, buf_eql_buf> row_table = {};
+    row_table.init(64);
+    double category_self = 0.0;
+    for (size_t i = 0; i < g->profile_spans.length; i += 1) {
+        ProfileSpan *span = &g->profile_spans.at(i);
+        if (span->category != category)
+            continue;
+
+        double duration = span->end - span->start;
+        category_self += duration - span->child_time;
+
+        Buf *label = span_label(span);
+        bool is_new;
+        auto entry = row_table.get_or_insert(label, &is_new);
+        if (is_new) {
+            entry->value = rows.length;
+            rows.append({label, 0, 0.0, 0.0});
+        }
+        ProfileRow *row = &rows.at(entry->value);
+        row->count += 1;
+        row->total += duration;
+        row->self += duration - span->child_time;
+    }
+    row_table.deinit();
+    if (rows.length == 0)
+        return;
+
+    qsort(rows.items, rows.length, sizeof(ProfileRow), compare_rows);
+    fprintf(f, "\n%s: %" ZIG_PRI_usize " names, %.4f seconds self time\n", profile_category_names[category],
+            rows.length, category_self);
+    fprintf(f, "%12s%12s%8s  %s\n", "Self", "Total", "Count", "Name");
+    for (size_t i = 0; i < rows.length && i < report_rows_per_category; i += 1) {
+        ProfileRow *row = &rows.at(i);
+        fprintf(f, "%12.4f%12.4f%8" ZIG_PRI_usize "  %s\n", row->self, row->total, row->count,
+                buf_ptr(row->label));
+    }
+    rows.deinit();
+}
+
+static int compare_dead_ir(const void *a, const void *b) {
+    const IrExecutable *exec_a = &(*reinterpret_cast<FnTableEntry * const *>(a))->ir_executable;
+    const IrExecutable *exec_b = &(*reinterpret_cast<FnTableEntry * const *>(b))->ir_executable;
+    if (exec_a->dead_instruction_count > exec_b->dead_instruction_count)
+        return -1;
+    if (exec_a->dead_instruction_count < exec_b->dead_instruction_count)
+        return 1;
+    return 0;
+}
+
+// The functions whose pass 1 IR had the most instructions removed as dead.
+static void print_dead_ir(CodeGen *g, FILE *f) {
+    ZigList<FnTableEntry *> fns = {0};
+    for (size_t i = 0; i < g->fn_defs.length; i += 1) {
+        FnTableEntry *fn_entry = g->fn_defs.at(i);
+        if (fn_entry->ir_executable.dead_instruction_count != 0)
+            fns.append(fn_entry);
+    }
+    if (fns.length == 0) {
+        fns.deinit();
+        return;
+    }
+
+    qsort(fns.items, fns.length, sizeof(FnTableEntry *), compare_dead_ir);
+    fprintf(f, "\nDead IR: %" ZIG_PRI_usize " functions\n", fns.length);
+    fprintf(f, "%12s%12s%8s  %s\n", "Generated", "Dead", "Blocks", "Name");
+    for (size_t i = 0; i < fns.length && i < report_rows_per_category; i += 1) {
+        FnTableEntry *fn_entry = fns.at(i);
+        IrExecutable *exec = &fn_entry->ir_executable;
+        fprintf(f, "%12" ZIG_PRI_usize "%12" ZIG_PRI_usize "%8" ZIG_PRI_usize "  %s\n",
+                exec->gen_instruction_count, exec->dead_instruction_count, exec->dead_block_count,
+                buf_ptr(&fn_entry->symbol_name));
+    }
+    fns.deinit();
+}
+
+void profile_print_report(CodeGen *g, FILE *f) {
+    for (size_t i = 0; i < ProfileCategoryCount; i += 1) {
+        print_category(g, f, (ProfileCategory)i);
+    }
+
+    fprintf(f, "\n%32s%14s\n", "Counter", "Value");
+    fprintf(f, "%32s%14" ZIG_PRI_usize "\n", "IR instructions", g->ir_instruction_count);
+    fprintf(f, "%32s%14" ZIG_PRI_usize "\n", "Types", get_type_table_entry_count());
+    fprintf(f, "%32s%14" ZIG_PRI_usize "\n", "Constant values", g->const_val_count);
+    fprintf(f, "%32s%14" ZIG_PRI_usize "\n", "Comptime calls", g->comptime_call_count);
+    fprintf(f, "%32s%14" ZIG_PRI_usize "\n", "Comptime calls memoized", g->comptime_call_memoized_count);
+    fprintf(f, "%32s%14" ZIG_PRI_usize "\n", "Comptime call IR reused", g->comptime_ir_reused_count);
+    fprintf(f, "%32s%14" ZIG_PRI_usize "\n", "Comptime calls interpreted", g->comptime_interpreted_count);
+    fprintf(f, "%32s%14" ZIG_PRI_usize "\n", "Function bodies not analyzed", g->fn_bodies_skipped_count);
+    fprintf(f, "%32s%14" ZIG_PRI_usize "\n", "Constant globals shared", g->const_globals_pooled_count);
+    fprintf(f, "%32s%14" ZIG_PRI_usize "\n", "Dead IR instructions removed", g->ir_dead_instruction_count);
+    fprintf(f, "%32s%14" ZIG_PRI_usize "\n", "Dead IR blocks removed", g->ir_dead_block_count);
+
+    print_dead_ir(g, f);
+}
+
+static void write_json_string(FILE *f, const char *str) {
+    fputc('"', f);
+    for (const char *c = str; *c; c += 1) {
+        switch (*c) {
+            case '"':
+                fputs("\\\"", f);
+                break;
+            case '\\':
+                fputs("\\\\", f);
+                break;
+            default:
+                if ((uint8_t)*c < 0x20) {
+                    fprintf(f, "\\u%04x", (unsigned)(uint8_t)*c);
+                } else {
+                    fputc(*c, f);
+                }
+                break;
+        }
+    }
+    fputc('"', f);
+}
+
+static void write_trace_event(FILE *f, bool *first, const char *name, const char *category,
+        double start, double end, uint32_t thread_index)
+{
+    fprintf(f, "%s\n{\"name\":", *first ? "" : ",");
+    *first = false;
+    write_json_string(f, name);
+    fprintf(f, ",\"cat\":");
+    write_json_string(f, category);
+    // timestamps are in microseconds
+    fprintf(f, ",\"ph\":\"X\",\"ts\":%.3f,\"dur\":%.3f,\"pid\":1,\"tid\":%" PRIu32 "}",
+            start * 1000000.0, (end - start) * 1000000.0, thread_index);
+}
+
+// Writes the phases and spans in the Chrome trace event format, which
+// chrome://tracing and Perfetto can load.
+int profile_write_trace(CodeGen *g, Buf *path) {
+    FILE *f = fopen(buf_ptr(path), "wb");
+    if (!f)
+        return ErrorFileSystem;
+
+    double start_time = g->timing_events.at(0).time;
+    bool first = true;
+    fprintf(f, "{\"traceEvents\":[");
+    for (size_t i = 0; i + 1 < g->timing_events.length; i += 1) {
+        TimeEvent *te = &g->timing_events.at(i);
+        TimeEvent *next_te = &g->timing_events.at(i + 1);
+        write_trace_event(f, &first, te->name, "Phase", te->time - start_time, next_te->time - start_time, 0);
+    }
+    for (size_t i = 0; i < g->profile_spans.length; i += 1) {
+        ProfileSpan *span = &g->profile_spans.at(i);
+        write_trace_event(f, &first, buf_ptr(span_label(span)), profile_category_names[span->category],
+                span->start - start_time, span->end - start_time, span->thread_index);
+    }
+
+    double end_time = g->timing_events.last().time - start_time;
+    fprintf(f, ",\n{\"name\":\"Counters\",\"ph\":\"C\",\"ts\":%.3f,\"pid\":1,\"args\":{", end_time * 1000000.0);
+    fprintf(f, "\"IR instructions\":%" ZIG_PRI_usize ",", g->ir_instruction_count);
+    fprintf(f, "\"Types\":%" ZIG_PRI_usize ",", get_type_table_entry_count());
+    fprintf(f, "\"Constant values\":%" ZIG_PRI_usize ",", g->const_val_count);
+    fprintf(f, "\"Comptime calls\":%" ZIG_PRI_usize "}}", g->comptime_call_count);
+    fprintf(f, "\n]}\n");
+
+    if (fclose(f))
+        return ErrorFileSystem;
+    return 0;
+}
@@ -0,0 +1,25 @@
+/*
+ * Copyright (c) 2017 Andrew Kelley
+ *
+ * This file is part of zig, which is MIT licensed.
+ * See http://opensource.org/licenses/MIT
+ */
+
+#ifndef ZIG_PROFILE_HPP
+#define ZIG_PROFILE_HPP
+
+#include "all_types.hpp"
+
+#include <stdio.h>
+
+// Returns SIZE_MAX, and records nothing, unless --enable-timing-info is on.
+size_t profile_begin(CodeGen *g, ProfileCategory category, Buf *name, AstNode *source_node);
+void profile_end(CodeGen *g, size_t span_index);
+// For work timed on another thread.
+void profile_add_span(CodeGen *g, ProfileCategory category, Buf *name, double start, double end,
+        uint32_t thread_index);
+
+void profile_print_report(CodeGen *g, FILE *f);
+int profile_write_trace(CodeGen *g, Buf *path);
+
+#endif
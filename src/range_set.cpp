@@ -1,79 +1,154 @@
 #include "range_set.hpp"
 
-AstNode *rangeset_add_range(RangeSet *rs, BigInt *first, BigInt *last, AstNode *source_node) {
-    for (size_t i = 0; i < rs->src_range_list.length; i += 1) {
-        RangeWithSrc *range_with_src = &rs->src_range_list.at(i);
-        Range *range = &range_with_src->range;
-        if ((bigint_cmp(first, &range->first) != CmpLT && bigint_cmp(first, &range->last) != CmpGT) ||
-            (bigint_cmp(last, &range->first) != CmpLT && bigint_cmp(last, &range->last) != CmpGT))
-        {
-            return range_with_src->source_node;
-        }
-    }
-    rs->src_range_list.append({{*first, *last}, source_node});
-
-    return nullptr;
+static int node_height(RangeSetNode *node) {
+    return (node == nullptr) ? 0 : node->height;
+}
 
+static void update_height(RangeSetNode *node) {
+    int left_height = node_height(node->left);
+    int right_height = node_height(node->right);
+    node->height = 1 + ((left_height > right_height) ? left_height : right_height);
 }
 
-static bool add_range(ZigList<Range> *list, Range *new_range, BigInt *one) {
-    for (size_t i = 0; i < list->length; i += 1) {
-        Range *range = &list->at(i);
+static RangeSetNode *rotate_right(RangeSetNode *node) {
+    RangeSetNode *new_root = node->left;
+    node->left = new_root->right;
+    new_root->right = node;
+    update_height(node);
+    update_height(new_root);
+    return new_root;
+}
 
-        BigInt first_minus_one;
-        bigint_sub(&first_minus_one, &range->first, one);
+static RangeSetNode *rotate_left(RangeSetNode *node) {
+    RangeSetNode *new_root = node->right;
+    node->right = new_root->left;
+    new_root->left = node;
+    update_height(node);
+    update_height(new_root);
+    return new_root;
+}
 
-        if (bigint_cmp(&new_range->last, &first_minus_one) == CmpEQ) {
-            range->first = new_range->first;
-            return true;
-        }
+static RangeSetNode *rebalance(RangeSetNode *node) {
+    update_height(node);
+    int balance = node_height(node->left) - node_height(node->right);
+    if (balance > 1) {
+        if (node_height(node->left->left) < node_height(node->left->right))
+            node->left = rotate_left(node->left);
+        return rotate_right(node);
+    }
+    if (balance < -1) {
+        if (node_height(node->right->right) < node_height(node->right->left))
+            node->right = rotate_right(node->right);
+        return rotate_left(node);
+    }
+    return node;
+}
 
-        BigInt last_plus_one;
-        bigint_add(&last_plus_one, &range->last, one);
+static RangeSetNode *insert_node(RangeSetNode *node, RangeSetNode *new_node) {
+    if (node == nullptr)
+        return new_node;
+    if (bigint_cmp(&new_node->range.first, &node->range.first) == CmpLT) {
+        node->left = insert_node(node->left, new_node);
+    } else {
+        node->right = insert_node(node->right, new_node);
+    }
+    return rebalance(node);
+}
 
-        if (bigint_cmp(&new_range->first, &last_plus_one) == CmpEQ) {
-            range->last = new_range->last;
-            return true;
+// Returns the range with the greatest first value that is <= value.
+static RangeSetNode *find_floor(RangeSetNode *node, BigInt *value) {
+    RangeSetNode *best = nullptr;
+    while (node != nullptr) {
+        if (bigint_cmp(&node->range.first, value) == CmpGT) {
+            node = node->left;
+        } else {
+            best = node;
+            node = node->right;
         }
     }
-    list->append({new_range->first, new_range->last});
-    return false;
+    return best;
 }
 
-bool rangeset_spans(RangeSet *rs, BigInt *first, BigInt *last) {
-    ZigList<Range> cur_list_value = {0};
-    ZigList<Range> other_list_value = {0};
-    ZigList<Range> *cur_list = &cur_list_value;
-    ZigList<Range> *other_list = &other_list_value;
-
-    for (size_t i = 0; i < rs->src_range_list.length; i += 1) {
-        RangeWithSrc *range_with_src = &rs->src_range_list.at(i);
-        Range *range = &range_with_src->range;
-        cur_list->append({range->first, range->last});
-    }
+AstNode *rangeset_add_range(RangeSet *rs, BigInt *first, BigInt *last, AstNode *source_node) {
+    assert(bigint_cmp(first, last) != CmpGT);
+
+    // Every stored range before this one ends before the floor starts, so the
+    // floor of last is the only range that can overlap [first, last].
+    RangeSetNode *floor = find_floor(rs->root, last);
+    if (floor != nullptr && bigint_cmp(&floor->range.last, first) != CmpLT)
+        return floor->source_node;
+
+    RangeSetNode *new_node = allocate<RangeSetNode>(1);
+    new_node->range.first = *first;
+    new_node->range.last = *last;
+    new_node->source_node = source_node;
+    new_node->height = 1;
+    rs->root = insert_node(rs->root, new_node);
+
+    return nullptr;
+}
 
+bool rangeset_spans(RangeSet *rs, BigInt *first, BigInt *last) {
+    // In order walk with an explicit stack. The tree is balanced, so the
+    // stack never holds more than its height.
+    //
+    // covered_last is the last value of the run that starts at first. A range
+    // continues the run when its first value minus one is at most
+    // covered_last. That is only computed for values greater than first, so
+    // it stays in the range of the type; last + 1 would not for a type that
+    // ends at @maxValue(u64).
+    ZigList<RangeSetNode *> stack = {0};
     BigInt one;
     bigint_init_unsigned(&one, 1);
+    BigInt covered_last;
+    bool have_run = false;
+    bool spans = false;
+
+    RangeSetNode *node = rs->root;
+    while (node != nullptr || stack.length != 0) {
+        while (node != nullptr) {
+            stack.append(node);
+            node = node->left;
+        }
+        node = stack.pop();
+        Range *range = &node->range;
+        node = node->right;
 
-    bool changes_made = true;
-    while (changes_made) {
-        changes_made = false;
-        for (size_t cur_i = 0; cur_i < cur_list->length; cur_i += 1) {
-            Range *range = &cur_list->at(cur_i);
-            changes_made = add_range(other_list, range, &one) || changes_made;
+        if (bigint_cmp(&range->last, first) == CmpLT)
+            continue;
+        if (!have_run) {
+            if (bigint_cmp(&range->first, first) == CmpGT)
+                break;
+            have_run = true;
+            covered_last = range->last;
+        } else {
+            if (bigint_cmp(&range->first, &covered_last) == CmpGT) {
+                BigInt first_minus_one;
+                bigint_sub(&first_minus_one, &range->first, &one);
+                if (bigint_cmp(&first_minus_one, &covered_last) == CmpGT)
+                    break;
+            }
+            if (bigint_cmp(&range->last, &covered_last) == CmpGT)
+                covered_last = range->last;
+        }
+        if (bigint_cmp(&covered_last, last) != CmpLT) {
+            spans = true;
+            break;
         }
-        ZigList<Range> *tmp = cur_list;
-        cur_list = other_list;
-        other_list = tmp;
-        other_list->resize(0);
     }
+    stack.deinit();
+    return spans;
+}
+
+static void destroy_node(RangeSetNode *node) {
+    if (node == nullptr)
+        return;
+    destroy_node(node->left);
+    destroy_node(node->right);
+    free(node);
+}
 
-    if (cur_list->length != 1)
-        return false;
-    Range *range = &cur_list->at(0);
-    if (bigint_cmp(&range->first, first) != CmpEQ)
-        return false;
-    if (bigint_cmp(&range->last, last) != CmpEQ)
-        return false;
-    return true;
+void rangeset_deinit(RangeSet *rs) {
+    destroy_node(rs->root);
+    rs->root = nullptr;
 }
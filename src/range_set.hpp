@@ -15,16 +15,23 @@ struct Range {
     BigInt last;
 };
 
-struct RangeWithSrc {
+// The ranges in a set never overlap, so an AVL tree ordered by range.first is
+// also ordered by range.last. Finding the only range that can overlap a new
+// one is a single O(log n) descent.
+struct RangeSetNode {
     Range range;
     AstNode *source_node;
+    RangeSetNode *left;
+    RangeSetNode *right;
+    int height;
 };
 
 struct RangeSet {
-    ZigList<RangeWithSrc> src_range_list;
+    RangeSetNode *root;
 };
 
 AstNode *rangeset_add_range(RangeSet *rs, BigInt *first, BigInt *last, AstNode *source_node);
 bool rangeset_spans(RangeSet *rs, BigInt *first, BigInt *last);
+void rangeset_deinit(RangeSet *rs);
 
 #endif
@@ -261,9 +261,9 @@ static void set_token_id(Tokenize *t, Token *token, TokenId id) {
         bigfloat_init_float(&token->data.float_lit.bigfloat, 0.0);
         token->data.float_lit.overflow = false;
     } else if (id == TokenIdStringLiteral || id == TokenIdSymbol) {
-        memset(&token->data.str_lit.str, 0, sizeof(Buf));
-        buf_resize(&token->data.str_lit.str, 0);
         token->data.str_lit.is_c_str = false;
+        token->data.str_lit.symbol = nullptr;
+        token->data.str_lit.str = nullptr;
     }
 }
 
@@ -349,6 +349,123 @@ static void end_float_token(Tokenize *t) {
     bigfloat_init_float(&t->cur_tok->data.float_lit.bigfloat, dbl_value);
 }
 
+static uint32_t get_digit_value(uint8_t c) {
+    if ('0' <= c && c <= '9') {
+        return c - '0';
+    }
+    if ('A' <= c && c <= 'Z') {
+        return c - 'A' + 10;
+    }
+    if ('a' <= c && c <= 'z') {
+        return c - 'a' + 10;
+    }
+    return UINT32_MAX;
+}
+
+static void append_utf8(Buf *buf, uint32_t code) {
+    if (code <= 0x7f) {
+        buf_append_char(buf, (uint8_t)code);
+    } else if (code <= 0x7ff) {
+        buf_append_char(buf, (uint8_t)(0xc0 | (code >> 6)));
+        buf_append_char(buf, (uint8_t)(0x80 | (code & 0x3f)));
+    } else if (code <= 0xffff) {
+        buf_append_char(buf, (uint8_t)(0xe0 | (code >> 12)));
+        buf_append_char(buf, (uint8_t)(0x80 | ((code >> 6) & 0x3f)));
+        buf_append_char(buf, (uint8_t)(0x80 | (code & 0x3f)));
+    } else {
+        buf_append_char(buf, (uint8_t)(0xf0 | (code >> 18)));
+        buf_append_char(buf, (uint8_t)(0x80 | ((code >> 12) & 0x3f)));
+        buf_append_char(buf, (uint8_t)(0x80 | ((code >> 6) & 0x3f)));
+        buf_append_char(buf, (uint8_t)(0x80 | (code & 0x3f)));
+    }
+}
+
+static uint32_t decode_char_code(const char **ptr, size_t digit_count) {
+    uint32_t code = 0;
+    for (size_t i = 0; i < digit_count; i += 1) {
+        code = code * 16 + get_digit_value((uint8_t)**ptr);
+        *ptr += 1;
+    }
+    return code;
+}
+
+// ptr is just past the opening quote. The tokenizer already rejected bad
+// escapes and unterminated strings, so neither is checked here.
+static void decode_quoted_str(Buf *out, const char *ptr) {
+    for (;;) {
+        const char *run_start = ptr;
+        while (*ptr != '"' && *ptr != '\\')
+            ptr += 1;
+        buf_append_mem(out, run_start, ptr - run_start);
+        if (*ptr == '"')
+            return;
+
+        ptr += 1;
+        char c = *ptr;
+        ptr += 1;
+        switch (c) {
+            case 'x':
+                buf_append_char(out, (uint8_t)decode_char_code(&ptr, 2));
+                break;
+            case 'u':
+                append_utf8(out, decode_char_code(&ptr, 4));
+                break;
+            case 'U':
+                append_utf8(out, decode_char_code(&ptr, 6));
+                break;
+            case 'n':
+                buf_append_char(out, '\n');
+                break;
+            case 'r':
+                buf_append_char(out, '\r');
+                break;
+            case 't':
+                buf_append_char(out, '\t');
+                break;
+            default:
+                // \\, \' and \"
+                buf_append_char(out, c);
+                break;
+        }
+    }
+}
+
+// Every line starts with \\ or c\\ and the lines are joined with '\n'. The
+// token runs up to the next token, so it ends with the whitespace after the
+// last line.
+static void decode_line_str(Buf *out, const char *ptr, const char *end) {
+    for (;;) {
+        if (*ptr == 'c')
+            ptr += 1;
+        assert(ptr[0] == '\\' && ptr[1] == '\\');
+        ptr += 2;
+        const char *line_start = ptr;
+        while (ptr < end && *ptr != '\n')
+            ptr += 1;
+        buf_append_mem(out, line_start, ptr - line_start);
+        while (ptr < end && (*ptr == ' ' || *ptr == '\n'))
+            ptr += 1;
+        if (ptr >= end)
+            return;
+        buf_append_char(out, '\n');
+    }
+}
+
+// Decodes a string literal or an @"..." symbol from its slice of the source.
+static void decode_str_lit(Buf *buf, Token *token, Buf *out) {
+    const char *ptr = buf_ptr(buf) + token->start_pos;
+    const char *end = buf_ptr(buf) + min(token->end_pos, buf_len(buf));
+    if (*ptr == '@')
+        ptr += 1;
+    if (token->data.str_lit.is_c_str)
+        ptr += 1;
+    if (*ptr == '"') {
+        decode_quoted_str(out, ptr + 1);
+    } else {
+        decode_line_str(out, ptr, end);
+    }
+}
+
 static void end_token(Tokenize *t) {
     assert(t->cur_tok);
     t->cur_tok->end_pos = t->pos + 1;
@@ -357,12 +474,27 @@ static void end_token(Tokenize *t) {
         end_float_token(t);
     } else if (t->cur_tok->id == TokenIdSymbol) {
         char *token_mem = buf_ptr(t->buf) + t->cur_tok->start_pos;
-        int token_len = (int)(t->cur_tok->end_pos - t->cur_tok->start_pos);
+        // a token ended by EOF reaches one past the end of the source
+        size_t token_end = min(t->cur_tok->end_pos, buf_len(t->buf));
+        int token_len = (int)(token_end - t->cur_tok->start_pos);
 
-        for (size_t i = 0; i < array_length(zig_keywords); i += 1) {
-            if (mem_eql_str(token_mem, token_len, zig_keywords[i].text)) {
-                t->cur_tok->id = zig_keywords[i].token_id;
-                break;
+        if (token_mem[0] == '@') {
+            // @"..." symbol; the quoted part may contain escapes
+            Buf name = BUF_INIT;
+            buf_resize(&name, 0);
+            decode_str_lit(t->buf, t->cur_tok, &name);
+            t->cur_tok->data.str_lit.symbol = buf_intern(&name);
+            buf_deinit(&name);
+        } else {
+            for (size_t i = 0; i < array_length(zig_keywords); i += 1) {
+                if (mem_eql_str(token_mem, token_len, zig_keywords[i].text)) {
+                    t->cur_tok->id = zig_keywords[i].token_id;
+                    break;
+                }
+            }
+
+            if (t->cur_tok->id == TokenIdSymbol) {
+                t->cur_tok->data.str_lit.symbol = buf_intern_mem(token_mem, token_len);
             }
         }
     }
@@ -378,25 +510,13 @@ static bool is_exponent_signifier(uint8_t c, int radix) {
     }
 }
 
-static uint32_t get_digit_value(uint8_t c) {
-    if ('0' <= c && c <= '9') {
-        return c - '0';
-    }
-    if ('A' <= c && c <= 'Z') {
-        return c - 'A' + 10;
-    }
-    if ('a' <= c && c <= 'z') {
-        return c - 'a' + 10;
-    }
-    return UINT32_MAX;
-}
 
 static void handle_string_escape(Tokenize *t, uint8_t c) {
     if (t->cur_tok->id == TokenIdCharLiteral) {
         t->cur_tok->data.char_lit.c = c;
         t->state = TokenizeStateCharLiteralEnd;
     } else if (t->cur_tok->id == TokenIdStringLiteral || t->cur_tok->id == TokenIdSymbol) {
-        buf_append_char(&t->cur_tok->data.str_lit.str, c);
+        // only validated here; token_str_lit_value decodes it again when needed
         t->state = TokenizeStateString;
     } else {
         zig_unreachable();
@@ -424,13 +544,11 @@ void tokenize(Buf *buf, Tokenization *out) {
                     case 'c':
                         t.state = TokenizeStateSymbolFirstC;
                         begin_token(&t, TokenIdSymbol);
-                        buf_append_char(&t.cur_tok->data.str_lit.str, c);
                         break;
                     case ALPHA_EXCEPT_C:
                     case '_':
                         t.state = TokenizeStateSymbol;
                         begin_token(&t, TokenIdSymbol);
-                        buf_append_char(&t.cur_tok->data.str_lit.str, c);
                         break;
                     case '0':
                         t.state = TokenizeStateZero;
@@ -905,7 +1023,6 @@ void tokenize(Buf *buf, Tokenization *out) {
                         t.state = TokenizeStateLineStringEnd;
                         break;
                     default:
-                        buf_append_char(&t.cur_tok->data.str_lit.str, c);
                         break;
                 }
                 break;
@@ -951,7 +1068,6 @@ void tokenize(Buf *buf, Tokenization *out) {
                 switch (c) {
                     case '\\':
                         t.state = TokenizeStateLineString;
-                        buf_append_char(&t.cur_tok->data.str_lit.str, '\n');
                         break;
                     default:
                         tokenize_error(&t, "invalid character: '%c'", c);
@@ -982,7 +1098,6 @@ void tokenize(Buf *buf, Tokenization *out) {
                         break;
                     case SYMBOL_CHAR:
                         t.state = TokenizeStateSymbol;
-                        buf_append_char(&t.cur_tok->data.str_lit.str, c);
                         break;
                     default:
                         t.pos -= 1;
@@ -1007,7 +1122,6 @@ void tokenize(Buf *buf, Tokenization *out) {
             case TokenizeStateSymbol:
                 switch (c) {
                     case SYMBOL_CHAR:
-                        buf_append_char(&t.cur_tok->data.str_lit.str, c);
                         break;
                     default:
                         t.pos -= 1;
@@ -1029,7 +1143,6 @@ void tokenize(Buf *buf, Tokenization *out) {
                         t.state = TokenizeStateStringEscape;
                         break;
                     default:
-                        buf_append_char(&t.cur_tok->data.str_lit.str, c);
                         break;
                 }
                 break;
@@ -1439,6 +1552,18 @@ void tokenize(Buf *buf, Tokenization *out) {
     }
 }
 
+// The value is kept on the token, so only the first call for a given
+// string literal does any work.
+Buf *token_str_lit_value(Buf *buf, Token *token) {
+    assert(token->id == TokenIdStringLiteral);
+    TokenStrLit *str_lit = &token->data.str_lit;
+    if (!str_lit->str) {
+        str_lit->str = buf_alloc();
+        decode_str_lit(buf, token, str_lit->str);
+    }
+    return str_lit->str;
+}
+
 const char * token_name(TokenId id) {
     switch (id) {
         case TokenIdAmpersand: return "&";
@@ -131,9 +131,15 @@ struct TokenIntLit {
     BigInt bigint;
 };
 
+// The characters of a string literal or symbol are not copied out of the
+// source; the token's [start_pos, end_pos) slice is the only record of them.
 struct TokenStrLit {
-    Buf str;
     bool is_c_str;
+    // TokenIdSymbol: the interned name, set when the token ends.
+    Buf *symbol;
+    // TokenIdStringLiteral: the value with escapes decoded, set by the first
+    // call to token_str_lit_value.
+    Buf *str;
 };
 
 struct TokenCharLit {
@@ -176,6 +182,8 @@ void tokenize(Buf *buf, Tokenization *out_tokenization);
 
 void print_tokens(Buf *buf, ZigList<Token> *tokens);
 
+Buf *token_str_lit_value(Buf *buf, Token *token);
+
 const char * token_name(TokenId id);
 
 bool valid_symbol_starter(uint8_t c);
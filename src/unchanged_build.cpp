@@ -0,0 +1,266 @@
+/*
+ * Copyright (c) 2017 Andrew Kelley
+ *
+ * This file is part of zig, which is MIT licensed.
+ * See http://opensource.org/licenses/MIT
+ */
+
+#include "unchanged_build.hpp"
+#include "analyze.hpp"
+#include "cache_hash.hpp"
+#include "codegen.hpp"
+#include "config.h"
+#include "os.hpp"
+#include "target.hpp"
+
+// With --skip-unchanged a build records every file whose contents went into
+// the root object (imports, the generated builtin.zig, @embedFile targets and
+// assembly files) together with a hash of the options that affect code
+// generation.
+// The next build with the same options re-hashes those files, and if none of
+// them changed it restores the objects, the generated header and the link
+// libraries that analysis discovered, skipping parsing, analysis and LLVM.
+// This is all or nothing: a change to any one of the files rebuilds everything.
+//
+// Manifest format, one tab separated record per line:
+//     options <hash>
+//     file    <hash> <path>
+//     lib     <name>
+//     object  <cached copy> <output path>
+//     header  <cached copy> <output path>
+
+static Buf *get_manifest_path(CodeGen *g) {
+    Buf *manifest_path = buf_alloc();
+    os_path_join(g->cache_dir, buf_sprintf("%s.unchanged", buf_ptr(g->root_out_name)), manifest_path);
+    return manifest_path;
+}
+
+static Buf *get_cached_copy_path(CodeGen *g, size_t index, const char *ext) {
+    Buf *cached_path = buf_alloc();
+    Buf *basename = buf_sprintf("%s-unchanged.%" ZIG_PRI_usize "%s", buf_ptr(g->root_out_name), index, ext);
+    os_path_join(g->cache_dir, basename, cached_path);
+    return cached_path;
+}
+
+static uint64_t hash_contents(Buf *contents) {
+    uint64_t hash = CACHE_HASH_INIT;
+    cache_hash_mem(&hash, buf_ptr(contents), buf_len(contents));
+    return hash;
+}
+
+static void hash_package(uint64_t *hash, PackageTableEntry *pkg, ZigList<PackageTableEntry *> *visited) {
+    for (size_t i = 0; i < visited->length; i += 1) {
+        if (visited->at(i) == pkg) {
+            cache_hash_mem(hash, &i, sizeof(size_t));
+            return;
+        }
+    }
+    visited->append(pkg);
+
+    cache_hash_str(hash, buf_ptr(&pkg->root_src_dir));
+    cache_hash_str(hash, buf_ptr(&pkg->root_src_path));
+    auto it = pkg->package_table.entry_iterator();
+    for (;;) {
+        auto *entry = it.next();
+        if (!entry)
+            break;
+        cache_hash_str(hash, buf_ptr(entry->key));
+        hash_package(hash, entry->value, visited);
+    }
+}
+
+static uint64_t hash_options(CodeGen *g) {
+    uint64_t hash = CACHE_HASH_INIT;
+    cache_hash_str(&hash, ZIG_VERSION_STRING);
+    cache_hash_str(&hash, buf_ptr(&g->triple_str));
+    cache_hash_str(&hash, buf_ptr(g->root_out_name));
+    cache_hash_mem(&hash, &g->out_type, sizeof(OutType));
+    cache_hash_mem(&hash, &g->build_mode, sizeof(BuildMode));
+    cache_hash_mem(&hash, &g->codegen_threads, sizeof(size_t));
+    cache_hash_mem(&hash, &g->lto, sizeof(ZigLLVMLtoMode));
+    cache_hash_bool(&hash, g->profile_generate);
+    cache_hash_str(&hash, g->profile_use_path ? buf_ptr(g->profile_use_path) : "");
+    cache_hash_bool(&hash, g->strip_debug_symbols);
+    cache_hash_bool(&hash, g->is_static);
+    cache_hash_bool(&hash, g->is_test_build);
+    cache_hash_bool(&hash, g->omit_zigrt);
+    cache_hash_bool(&hash, g->want_h_file);
+    cache_hash_bool(&hash, g->lazy_analysis);
+    cache_hash_str(&hash, g->test_filter ? buf_ptr(g->test_filter) : "");
+    cache_hash_str(&hash, g->test_name_prefix ? buf_ptr(g->test_name_prefix) : "");
+    cache_hash_str(&hash, g->mmacosx_version_min ? buf_ptr(g->mmacosx_version_min) : "");
+    cache_hash_str(&hash, g->mios_version_min ? buf_ptr(g->mios_version_min) : "");
+    cache_hash_bool(&hash, g->is_native_target);
+    if (g->is_native_target) {
+        cache_hash_str(&hash, ZigLLVMGetHostCPUName());
+        cache_hash_str(&hash, ZigLLVMGetNativeFeatures());
+    }
+
+    // which file an @import resolves to depends on the package table
+    ZigList<PackageTableEntry *> visited = {0};
+    hash_package(&hash, g->root_package, &visited);
+    visited.deinit();
+
+    return hash;
+}
+
+void unchanged_build_add_dependency(CodeGen *g, Buf *path, Buf *contents) {
+    if (!g->skip_unchanged)
+        return;
+    CacheDependency *dep = g->cache_dependencies.add_one();
+    dep->path = path;
+    dep->hash = hash_contents(contents);
+}
+
+// Splits the next line of the manifest into tab separated fields. Returns false at end of input.
+static bool next_record(Buf *contents, size_t *pos, ZigList<Buf *> *fields) {
+    fields->resize(0);
+    if (*pos >= buf_len(contents))
+        return false;
+
+    Buf *field = buf_alloc();
+    for (;;) {
+        if (*pos >= buf_len(contents) || buf_ptr(contents)[*pos] == '\n') {
+            *pos += 1;
+            fields->append(field);
+            return true;
+        }
+        uint8_t c = buf_ptr(contents)[*pos];
+        *pos += 1;
+        if (c == '\t') {
+            fields->append(field);
+            field = buf_alloc();
+        } else {
+            buf_append_char(field, c);
+        }
+    }
+}
+
+static bool parse_hash(Buf *str, uint64_t *out_hash) {
+    char *end;
+    *out_hash = strtoull(buf_ptr(str), &end, 16);
+    return buf_len(str) != 0 && *end == 0;
+}
+
+bool unchanged_build_load(CodeGen *g) {
+    assert(g->skip_unchanged);
+    codegen_add_time_event(g, "Check Unchanged Build");
+
+    Buf *contents = buf_alloc();
+    if (os_fetch_file_path(get_manifest_path(g), contents))
+        return false;
+
+    ZigList<Buf *> lib_names = {0};
+    ZigList<Buf *> copy_src = {0};
+    ZigList<Buf *> copy_dest = {0};
+    ZigList<bool> copy_is_object = {0};
+    bool options_match = false;
+
+    ZigList<Buf *> fields = {0};
+    size_t pos = 0;
+    Buf *file_contents = buf_alloc();
+    while (next_record(contents, &pos, &fields)) {
+        Buf *tag = fields.at(0);
+        if (buf_eql_str(tag, "options") && fields.length == 2) {
+            uint64_t hash;
+            if (!parse_hash(fields.at(1), &hash) || hash != hash_options(g))
+                return false;
+            options_match = true;
+        } else if (buf_eql_str(tag, "file") && fields.length == 3) {
+            uint64_t hash;
+            if (!parse_hash(fields.at(1), &hash))
+                return false;
+            if (os_fetch_file_path(fields.at(2), file_contents))
+                return false;
+            if (hash_contents(file_contents) != hash) {
+                if (g->verbose) {
+                    fprintf(stderr, "skip-unchanged: %s changed\n", buf_ptr(fields.at(2)));
+                }
+                return false;
+            }
+        } else if (buf_eql_str(tag, "lib") && fields.length == 2) {
+            lib_names.append(fields.at(1));
+        } else if ((buf_eql_str(tag, "object") || buf_eql_str(tag, "header")) && fields.length == 3) {
+            bool exists;
+            if (os_file_exists(fields.at(1), &exists) || !exists)
+                return false;
+            copy_src.append(fields.at(1));
+            copy_dest.append(fields.at(2));
+            copy_is_object.append(buf_eql_str(tag, "object"));
+        } else if (buf_len(tag) != 0 || fields.length != 1) {
+            // written by a different version of the compiler
+            return false;
+        }
+    }
+    if (!options_match)
+        return false;
+
+    // nothing changed; restore everything the skipped phases would have produced
+    for (size_t i = 0; i < copy_src.length; i += 1) {
+        int err;
+        if ((err = os_copy_file(copy_src.at(i), copy_dest.at(i)))) {
+            zig_panic("unable to copy %s to %s: %s", buf_ptr(copy_src.at(i)),
+                    buf_ptr(copy_dest.at(i)), err_str(err));
+        }
+        if (copy_is_object.at(i)) {
+            g->link_objects.append(copy_dest.at(i));
+        } else {
+            g->out_h_path = copy_dest.at(i);
+        }
+        if (g->verbose) {
+            fprintf(stderr, "using cached %s\n", buf_ptr(copy_src.at(i)));
+        }
+    }
+    for (size_t i = 0; i < lib_names.length; i += 1) {
+        add_link_lib(g, lib_names.at(i));
+    }
+    return true;
+}
+
+void unchanged_build_save(CodeGen *g, size_t first_object_index) {
+    assert(g->skip_unchanged);
+    Buf *manifest_path = get_manifest_path(g);
+
+    if (g->skip_unchanged_uncacheable) {
+        // don't leave a manifest behind that would be trusted by the next build
+        bool exists;
+        if (!os_file_exists(manifest_path, &exists) && exists) {
+            os_delete_file(manifest_path);
+        }
+        return;
+    }
+
+    Buf *contents = buf_alloc();
+    buf_appendf(contents, "options\t%016" ZIG_PRI_x64 "\n", hash_options(g));
+    for (size_t i = 0; i < g->cache_dependencies.length; i += 1) {
+        CacheDependency *dep = &g->cache_dependencies.at(i);
+        buf_appendf(contents, "file\t%016" ZIG_PRI_x64 "\t%s\n", dep->hash, buf_ptr(dep->path));
+    }
+    for (size_t i = 0; i < g->link_libs_list.length; i += 1) {
+        LinkLib *link_lib = g->link_libs_list.at(i);
+        if (!link_lib->provided_explicitly) {
+            buf_appendf(contents, "lib\t%s\n", buf_ptr(link_lib->name));
+        }
+    }
+
+    const char *o_ext = target_o_file_ext(&g->zig_target);
+    for (size_t i = first_object_index; i < g->link_objects.length; i += 1) {
+        Buf *object_path = g->link_objects.at(i);
+        Buf *cached_path = get_cached_copy_path(g, i - first_object_index, o_ext);
+        int err;
+        if ((err = os_copy_file(object_path, cached_path))) {
+            zig_panic("unable to copy %s to %s: %s", buf_ptr(object_path), buf_ptr(cached_path), err_str(err));
+        }
+        buf_appendf(contents, "object\t%s\t%s\n", buf_ptr(cached_path), buf_ptr(object_path));
+    }
+    if (g->want_h_file && g->out_h_path) {
+        Buf *cached_path = get_cached_copy_path(g, 0, ".h");
+        int err;
+        if ((err = os_copy_file(g->out_h_path, cached_path))) {
+            zig_panic("unable to copy %s to %s: %s", buf_ptr(g->out_h_path), buf_ptr(cached_path), err_str(err));
+        }
+        buf_appendf(contents, "header\t%s\t%s\n", buf_ptr(cached_path), buf_ptr(g->out_h_path));
+    }
+
+    os_write_file(manifest_path, contents);
+}
@@ -0,0 +1,17 @@
+/*
+ * Copyright (c) 2017 Andrew Kelley
+ *
+ * This file is part of zig, which is MIT licensed.
+ * See http://opensource.org/licenses/MIT
+ */
+
+#ifndef ZIG_UNCHANGED_BUILD_HPP
+#define ZIG_UNCHANGED_BUILD_HPP
+
+#include "all_types.hpp"
+
+void unchanged_build_add_dependency(CodeGen *g, Buf *path, Buf *contents);
+bool unchanged_build_load(CodeGen *g);
+void unchanged_build_save(CodeGen *g, size_t first_object_index);
+
+#endif
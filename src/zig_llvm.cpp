@@ -24,11 +24,15 @@
 
 #include <llvm/Analysis/TargetLibraryInfo.h>
 #include <llvm/Analysis/TargetTransformInfo.h>
+#include <llvm/Bitcode/BitcodeReader.h>
+#include <llvm/Bitcode/BitcodeWriter.h>
+#include <llvm/Bitcode/BitcodeWriterPass.h>
 #include <llvm/IR/DIBuilder.h>
 #include <llvm/IR/DiagnosticInfo.h>
 #include <llvm/IR/IRBuilder.h>
 #include <llvm/IR/InlineAsm.h>
 #include <llvm/IR/Instructions.h>
+#include <llvm/IR/LLVMContext.h>
 #include <llvm/IR/LegacyPassManager.h>
 #include <llvm/IR/Module.h>
 #include <llvm/IR/Verifier.h>
@@ -36,7 +40,9 @@
 #include <llvm/MC/SubtargetFeature.h>
 #include <llvm/PassRegistry.h>
 #include <llvm/Support/FileSystem.h>
+#include <llvm/Support/MemoryBuffer.h>
 #include <llvm/Support/TargetParser.h>
+#include <llvm/Support/TargetRegistry.h>
 #include <llvm/Support/raw_ostream.h>
 #include <llvm/Support/COFF.h>
 #include <llvm/Target/TargetMachine.h>
@@ -44,9 +50,15 @@
 #include <llvm/Transforms/IPO/PassManagerBuilder.h>
 #include <llvm/Transforms/IPO/AlwaysInliner.h>
 #include <llvm/Transforms/Scalar.h>
+#include <llvm/Transforms/Utils/Cloning.h>
+#include <llvm/Transforms/Utils/SplitModule.h>
 
 #include <lld/Driver/Driver.h>
 
+#include <string>
+#include <thread>
+#include <vector>
+
 using namespace llvm;
 
 void ZigLLVMInitializeLoopStrengthReducePass(LLVMPassRegistryRef R) {
@@ -84,30 +96,26 @@ static const bool assertions_on = true;
 static const bool assertions_on = false;
 #endif
 
-bool ZigLLVMTargetMachineEmitToFile(LLVMTargetMachineRef targ_machine_ref, LLVMModuleRef module_ref,
-        const char *filename, LLVMCodeGenFileType file_type, char **error_message, bool is_debug)
+static bool emit_module(TargetMachine *target_machine, Module *module, raw_pwrite_stream &dest,
+        TargetMachine::CodeGenFileType ft, std::string &error_message, bool is_debug, unsigned size_level,
+        ZigLLVMLtoMode lto,
+        const char *pgo_gen_path, const char *pgo_use_path,
+        ZigLLVMPassTimingCallback timing_callback, void *timing_context)
 {
-    std::error_code EC;
-    raw_fd_ostream dest(filename, EC, sys::fs::F_None);
-    if (EC) {
-        *error_message = strdup(EC.message().c_str());
-        return true;
-    }
-    TargetMachine* target_machine = reinterpret_cast<TargetMachine*>(targ_machine_ref);
     target_machine->setO0WantsFastISel(true);
 
-    Module* module = unwrap(module_ref);
-
     PassManagerBuilder *PMBuilder = new PassManagerBuilder();
     PMBuilder->OptLevel = target_machine->getOptLevel();
-    PMBuilder->SizeLevel = 0;
+    PMBuilder->SizeLevel = size_level;
 
+    // like clang, -Oz gives up vectorization, which grows code to save time
+    bool want_vectorize = !is_debug && size_level < 2;
     PMBuilder->DisableTailCalls = is_debug;
     PMBuilder->DisableUnitAtATime = is_debug;
-    PMBuilder->DisableUnrollLoops = is_debug;
-    PMBuilder->BBVectorize = !is_debug;
-    PMBuilder->SLPVectorize = !is_debug;
-    PMBuilder->LoopVectorize = !is_debug;
+    PMBuilder->DisableUnrollLoops = is_debug || size_level > 0;
+    PMBuilder->BBVectorize = want_vectorize;
+    PMBuilder->SLPVectorize = want_vectorize;
+    PMBuilder->LoopVectorize = want_vectorize;
     PMBuilder->RerollLoops = !is_debug;
     PMBuilder->LoadCombine = !is_debug;
     PMBuilder->NewGVN = !is_debug;
@@ -115,9 +123,15 @@ bool ZigLLVMTargetMachineEmitToFile(LLVMTargetMachineRef targ_machine_ref, LLVMM
     PMBuilder->VerifyInput = assertions_on;
     PMBuilder->VerifyOutput = assertions_on;
     PMBuilder->MergeFunctions = !is_debug;
-    PMBuilder->PrepareForLTO = false;
-    PMBuilder->PrepareForThinLTO = false;
+    PMBuilder->PrepareForLTO = (lto == ZigLLVMLtoModeFull);
+    PMBuilder->PrepareForThinLTO = (lto == ZigLLVMLtoModeThin);
     PMBuilder->PerformThinLTO = false;
+    if (pgo_gen_path != nullptr) {
+        PMBuilder->PGOInstrGen = pgo_gen_path;
+    }
+    if (pgo_use_path != nullptr) {
+        PMBuilder->PGOInstrUse = pgo_use_path;
+    }
 
     TargetLibraryInfoImpl tlii(Triple(module->getTargetTriple()));
     PMBuilder->LibraryInfo = &tlii;
@@ -148,6 +162,59 @@ bool ZigLLVMTargetMachineEmitToFile(LLVMTargetMachineRef targ_machine_ref, LLVMM
     MPM.add(createTargetTransformInfoWrapperPass(target_machine->getTargetIRAnalysis()));
     PMBuilder->populateModulePassManager(MPM);
 
+    // with LTO the linker generates the code, so the object file is bitcode;
+    // ThinLTO bitcode also carries the summary the linker uses to import functions
+    switch (lto) {
+        case ZigLLVMLtoModeNone:
+            if (target_machine->addPassesToEmitFile(MPM, dest, ft)) {
+                error_message = "TargetMachine can't emit a file of this type";
+                return true;
+            }
+            break;
+        case ZigLLVMLtoModeThin:
+            MPM.add(createWriteThinLTOBitcodePass(dest));
+            break;
+        case ZigLLVMLtoModeFull:
+            MPM.add(createBitcodeWriterPass(dest));
+            break;
+    }
+
+    // run per function optimization passes
+    FPM.doInitialization();
+    for (Function &F : *module) {
+      if (F.isDeclaration())
+        continue;
+      if (timing_callback)
+        timing_callback(timing_context, F.getName().data(), true);
+      FPM.run(F);
+      if (timing_callback)
+        timing_callback(timing_context, F.getName().data(), false);
+    }
+    FPM.doFinalization();
+
+    if (timing_callback)
+      timing_callback(timing_context, nullptr, true);
+    MPM.run(*module);
+    if (timing_callback)
+      timing_callback(timing_context, nullptr, false);
+
+    dest.flush();
+    return false;
+}
+
+bool ZigLLVMTargetMachineEmitToFile(LLVMTargetMachineRef targ_machine_ref, LLVMModuleRef module_ref,
+        const char *filename, LLVMCodeGenFileType file_type, char **error_message, bool is_debug,
+        unsigned size_level, ZigLLVMLtoMode lto, const char *pgo_gen_path, const char *pgo_use_path,
+        ZigLLVMPassTimingCallback timing_callback, void *timing_context)
+{
+    std::error_code EC;
+    raw_fd_ostream dest(filename, EC, sys::fs::F_None);
+    if (EC) {
+        *error_message = strdup(EC.message().c_str());
+        return true;
+    }
+    TargetMachine* target_machine = reinterpret_cast<TargetMachine*>(targ_machine_ref);
+
     TargetMachine::CodeGenFileType ft;
     switch (file_type) {
         case LLVMAssemblyFile:
@@ -157,21 +224,83 @@ bool ZigLLVMTargetMachineEmitToFile(LLVMTargetMachineRef targ_machine_ref, LLVMM
             ft = TargetMachine::CGFT_ObjectFile;
             break;
     }
-    if (target_machine->addPassesToEmitFile(MPM, dest, ft)) {
-        *error_message = strdup("TargetMachine can't emit a file of this type");
+
+    std::string err;
+    if (emit_module(target_machine, unwrap(module_ref), dest, ft, err, is_debug, size_level, lto,
+                pgo_gen_path, pgo_use_path, timing_callback, timing_context))
+    {
+        *error_message = strdup(err.c_str());
         return true;
     }
+    return false;
+}
 
-    // run per function optimization passes
-    FPM.doInitialization();
-    for (Function &F : *module)
-      if (!F.isDeclaration())
-        FPM.run(F);
-    FPM.doFinalization();
+bool ZigLLVMTargetMachineEmitToFiles(LLVMTargetMachineRef targ_machine_ref, LLVMModuleRef module_ref,
+        const char **filenames, unsigned partition_count, char **error_message, bool is_debug,
+        unsigned size_level, const char *pgo_gen_path, const char *pgo_use_path)
+{
+    TargetMachine* target_machine = reinterpret_cast<TargetMachine*>(targ_machine_ref);
+    Module* module = unwrap(module_ref);
 
-    MPM.run(*module);
+    // Inline functions must be resolved while every caller can still see the callee.
+    // Running the always inliner up front also deletes the inlined bodies from the
+    // module, which is what the caller checks to report "unable to inline function".
+    legacy::PassManager inline_pm;
+    inline_pm.add(createAlwaysInlinerLegacyPass(false));
+    inline_pm.run(*module);
+
+    // An LLVMContext must not be used from more than one thread, so each partition is
+    // serialized to bitcode here and parsed back into a private context by its worker.
+    std::vector<SmallString<0>> partition_bitcode;
+    SplitModule(CloneModule(module), partition_count, [&](std::unique_ptr<Module> part) {
+        partition_bitcode.emplace_back();
+        raw_svector_ostream bc_stream(partition_bitcode.back());
+        WriteBitcodeToFile(part.get(), bc_stream);
+    });
+    assert(partition_bitcode.size() == partition_count);
+
+    std::vector<std::unique_ptr<TargetMachine>> target_machines;
+    for (unsigned i = 0; i < partition_count; i += 1) {
+        target_machines.emplace_back(target_machine->getTarget().createTargetMachine(
+                target_machine->getTargetTriple().str(), target_machine->getTargetCPU(),
+                target_machine->getTargetFeatureString(), target_machine->Options,
+                target_machine->getRelocationModel(), target_machine->getCodeModel(),
+                target_machine->getOptLevel()));
+    }
 
-    dest.flush();
+    std::vector<std::string> errors(partition_count);
+    std::vector<std::thread> threads;
+    for (unsigned i = 0; i < partition_count; i += 1) {
+        threads.emplace_back([&, i]() {
+            LLVMContext context;
+            MemoryBufferRef bc_ref(StringRef(partition_bitcode[i].data(), partition_bitcode[i].size()),
+                    filenames[i]);
+            Expected<std::unique_ptr<Module>> part = parseBitcodeFile(bc_ref, context);
+            if (!part) {
+                errors[i] = toString(part.takeError());
+                return;
+            }
+
+            std::error_code EC;
+            raw_fd_ostream dest(filenames[i], EC, sys::fs::F_None);
+            if (EC) {
+                errors[i] = EC.message();
+                return;
+            }
+            emit_module(target_machines[i].get(), part->get(), dest, TargetMachine::CGFT_ObjectFile,
+                    errors[i], is_debug, size_level, ZigLLVMLtoModeNone, pgo_gen_path, pgo_use_path, nullptr, nullptr);
+        });
+    }
+    for (std::thread &thread : threads) {
+        thread.join();
+    }
+
+    for (unsigned i = 0; i < partition_count; i += 1) {
+        if (!errors[i].empty()) {
+            *error_message = strdup(errors[i].c_str());
+            return true;
+        }
+    }
     return false;
 }
 
@@ -222,6 +351,18 @@ ZigLLVMDIType *ZigLLVMCreateDebugArrayType(ZigLLVMDIBuilder *dibuilder, uint64_t
     return reinterpret_cast<ZigLLVMDIType*>(di_type);
 }
 
+ZigLLVMDIType *ZigLLVMCreateDebugVectorType(ZigLLVMDIBuilder *dibuilder, uint64_t size_in_bits,
+        uint64_t align_in_bits, ZigLLVMDIType *elem_type, int elem_count)
+{
+    SmallVector<Metadata *, 1> subrange;
+    subrange.push_back(reinterpret_cast<DIBuilder*>(dibuilder)->getOrCreateSubrange(0, elem_count));
+    DIType *di_type = reinterpret_cast<DIBuilder*>(dibuilder)->createVectorType(
+            size_in_bits, align_in_bits,
+            reinterpret_cast<DIType*>(elem_type),
+            reinterpret_cast<DIBuilder*>(dibuilder)->getOrCreateArray(subrange));
+    return reinterpret_cast<ZigLLVMDIType*>(di_type);
+}
+
 ZigLLVMDIEnumerator *ZigLLVMCreateDebugEnumerator(ZigLLVMDIBuilder *dibuilder, const char *name, int64_t val) {
     DIEnumerator *di_enumerator = reinterpret_cast<DIBuilder*>(dibuilder)->createEnumerator(name, val);
     return reinterpret_cast<ZigLLVMDIEnumerator*>(di_enumerator);
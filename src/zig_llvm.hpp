@@ -34,8 +34,30 @@ void ZigLLVMInitializeLowerIntrinsicsPass(LLVMPassRegistryRef R);
 char *ZigLLVMGetHostCPUName(void);
 char *ZigLLVMGetNativeFeatures(void);
 
+// Called before and after the function passes run on each function, and
+// around the module passes and code generation with fn_name null.
+typedef void (*ZigLLVMPassTimingCallback)(void *context, const char *fn_name, bool is_begin);
+
+enum ZigLLVMLtoMode {
+    ZigLLVMLtoModeNone,
+    ZigLLVMLtoModeThin,
+    ZigLLVMLtoModeFull,
+};
+
+// With an LTO mode other than none, file_type is ignored and the optimized
+// module is written as bitcode for the linker to generate code from.
+// size_level is 0 to optimize for speed, 1 for -Os and 2 for -Oz.
+// pgo_gen_path, when not null, instruments the module to write its counters
+// to that file. pgo_use_path, when not null, names an indexed profile
+// (llvm-profdata merge output) to take branch weights and entry counts from.
 bool ZigLLVMTargetMachineEmitToFile(LLVMTargetMachineRef targ_machine_ref, LLVMModuleRef module_ref,
-        const char *filename, LLVMCodeGenFileType file_type, char **error_message, bool is_debug);
+        const char *filename, LLVMCodeGenFileType file_type, char **error_message, bool is_debug,
+        unsigned size_level, ZigLLVMLtoMode lto, const char *pgo_gen_path, const char *pgo_use_path,
+        ZigLLVMPassTimingCallback timing_callback, void *timing_context);
+// Splits the module into partition_count object files and optimizes and emits them in parallel.
+bool ZigLLVMTargetMachineEmitToFiles(LLVMTargetMachineRef targ_machine_ref, LLVMModuleRef module_ref,
+        const char **filenames, unsigned partition_count, char **error_message, bool is_debug,
+        unsigned size_level, const char *pgo_gen_path, const char *pgo_use_path);
 
 LLVMValueRef ZigLLVMBuildCall(LLVMBuilderRef B, LLVMValueRef Fn, LLVMValueRef *Args,
         unsigned NumArgs, unsigned CC, bool always_inline, const char *Name);
@@ -59,6 +81,10 @@ ZigLLVMDIType *ZigLLVMCreateDebugArrayType(ZigLLVMDIBuilder *dibuilder,
         uint64_t size_in_bits, uint64_t align_in_bits, ZigLLVMDIType *elem_type,
         int elem_count);
 
+ZigLLVMDIType *ZigLLVMCreateDebugVectorType(ZigLLVMDIBuilder *dibuilder,
+        uint64_t size_in_bits, uint64_t align_in_bits, ZigLLVMDIType *elem_type,
+        int elem_count);
+
 ZigLLVMDIEnumerator *ZigLLVMCreateDebugEnumerator(ZigLLVMDIBuilder *dibuilder, const char *name, int64_t val);
 
 ZigLLVMDIType *ZigLLVMCreateDebugEnumerationType(ZigLLVMDIBuilder *dibuilder, ZigLLVMDIScope *scope,
@@ -413,15 +413,18 @@ pub const Builder = struct {
 
         const release_safe = self.option(bool, "release-safe", "optimizations on and safety on") ?? false;
         const release_fast = self.option(bool, "release-fast", "optimizations on and safety off") ?? false;
+        const release_small = self.option(bool, "release-small", "size optimizations on and safety off") ?? false;
 
-        const mode = if (release_safe and !release_fast) {
+        const mode = if (release_safe and !release_fast and !release_small) {
             builtin.Mode.ReleaseSafe
-        } else if (release_fast and !release_safe) {
+        } else if (release_fast and !release_safe and !release_small) {
             builtin.Mode.ReleaseFast
-        } else if (!release_fast and !release_safe) {
+        } else if (release_small and !release_safe and !release_fast) {
+            builtin.Mode.ReleaseSmall
+        } else if (!release_fast and !release_safe and !release_small) {
             builtin.Mode.Debug
         } else {
-            %%io.stderr.printf("Both -Drelease-safe and -Drelease-fast specified");
+            %%io.stderr.printf("More than one of -Drelease-safe, -Drelease-fast and -Drelease-small specified");
             self.markInvalidUserInput();
             builtin.Mode.Debug
         };
@@ -682,6 +685,11 @@ const Target = enum {
     }
 };
 
+pub const LtoMode = enum {
+    Thin,
+    Full,
+};
+
 pub const LibExeObjStep = struct {
     step: Step,
     builder: &Builder,
@@ -704,6 +712,9 @@ pub const LibExeObjStep = struct {
     object_files: ArrayList([]const u8),
     assembly_files: ArrayList([]const u8),
     packages: ArrayList(Pkg),
+    lazy_analysis: bool,
+    lto: ?LtoMode,
+    profile_generate: bool,
 
     const Pkg = struct {
         name: []const u8,
@@ -767,6 +778,9 @@ pub const LibExeObjStep = struct {
             .object_files = ArrayList([]const u8).init(builder.allocator),
             .assembly_files = ArrayList([]const u8).init(builder.allocator),
             .packages = ArrayList(Pkg).init(builder.allocator),
+            .lazy_analysis = false,
+            .lto = null,
+            .profile_generate = false,
         };
         self.computeOutFileNames();
         return self;
@@ -822,6 +836,18 @@ pub const LibExeObjStep = struct {
         self.build_mode = mode;
     }
 
+    pub fn setLazyAnalysis(self: &LibExeObjStep, value: bool) {
+        self.lazy_analysis = value;
+    }
+
+    pub fn setLto(self: &LibExeObjStep, mode: ?LtoMode) {
+        self.lto = mode;
+    }
+
+    pub fn setProfileGenerate(self: &LibExeObjStep, value: bool) {
+        self.profile_generate = value;
+    }
+
     pub fn setOutputPath(self: &LibExeObjStep, value: []const u8) {
         self.output_path = value;
     }
@@ -913,6 +939,22 @@ pub const LibExeObjStep = struct {
             builtin.Mode.Debug => {},
             builtin.Mode.ReleaseSafe => %%zig_args.append("--release-safe"),
             builtin.Mode.ReleaseFast => %%zig_args.append("--release-fast"),
+            builtin.Mode.ReleaseSmall => %%zig_args.append("--release-small"),
+        }
+
+        if (self.lazy_analysis) {
+            %%zig_args.append("--lazy-analysis");
+        }
+
+        if (self.lto) |lto| {
+            switch (lto) {
+                LtoMode.Thin => %%zig_args.append("--lto=thin"),
+                LtoMode.Full => %%zig_args.append("--lto=full"),
+            }
+        }
+
+        if (self.profile_generate) {
+            %%zig_args.append("--profile-generate");
         }
 
         %%zig_args.append("--cache-dir");
@@ -1010,6 +1052,7 @@ pub const TestStep = struct {
     link_libs: BufSet,
     name_prefix: []const u8,
     filter: ?[]const u8,
+    lazy_analysis: bool,
 
     pub fn init(builder: &Builder, root_src: []const u8) -> TestStep {
         const step_name = builder.fmt("test {}", root_src);
@@ -1021,6 +1064,7 @@ pub const TestStep = struct {
             .verbose = false,
             .name_prefix = "",
             .filter = null,
+            .lazy_analysis = false,
             .link_libs = BufSet.init(builder.allocator),
         }
     }
@@ -1045,6 +1089,10 @@ pub const TestStep = struct {
         self.filter = text;
     }
 
+    pub fn setLazyAnalysis(self: &TestStep, value: bool) {
+        self.lazy_analysis = value;
+    }
+
     fn make(step: &Step) -> %void {
         const self = @fieldParentPtr(TestStep, "step", step);
         const builder = self.builder;
@@ -1063,6 +1111,7 @@ pub const TestStep = struct {
             builtin.Mode.Debug => {},
             builtin.Mode.ReleaseSafe => %%zig_args.append("--release-safe"),
             builtin.Mode.ReleaseFast => %%zig_args.append("--release-fast"),
+            builtin.Mode.ReleaseSmall => %%zig_args.append("--release-small"),
         }
 
         if (self.filter) |filter| {
@@ -1070,6 +1119,10 @@ pub const TestStep = struct {
             %%zig_args.append(filter);
         }
 
+        if (self.lazy_analysis) {
+            %%zig_args.append("--lazy-analysis");
+        }
+
         if (self.name_prefix.len != 0) {
             %%zig_args.append("--test-name-prefix");
             %%zig_args.append(self.name_prefix);
@@ -1289,6 +1342,9 @@ pub const CLibExeObjStep = struct {
             builtin.Mode.ReleaseFast => {
                 %%args.append("-O2");
             },
+            builtin.Mode.ReleaseSmall => {
+                %%args.append("-Oz");
+            },
         }
 
         for (self.include_dirs.toSliceConst()) |dir| {
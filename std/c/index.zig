@@ -10,5 +10,6 @@ pub use switch(builtin.os) {
 };
 
 pub extern "c" fn abort() -> noreturn;
+pub extern "c" fn exit(code: c_int) -> noreturn;
 
 const empty_import = @import("../empty.zig");
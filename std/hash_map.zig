@@ -5,7 +5,8 @@ const mem = @import("mem.zig");
 const Allocator = mem.Allocator;
 const builtin = @import("builtin");
 
-const want_modification_safety = builtin.mode != builtin.Mode.ReleaseFast;
+const want_modification_safety = builtin.mode != builtin.Mode.ReleaseFast and
+    builtin.mode != builtin.Mode.ReleaseSmall;
 const debug_u32 = if (want_modification_safety) u32 else void;
 
 pub fn HashMap(comptime K: type, comptime V: type,
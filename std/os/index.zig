@@ -94,10 +94,45 @@ pub fn getRandomBytes(buf: []u8) -> %void {
     }
 }
 
+// provided by std/special/profile_rt.zig in --profile-generate builds
+extern fn __llvm_profile_write_file() -> c_int;
+
+/// In --profile-generate builds, writes the counters collected so far to
+/// default.profraw. exit and abort call this, so a profile is written however
+/// the program ends.
+pub fn writeProfile() {
+    if (builtin.profile_generate) {
+        _ = __llvm_profile_write_file();
+    }
+}
+
+/// Ends the process with the given exit status.
+/// If linking against libc, this calls the exit() libc function. Otherwise
+/// it uses the zig standard library implementation.
+pub fn exit(status: i32) -> noreturn {
+    writeProfile();
+    if (builtin.link_libc) {
+        c.exit(c_int(status));
+    }
+    switch (builtin.os) {
+        Os.linux => {
+            linux.exit(status);
+        },
+        Os.darwin, Os.macosx, Os.ios, Os.freebsd => {
+            posix.exit(usize(@bitCast(u32, status)));
+        },
+        Os.windows => {
+            windows.ExitProcess(@bitCast(u32, status));
+        },
+        else => @compileError("Unsupported OS"),
+    }
+}
+
 /// Raises a signal in the current kernel thread, ending its execution.
 /// If linking against libc, this calls the abort() libc function. Otherwise
 /// it uses the zig standard library implementation.
 pub coldcc fn abort() -> noreturn {
+    writeProfile();
     if (builtin.link_libc) {
         c.abort();
     }
@@ -44,8 +44,8 @@ fn posixCallMainAndExit() -> noreturn {
     const argc = *argc_ptr;
     const argv = @ptrCast(&&u8, &argc_ptr[1]);
     const envp = @ptrCast(&?&u8, &argv[argc + 1]);
-    callMain(argc, argv, envp) %% std.os.posix.exit(1);
-    std.os.posix.exit(0);
+    callMain(argc, argv, envp) %% std.os.exit(1);
+    std.os.exit(0);
 }
 
 fn callMain(argc: usize, argv: &&u8, envp: &?&u8) -> %void {
@@ -66,6 +66,12 @@ export fn main(c_argc: i32, c_argv: &&u8, c_envp: &?&u8) -> i32 {
         unreachable;
     }
 
+    if (builtin.profile_generate) {
+        // std.os.exit writes the counters, which a return from main would skip
+        callMain(usize(c_argc), c_argv, c_envp) %% std.os.exit(1);
+        std.os.exit(0);
+    }
+
     callMain(usize(c_argc), c_argv, c_envp) %% return 1;
     return 0;
 }
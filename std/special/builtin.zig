@@ -23,7 +23,7 @@ export fn memcpy(noalias dest: ?&u8, noalias src: ?&const u8, n: usize) {
 }
 
 export fn __stack_chk_fail() {
-    if (builtin.mode == builtin.Mode.ReleaseFast) {
+    if (builtin.mode == builtin.Mode.ReleaseFast or builtin.mode == builtin.Mode.ReleaseSmall) {
         @setGlobalLinkage(__stack_chk_fail, builtin.GlobalLinkage.Internal);
         unreachable;
     }
@@ -0,0 +1,108 @@
+// The part of LLVM's profiling runtime that --profile-generate builds need.
+// The instrumented program keeps its counters in sections of its own, and
+// std.os.exit and std.os.abort call __llvm_profile_write_file, which
+// writes them out in the raw format that `llvm-profdata merge` reads.
+// Only Linux on x86_64 and i386 is supported: the linker defines the bounds
+// of those sections in ELF output, and the file is written with
+// std.os.linux. This object is built without instrumentation, and it is
+// not cached because it imports std.
+
+const builtin = @import("builtin");
+const linux = @import("std").os.linux;
+
+comptime {
+    if (builtin.os != builtin.Os.linux or
+        (builtin.arch != builtin.Arch.x86_64 and builtin.arch != builtin.Arch.i386))
+    {
+        @compileError("--profile-generate is only supported when targeting Linux on x86_64 or i386");
+    }
+}
+
+const raw_magic_char = if (@sizeOf(usize) == 8) 'r' else 'R';
+const raw_magic = (u64(255) << 56) | (u64('l') << 48) | (u64('p') << 40) | (u64(raw_magic_char) << 32) |
+    (u64('o') << 24) | (u64('f') << 16) | (u64('r') << 8) | 129;
+
+const EINTR = 4;
+
+// the last kind of value profile, only indirect call targets
+const value_kind_last = 0;
+
+// One record per instrumented function, laid out like __llvm_profile_data.
+const ProfileData = extern struct {
+    name_ref: u64,
+    func_hash: u64,
+    counter_ptr: &u64,
+    function_pointer: ?&u8,
+    values: ?&u8,
+    num_counters: u32,
+    num_value_sites: [value_kind_last + 1]u16,
+};
+
+extern var __start___llvm_prf_data: u8;
+extern var __stop___llvm_prf_data: u8;
+extern var __start___llvm_prf_cnts: u8;
+extern var __stop___llvm_prf_cnts: u8;
+extern var __start___llvm_prf_names: u8;
+extern var __stop___llvm_prf_names: u8;
+
+// Defined by the instrumented module: the format version including the flag
+// that marks IR level instrumentation, and the file name to write.
+extern var __llvm_profile_raw_version: u64;
+extern var __llvm_profile_filename: u8;
+
+// Every instrumented module refers to this, which is how the linker knows to
+// keep the runtime.
+export var __llvm_profile_runtime: i32 = 0;
+
+// Indirect call targets are not recorded, so their value sites stay empty.
+export fn __llvm_profile_instrument_target(target: u64, data: ?&u8, counter_index: u32) {}
+
+export fn __llvm_profile_write_file() -> c_int {
+    const data_begin = usize(&__start___llvm_prf_data);
+    const counters_begin = usize(&__start___llvm_prf_cnts);
+    const names_begin = usize(&__start___llvm_prf_names);
+    const data_size = usize(&__stop___llvm_prf_data) - data_begin;
+    const counters_size = usize(&__stop___llvm_prf_cnts) - counters_begin;
+    const names_size = usize(&__stop___llvm_prf_names) - names_begin;
+
+    const header = []u64 {
+        raw_magic,
+        __llvm_profile_raw_version,
+        data_size / @sizeOf(ProfileData),
+        counters_size / @sizeOf(u64),
+        names_size,
+        counters_begin,
+        names_begin,
+        value_kind_last,
+    };
+    // the names are followed by zeros up to a multiple of 8 bytes
+    const padding = []u8 {0} ** 8;
+    const padding_size = (8 - names_size % 8) % 8;
+
+    const rc = linux.open(&__llvm_profile_filename, linux.O_WRONLY | linux.O_CREAT | linux.O_TRUNC, 0o644);
+    if (linux.getErrno(rc) != 0)
+        return -1;
+    const fd = i32(rc);
+
+    const ok = writeAll(fd, @ptrCast(&const u8, &header[0]), @sizeOf(@typeOf(header))) and
+        writeAll(fd, &__start___llvm_prf_data, data_size) and
+        writeAll(fd, &__start___llvm_prf_cnts, counters_size) and
+        writeAll(fd, &__start___llvm_prf_names, names_size) and
+        writeAll(fd, &padding[0], padding_size);
+    _ = linux.close(fd);
+    return if (ok) 0 else -1;
+}
+
+fn writeAll(fd: i32, bytes: &const u8, len: usize) -> bool {
+    var index: usize = 0;
+    while (index < len) {
+        const rc = linux.write(fd, &bytes[index], len - index);
+        const err = linux.getErrno(rc);
+        if (err == EINTR)
+            continue;
+        if (err != 0)
+            return false;
+        index += rc;
+    }
+    return true;
+}
@@ -9,4 +9,7 @@ pub fn addCases(cases: &tests.BuildExamplesContext) {
     cases.addBuildFile("example/mix_o_files/build.zig");
     cases.addBuildFile("test/standalone/issue_339/build.zig");
     cases.addBuildFile("test/standalone/pkg_import/build.zig");
+    cases.addBuildFile("test/standalone/lazy_analysis/build.zig");
+    cases.addBuildFile("test/standalone/lto/build.zig");
+    cases.addBuildFile("test/standalone/profile_generate/build.zig");
 }
@@ -1,5 +1,7 @@
 const assert = @import("std").debug.assert;
-const AtomicOrder = @import("builtin").AtomicOrder;
+const builtin = @import("builtin");
+const AtomicOrder = builtin.AtomicOrder;
+const AtomicRmwOp = builtin.AtomicRmwOp;
 
 test "cmpxchg" {
     var x: i32 = 1234;
@@ -12,3 +14,48 @@ test "fence" {
     @fence(AtomicOrder.SeqCst);
     x = 5678;
 }
+
+test "atomicrmw and atomicload" {
+    var data: u8 = 200;
+    testAtomicRmw(&data);
+    assert(data == 42);
+    testAtomicLoad(&data);
+}
+
+fn testAtomicRmw(ptr: &u8) {
+    const prev_value = @atomicRmw(u8, ptr, AtomicRmwOp.Xchg, 42, AtomicOrder.SeqCst);
+    assert(prev_value == 200);
+}
+
+fn testAtomicLoad(ptr: &u8) {
+    const x = @atomicLoad(u8, ptr, AtomicOrder.SeqCst);
+    assert(x == 42);
+}
+
+test "atomicrmw arithmetic" {
+    var x: i32 = 10;
+    assert(@atomicRmw(i32, &x, AtomicRmwOp.Add, 5, AtomicOrder.SeqCst) == 10);
+    assert(@atomicRmw(i32, &x, AtomicRmwOp.Sub, 3, AtomicOrder.Monotonic) == 15);
+    assert(@atomicRmw(i32, &x, AtomicRmwOp.Max, 20, AtomicOrder.AcqRel) == 12);
+    assert(@atomicRmw(i32, &x, AtomicRmwOp.Min, -4, AtomicOrder.Acquire) == 20);
+    assert(x == -4);
+
+    var bits: u16 = 0b1100;
+    assert(@atomicRmw(u16, &bits, AtomicRmwOp.And, 0b1010, AtomicOrder.SeqCst) == 0b1100);
+    assert(@atomicRmw(u16, &bits, AtomicRmwOp.Or, 0b0001, AtomicOrder.SeqCst) == 0b1000);
+    assert(@atomicRmw(u16, &bits, AtomicRmwOp.Xor, 0b1111, AtomicOrder.Release) == 0b1001);
+    assert(bits == 0b0110);
+
+    // unsigned Max and Min compare as unsigned
+    var big: u32 = 1;
+    _ = @atomicRmw(u32, &big, AtomicRmwOp.Max, 0xffffffff, AtomicOrder.SeqCst);
+    assert(big == 0xffffffff);
+}
+
+test "atomicstore" {
+    var x: u64 = 0;
+    @atomicStore(u64, &x, 0x123456789, AtomicOrder.Release);
+    assert(@atomicLoad(u64, &x, AtomicOrder.Acquire) == 0x123456789);
+    @atomicStore(u64, &x, 1, AtomicOrder.Unordered);
+    assert(@atomicLoad(u64, &x, AtomicOrder.Unordered) == 1);
+}
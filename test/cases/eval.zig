@@ -342,3 +342,122 @@ test "const global shares pointer with other same one" {
 fn assertEqualPtrs(ptr1: &const u8, ptr2: &const u8) {
     assert(ptr1 == ptr2);
 }
+
+test "repeated comptime calls see their own arguments" {
+    comptime {
+        var i: u32 = 0;
+        var sum: u32 = 0;
+        while (i < 10) : (i += 1) {
+            sum += sumOfSquares(i);
+        }
+        assert(sum == 825);
+        assert(sumOfSquares(10) == 385);
+    }
+}
+fn sumOfSquares(n: u32) -> u32 {
+    var total: u32 = 0;
+    var i: u32 = 1;
+    while (i <= n) : (i += 1) {
+        total += i * i;
+    }
+    return total;
+}
+
+test "comptime calls that return new types are not shared" {
+    const A = Wrapper(u8);
+    const B = Wrapper(u16);
+    comptime assert(A != B);
+    comptime assert(@sizeOf(A) == 1);
+    comptime assert(@sizeOf(B) == 2);
+}
+fn Wrapper(comptime T: type) -> type {
+    struct {
+        value: T,
+    }
+}
+
+test "comptime calls computing with integers and arrays" {
+    const table = comptime makeSquaresTable();
+    assert(table.len == 16);
+    assert(table[0] == 0);
+    assert(table[7] == 49);
+    assert(table[15] == 225);
+    comptime assert(wrappingHash(4) == 0xc3aa51b1);
+}
+fn makeSquaresTable() -> [16]u32 {
+    var table: [16]u32 = undefined;
+    var i: usize = 0;
+    while (i < table.len) : (i += 1) {
+        table[i] = u32(i * i);
+    }
+    return table;
+}
+fn wrappingHash(n: u32) -> u32 {
+    var hash: u32 = 2166136261;
+    var i: u32 = 0;
+    while (i < n) : (i += 1) {
+        hash ^= i;
+        hash *%= 16777619;
+    }
+    return hash;
+}
+
+test "comptime calls that mutate a local array start from a fresh one" {
+    comptime {
+        assert(fillAndSum(3, 1) == 3);
+        assert(fillAndSum(3, 2) == 6);
+        assert(fillAndSum(5, 0) == 0);
+        assert(replaceFirstByte('x') == 'a');
+        assert(replaceFirstByte('y') == 'a');
+    }
+}
+fn fillAndSum(count: usize, value: u32) -> u32 {
+    var array = []u32{0} ** 5;
+    var i: usize = 0;
+    while (i < count) : (i += 1) {
+        array[i] += value;
+    }
+    var total: u32 = 0;
+    for (array) |x| {
+        total += x;
+    }
+    return total;
+}
+fn replaceFirstByte(byte: u8) -> u8 {
+    var buf = "abc";
+    const before = buf[0];
+    buf[0] = byte;
+    return before;
+}
+
+test "recursive comptime calls with different arguments" {
+    comptime {
+        assert(triangle(4) == 10);
+        assert(triangle(6) == 21);
+        assert(triangle(3) == 6);
+    }
+}
+fn triangle(n: u32) -> u32 {
+    var parts = []u32{n, 0};
+    if (n > 0) {
+        parts[1] = triangle(n - 1);
+    }
+    return parts[0] + parts[1];
+}
+
+test "comptime calls after one the interpreter gave up on" {
+    comptime {
+        assert(lowByte(-1) == 255);
+        assert(lowByte(300) == 44);
+        assert(lowByte(-256) == 0);
+        assert(lowByte(513) == 1);
+        assert(wrappingShl(0xffffffffffffffff, 63) == 0x8000000000000000);
+        assert(wrappingShl(3, 1) == 6);
+    }
+}
+fn lowByte(x: i32) -> i32 {
+    return x & 0xff;
+}
+fn wrappingShl(x: u64, n: u6) -> u64 {
+    return x <<% n;
+}
@@ -135,3 +135,56 @@ test "array of generic fns" {
     assert(foos[0](true));
     assert(!foos[1](true));
 }
+
+
+test "generic fn keyed on comptime array and struct values" {
+    assert(sumOfTable([3]u8 {1, 2, 3}) == 6);
+    assert(sumOfTable([3]u8 {1, 2, 3}) == 6);
+    assert(sumOfTable([3]u8 {1, 2, 4}) == 7);
+    assert(sumOfTable("abc") == 294);
+    assert(rangeWidth(Range {.start = 2, .end = 9}) == 7);
+    assert(rangeWidth(Range {.start = 2, .end = 9}) == 7);
+    assert(rangeWidth(Range {.start = 3, .end = 9}) == 6);
+}
+fn sumOfTable(comptime table: [3]u8) -> u32 {
+    var sum: u32 = 0;
+    for (table) |x| {
+        sum += x;
+    }
+    return sum;
+}
+const Range = struct {
+    start: u32,
+    end: u32,
+};
+fn rangeWidth(comptime range: Range) -> u32 {
+    return range.end - range.start;
+}
+
+test "identical generic instantiations keep their own results" {
+    // LLVM's MergeFunctions pass, which release builds run, folds functions
+    // that lower to the same code. sumOf(i32) and sumOf(u32) are identical
+    // once safety is off;
+    // divide(i32) and divide(u32) are not and must stay separate.
+    var signed = []i32 { 1, 2, 3, -4 };
+    var unsigned = []u32 { 1, 2, 3, 4 };
+    assert(sumOf(i32, signed[0..]) == 2);
+    assert(sumOf(u32, unsigned[0..]) == 10);
+
+    var signed_dividend: i32 = -8;
+    var unsigned_dividend: u32 = 0xfffffff8;
+    assert(divide(i32, signed_dividend, 2) == -4);
+    assert(divide(u32, unsigned_dividend, 2) == 0x7ffffffc);
+}
+
+fn sumOf(comptime T: type, items: []const T) -> T {
+    var total: T = 0;
+    for (items) |item| {
+        total += item;
+    }
+    return total;
+}
+
+fn divide(comptime T: type, a: T, b: T) -> T {
+    @divTrunc(a, b)
+}
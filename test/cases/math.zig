@@ -251,3 +251,28 @@ test "allow signed integer division/remainder when values are comptime known and
 test "float literal parsing" {
     comptime assert(0x1.0 == 1.0);
 }
+
+test "constants that differ only in the sign of zero" {
+    const negative = []f32 { -0.0, 1.0 };
+    const positive = []f32 { 0.0, 1.0 };
+    assert(firstSignBit(negative[0..]) == 1);
+    assert(firstSignBit(positive[0..]) == 0);
+
+    const negative_point = FloatPoint { .x = -0.0, .y = 1.0 };
+    const positive_point = FloatPoint { .x = 0.0, .y = 1.0 };
+    assert(pointSignBit(&negative_point) == 1);
+    assert(pointSignBit(&positive_point) == 0);
+}
+
+const FloatPoint = struct {
+    x: f64,
+    y: f64,
+};
+
+fn firstSignBit(values: []const f32) -> u32 {
+    @bitCast(u32, values[0]) >> 31
+}
+
+fn pointSignBit(point: &const FloatPoint) -> u64 {
+    @bitCast(u64, point.x) >> 63
+}
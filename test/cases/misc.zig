@@ -135,6 +135,19 @@ fn testTruncate(x: u32) -> u8 {
     @truncate(u8, x)
 }
 
+test "truncate a negative multiple of 2^n to n bits" {
+    assert(testTruncateSigned(-256) == 0);
+    comptime {
+        assert(@truncate(i8, i16(-256)) == 0);
+        assert(@truncate(i64, i128(-(1 << 64))) == 0);
+        assert(@truncate(i70, i128(-(1 << 70))) == 0);
+        assert(@truncate(i70, i128(-(1 << 70) - 5)) == -5);
+    }
+}
+fn testTruncateSigned(x: i16) -> i8 {
+    @truncate(i8, x)
+}
+
 fn first4KeysOfHomeRow() -> []const u8 {
     "aoeu"
 }
@@ -205,6 +218,15 @@ test "array mult operator" {
     assert(mem.eql(u8, "ab" ** 5, "ababababab"));
 }
 
+test "comptime mutation of string literal array" {
+    comptime {
+        var s = "hello";
+        s[0] = 'j';
+        assert(mem.eql(u8, s, "jello"));
+        assert(mem.eql(u8, "hello", "hello"));
+    }
+}
+
 test "string escapes" {
     assert(mem.eql(u8, "\"", "\x22"));
     assert(mem.eql(u8, "\'", "\x27"));
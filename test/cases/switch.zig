@@ -205,6 +205,29 @@ fn testSwitchHandleAllCasesRange(x: u8) -> u8 {
     }
 }
 
+test "switch handles all cases up to the max value of the type" {
+    assert(testSwitchHandleAllCasesU64(100) == 0);
+    assert(testSwitchHandleAllCasesU64(101) == 1);
+    assert(testSwitchHandleAllCasesU64(@maxValue(u64)) == 2);
+    assert(testSwitchHandleAllCasesUsize(0) == 0);
+    assert(testSwitchHandleAllCasesUsize(@maxValue(usize)) == 1);
+}
+
+fn testSwitchHandleAllCasesU64(x: u64) -> u8 {
+    switch (x) {
+        0 ... 100 => u8(0),
+        101 ... @maxValue(u64) - 1 => 1,
+        @maxValue(u64) => 2,
+    }
+}
+
+fn testSwitchHandleAllCasesUsize(x: usize) -> u8 {
+    switch (x) {
+        0 ... @maxValue(usize) - 1 => u8(0),
+        @maxValue(usize) => 1,
+    }
+}
+
 test "switch all prongs unreachable" {
     testAllProngsUnreachable();
     comptime testAllProngsUnreachable();
@@ -225,3 +248,49 @@ fn switchWithUnreachable(x: i32) -> i32 {
     }
     return 10;
 }
+
+test "dense and sparse integer switches" {
+    var x: i8 = -128;
+    while (true) : (x += 1) {
+        assert(denseSwitch(x) == switch (x) { -2 ... 5 => i32(x) + 10, else => 0 });
+        if (x == 127) break;
+    }
+    assert(sparseSwitch(0) == 1);
+    assert(sparseSwitch(7) == 2);
+    assert(sparseSwitch(100) == 3);
+    assert(sparseSwitch(1000) == 4);
+    assert(sparseSwitch(5000) == 5);
+    assert(sparseSwitch(40000) == 6);
+    assert(sparseSwitch(65535) == 7);
+    assert(sparseSwitch(123456) == 8);
+    assert(sparseSwitch(8) == 0);
+    assert(sparseSwitch(99999) == 0);
+}
+
+fn denseSwitch(x: i8) -> i32 {
+    switch (x) {
+        -2 => 8,
+        -1 => 9,
+        0 => 10,
+        1 => 11,
+        2 => 12,
+        3 => 13,
+        4 => 14,
+        5 => 15,
+        else => 0,
+    }
+}
+
+fn sparseSwitch(x: u32) -> i32 {
+    switch (x) {
+        0 => 1,
+        7 => 2,
+        100 => 3,
+        1000 => 4,
+        5000 => 5,
+        40000 => 6,
+        65535 => 7,
+        123456 => 8,
+        else => 0,
+    }
+}
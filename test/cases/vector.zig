@@ -0,0 +1,148 @@
+const assert = @import("std").debug.assert;
+const ReduceOp = @import("builtin").ReduceOp;
+
+test "vector elementwise arithmetic" {
+    var a = @Vector(4, i32)([]i32 {1, 2, 3, 4});
+    var b = @Vector(4, i32)([]i32 {10, 20, 30, 40});
+    const sum = [4]i32(a + b);
+    assert(sum[0] == 11 and sum[1] == 22 and sum[2] == 33 and sum[3] == 44);
+    const product = [4]i32(a * b);
+    assert(product[0] == 10 and product[1] == 40 and product[2] == 90 and product[3] == 160);
+    const difference = [4]i32(b - a);
+    assert(difference[0] == 9 and difference[3] == 36);
+}
+
+test "vector comparison produces a vector of bool" {
+    var a = @Vector(4, u8)([]u8 {1, 5, 3, 7});
+    var b = @splat(4, u8(4));
+    const less = [4]bool(a < b);
+    assert(less[0] and !less[1] and less[2] and !less[3]);
+    assert(@reduce(ReduceOp.Or, a == b) == false);
+}
+
+test "vector of floats" {
+    var a = @Vector(2, f32)([]f32 {1.5, 2.5});
+    var b = @splat(2, f32(2.0));
+    const quotient = [2]f32(a / b);
+    assert(quotient[0] == 0.75 and quotient[1] == 1.25);
+    assert(@reduce(ReduceOp.Add, a) == 4.0);
+}
+
+test "@splat" {
+    var x: u16 = 7;
+    const v = [8]u16(@splat(8, x));
+    for (v) |elem| {
+        assert(elem == 7);
+    }
+}
+
+test "@shuffle" {
+    var a = @Vector(4, i32)([]i32 {1, 2, 3, 4});
+    var b = @Vector(4, i32)([]i32 {5, 6, 7, 8});
+    // ~i selects element i of b
+    const mask = []i32 {3, ~i32(0), 1, ~i32(3)};
+    const shuffled = [4]i32(@shuffle(i32, a, b, mask));
+    assert(shuffled[0] == 4 and shuffled[1] == 5 and shuffled[2] == 2 and shuffled[3] == 8);
+
+    const widened = [6]i32(@shuffle(i32, a, b, []i32 {0, 0, 1, 1, ~i32(2), ~i32(2)}));
+    assert(widened[0] == 1 and widened[3] == 2 and widened[5] == 7);
+}
+
+test "@extractElement and @insertElement" {
+    var v = @Vector(4, u32)([]u32 {1, 2, 3, 4});
+    var index: usize = 2;
+    assert(@extractElement(v, index) == 3);
+    v = @insertElement(v, index, 30);
+    assert(@extractElement(v, 2) == 30);
+    assert(@extractElement(v, 3) == 4);
+}
+
+test "@reduce" {
+    var a = @Vector(4, i32)([]i32 {3, -7, 12, 5});
+    assert(@reduce(ReduceOp.Add, a) == 13);
+    assert(@reduce(ReduceOp.Mul, a) == -1260);
+    assert(@reduce(ReduceOp.Min, a) == -7);
+    assert(@reduce(ReduceOp.Max, a) == 12);
+
+    var c = @Vector(3, u8)([]u8 {0b0011, 0b0101, 0b1001});
+    assert(@reduce(ReduceOp.And, c) == 0b0001);
+    assert(@reduce(ReduceOp.Or, c) == 0b1111);
+    assert(@reduce(ReduceOp.Xor, c) == 0b1111);
+}
+
+test "comptime vectors filled in one element at a time" {
+    comptime {
+        var v = @Vector(3, u8)(undefined);
+        v = @insertElement(v, 0, 1);
+        v = @insertElement(v, 1, 2);
+        v = @insertElement(v, 2, 3);
+        assert(@reduce(ReduceOp.Add, v) == 6);
+
+        var array: [2]u16 = undefined;
+        array[1] = 7;
+        const w = @Vector(2, u16)(array);
+        assert(@extractElement(w, 1) == 7);
+        const filled = @insertElement(w, 0, 5);
+        assert(@reduce(ReduceOp.Add, filled) == 12);
+    }
+}
+
+test "vector operations at compile time" {
+    comptime {
+        const a = @Vector(4, i32)([]i32 {1, 2, 3, 4});
+        const b = a * @splat(4, i32(2)) + a;
+        assert(@reduce(ReduceOp.Add, b) == 30);
+        const r = [4]i32(@shuffle(i32, b, b, []i32 {3, 2, 1, 0}));
+        assert(r[0] == 12 and r[3] == 3);
+    }
+}
+
+test "vector of values narrower than a byte" {
+    var a = @Vector(4, u3)([]u3 {1, 2, 3, 4});
+    const b = [4]u3(a +% @splat(4, u3(5)));
+    assert(b[0] == 6 and b[1] == 7 and b[2] == 0 and b[3] == 1);
+}
+
+test "vector shifts" {
+    var a = @Vector(4, u8)([]u8 {1, 3, 0b1000, 0b01000000});
+    var amounts = @Vector(4, u8)([]u8 {0, 2, 3, 1});
+    const left = [4]u8(a << amounts);
+    assert(left[0] == 1 and left[1] == 12 and left[2] == 64 and left[3] == 128);
+    const right = [4]u8(a >> amounts);
+    assert(right[0] == 1 and right[1] == 0 and right[2] == 1 and right[3] == 0b00100000);
+
+    var b = @Vector(2, i16)([]i16 {-8, 5});
+    const signed_right = [2]i16(b >> @splat(2, i16(2)));
+    assert(signed_right[0] == -2 and signed_right[1] == 1);
+}
+
+test "vector @divFloor and @mod" {
+    var a = @Vector(4, i32)([]i32 {7, -7, 7, -7});
+    var b = @Vector(4, i32)([]i32 {2, 2, -2, -2});
+    const quotient = [4]i32(@divFloor(a, b));
+    assert(quotient[0] == 3 and quotient[1] == -4 and quotient[2] == -4 and quotient[3] == 3);
+    const modulus = [4]i32(@mod(a, @splat(4, i32(3))));
+    assert(modulus[0] == 1 and modulus[1] == 2 and modulus[2] == 1 and modulus[3] == 2);
+
+    var c = @Vector(2, f32)([]f32 {-7.5, 7.5});
+    var d = @splat(2, f32(2.0));
+    const float_quotient = [2]f32(@divFloor(c, d));
+    assert(float_quotient[0] == -4.0 and float_quotient[1] == 3.0);
+    const float_modulus = [2]f32(@mod(c, d));
+    assert(float_modulus[0] == 0.5 and float_modulus[1] == 1.5);
+}
+
+test "vector arithmetic up to the limits of the element type" {
+    var a = @Vector(3, u8)([]u8 {250, 0, 15});
+    var b = @Vector(3, u8)([]u8 {5, 0, 17});
+    const sum = [3]u8(a + b);
+    assert(sum[0] == 255 and sum[1] == 0 and sum[2] == 32);
+    const product = [3]u8(b * @splat(3, u8(15)));
+    assert(product[0] == 75 and product[2] == 255);
+
+    var c = @Vector(2, i8)([]i8 {-128, 127});
+    const quotient = [2]i8(@divTrunc(c, @splat(2, i8(1))));
+    assert(quotient[0] == -128 and quotient[1] == 127);
+    const difference = [2]i8(c - @Vector(2, i8)([]i8 {0, 127}));
+    assert(difference[0] == -128 and difference[1] == 0);
+}
@@ -614,6 +614,48 @@ pub fn addCases(cases: &tests.CompileErrorContext) {
     ,
         ".tmp_source.zig:2:5: error: switch must handle all possibilities");
 
+    cases.add("switch expression - u64 prongs that stop short of the max value",
+        \\fn foo(x: u64) -> u8 {
+        \\    switch (x) {
+        \\        0 ... 100 => u8(0),
+        \\    }
+        \\}
+        \\export fn entry() -> usize { @sizeOf(@typeOf(foo)) }
+    ,
+        ".tmp_source.zig:2:5: error: switch must handle all possibilities");
+
+    cases.add("switch expression - u64 prongs that reach the max value with a gap",
+        \\fn foo(x: u64) -> u8 {
+        \\    switch (x) {
+        \\        0 ... 100 => u8(0),
+        \\        102 ... @maxValue(u64) => 1,
+        \\    }
+        \\}
+        \\export fn entry() -> usize { @sizeOf(@typeOf(foo)) }
+    ,
+        ".tmp_source.zig:2:5: error: switch must handle all possibilities");
+
+    cases.add("switch expression - usize prongs that reach the max value with a gap",
+        \\fn foo(x: usize) -> u8 {
+        \\    switch (x) {
+        \\        1 ... @maxValue(usize) => u8(0),
+        \\    }
+        \\}
+        \\export fn entry() -> usize { @sizeOf(@typeOf(foo)) }
+    ,
+        ".tmp_source.zig:2:5: error: switch must handle all possibilities");
+
+    cases.add("switch expression - range start greater than end",
+        \\fn foo(x: u8) -> u8 {
+        \\    switch (x) {
+        \\        10 ... 5 => u8(0),
+        \\        else => 1,
+        \\    }
+        \\}
+        \\export fn entry() -> usize { @sizeOf(@typeOf(foo)) }
+    ,
+        ".tmp_source.zig:3:9: error: range start value is greater than the end value");
+
     cases.add("switch expression - duplicate or overlapping integer value",
         \\fn foo(x: u8) -> u8 {
         \\    switch (x) {
@@ -628,6 +670,19 @@ pub fn addCases(cases: &tests.CompileErrorContext) {
         ".tmp_source.zig:6:9: error: duplicate switch value",
         ".tmp_source.zig:5:14: note: previous value is here");
 
+    cases.add("switch expression - integer range containing an earlier prong",
+        \\fn foo(x: u8) -> u8 {
+        \\    switch (x) {
+        \\        10 ... 20 => u8(0),
+        \\        0 ... 100 => 1,
+        \\        else => 2,
+        \\    }
+        \\}
+        \\export fn entry() -> usize { @sizeOf(@typeOf(foo)) }
+    ,
+        ".tmp_source.zig:4:9: error: duplicate switch value",
+        ".tmp_source.zig:3:9: note: previous value is here");
+
     cases.add("switch expression - switch on pointer type with no else",
         \\fn foo(x: &u8) {
         \\    switch (x) {
@@ -1918,4 +1973,69 @@ pub fn addCases(cases: &tests.CompileErrorContext) {
         ".tmp_source.zig:1:13: error: aoeu",
         ".tmp_source.zig:3:19: note: referenced here",
         ".tmp_source.zig:7:12: note: referenced here");
+
+    cases.add("vector of a type that is not a number",
+        \\const V = @Vector(4, []u8);
+        \\
+        \\export fn entry() -> usize { @sizeOf(V) }
+    ,
+        ".tmp_source.zig:1:22: error: vector element type must be an integer, float or bool, found '[]u8'");
+
+    cases.add("arithmetic on a vector of bool",
+        \\export fn entry() {
+        \\    var a = @splat(2, true);
+        \\    _ = a + a;
+        \\}
+    ,
+        ".tmp_source.zig:3:11: error: operator not allowed for type '@Vector(2, bool)'");
+
+    cases.add("@shuffle mask selects past the end of the vector",
+        \\export fn entry() {
+        \\    var a = @splat(4, i32(1));
+        \\    _ = @shuffle(i32, a, a, []i32 {0, 4});
+        \\}
+    ,
+        ".tmp_source.zig:3:29: error: mask index 1 selects element 4 of '@Vector(4, i32)' which has 4 elements");
+
+    cases.add("vector shift by the element width at compile time",
+        \\export fn entry() {
+        \\    const a = @splat(2, u8(1));
+        \\    _ = a >> @splat(2, u8(8));
+        \\}
+    ,
+        ".tmp_source.zig:3:11: error: shift amount is too large for 'u8'");
+
+    cases.add("arithmetic on a comptime vector with an undefined element",
+        \\export fn entry() {
+        \\    const a = @insertElement(@Vector(2, i32)(undefined), 0, 1);
+        \\    _ = a + a;
+        \\}
+    ,
+        ".tmp_source.zig:3:9: error: use of undefined value in element 1 of '@Vector(2, i32)'");
+
+    cases.add("@atomicRmw with an integer type that is not a power of 2",
+        \\const AtomicOrder = @import("builtin").AtomicOrder;
+        \\const AtomicRmwOp = @import("builtin").AtomicRmwOp;
+        \\export fn f() {
+        \\    var x: u24 = 1;
+        \\    _ = @atomicRmw(u24, &x, AtomicRmwOp.Add, 1, AtomicOrder.SeqCst);
+        \\}
+    , ".tmp_source.zig:5:20: error: 24-bit integer type is not a power of 2");
+
+    cases.add("@atomicRmw with Unordered ordering",
+        \\const AtomicOrder = @import("builtin").AtomicOrder;
+        \\const AtomicRmwOp = @import("builtin").AtomicRmwOp;
+        \\export fn f() {
+        \\    var x: u32 = 1;
+        \\    _ = @atomicRmw(u32, &x, AtomicRmwOp.Xchg, 2, AtomicOrder.Unordered);
+        \\}
+    , ".tmp_source.zig:5:61: error: @atomicRmw atomic ordering must not be Unordered");
+
+    cases.add("@atomicStore with Acquire ordering",
+        \\const AtomicOrder = @import("builtin").AtomicOrder;
+        \\export fn f() {
+        \\    var x: u32 = 1;
+        \\    @atomicStore(u32, &x, 2, AtomicOrder.Acquire);
+        \\}
+    , ".tmp_source.zig:4:41: error: @atomicStore atomic ordering must not be Acquire or AcqRel");
 }
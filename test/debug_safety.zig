@@ -231,4 +231,123 @@ pub fn addCases(cases: &tests.CompareOutputContext) {
         \\    return error(x);
         \\}
     );
+
+    cases.addDebugSafety("vector integer addition overflow",
+        \\pub fn panic(message: []const u8) -> noreturn {
+        \\    @breakpoint();
+        \\    while (true) {}
+        \\}
+        \\error Whatever;
+        \\pub fn main() -> %void {
+        \\    var a = @Vector(4, u16)([]u16 {1, 2, 65530, 4});
+        \\    var b = @Vector(4, u16)([]u16 {10, 10, 10, 10});
+        \\    const x = [4]u16(add(a, b));
+        \\    if (x[2] == 0) return error.Whatever;
+        \\}
+        \\fn add(a: @Vector(4, u16), b: @Vector(4, u16)) -> @Vector(4, u16) {
+        \\    a + b
+        \\}
+    );
+
+    cases.addDebugSafety("vector integer multiplication overflow",
+        \\pub fn panic(message: []const u8) -> noreturn {
+        \\    @breakpoint();
+        \\    while (true) {}
+        \\}
+        \\error Whatever;
+        \\pub fn main() -> %void {
+        \\    var a = @Vector(2, i8)([]i8 {2, -64});
+        \\    var b = @Vector(2, i8)([]i8 {3, 3});
+        \\    const x = [2]i8(mul(a, b));
+        \\    if (x[1] == 0) return error.Whatever;
+        \\}
+        \\fn mul(a: @Vector(2, i8), b: @Vector(2, i8)) -> @Vector(2, i8) {
+        \\    a * b
+        \\}
+    );
+
+    cases.addDebugSafety("vector integer division by zero",
+        \\pub fn panic(message: []const u8) -> noreturn {
+        \\    @breakpoint();
+        \\    while (true) {}
+        \\}
+        \\error Whatever;
+        \\pub fn main() -> %void {
+        \\    var a = @Vector(4, i32)([]i32 {1, 2, 3, 4});
+        \\    var b = @Vector(4, i32)([]i32 {1, 1, 0, 1});
+        \\    const x = [4]i32(div0(a, b));
+        \\    if (x[2] == 0) return error.Whatever;
+        \\}
+        \\fn div0(a: @Vector(4, i32), b: @Vector(4, i32)) -> @Vector(4, i32) {
+        \\    @divTrunc(a, b)
+        \\}
+    );
+
+    cases.addDebugSafety("vector integer division overflow",
+        \\pub fn panic(message: []const u8) -> noreturn {
+        \\    @breakpoint();
+        \\    while (true) {}
+        \\}
+        \\error Whatever;
+        \\pub fn main() -> %void {
+        \\    var a = @Vector(2, i16)([]i16 {10, -32768});
+        \\    var b = @Vector(2, i16)([]i16 {2, -1});
+        \\    const x = [2]i16(div(a, b));
+        \\    if (x[1] == 32767) return error.Whatever;
+        \\}
+        \\fn div(a: @Vector(2, i16), b: @Vector(2, i16)) -> @Vector(2, i16) {
+        \\    @divFloor(a, b)
+        \\}
+    );
+
+    cases.addDebugSafety("vector remainder division by zero",
+        \\pub fn panic(message: []const u8) -> noreturn {
+        \\    @breakpoint();
+        \\    while (true) {}
+        \\}
+        \\error Whatever;
+        \\pub fn main() -> %void {
+        \\    var a = @Vector(2, u32)([]u32 {7, 8});
+        \\    var b = @Vector(2, u32)([]u32 {0, 3});
+        \\    const x = [2]u32(mod0(a, b));
+        \\    if (x[0] == 0) return error.Whatever;
+        \\}
+        \\fn mod0(a: @Vector(2, u32), b: @Vector(2, u32)) -> @Vector(2, u32) {
+        \\    a % b
+        \\}
+    );
+
+    cases.addDebugSafety("vector shift amount as wide as the element",
+        \\pub fn panic(message: []const u8) -> noreturn {
+        \\    @breakpoint();
+        \\    while (true) {}
+        \\}
+        \\error Whatever;
+        \\pub fn main() -> %void {
+        \\    var a = @Vector(2, u8)([]u8 {1, 1});
+        \\    var b = @Vector(2, u8)([]u8 {1, 8});
+        \\    const x = [2]u8(shr(a, b));
+        \\    if (x[1] == 0) return error.Whatever;
+        \\}
+        \\fn shr(a: @Vector(2, u8), b: @Vector(2, u8)) -> @Vector(2, u8) {
+        \\    a >> b
+        \\}
+    );
+
+    cases.addDebugSafety("vector left shift overflowed bits",
+        \\pub fn panic(message: []const u8) -> noreturn {
+        \\    @breakpoint();
+        \\    while (true) {}
+        \\}
+        \\error Whatever;
+        \\pub fn main() -> %void {
+        \\    var a = @Vector(2, u8)([]u8 {1, 0b11000000});
+        \\    var b = @Vector(2, u8)([]u8 {1, 1});
+        \\    const x = [2]u8(shl(a, b));
+        \\    if (x[1] == 0) return error.Whatever;
+        \\}
+        \\fn shl(a: @Vector(2, u8), b: @Vector(2, u8)) -> @Vector(2, u8) {
+        \\    a << b
+        \\}
+    );
 }
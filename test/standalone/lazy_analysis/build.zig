@@ -0,0 +1,20 @@
+const Builder = @import("std").build.Builder;
+
+pub fn build(b: &Builder) {
+    const exe = b.addExecutable("test", "main.zig");
+    exe.setBuildMode(b.standardReleaseOptions());
+    exe.setLazyAnalysis(true);
+
+    const run = b.addCommand(".", b.env_map, exe.getOutputPath(), [][]const u8{});
+    run.step.dependOn(&exe.step);
+
+    // the test left out by the filter refers to a function that does not
+    // compile, which only --lazy-analysis skips
+    const lazy_tests = b.addTest("test.zig");
+    lazy_tests.setLazyAnalysis(true);
+    lazy_tests.setFilter("reached through");
+
+    const test_step = b.step("test", "Test it");
+    test_step.dependOn(&run.step);
+    test_step.dependOn(&lazy_tests.step);
+}
@@ -0,0 +1,62 @@
+const assert = @import("std").debug.assert;
+
+// Each of these functions is referred to only by a global constant, so
+// --lazy-analysis has to find it in the constant's value or the link fails.
+
+fn double(x: i32) -> i32 {
+    x * 2
+}
+
+fn negate(x: i32) -> i32 {
+    -x
+}
+
+fn square(x: i32) -> i32 {
+    x * x
+}
+
+fn increment(x: i32) -> i32 {
+    x + 1
+}
+
+fn decrement(x: i32) -> i32 {
+    x - 1
+}
+
+fn halve(x: i32) -> i32 {
+    @divExact(x, 2)
+}
+
+const Op = enum {
+    Unary: fn(i32) -> i32,
+    Identity,
+};
+
+const OpHolder = struct {
+    op: Op,
+    f: fn(i32) -> i32,
+};
+
+const op_in_enum = Op.Unary { double };
+const op_in_struct = OpHolder {
+    .op = Op.Unary { halve },
+    .f = negate,
+};
+const ops_in_array = []fn(i32) -> i32 { square, increment };
+const maybe_op: ?fn(i32) -> i32 = decrement;
+
+fn apply(op: Op, x: i32) -> i32 {
+    switch (op) {
+        Op.Unary => |f| f(x),
+        Op.Identity => x,
+    }
+}
+
+pub fn main() -> %void {
+    assert(apply(op_in_enum, 3) == 6);
+    assert(apply(op_in_struct.op, 8) == 4);
+    assert(op_in_struct.f(3) == -3);
+    assert(ops_in_array[0](3) == 9);
+    assert(ops_in_array[1](3) == 4);
+    assert((??maybe_op)(3) == 2);
+}
@@ -0,0 +1,28 @@
+const assert = @import("std").debug.assert;
+
+fn triple(x: i32) -> i32 {
+    x * 3
+}
+
+const Op = enum {
+    Unary: fn(i32) -> i32,
+    Identity,
+};
+
+const op = Op.Unary { triple };
+
+test "function reached through an enum payload" {
+    var runtime_op = op;
+    switch (runtime_op) {
+        Op.Unary => |f| assert(f(2) == 6),
+        Op.Identity => unreachable,
+    }
+}
+
+fn notAnalyzed() {
+    @compileError("only the test the filter leaves out refers to this");
+}
+
+test "left out by the filter" {
+    notAnalyzed();
+}
@@ -0,0 +1,23 @@
+const assert = @import("std").debug.assert;
+
+// Read through volatile pointers so that LTO cannot fold the operations
+// below: on i386 the u64 division and remainder stay calls into compiler_rt.
+var dividend: u64 = 0x123456789ABCDEF0;
+var divisor: u64 = 0x100000007;
+var big_factor: u64 = 0x100000000;
+
+pub fn main() -> %void {
+    const a = *(&volatile dividend);
+    const b = *(&volatile divisor);
+    const quotient = a / b;
+    const remainder = a % b;
+    assert(quotient == 0x12345678);
+    assert(quotient * b + remainder == a);
+    assert(remainder < b);
+
+    const c = *(&volatile big_factor);
+    var product: u64 = undefined;
+    assert(@mulWithOverflow(u64, c, c, &product));
+    assert(!@mulWithOverflow(u64, c - 1, 3, &product));
+    assert(product == 0x2FFFFFFFD);
+}
@@ -0,0 +1,49 @@
+const builtin = @import("builtin");
+const Builder = @import("std").build.Builder;
+const LtoMode = @import("std").build.LtoMode;
+
+pub fn build(b: &Builder) {
+    const test_step = b.step("test", "Test it");
+
+    for ([]LtoMode{LtoMode.Thin, LtoMode.Full}) |mode| {
+        const mode_name = @enumTagName(mode);
+
+        // Both objects are bitcode, so LLD optimizes the call from main.zig
+        // into square.zig at link time.
+        const obj = b.addObject(b.fmt("square_{}", mode_name), "square.zig");
+        obj.setBuildMode(builtin.Mode.ReleaseFast);
+        obj.setLto(mode);
+
+        const exe = b.addExecutable(b.fmt("test_{}", mode_name), "main.zig");
+        exe.setBuildMode(builtin.Mode.ReleaseFast);
+        exe.setLto(mode);
+        exe.addObject(obj);
+
+        const run = b.addCommand(".", b.env_map, exe.getOutputPath(), [][]const u8{});
+        run.step.dependOn(&exe.step);
+        test_step.dependOn(&run.step);
+
+        // LTO codegen emits calls into compiler_rt, which has to be linked
+        // as a native object so that LLD does not drop the functions first.
+        const arith = b.addExecutable(b.fmt("arith_{}", mode_name), "arith.zig");
+        arith.setBuildMode(builtin.Mode.ReleaseFast);
+        arith.setLto(mode);
+
+        const run_arith = b.addCommand(".", b.env_map, arith.getOutputPath(), [][]const u8{});
+        run_arith.step.dependOn(&arith.step);
+        test_step.dependOn(&run_arith.step);
+
+        // u64 division is a compiler_rt call on i386, which an x86_64 Linux
+        // host can run
+        if (builtin.os == builtin.Os.linux and builtin.arch == builtin.Arch.x86_64) {
+            const arith_i386 = b.addExecutable(b.fmt("arith_i386_{}", mode_name), "arith.zig");
+            arith_i386.setBuildMode(builtin.Mode.ReleaseFast);
+            arith_i386.setTarget(builtin.Arch.i386, builtin.Os.linux, builtin.Environ.gnu);
+            arith_i386.setLto(mode);
+
+            const run_arith_i386 = b.addCommand(".", b.env_map, arith_i386.getOutputPath(), [][]const u8{});
+            run_arith_i386.step.dependOn(&arith_i386.step);
+            test_step.dependOn(&run_arith_i386.step);
+        }
+    }
+}
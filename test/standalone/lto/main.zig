@@ -0,0 +1,9 @@
+const assert = @import("std").debug.assert;
+
+extern fn square(x: i32) -> i32;
+
+pub fn main() -> %void {
+    var x: i32 = 7;
+    assert(square(x) == 49);
+    assert(square(-x) == 49);
+}
@@ -0,0 +1,3 @@
+export fn square(x: i32) -> i32 {
+    x * x
+}
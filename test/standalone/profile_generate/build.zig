@@ -0,0 +1,27 @@
+const builtin = @import("builtin");
+const Builder = @import("std").build.Builder;
+
+pub fn build(b: &Builder) {
+    const exe = b.addExecutable("test", "main.zig");
+    exe.setBuildMode(builtin.Mode.ReleaseFast);
+    exe.setProfileGenerate(true);
+
+    const check = b.addExecutable("check", "check.zig");
+
+    // the instrumented program writes default.profraw into its working
+    // directory; start from an empty file so a stale one can't pass
+    const profraw_path = b.fmt("{}/default.profraw", b.cache_root);
+    const clear = b.addWriteFile(profraw_path, "");
+
+    const run = b.addCommand(b.cache_root, b.env_map, b.pathFromRoot(exe.getOutputPath()), [][]const u8{});
+    run.step.dependOn(&exe.step);
+    run.step.dependOn(&clear.step);
+
+    const run_check = b.addCommand(".", b.env_map, check.getOutputPath(),
+        [][]const u8{b.pathFromRoot(profraw_path)});
+    run_check.step.dependOn(&check.step);
+    run_check.step.dependOn(&run.step);
+
+    const test_step = b.step("test", "Test it");
+    test_step.dependOn(&run_check.step);
+}
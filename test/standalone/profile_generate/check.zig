@@ -0,0 +1,27 @@
+const std = @import("std");
+const io = std.io;
+const os = std.os;
+const assert = std.debug.assert;
+
+const raw_magic_char = if (@sizeOf(usize) == 8) 'r' else 'R';
+const raw_magic = (u64(255) << 56) | (u64('l') << 48) | (u64('p') << 40) | (u64(raw_magic_char) << 32) |
+    (u64('o') << 24) | (u64('f') << 16) | (u64('r') << 8) | 129;
+
+// the size of the header that precedes the data, counters and names
+const header_size = 8 * @sizeOf(u64);
+
+pub fn main() -> %void {
+    var in_stream = %return io.InStream.open(os.args.at(1), null);
+    defer in_stream.close();
+
+    const file_size = %return in_stream.getEndPos();
+    assert(file_size > header_size);
+
+    const magic = %return in_stream.readIntLe(u64);
+    assert(magic == raw_magic);
+    _ = %return in_stream.readIntLe(u64); // version
+    const data_count = %return in_stream.readIntLe(u64);
+    const counter_count = %return in_stream.readIntLe(u64);
+    assert(data_count > 0);
+    assert(counter_count > 0);
+}
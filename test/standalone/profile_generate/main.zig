@@ -0,0 +1,24 @@
+const os = @import("std").os;
+
+fn collatzSteps(start: u64) -> usize {
+    var n = start;
+    var steps: usize = 0;
+    while (n != 1) : (steps += 1) {
+        n = if (n % 2 == 0) n / 2 else 3 * n + 1;
+    }
+    return steps;
+}
+
+fn finish(steps: usize) -> noreturn {
+    // main never returns, so the counters have to be written by os.exit
+    os.exit(if (steps == 0) 1 else 0);
+}
+
+pub fn main() -> %void {
+    var total: usize = 0;
+    var i: u64 = 1;
+    while (i < 1000) : (i += 1) {
+        total += collatzSteps(i);
+    }
+    finish(total);
+}
@@ -108,7 +108,7 @@ pub fn addPkgTests(b: &build.Builder, test_filter: ?[]const u8, root_src: []cons
     name:[] const u8, desc: []const u8) -> &build.Step
 {
     const step = b.step(b.fmt("test-{}", name), desc);
-    for ([]Mode{Mode.Debug, Mode.ReleaseFast}) |mode| {
+    for ([]Mode{Mode.Debug, Mode.ReleaseFast, Mode.ReleaseSmall}) |mode| {
         for ([]bool{false, true}) |link_libc| {
             const these_tests = b.addTest(root_src);
             these_tests.setNamePrefix(b.fmt("{}-{}-{} ", name, @enumTagName(mode),
@@ -500,6 +500,7 @@ pub const CompileErrorContext = struct {
                 Mode.Debug => {},
                 Mode.ReleaseSafe => %%zig_args.append("--release-safe"),
                 Mode.ReleaseFast => %%zig_args.append("--release-fast"),
+                Mode.ReleaseSmall => %%zig_args.append("--release-small"),
             }
 
             %%io.stderr.printf("Test {}/{} {}...", self.test_index+1, self.context.test_index, self.name);